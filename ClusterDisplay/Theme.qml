@@ -0,0 +1,24 @@
+pragma Singleton
+import QtQuick 6.4
+
+// Shared typography constants. Kept in a singleton (instead of properties on the
+// root window) so that bindings using them can be compiled ahead of time.
+QtObject {
+    readonly property string primaryFont: "'Ubuntu Mono', 'DejaVu Sans Mono', monospace"
+    readonly property string secondaryFont: "'Ubuntu Condensed', 'DejaVu Sans', sans-serif"
+    readonly property string monoFont: "'Ubuntu Mono', 'DejaVu Sans Mono', monospace"
+
+    readonly property int fontLight: Font.Light
+    readonly property int fontNormal: Font.Normal
+    readonly property int fontMedium: Font.Medium
+    readonly property int fontDemiBold: Font.DemiBold
+    readonly property int fontBold: Font.Bold
+
+    readonly property real letterSpacingTight: 0.5
+    readonly property real letterSpacingNormal: 1.0
+    readonly property real letterSpacingWide: 2.0
+    readonly property real letterSpacingExtraWide: 3.0
+
+    // Values restored at startup are dimmed until live data confirms them
+    readonly property real provisionalOpacity: 0.5
+}
@@ -4,16 +4,24 @@
 #include <QObject>
 #include <QQmlEngine>
 
-#include "ZmqSubscriber.hpp"
+#include "ClusterSignalHub.hpp"
 
-#define BATTERY_ADDRESS "tcp://localhost:5556"
-
-class BatteryIconObj : public ZmqSubscriber {
+/**
+ * @brief Battery percentage fed by the "battery" key of the cluster signal hub
+ */
+class BatteryIconObj : public QObject {
   Q_OBJECT
   Q_PROPERTY(int percentage READ percentage WRITE setPercentage NOTIFY percentageChanged FINAL)
 
  public:
   explicit BatteryIconObj(QObject* parent = nullptr);
+
+  /**
+   * @brief Constructs a battery icon listening to the hub's "battery" values
+   * @param hub The signal hub owning the subscription (must outlive this object)
+   * @param parent The parent QObject
+   */
+  explicit BatteryIconObj(ClusterSignalHub* hub, QObject* parent = nullptr);
   ~BatteryIconObj();
 
   int percentage(void) const;
@@ -23,10 +31,12 @@ class BatteryIconObj : public ZmqSubscriber {
   void percentageChanged(int);
 
  protected:
-  void _handleMsg(QString& message);
+  void _handleMsg(const QString& message);
 
  private:
   int m_percentage;
+  ClusterSignalHub* m_hub;
+  int m_listenerId;
 };
 
 #endif // BATTERYICONOBJ_HPP
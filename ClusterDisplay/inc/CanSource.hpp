@@ -0,0 +1,170 @@
+#ifndef CANSOURCE_HPP
+#define CANSOURCE_HPP
+
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QSocketNotifier>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+#include "ClusterModel.hpp"
+#include "DbcDatabase.hpp"
+
+/**
+ * @brief Reads the vehicle data straight from a SocketCAN interface
+ *
+ * The frames are decoded with a DbcDatabase. Each DBC signal is routed once,
+ * when the source is created:
+ * - signals mapped to a protocol key ("speed", "battery", ...) are collected
+ *   into a frame for ClusterDataSubscriber, so they take the same path as the
+ *   ZeroMQ frames (trip computer, odometer, sign expiry). A signal named like
+ *   a protocol key is mapped to it unless the mapping says otherwise;
+ * - every other signal is written to the model's SignalStore under its DBC
+ *   name and shows up in ClusterModel::vehicleSignals.
+ *
+ * The socket is read on the GUI thread through a QSocketNotifier. Each pass
+ * drains the queued frames with recvmmsg(), kBatchSize frames per system
+ * call, and emits at most one frameReceived() with the newest value of every
+ * mapped key, so a burst of CAN traffic costs one model update. Values of the
+ * priority keys are not coalesced: each decoded CAN frame carrying one is
+ * emitted at once with priorityFrameReceived(), so an alert that is raised
+ * and cleared within one pass is still seen, and never waits for the pass.
+ *
+ * Only the kernel's CAN_RAW filter passes the identifiers the database
+ * defines. SocketCAN is Linux only; elsewhere open() fails, while
+ * processFrame() still decodes frames fed by hand.
+ */
+class CanSource : public QObject {
+  Q_OBJECT
+
+ public:
+  /// Frames read per recvmmsg() call
+  static constexpr int kBatchSize = 64;
+
+  /// Batches read per notification before the event loop gets control back
+  static constexpr int kMaxBatches = 16;
+
+  /**
+   * @brief Creates a closed source
+   * @param database Compiled CAN database
+   * @param mapping Protocol key per DBC signal name, in addition to the signals named like a
+   *                key; the value of a mapped signal must be in the unit of its key
+   *                (see ClusterProtocol)
+   * @param clusterModel Model whose SignalStore receives the unmapped signals
+   * @param parent The parent QObject
+   */
+  CanSource(const DbcDatabase& database, const QHash<QString, QString>& mapping,
+            ClusterModel* clusterModel, QObject* parent = nullptr);
+  ~CanSource();
+
+  /**
+   * @brief Parses a mapping specification such as "VehicleSpeed=speed,Soc=battery"
+   * @param specification Comma-separated DBC signal name and protocol key pairs
+   * @param mapping Receives the protocol key per DBC signal name
+   * @return False if a pair is malformed or names an unknown protocol key
+   */
+  static bool parseMapping(const QString& specification, QHash<QString, QString>* mapping);
+
+  /**
+   * @brief Opens a raw CAN socket on an interface and starts reading
+   * @param interface Network interface, e.g. "can0" or "vcan0"
+   * @return False if the socket cannot be opened; see errorString()
+   */
+  bool open(const QString& interface);
+
+  /**
+   * @brief Sets the protocol keys whose values bypass the coalescing
+   * @param keys Protocol keys (e.g. "obs")
+   */
+  void setPriorityKeys(const QStringList& keys);
+
+  /** @brief Stops reading and closes the socket */
+  void close();
+
+  /** @brief Checks whether the socket is open */
+  bool isOpen() const;
+
+  /** @brief Gets the reason open() failed */
+  QString errorString() const;
+
+  /**
+   * @brief Decodes one frame
+   * Mapped values are collected until deliver(); unmapped ones are stored and priority ones
+   * emitted right away.
+   * @param id CAN identifier, without flags
+   * @param extended 29-bit identifier
+   * @param data Payload
+   * @param length Payload length in bytes
+   * @return False if the database does not define the frame or the payload is too short
+   */
+  bool processFrame(quint32 id, bool extended, const quint8* data, int length);
+
+  /**
+   * @brief Emits the values collected since the previous delivery as one frame
+   * Nothing is emitted unless a frame was decoded; the frame may be empty if only
+   * unmapped signals were received, and still tells that the bus is alive.
+   */
+  void deliver();
+
+  /** @brief Gets the number of frames decoded */
+  qint64 frameCount() const;
+
+  /** @brief Gets the number of frames that were not defined or too short */
+  qint64 unknownFrameCount() const;
+
+  /** @brief Gets the number of recvmmsg() calls that returned frames */
+  qint64 batchCount() const;
+
+ signals:
+  /**
+   * @brief Emitted once per read pass that decoded frames, with the newest mapped values
+   * @param data Protocol key-value pairs, as parsed from a ZeroMQ frame
+   */
+  void frameReceived(const QMap<QString, QString>& data);
+
+  /**
+   * @brief Emitted for every decoded CAN frame that carries a priority key
+   * @param data The priority key-value pairs of that frame only
+   */
+  void priorityFrameReceived(const QMap<QString, QString>& data);
+
+ private slots:
+  /**
+   * @brief Drains the socket and delivers the collected values
+   */
+  void onReadyRead();
+
+ private:
+  /**
+   * @brief Where a decoded signal goes
+   */
+  struct Route {
+    int signal;                    ///< Index in DbcMessage::dbcSignals
+    QString key;                   ///< Protocol key, empty for a vehicle signal
+    SignalStore::SignalId storeId; ///< Id in the model's SignalStore (vehicle signals)
+    bool priority;                 ///< Protocol key emitted without coalescing
+  };
+
+  /**
+   * @brief Routes every signal of the database to a protocol key or the SignalStore
+   */
+  void compileRoutes();
+
+  DbcDatabase m_database;                      ///< Compiled CAN database
+  ClusterModel* m_clusterModel;                ///< Receives the vehicle signals
+  QHash<QString, QString> m_mapping;           ///< Protocol key per DBC signal name
+  QVector<QVector<Route>> m_routes;            ///< Routes per message, parallel to the database
+  QMap<QString, QString> m_pending;            ///< Mapped values not delivered yet
+  bool m_undelivered;                          ///< Frames were decoded since the last delivery
+  int m_socket;                                ///< Raw CAN socket, -1 while closed
+  std::unique_ptr<QSocketNotifier> m_notifier; ///< Activity on the socket
+  QString m_error;                             ///< Reason open() failed
+  qint64 m_frameCount;                         ///< Frames decoded
+  qint64 m_unknownFrameCount;                  ///< Frames not defined or too short
+  qint64 m_batchCount;                         ///< recvmmsg() calls that returned frames
+};
+
+#endif // CANSOURCE_HPP
@@ -0,0 +1,106 @@
+#ifndef CLOCK_HPP
+#define CLOCK_HPP
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QtGlobal>
+
+/**
+ * @brief Timer driven by a Clock, with the QTimer interface the cluster uses
+ *
+ * Created by Clock::createTimer(); behaves like a QTimer on the system clock
+ * and fires in virtual time on a VirtualClock.
+ */
+class ClockTimer : public QObject {
+  Q_OBJECT
+
+ public:
+  /** @brief Sets the interval in milliseconds; a running timer is restarted with it */
+  void setInterval(int intervalMs);
+
+  /** @brief Gets the interval in milliseconds */
+  int interval() const;
+
+  /** @brief Makes the timer fire only once per start() */
+  void setSingleShot(bool singleShot);
+
+  /** @brief Checks whether the timer fires only once per start() */
+  bool isSingleShot() const;
+
+  /** @brief Starts or restarts the timer with its interval */
+  void start();
+
+  /** @brief Sets the interval and starts or restarts the timer */
+  void start(int intervalMs);
+
+  /** @brief Stops the timer */
+  virtual void stop() = 0;
+
+  /** @brief Checks whether the timer is running */
+  virtual bool isActive() const = 0;
+
+ signals:
+  /** @brief Emitted when the interval has elapsed */
+  void timeout();
+
+ protected:
+  explicit ClockTimer(QObject* parent = nullptr);
+
+  /**
+   * @brief Starts or restarts the timer with the current interval
+   */
+  virtual void arm() = 0;
+
+ private:
+  int m_intervalMs;  ///< Interval in milliseconds
+  bool m_singleShot; ///< Fires once per start()
+};
+
+/**
+ * @brief Source of time and timers for the model and the subscriber
+ *
+ * Code that reads the time or waits for it goes through a Clock instead of
+ * QDateTime, QElapsedTimer and QTimer, so the same logic runs on the system
+ * clock in the car and on a VirtualClock in tests and replays, where hours of
+ * driving pass in as long as it takes to process them.
+ */
+class Clock {
+ public:
+  virtual ~Clock() = default;
+
+  /**
+   * @brief Gets the monotonic time in milliseconds
+   * Only differences are meaningful; the origin is unspecified.
+   */
+  virtual qint64 elapsedMs() const = 0;
+
+  /** @brief Gets the local date and time shown to the driver */
+  virtual QDateTime currentDateTime() const = 0;
+
+  /**
+   * @brief Creates a stopped timer running on this clock
+   * @param parent Owner of the timer; the clock must outlive it
+   */
+  virtual ClockTimer* createTimer(QObject* parent) = 0;
+
+  /** @brief Gets the system clock, the default of every user of a Clock */
+  static Clock* system();
+};
+
+/**
+ * @brief The system's monotonic and wall clocks, with QTimer-based timers
+ */
+class SystemClock : public Clock {
+ public:
+  SystemClock();
+
+  qint64 elapsedMs() const override;
+  QDateTime currentDateTime() const override;
+  ClockTimer* createTimer(QObject* parent) override;
+
+ private:
+  QElapsedTimer m_monotonic; ///< Origin of elapsedMs()
+};
+
+#endif // CLOCK_HPP
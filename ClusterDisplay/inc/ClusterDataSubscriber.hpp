@@ -1,29 +1,101 @@
 #ifndef CLUSTERDATASUBSCRIBER_HPP
 #define CLUSTERDATASUBSCRIBER_HPP
 
+#include <QHash>
 #include <QMap>
 #include <QObject>
+#include <QVector>
 #include <memory>
 
+#include "CanSource.hpp"
 #include "ClusterModel.hpp"
+#include "ClusterSignalHub.hpp"
+#include "LocalOdometer.hpp"
+#include "OdometerJournal.hpp"
+#include "RangeEstimator.hpp"
+#include "SequenceTracker.hpp"
+#include "TripComputer.hpp"
 #include "ZmqMessageParser.hpp"
-#include "ZmqSubscriber.hpp"
+#include "ZmqSnapshotClient.hpp"
 
-// Port definitions
+// Publisher host and port definitions
+#define DEFAULT_DATA_HOST "100.93.45.188"
 #define CRITICAL_DATA_PORT 5555
 #define NON_CRITICAL_DATA_PORT 5556
+#define SNAPSHOT_PORT 5557
+#define RATE_PORT 5558
 
 /**
  * @brief Class to manage ZeroMQ subscribers for cluster data
  *
- * This class creates and manages subscribers for critical and non-critical
- * data, parses incoming messages, and updates the cluster model accordingly.
+ * This class receives the critical and non-critical data frames from a
+ * ClusterSignalHub, and updates the cluster model accordingly.
+ *
+ * Obstacle and emergency brake frames ("obs") take the hub's priority path:
+ * they update the alert state before any telemetry queued in front of them
+ * and emit safetyFrameProcessed() so the window can render out of band.
+ *
+ * A display that starts mid-drive calls synchronize() to fetch the full state
+ * from the publisher's snapshot socket. Every frame carries the sequence
+ * number of its channel ("cseq" on the critical, "nseq" on the non-critical
+ * port); frames received while the snapshot is pending are held back and,
+ * once it is applied, only the ones newer than the snapshot are processed.
+ * Frames without a sequence number are always processed.
+ *
+ * The sequence numbers also account for lost and late frames per channel.
+ * The health of the link is published as ClusterModel::linkStatus: down while
+ * no publisher is connected, stale when no frame arrived within the stale
+ * timeout. When the publishers come back after all of them were lost, the
+ * snapshot is fetched again so the display does not wait for every key to be
+ * republished.
+ *
+ * The speed, odometer and battery values also feed a TripComputer and a
+ * RangeEstimator, whose results are published to the model every second and
+ * after each frame. Both pause while the link is down. The range estimator
+ * takes its distance from the LocalOdometer below rather than integrating the
+ * speed a second time.
+ *
+ * The displayed odometer is a LocalOdometer integrated from the speed and
+ * reconciled with the publisher's `odo`, so it moves steadily between odometer
+ * frames and keeps its count when the publisher restarts. With an
+ * OdometerJournal attached, the figure survives restarts of the display too.
+ *
+ * A CanSource attached with attachCanSource() feeds its decoded frames into
+ * the same path as the hub's frames; its obstacle values take the priority
+ * path one CAN frame at a time.
+ *
+ * The sign expiry, the stale check, the trip updates and the mock data all
+ * run on the Clock of the model, so they follow a VirtualClock in tests and
+ * replays instead of the system clock.
  */
 class ClusterDataSubscriber : public QObject {
   Q_OBJECT
 
  public:
+  /** @brief Progress of the late-join state synchronization */
+  enum SyncState {
+    Unsynchronized,   ///< Live frames only (no snapshot requested, or the request failed)
+    AwaitingSnapshot, ///< Snapshot requested; live frames are held back
+    Synchronized      ///< Snapshot applied; only newer frames are processed
+  };
+  Q_ENUM(SyncState)
+
+  /**
+   * @brief Constructs a subscriber with its own hub connected to both data ports
+   * @param clusterModel The model to update
+   * @param parent The parent QObject
+   */
   explicit ClusterDataSubscriber(ClusterModel* clusterModel, QObject* parent = nullptr);
+
+  /**
+   * @brief Constructs a subscriber fed by a shared hub
+   * @param clusterModel The model to update
+   * @param hub The signal hub owning the subscriptions (must outlive this object), or nullptr
+   *            to create a hub connected to both data ports
+   * @param parent The parent QObject
+   */
+  ClusterDataSubscriber(ClusterModel* clusterModel, ClusterSignalHub* hub,
+                        QObject* parent = nullptr);
   virtual ~ClusterDataSubscriber();
 
   /**
@@ -38,6 +110,91 @@ class ClusterDataSubscriber : public QObject {
    */
   bool isMockingEnabled() const;
 
+  /**
+   * @brief Subscribe a hub to the critical and non-critical data ports
+   * @param hub The hub to add the publishers to
+   * @param host Host or IP address of the publisher (e.g. "localhost" for ClusterLoadGen)
+   * @param options Socket and I/O thread options of both subscriptions
+   */
+  static void addDataSources(ClusterSignalHub* hub, const QString& host = DEFAULT_DATA_HOST,
+                             const ZmqSocketOptions& options = ZmqSocketOptions());
+
+  /**
+   * @brief Get the address of a publisher's snapshot socket
+   * @param host Host or IP address of the publisher
+   */
+  static QString snapshotAddress(const QString& host = DEFAULT_DATA_HOST);
+
+  /**
+   * @brief Get the address of a publisher's rate backchannel
+   * @param host Host or IP address of the publisher
+   */
+  static QString rateAddress(const QString& host = DEFAULT_DATA_HOST);
+
+  /**
+   * @brief Get the highest rate per key at which updates still change the display
+   *
+   * Values on screen are shown at most once per frame, slowly changing ones
+   * once per second. Obstacle alerts are not limited.
+   *
+   * @param refreshRate Refresh rate of the screen in Hz
+   * @return Maximum useful rate in Hz by message key
+   */
+  static QMap<QString, qreal> maxUsefulRates(qreal refreshRate);
+
+  /**
+   * @brief Fetch the full state from the publisher, then apply only newer frames
+   * @param address The ZMQ endpoint of the publisher's snapshot socket
+   * @param timeoutMs Time to wait for each of the snapshot requests
+   */
+  void synchronize(const QString& address, int timeoutMs = 500);
+
+  /**
+   * @brief Get the progress of the state synchronization
+   */
+  SyncState syncState() const;
+
+  /**
+   * @brief Get the lost and late frame accounting of a channel
+   * @param key Sequence number key of the channel ("cseq" or "nseq")
+   */
+  SequenceTracker sequenceTracker(const QString& key) const;
+
+  /**
+   * @brief Get the trip computer fed by the data frames
+   */
+  const TripComputer& tripComputer() const;
+
+  /**
+   * @brief Get the range estimator fed by the data frames
+   */
+  const RangeEstimator& rangeEstimator() const;
+
+  /**
+   * @brief Get the odometer integrated by the display
+   */
+  const LocalOdometer& localOdometer() const;
+
+  /**
+   * @brief Persist the local odometer in a journal and continue from its newest figure
+   * Without a figure in the journal, the odometer continues from the model's value.
+   * @param journal An open journal (must outlive this object), or nullptr to stop persisting
+   */
+  void setOdometerJournal(OdometerJournal* journal);
+
+  /**
+   * @brief Process the frames decoded by a CAN source like the frames of the hub
+   * CAN frames carry no sequence numbers; they are always processed and keep the link fresh.
+   * @param source The CAN source (must outlive this object)
+   */
+  void attachCanSource(CanSource* source);
+
+  /**
+   * @brief Set the time without frames after which the link is reported stale
+   * @param timeoutMs Stale timeout in milliseconds
+   */
+  void setStaleTimeout(int timeoutMs);
+
  public slots:
   /**
    * @brief Handle critical data messages
@@ -57,6 +214,25 @@ class ClusterDataSubscriber : public QObject {
    */
   void generateMockData();
 
+  /**
+   * @brief Apply a full-state snapshot and the held-back frames newer than it
+   * Ignored unless a snapshot is awaited.
+   * @param snapshot Full state including the sequence number of every channel
+   */
+  void applySnapshot(const QString& snapshot);
+
+ signals:
+  /**
+   * @brief Emitted after a safety frame was applied through the priority path
+   * Connect to QQuickWindow::update() to present the alert without waiting for other work.
+   */
+  void safetyFrameProcessed();
+
+  /**
+   * @brief Emitted once a snapshot has been applied and the model shows the full state
+   */
+  void stateSynchronized();
+
  private:
   /**
    * @brief Process parsed message data and update the cluster model
@@ -64,17 +240,122 @@ class ClusterDataSubscriber : public QObject {
    */
   void processData(const QMap<QString, QString>& data);
 
-  ClusterModel* m_clusterModel;                    ///< Pointer to cluster model
-  std::unique_ptr<ZmqSubscriber> m_criticalSub;    ///< Critical data subscriber
-  std::unique_ptr<ZmqSubscriber> m_nonCriticalSub; ///< Non-critical data subscriber
-  ZmqMessageParser m_parser;                       ///< Message parser
-  QTimer* m_mockTimer;                             ///< Timer for mock data generation
-  bool m_mockingEnabled;                           ///< Mocking status
+  /**
+   * @brief Update the obstacle and emergency brake alerts from a frame
+   * @param data The parsed key-value pairs from the message
+   * @return True if the frame contained safety data
+   */
+  bool processSafetyData(const QMap<QString, QString>& data);
+
+  /**
+   * @brief Store the numeric values of keys the protocol does not define as vehicle signals
+   * @param data The parsed key-value pairs from the message
+   */
+  void processVehicleSignals(const QMap<QString, QString>& data);
+
+  /**
+   * @brief Apply a frame carrying a priority key ahead of the queued telemetry
+   * @param data The parsed key-value pairs from the message
+   */
+  void handlePriorityFrame(const QMap<QString, QString>& data);
+
+  /**
+   * @brief Hold back, drop or process a live frame depending on the synchronization
+   * @param data The parsed key-value pairs from the message
+   */
+  void handleFrame(const QMap<QString, QString>& data);
+
+  /**
+   * @brief Check whether a frame is already contained in the applied snapshot
+   *
+   * A channel's first frame newer than the snapshot ends the check for that
+   * channel, since its frames arrive in order from then on.
+   */
+  bool coveredBySnapshot(const QMap<QString, QString>& data);
+
+  /**
+   * @brief Stop waiting for the snapshot and process the held-back frames
+   */
+  void abandonSnapshot();
+
+  /**
+   * @brief Account for the sequence numbers of a live frame
+   * @param data The parsed key-value pairs from the message
+   */
+  void trackSequences(const QMap<QString, QString>& data);
+
+  /**
+   * @brief Re-evaluate the link status from the connections and the frame age
+   */
+  void updateLinkStatus();
+
+  /**
+   * @brief Feed the trip computer and the range estimator with the values of a frame
+   * @param data The parsed key-value pairs from the message
+   */
+  void updateTrip(const QMap<QString, QString>& data);
+
+  /**
+   * @brief Get the time base of the trip computer, the range estimator and the odometer
+   * @return Milliseconds on the clock since this subscriber was created
+   */
+  qint64 tripTimeMs() const;
+
+  /**
+   * @brief Account for the time passed and publish the trip results and range to the model
+   */
+  void publishTrip();
+
+  /**
+   * @brief Publish the local odometer to the model and the journal
+   * Leaves a restored odometer provisional; only live samples confirm it.
+   */
+  void publishOdometer();
+
+  /**
+   * @brief React to publishers connecting or disconnecting
+   * @param connectedSources Number of publishers connected now
+   */
+  void onConnectedSourcesChanged(int connectedSources);
+
+  ClusterModel* m_clusterModel;                 ///< Pointer to cluster model
+  std::unique_ptr<ClusterSignalHub> m_ownedHub; ///< Hub created when none is shared
+  ClusterSignalHub* m_hub;                      ///< Hub delivering the data frames
+  int m_frameListenerId;                        ///< Registration of the frame listener
+  int m_priorityListenerId;                     ///< Registration of the safety listener
+  ZmqMessageParser m_parser;                    ///< Message parser
+  Clock* m_clock;                               ///< Clock of the model
+  ClockTimer* m_mockTimer;                      ///< Timer for mock data generation
+  bool m_mockingEnabled;                        ///< Mocking status
+
+  // Late-join state synchronization
+  std::unique_ptr<ZmqSnapshotClient> m_snapshotClient; ///< Snapshot side channel
+  SyncState m_syncState;                               ///< Synchronization progress
+  QVector<QMap<QString, QString>> m_pendingFrames;     ///< Held back until the snapshot
+  QHash<QString, qint64> m_snapshotSequences;          ///< Snapshot sequence per channel key
+  QString m_snapshotAddress;                           ///< Snapshot endpoint for resyncs
+  int m_snapshotTimeoutMs;                             ///< Reply timeout of the resyncs
+
+  // Link health
+  QHash<QString, SequenceTracker> m_sequenceTrackers; ///< Frame accounting per channel key
+  qint64 m_lastFrameMs;                               ///< Time of the newest frame (-1 = none)
+  ClockTimer* m_linkTimer;                            ///< Periodic stale check
+  int m_staleTimeoutMs;                               ///< Frame age reported as stale
+  int m_connectedSources;                             ///< Publishers connected now
+  bool m_resyncOnReconnect;                           ///< All publishers were lost
+
+  // Trip computer, range estimator and odometer
+  TripComputer m_tripComputer;        ///< Trip statistics
+  RangeEstimator m_rangeEstimator;    ///< Remaining range
+  LocalOdometer m_localOdometer;      ///< Displayed odometer
+  OdometerJournal* m_odometerJournal; ///< Persistence of the odometer (not owned, may be null)
+  qint64 m_tripStartMs;               ///< Clock time at which the trip time base starts
+  ClockTimer* m_tripTimer;            ///< Periodic publication of the trip results
 
   // Sign tracking for prolonging display instead of resetting
-  QString m_currentSignType;  ///< Currently displayed sign type
-  QString m_currentSignValue; ///< Currently displayed sign value
-  QTimer* m_signHideTimer;    ///< Timer for hiding the current sign
+  ClusterModel::SignKind m_currentSignKind; ///< Currently displayed sign kind
+  int m_currentSpeedLimit;                  ///< Currently displayed speed limit (0 if none)
+  ClockTimer* m_signHideTimer;              ///< Timer for hiding the current sign
 };
 
 #endif // CLUSTERDATASUBSCRIBER_HPP
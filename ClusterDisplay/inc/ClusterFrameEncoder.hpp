@@ -0,0 +1,68 @@
+#ifndef CLUSTERFRAMEENCODER_HPP
+#define CLUSTERFRAMEENCODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Encodes one "key1:value1;key2:value2" frame into a fixed buffer
+ *
+ * The buffer is part of the object, so encoding never allocates; an encoder
+ * is cleared and reused for every frame. A pair that does not fit is dropped
+ * as a whole and the frame is marked truncated, so a frame on the wire is
+ * always well-formed.
+ */
+class ClusterFrameEncoder {
+ public:
+  /// Bytes available for one frame; far more than all keys of a channel take
+  static constexpr size_t kCapacity = 256;
+
+  ClusterFrameEncoder();
+
+  /**
+   * @brief Starts a new, empty frame
+   */
+  void clear();
+
+  /**
+   * @brief Appends an integer value
+   * @param key Message key
+   * @param value Value in decimal
+   * @return False if the pair did not fit
+   */
+  bool append(const char* key, int64_t value);
+
+  /**
+   * @brief Appends a text value
+   * @param key Message key
+   * @param value Value; must be non-empty and not contain the protocol separators
+   * @param length Length of the value in bytes
+   * @return False if the pair did not fit or the value is not valid
+   */
+  bool append(const char* key, const char* value, size_t length);
+
+  /** @brief Gets the encoded frame (not null-terminated) */
+  const char* data() const;
+
+  /** @brief Gets the length of the encoded frame in bytes */
+  size_t size() const;
+
+  /** @brief Checks whether no pair was appended since clear() */
+  bool isEmpty() const;
+
+  /** @brief Checks whether a pair was dropped since clear() */
+  bool isTruncated() const;
+
+ private:
+  /**
+   * @brief Writes the separator and the key, reserving room for the value
+   * @return Position of the value, or nullptr if the key does not fit
+   */
+  char* beginPair(const char* key, size_t valueLength);
+
+  char m_buffer[kCapacity]; ///< Encoded frame
+  size_t m_size;            ///< Bytes used
+  bool m_truncated;         ///< A pair was dropped
+};
+
+#endif // CLUSTERFRAMEENCODER_HPP
@@ -2,10 +2,16 @@
 #ifndef CLUSTERMODEL_HPP
 #define CLUSTERMODEL_HPP
 
+#include <QByteArray>
+#include <QJSEngine>
 #include <QObject>
 #include <QQmlEngine>
 #include <QTimer>
 
+#include "Clock.hpp"
+#include "SignalStore.hpp"
+#include "TripleBuffer.hpp"
+
 /**
  * @brief Main data model for the automotive cluster display
  *
@@ -21,10 +27,34 @@
  * - Real-time clock and date display
  * - Signal-based property change notifications
  *
+ * The model is registered as the typed QML singleton `ClusterModel` of the
+ * `ClusterDisplay` module, which lets qmlcachegen compile bindings against it.
+ * The application owns the instance and hands it to QML with setQmlInstance().
+ *
+ * After every change the complete state is also published as a plain State
+ * snapshot that the render thread can read wait-free with latestState(), so
+ * native scene graph items do not need GUI-thread property reads while the
+ * GUI thread is blocked in the synchronization phase.
+ *
+ * The vehicle telemetry, driver assistance and traffic sign properties are
+ * thin views on a SignalStore, which also holds any number of further vehicle
+ * signals without a property of their own. QML reads all of them by name
+ * through vehicleSignals.
+ *
+ * Values restored from a persisted StateSnapshot at startup are flagged in
+ * provisionalFields until live data confirms them, even with an unchanged
+ * value, so QML can present them as not yet current.
+ *
+ * The time and date shown come from a Clock, the system clock unless another
+ * one is passed to the constructor. The ClusterDataSubscriber of the model
+ * uses the same clock, so a VirtualClock runs a whole scenario in virtual time.
+ *
  * @since 1.0.0
  */
 class ClusterModel : public QObject {
   Q_OBJECT
+  QML_ELEMENT
+  QML_SINGLETON
 
   // Vehicle telemetry properties
   Q_PROPERTY(int speed READ speed WRITE setSpeed NOTIFY speedChanged)
@@ -32,6 +62,8 @@ class ClusterModel : public QObject {
   Q_PROPERTY(bool charging READ charging WRITE setCharging NOTIFY chargingChanged)
   Q_PROPERTY(int odometer READ odometer WRITE setOdometer NOTIFY odometerChanged)
   Q_PROPERTY(QString drivingMode READ drivingMode WRITE setDrivingMode NOTIFY drivingModeChanged)
+  Q_PROPERTY(DrivingMode drivingModeType READ drivingModeType WRITE setDrivingModeType NOTIFY
+                 drivingModeTypeChanged)
 
   // Time and date properties
   Q_PROPERTY(QString currentTime READ currentTime NOTIFY currentTimeChanged)
@@ -44,6 +76,7 @@ class ClusterModel : public QObject {
   Q_PROPERTY(bool laneAlert READ laneAlert WRITE setLaneAlert NOTIFY laneAlertChanged)
   Q_PROPERTY(QString laneDeviationSide READ laneDeviationSide WRITE setLaneDeviationSide NOTIFY
                  laneDeviationSideChanged)
+  Q_PROPERTY(LaneSide laneSide READ laneSide WRITE setLaneSide NOTIFY laneSideChanged)
 
   // Speed limit and traffic sign recognition
   Q_PROPERTY(int speedLimitSignal READ speedLimitSignal WRITE setSpeedLimitSignal NOTIFY
@@ -51,47 +84,220 @@ class ClusterModel : public QObject {
   Q_PROPERTY(bool speedLimitVisible READ speedLimitVisible WRITE setSpeedLimitVisible NOTIFY
                  speedLimitVisibleChanged)
   Q_PROPERTY(QString signType READ signType WRITE setSignType NOTIFY signTypeChanged)
+  Q_PROPERTY(SignKind signKind READ signKind WRITE setSignKind NOTIFY signKindChanged)
   Q_PROPERTY(QString signValue READ signValue WRITE setSignValue NOTIFY signValueChanged)
   Q_PROPERTY(bool signVisible READ signVisible WRITE setSignVisible NOTIFY signVisibleChanged)
   Q_PROPERTY(
       int lastSpeedLimit READ lastSpeedLimit WRITE setLastSpeedLimit NOTIFY lastSpeedLimitChanged)
 
+  // Derived presentation state, computed in C++ so QML can bind to plain values
+  Q_PROPERTY(LaneSide highlightedLane READ highlightedLane NOTIFY highlightedLaneChanged)
+  Q_PROPERTY(SignKind visibleSign READ visibleSign NOTIFY visibleSignChanged)
+  Q_PROPERTY(bool speedLimitExceeded READ speedLimitExceeded NOTIFY speedLimitExceededChanged)
+  Q_PROPERTY(AlertSeverity alertSeverity READ alertSeverity NOTIFY alertSeverityChanged)
+
+  // Health of the connection to the vehicle publisher
+  Q_PROPERTY(LinkStatus linkStatus READ linkStatus WRITE setLinkStatus NOTIFY linkStatusChanged)
+
+  // Trip computer, reset per ignition cycle or with resetTrip()
+  Q_PROPERTY(int tripDistance READ tripDistance WRITE setTripDistance NOTIFY tripDistanceChanged)
+  Q_PROPERTY(
+      int tripMovingTime READ tripMovingTime WRITE setTripMovingTime NOTIFY tripMovingTimeChanged)
+  Q_PROPERTY(int tripAverageSpeed READ tripAverageSpeed WRITE setTripAverageSpeed NOTIFY
+                 tripAverageSpeedChanged)
+  Q_PROPERTY(int tripMaxSpeed READ tripMaxSpeed WRITE setTripMaxSpeed NOTIFY tripMaxSpeedChanged)
+  Q_PROPERTY(
+      int recentMaxSpeed READ recentMaxSpeed WRITE setRecentMaxSpeed NOTIFY recentMaxSpeedChanged)
+  Q_PROPERTY(
+      int tripEnergyUsed READ tripEnergyUsed WRITE setTripEnergyUsed NOTIFY tripEnergyUsedChanged)
+
+  // Remaining range estimated from the battery consumption (meters, -1 = unknown)
+  Q_PROPERTY(
+      int estimatedRange READ estimatedRange WRITE setEstimatedRange NOTIFY estimatedRangeChanged)
+
+  // Values restored at startup that live data has not confirmed yet
+  Q_PROPERTY(ProvisionalFields provisionalFields READ provisionalFields WRITE setProvisionalFields
+                 NOTIFY provisionalFieldsChanged)
+
+  // Every vehicle signal by name, including the ones without a property of their own
+  Q_PROPERTY(QQmlPropertyMap* vehicleSignals READ vehicleSignals CONSTANT)
+
  public:
+  /** @brief Driving mode of the vehicle */
+  enum DrivingMode { ManualMode, AutoMode };
+  Q_ENUM(DrivingMode)
+
+  /** @brief Lane side, used both for the deviation side and the highlighted lane */
+  enum LaneSide { NoLane, LeftLane, RightLane };
+  Q_ENUM(LaneSide)
+
+  /** @brief Kind of traffic sign, which also selects the sign panel shown in QML */
+  enum SignKind { NoSign, SpeedLimitSign, StopSign, CrosswalkSign, YieldSign };
+  Q_ENUM(SignKind)
+
+  /** @brief Severity of the most important active driver assistance alert */
+  enum AlertSeverity {
+    NoAlert,       ///< No alert active
+    AdvisoryAlert, ///< Lane departure or speed limit exceeded
+    WarningAlert,  ///< Object detected ahead
+    CriticalAlert  ///< Emergency brake active
+  };
+  Q_ENUM(AlertSeverity)
+
+  /** @brief Health of the data link, as seen by the subscriber */
+  enum LinkStatus {
+    LinkDown,  ///< Not connected to the publisher; the values shown are the last known ones
+    LinkStale, ///< Connected, but no frame arrived recently
+    LinkUp     ///< Frames are arriving
+  };
+  Q_ENUM(LinkStatus)
+
+  /** @brief Properties that can be restored from a persisted snapshot */
+  enum ProvisionalField {
+    NoProvisionalField = 0x00,    ///< Every value is live
+    BatteryField = 0x01,          ///< battery
+    ChargingField = 0x02,         ///< charging
+    OdometerField = 0x04,         ///< odometer
+    DrivingModeField = 0x08,      ///< drivingMode and drivingModeType
+    SpeedLimitSignalField = 0x10, ///< speedLimitSignal
+    LastSpeedLimitField = 0x20    ///< lastSpeedLimit
+  };
+  Q_DECLARE_FLAGS(ProvisionalFields, ProvisionalField)
+  Q_FLAG(ProvisionalFields)
+
+  /**
+   * @brief Plain copy of the complete model state, readable from the render thread
+   *
+   * Text values are stored as fixed-size UTF-8 buffers so the snapshot can be
+   * copied between threads without allocations. Time and date are not part of
+   * it; they change once per second and are cheap to read from the clock.
+   */
+  struct State {
+    quint64 revision;            ///< Incremented with every published change
+    int speed;                   ///< Vehicle speed in km/h (scaled by 10)
+    int battery;                 ///< Battery level percentage (0-100)
+    bool charging;               ///< Charging state
+    int odometer;                ///< Total distance traveled
+    DrivingMode drivingMode;     ///< Current driving mode
+    bool objectAlert;            ///< Object detection alert status
+    bool emergencyBrakeActive;   ///< Emergency brake activation status
+    bool laneAlert;              ///< Lane departure alert status
+    LaneSide laneSide;           ///< Side of lane deviation
+    int speedLimitSignal;        ///< Detected speed limit value
+    bool speedLimitVisible;      ///< Speed limit display visibility
+    SignKind signKind;           ///< Kind of detected traffic sign
+    char signValue[16];          ///< Sign value as null-terminated UTF-8, cut between characters
+    bool signVisible;            ///< Traffic sign display visibility
+    int lastSpeedLimit;          ///< Last valid speed limit
+    LaneSide highlightedLane;    ///< Lane highlighted by the lane alert
+    SignKind visibleSign;        ///< Sign panel currently shown
+    bool speedLimitExceeded;     ///< Speed above the last known limit
+    AlertSeverity alertSeverity; ///< Most important active alert
+  };
+
   /**
    * @brief Constructs a new ClusterModel instance
    * @param parent Parent QObject for memory management
    */
   explicit ClusterModel(QObject* parent = nullptr);
 
+  /**
+   * @brief Constructs a new ClusterModel instance running on a clock
+   * @param clock Source of the time and the timers (must outlive the model), or nullptr for
+   *              the system clock
+   * @param parent Parent QObject for memory management
+   */
+  explicit ClusterModel(Clock* clock, QObject* parent = nullptr);
+
   /**
    * @brief Destructor - stops internal timers and cleans up resources
    */
   virtual ~ClusterModel();
 
+  /**
+   * @brief Registers the instance returned to QML by create()
+   * Must be called before the QML engine loads any file importing ClusterDisplay.
+   * @param instance Application-owned model, or nullptr to unregister
+   */
+  static void setQmlInstance(ClusterModel* instance);
+
+  /**
+   * @brief Singleton factory used by the QML engine
+   * @return The instance registered with setQmlInstance(); ownership stays with C++
+   */
+  static ClusterModel* create(QQmlEngine* qmlEngine, QJSEngine* jsEngine);
+
+  /**
+   * @brief Gets the most recently published state snapshot
+   *
+   * Wait-free and safe to call from one thread other than the GUI thread,
+   * typically the render thread in QQuickItem::updatePaintNode(). Only a
+   * single thread may read snapshots.
+   */
+  State latestState() const;
+
+  /**
+   * @brief Gets the store holding the vehicle signal values
+   *
+   * The telemetry, driver assistance and traffic sign properties are views on
+   * its first entries, registered under their property names. Set those
+   * through the property setters; other signals are added with
+   * registerVehicleSignal() and updated with SignalStore::set().
+   */
+  SignalStore& signalStore() {
+    return m_store;
+  }
+
+  /**
+   * @brief Gets the clock the model and its subscriber run on
+   */
+  Clock* clock() const {
+    return m_clock;
+  }
+
+  /**
+   * @brief Registers a vehicle signal that has no property of its own
+   * @param name Signal name, also its key in vehicleSignals
+   * @return Id of the signal, or SignalStore::kInvalidSignal if the name belongs to a property
+   *         or the store is full
+   */
+  SignalStore::SignalId registerVehicleSignal(const QString& name);
+
+  /**
+   * @brief Gets every vehicle signal by name for QML, e.g. `vehicleSignals.motorTemperature`
+   * Updated once per event loop pass with the values that changed.
+   */
+  QQmlPropertyMap* vehicleSignals() const {
+    return m_vehicleSignals;
+  }
+
   // Getters
   /** @brief Gets current vehicle speed in km/h */
   int speed() const {
-    return m_speed;
+    return static_cast<int>(m_store.value(SpeedValue));
   }
 
   /** @brief Gets current battery level as percentage (0-100) */
   int battery() const {
-    return m_battery;
+    return static_cast<int>(m_store.value(BatteryValue));
   }
 
   /** @brief Gets charging state of the vehicle */
   bool charging() const {
-    return m_charging;
+    return m_store.value(ChargingValue) != 0.0;
   }
 
   /** @brief Gets total odometer reading in kilometers */
   int odometer() const {
-    return m_odometer;
+    return static_cast<int>(m_store.value(OdometerValue));
   }
 
-  /** @brief Gets current driving mode (e.g., "MAN", "AUTO", "ECO") */
-  QString drivingMode() const {
-    return m_drivingMode;
+  /** @brief Gets current driving mode as display text ("MAN" or "AUTO") */
+  QString drivingMode() const;
+
+  /** @brief Gets current driving mode */
+  DrivingMode drivingModeType() const {
+    return static_cast<DrivingMode>(m_store.value(DrivingModeValue));
   }
 
   /** @brief Gets current time formatted as "hh:mm" */
@@ -106,37 +312,43 @@ class ClusterModel : public QObject {
 
   /** @brief Gets object detection alert status */
   bool objectAlert() const {
-    return m_objectAlert;
+    return m_store.value(ObjectAlertValue) != 0.0;
   }
 
   /** @brief Gets emergency brake activation status */
   bool emergencyBrakeActive() const {
-    return m_emergencyBrakeActive;
+    return m_store.value(EmergencyBrakeValue) != 0.0;
   }
 
   /** @brief Gets lane departure alert status */
   bool laneAlert() const {
-    return m_laneAlert;
+    return m_store.value(LaneAlertValue) != 0.0;
   }
 
   /** @brief Gets lane deviation side ("left" or "right") */
-  QString laneDeviationSide() const {
-    return m_laneDeviationSide;
+  QString laneDeviationSide() const;
+
+  /** @brief Gets lane deviation side */
+  LaneSide laneSide() const {
+    return static_cast<LaneSide>(m_store.value(LaneSideValue));
   }
 
   /** @brief Gets detected speed limit value */
   int speedLimitSignal() const {
-    return m_speedLimitSignal;
+    return static_cast<int>(m_store.value(SpeedLimitValue));
   }
 
   /** @brief Gets speed limit display visibility status */
   bool speedLimitVisible() const {
-    return m_speedLimitVisible;
+    return m_store.value(SpeedLimitVisibleValue) != 0.0;
   }
 
-  /** @brief Gets detected traffic sign type */
-  QString signType() const {
-    return m_signType;
+  /** @brief Gets detected traffic sign type ("SPEED_LIMIT", "STOP", ... or empty) */
+  QString signType() const;
+
+  /** @brief Gets detected traffic sign kind */
+  SignKind signKind() const {
+    return static_cast<SignKind>(m_store.value(SignKindValue));
   }
 
   /** @brief Gets detected traffic sign value/text */
@@ -146,12 +358,77 @@ class ClusterModel : public QObject {
 
   /** @brief Gets traffic sign display visibility status */
   bool signVisible() const {
-    return m_signVisible;
+    return m_store.value(SignVisibleValue) != 0.0;
   }
 
   /** @brief Gets last valid speed limit for reference */
   int lastSpeedLimit() const {
-    return m_lastSpeedLimit;
+    return static_cast<int>(m_store.value(LastSpeedLimitValue));
+  }
+
+  /** @brief Gets the lane to highlight (deviation side while a lane alert is active) */
+  LaneSide highlightedLane() const {
+    return m_highlightedLane;
+  }
+
+  /** @brief Gets the sign panel to show, or NoSign when no sign is displayed */
+  SignKind visibleSign() const {
+    return m_visibleSign;
+  }
+
+  /** @brief Gets whether the current speed exceeds the last known speed limit */
+  bool speedLimitExceeded() const {
+    return m_speedLimitExceeded;
+  }
+
+  /** @brief Gets severity of the most important active alert */
+  AlertSeverity alertSeverity() const {
+    return m_alertSeverity;
+  }
+
+  /** @brief Gets the health of the data link */
+  LinkStatus linkStatus() const {
+    return m_linkStatus;
+  }
+
+  /** @brief Gets the distance of the trip in meters */
+  int tripDistance() const {
+    return m_tripDistance;
+  }
+
+  /** @brief Gets the time spent moving during the trip in seconds */
+  int tripMovingTime() const {
+    return m_tripMovingTime;
+  }
+
+  /** @brief Gets the average speed while moving in km/h (scaled by 10, like speed) */
+  int tripAverageSpeed() const {
+    return m_tripAverageSpeed;
+  }
+
+  /** @brief Gets the maximum speed of the trip in km/h (scaled by 10) */
+  int tripMaxSpeed() const {
+    return m_tripMaxSpeed;
+  }
+
+  /** @brief Gets the maximum speed of the last minute in km/h (scaled by 10) */
+  int recentMaxSpeed() const {
+    return m_recentMaxSpeed;
+  }
+
+  /** @brief Gets the battery used during the trip in percentage points */
+  int tripEnergyUsed() const {
+    return m_tripEnergyUsed;
+  }
+
+  /** @brief Gets the estimated remaining range in meters (-1 = unknown) */
+  int estimatedRange() const {
+    return m_estimatedRange;
+  }
+
+  /** @brief Gets the restored values that live data has not confirmed yet */
+  ProvisionalFields provisionalFields() const {
+    return m_provisionalFields;
   }
 
   // Setters
@@ -180,11 +457,24 @@ class ClusterModel : public QObject {
   void setOdometer(int value);
 
   /**
-   * @brief Sets driving mode and emits change signal if different
-   * @param value Driving mode string (e.g., "MAN", "AUTO", "ECO")
+   * @brief Sets odometer reading without confirming a restored value
+   * For figures carried on from persisted or held data rather than a live sample.
+   * @param value Total distance in kilometers
+   */
+  void setUnconfirmedOdometer(int value);
+
+  /**
+   * @brief Sets driving mode from its display text
+   * @param value "AUTO" for autonomous mode, anything else selects manual mode
    */
   void setDrivingMode(const QString& value);
 
+  /**
+   * @brief Sets driving mode and emits change signals if different
+   * @param value The new driving mode
+   */
+  void setDrivingModeType(DrivingMode value);
+
   /**
    * @brief Sets object detection alert and emits change signal if different
    * @param value True if object detected ahead, false otherwise
@@ -204,11 +494,17 @@ class ClusterModel : public QObject {
   void setLaneAlert(bool value);
 
   /**
-   * @brief Sets lane deviation side and emits change signal if different
-   * @param value Side of deviation ("left" or "right")
+   * @brief Sets lane deviation side from its text form
+   * @param value "right" for the right side, anything else selects the left side
    */
   void setLaneDeviationSide(const QString& value);
 
+  /**
+   * @brief Sets lane deviation side and emits change signals if different
+   * @param value LeftLane or RightLane
+   */
+  void setLaneSide(LaneSide value);
+
   /**
    * @brief Sets detected speed limit and emits change signal if different
    * @param value Speed limit in km/h
@@ -222,11 +518,17 @@ class ClusterModel : public QObject {
   void setSpeedLimitVisible(bool value);
 
   /**
-   * @brief Sets traffic sign type and emits change signal if different
-   * @param value Type of detected sign (e.g., "speed_limit", "stop", "yield")
+   * @brief Sets traffic sign type from its text form
+   * @param value "SPEED_LIMIT", "STOP", "CROSSWALK" or "YIELD"; anything else clears the sign
    */
   void setSignType(const QString& value);
 
+  /**
+   * @brief Sets traffic sign kind and emits change signals if different
+   * @param value Kind of detected sign
+   */
+  void setSignKind(SignKind value);
+
   /**
    * @brief Sets traffic sign value and emits change signal if different
    * @param value Value/text content of the detected sign
@@ -245,6 +547,45 @@ class ClusterModel : public QObject {
    */
   void setLastSpeedLimit(int value);
 
+  /**
+   * @brief Sets the health of the data link and emits change signal if different
+   * @param value The new link status
+   */
+  void setLinkStatus(LinkStatus value);
+
+  /** @brief Sets the trip distance in meters */
+  void setTripDistance(int value);
+
+  /** @brief Sets the trip moving time in seconds */
+  void setTripMovingTime(int value);
+
+  /** @brief Sets the trip average speed in km/h (scaled by 10) */
+  void setTripAverageSpeed(int value);
+
+  /** @brief Sets the trip maximum speed in km/h (scaled by 10) */
+  void setTripMaxSpeed(int value);
+
+  /** @brief Sets the maximum speed of the last minute in km/h (scaled by 10) */
+  void setRecentMaxSpeed(int value);
+
+  /** @brief Sets the battery used during the trip in percentage points */
+  void setTripEnergyUsed(int value);
+
+  /** @brief Sets the estimated remaining range in meters (-1 = unknown) */
+  void setEstimatedRange(int value);
+
+  /**
+   * @brief Asks the trip computer to start a new trip (emits tripResetRequested())
+   */
+  Q_INVOKABLE void resetTrip();
+
+  /**
+   * @brief Marks values as restored rather than live
+   * Each flag is cleared again by the next call to the corresponding setter.
+   * @param value Fields whose current value is provisional
+   */
+  void setProvisionalFields(ProvisionalFields value);
+
  signals:
   /** @brief Emitted when speed changes */
   void speedChanged(int value);
@@ -261,6 +602,9 @@ class ClusterModel : public QObject {
   /** @brief Emitted when driving mode changes */
   void drivingModeChanged(const QString& value);
 
+  /** @brief Emitted when driving mode changes */
+  void drivingModeTypeChanged(ClusterModel::DrivingMode value);
+
   /** @brief Emitted when current time changes */
   void currentTimeChanged(const QString& value);
 
@@ -279,6 +623,9 @@ class ClusterModel : public QObject {
   /** @brief Emitted when lane deviation side changes */
   void laneDeviationSideChanged(const QString& value);
 
+  /** @brief Emitted when lane deviation side changes */
+  void laneSideChanged(ClusterModel::LaneSide value);
+
   /** @brief Emitted when speed limit signal changes */
   void speedLimitSignalChanged(int value);
 
@@ -288,6 +635,9 @@ class ClusterModel : public QObject {
   /** @brief Emitted when sign type changes */
   void signTypeChanged(const QString& value);
 
+  /** @brief Emitted when sign kind changes */
+  void signKindChanged(ClusterModel::SignKind value);
+
   /** @brief Emitted when sign value changes */
   void signValueChanged(const QString& value);
 
@@ -297,6 +647,48 @@ class ClusterModel : public QObject {
   /** @brief Emitted when last speed limit changes */
   void lastSpeedLimitChanged(int value);
 
+  /** @brief Emitted when the highlighted lane changes */
+  void highlightedLaneChanged(ClusterModel::LaneSide value);
+
+  /** @brief Emitted when the visible sign panel changes */
+  void visibleSignChanged(ClusterModel::SignKind value);
+
+  /** @brief Emitted when the speed limit exceeded state changes */
+  void speedLimitExceededChanged(bool value);
+
+  /** @brief Emitted when the alert severity changes */
+  void alertSeverityChanged(ClusterModel::AlertSeverity value);
+
+  /** @brief Emitted when the link status changes */
+  void linkStatusChanged(ClusterModel::LinkStatus value);
+
+  /** @brief Emitted when the trip distance changes */
+  void tripDistanceChanged(int value);
+
+  /** @brief Emitted when the trip moving time changes */
+  void tripMovingTimeChanged(int value);
+
+  /** @brief Emitted when the trip average speed changes */
+  void tripAverageSpeedChanged(int value);
+
+  /** @brief Emitted when the trip maximum speed changes */
+  void tripMaxSpeedChanged(int value);
+
+  /** @brief Emitted when the maximum speed of the last minute changes */
+  void recentMaxSpeedChanged(int value);
+
+  /** @brief Emitted when the trip energy use changes */
+  void tripEnergyUsedChanged(int value);
+
+  /** @brief Emitted when the estimated range changes */
+  void estimatedRangeChanged(int value);
+
+  /** @brief Emitted by resetTrip() */
+  void tripResetRequested();
+
+  /** @brief Emitted when a value becomes or stops being provisional */
+  void provisionalFieldsChanged(ClusterModel::ProvisionalFields value);
+
  private slots:
   /**
    * @brief Updates current time and date from system clock
@@ -305,33 +697,84 @@ class ClusterModel : public QObject {
   void updateDateTime();
 
  private:
-  // Vehicle telemetry data
-  int m_speed;           ///< Current vehicle speed in km/h
-  int m_battery;         ///< Battery level percentage (0-100)
-  bool m_charging;       ///< Charging state of the vehicle
-  int m_odometer;        ///< Total distance traveled in km
-  QString m_drivingMode; ///< Current driving mode
+  /**
+   * @brief Recomputes derived presentation state and emits signals for what changed
+   * Called by every setter whose property feeds into the derived state.
+   */
+  void updateDerivedState();
+
+  /**
+   * @brief Publishes the current state to latestState() readers
+   * Called by every setter after the model changed.
+   */
+  void publishState();
+
+  /**
+   * @brief Clears the provisional flag of a field that has received live data
+   */
+  void confirmField(ProvisionalField field);
+
+  /**
+   * @brief Values of the properties that are views on the signal store, registered in this order
+   */
+  enum PropertyValue : SignalStore::SignalId {
+    SpeedValue,             ///< speed
+    BatteryValue,           ///< battery
+    ChargingValue,          ///< charging
+    OdometerValue,          ///< odometer
+    DrivingModeValue,       ///< drivingModeType
+    ObjectAlertValue,       ///< objectAlert
+    EmergencyBrakeValue,    ///< emergencyBrakeActive
+    LaneAlertValue,         ///< laneAlert
+    LaneSideValue,          ///< laneSide
+    SpeedLimitValue,        ///< speedLimitSignal
+    SpeedLimitVisibleValue, ///< speedLimitVisible
+    SignKindValue,          ///< signKind
+    SignVisibleValue,       ///< signVisible
+    LastSpeedLimitValue,    ///< lastSpeedLimit
+    PropertyValueCount
+  };
+
+  // Vehicle telemetry, driver assistance and traffic sign values (see PropertyValue)
+  SignalStore m_store;                 ///< Values of the vehicle signals
+  SignalPropertyMap* m_vehicleSignals; ///< QML view of m_store
 
   // Time and date
   QString m_currentTime; ///< Current time formatted as "hh:mm"
   QString m_currentDate; ///< Current date formatted as "dd MMM yyyy"
 
-  // Driver assistance alerts
-  bool m_objectAlert;          ///< Object detection alert status
-  bool m_emergencyBrakeActive; ///< Emergency brake activation status
-  bool m_laneAlert;            ///< Lane departure alert status
-  QString m_laneDeviationSide; ///< Side of lane deviation
-
-  // Traffic sign recognition
-  int m_speedLimitSignal;   ///< Detected speed limit value
-  bool m_speedLimitVisible; ///< Speed limit display visibility
-  QString m_signType;       ///< Type of detected traffic sign
-  QString m_signValue;      ///< Value/content of detected sign
-  bool m_signVisible;       ///< Traffic sign display visibility
-  int m_lastSpeedLimit;     ///< Last valid speed limit for reference
-
-  QTimer* m_timeUpdateTimer; ///< Timer for updating time/date display
+  // Traffic sign text, which the store of numbers cannot hold
+  QString m_signValue; ///< Value/content of detected sign
+
+  // Derived presentation state
+  LaneSide m_highlightedLane;    ///< Lane highlighted by the lane alert
+  SignKind m_visibleSign;        ///< Sign panel currently shown
+  bool m_speedLimitExceeded;     ///< Speed above the last known limit
+  AlertSeverity m_alertSeverity; ///< Most important active alert
+
+  // Trip computer results
+  int m_tripDistance;     ///< Trip distance in meters
+  int m_tripMovingTime;   ///< Time spent moving in seconds
+  int m_tripAverageSpeed; ///< Average speed while moving (scaled by 10)
+  int m_tripMaxSpeed;     ///< Maximum speed of the trip (scaled by 10)
+  int m_recentMaxSpeed;   ///< Maximum speed of the last minute (scaled by 10)
+  int m_tripEnergyUsed;   ///< Battery used in percentage points
+  int m_estimatedRange;   ///< Remaining range in meters (-1 = unknown)
+
+  LinkStatus m_linkStatus;               ///< Health of the data link
+  ProvisionalFields m_provisionalFields; ///< Restored values not confirmed by live data
+
+  Clock* m_clock;                ///< Source of the time and the timers
+  ClockTimer* m_timeUpdateTimer; ///< Timer for updating time/date display
+
+  QByteArray m_signValueUtf8;                ///< UTF-8 form of m_signValue for snapshots
+  quint64 m_stateRevision;                   ///< Revision of the last published snapshot
+  mutable TripleBuffer<State> m_stateBuffer; ///< Snapshots handed to the render thread
+
+  static ClusterModel* s_qmlInstance; ///< Instance handed out to QML
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(ClusterModel::ProvisionalFields)
+
 #endif // CLUSTERMODEL_HPP
 // LCOV_EXCL_STOP
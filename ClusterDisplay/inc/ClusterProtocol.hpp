@@ -0,0 +1,74 @@
+#ifndef CLUSTERPROTOCOL_HPP
+#define CLUSTERPROTOCOL_HPP
+
+#include <cstring>
+#include <initializer_list>
+
+/**
+ * @brief Wire protocol shared by the display and the vehicle-side publishers
+ *
+ * Frames are plain text, "key1:value1;key2:value2;...", published on two PUB
+ * sockets: the critical port carries what the driver must see without delay
+ * (speed, lane, obstacles, signs, driving mode), the non-critical port the
+ * slowly changing values (battery, charging, odometer). Each frame starts
+ * with the sequence number of its channel. The full state is served on the
+ * snapshot port in reply to kSnapshotRequest.
+ *
+ * In the other direction the display pushes the maximum useful rate per key
+ * to the rate port, as a frame of "key:hz" pairs (0 = not shown). An empty
+ * frame, or no frame for kRateLimitLifetimeMs, lifts all limits.
+ *
+ * This header has no Qt dependency so that publishers can include it as is.
+ */
+namespace ClusterProtocol {
+
+/** @brief Data channel of a key */
+enum class Channel { Critical, NonCritical };
+
+constexpr int kCriticalPort = 5555;    ///< PUB port of the critical channel
+constexpr int kNonCriticalPort = 5556; ///< PUB port of the non-critical channel
+constexpr int kSnapshotPort = 5557;    ///< ROUTER port answering snapshot requests
+constexpr int kRatePort = 5558;        ///< PULL port receiving the display's rate limits
+
+constexpr int kRateLimitLifetimeMs = 3000; ///< Rate limits expire unless advertised again
+
+constexpr char kPairSeparator = ';';     ///< Separates the key-value pairs of a frame
+constexpr char kKeyValueSeparator = ':'; ///< Separates a key from its value
+
+constexpr const char* kSnapshotRequest = "SNAPSHOT"; ///< Request payload on the snapshot port
+
+// Message keys
+constexpr const char* kSpeed = "speed";              ///< Speed in mm/s
+constexpr const char* kLane = "lane";                ///< Lane departure: 0 none, 1 left, 2 right
+constexpr const char* kObstacle = "obs";             ///< 0 clear, 1 obstacle, 2 emergency brake
+constexpr const char* kSign = "sign";                ///< Speed limit, "stop", "crosswalk", "yield"
+constexpr const char* kDrivingMode = "mode";         ///< 0 manual, 1 autonomous
+constexpr const char* kBattery = "battery";          ///< Battery level in percent
+constexpr const char* kCharging = "charging";        ///< 1 while charging
+constexpr const char* kOdometer = "odo";             ///< Distance driven
+constexpr const char* kCriticalSequence = "cseq";    ///< Sequence number of critical frames
+constexpr const char* kNonCriticalSequence = "nseq"; ///< Sequence number of non-critical frames
+
+/**
+ * @brief Gets the channel a key is published on
+ * @param key Message key
+ */
+inline Channel channelOf(const char* key) {
+  for (const char* nonCritical : {kBattery, kCharging, kOdometer, kNonCriticalSequence}) {
+    if (std::strcmp(key, nonCritical) == 0) {
+      return Channel::NonCritical;
+    }
+  }
+  return Channel::Critical;
+}
+
+/**
+ * @brief Gets the sequence number key of a channel
+ */
+constexpr const char* sequenceKey(Channel channel) {
+  return channel == Channel::Critical ? kCriticalSequence : kNonCriticalSequence;
+}
+
+} // namespace ClusterProtocol
+
+#endif // CLUSTERPROTOCOL_HPP
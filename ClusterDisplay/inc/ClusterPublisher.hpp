@@ -0,0 +1,232 @@
+#ifndef CLUSTERPUBLISHER_HPP
+#define CLUSTERPUBLISHER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <zmq.hpp>
+
+#include "ClusterFrameEncoder.hpp"
+#include "ClusterProtocol.hpp"
+
+/**
+ * @brief Endpoints a ClusterPublisher binds to
+ *
+ * The defaults are the ports the display subscribes to, on all interfaces.
+ */
+struct ClusterPublisherEndpoints {
+  std::string critical = "tcp://*:5555";    ///< PUB socket of the critical channel
+  std::string nonCritical = "tcp://*:5556"; ///< PUB socket of the non-critical channel
+  std::string snapshot = "tcp://*:5557";    ///< ROUTER socket of the snapshot server (empty = none)
+  std::string rates = "tcp://*:5558";       ///< PULL socket of the rate backchannel (empty = none)
+};
+
+/**
+ * @brief Counters of a ClusterPublisher
+ */
+struct ClusterPublisherStatistics {
+  uint64_t updates = 0;            ///< Setter calls that changed a value
+  uint64_t suppressedUpdates = 0;  ///< Setter calls that repeated the current value
+  uint64_t framesSent = 0;         ///< Frames published on both channels
+  uint64_t bytesSent = 0;          ///< Payload bytes of the published frames
+  uint64_t snapshotsServed = 0;    ///< Snapshot requests answered
+  uint64_t rateAdvertisements = 0; ///< Rate limits received from the display
+  uint64_t coalescedUpdates = 0;   ///< Changed values replaced before they were sent
+};
+
+/**
+ * @brief Vehicle-side publisher of the cluster data
+ *
+ * Producers set typed values instead of formatting frames by hand. Setting a
+ * value that equals the last one is suppressed; changes are collected and
+ * flush() sends at most one frame per channel, carrying every changed key and
+ * the channel's sequence number. Frames are encoded into a reusable buffer,
+ * so publishing does not allocate.
+ *
+ * Two kinds of values are not held back: obstacle alerts flush the critical
+ * channel right away, and signs are sent on every detection, since the
+ * display keeps a sign on screen only while it is being reported.
+ *
+ * The display advertises the maximum useful rate per key on a backchannel
+ * (see ZmqRateAdvertiser). A changed value whose key was sent more recently
+ * than its rate allows stays pending, and only its latest value is sent once
+ * the interval has passed; a key advertised at 0 Hz is not sent at all.
+ * Obstacle alerts are never throttled.
+ *
+ * The publisher also answers the display's snapshot requests with the full
+ * state (see ClusterDataSubscriber::synchronize()). It is meant to be driven
+ * from a single thread that calls tick() once per control loop iteration.
+ */
+class ClusterPublisher {
+ public:
+  /** @brief Lane departure reported by the lane detection */
+  enum class Lane { None = 0, Left = 1, Right = 2 };
+
+  /** @brief Result of the obstacle detection */
+  enum class Obstacle { Clear = 0, Detected = 1, EmergencyBrake = 2 };
+
+  /**
+   * @brief Binds the publisher sockets
+   * @param endpoints Endpoints of the data channels and the snapshot server
+   * @throws zmq::error_t if an endpoint cannot be bound
+   */
+  explicit ClusterPublisher(const ClusterPublisherEndpoints& endpoints = {});
+  ~ClusterPublisher();
+
+  ClusterPublisher(const ClusterPublisher&) = delete;
+  ClusterPublisher& operator=(const ClusterPublisher&) = delete;
+
+  /** @brief Sets the speed in mm/s */
+  void setSpeed(int mmPerSecond);
+
+  /** @brief Sets the lane departure state */
+  void setLane(Lane lane);
+
+  /** @brief Sets the obstacle state and publishes it immediately */
+  void setObstacle(Obstacle obstacle);
+
+  /** @brief Reports a detected speed limit sign */
+  void setSpeedLimitSign(int kmPerHour);
+
+  /**
+   * @brief Reports a detected traffic sign
+   * @param sign "stop", "crosswalk" or "yield"
+   * @return False if the name is not a valid value
+   */
+  bool setSign(const char* sign);
+
+  /** @brief Sets the driving mode */
+  void setAutonomous(bool autonomous);
+
+  /** @brief Sets the battery level in percent */
+  void setBattery(int percent);
+
+  /** @brief Sets whether the battery is charging */
+  void setCharging(bool charging);
+
+  /** @brief Sets the distance driven */
+  void setOdometer(int64_t odometer);
+
+  /**
+   * @brief Publishes the pending changes, at most one frame per channel
+   * @return Number of frames sent
+   */
+  int flush();
+
+  /**
+   * @brief Answers the pending snapshot requests without blocking
+   * Pending changes are flushed first, so that the snapshot covers them.
+   * @return Number of requests answered
+   */
+  int serveSnapshots();
+
+  /**
+   * @brief Applies the rate limits received from the display without blocking
+   * @return Number of advertisements received
+   */
+  int receiveRateLimits();
+
+  /**
+   * @brief Gets the minimum interval between two frames carrying a key
+   * @return Zero if the key is not limited, a negative value if it is not sent at all
+   */
+  std::chrono::nanoseconds minimumInterval(const char* key) const;
+
+  /**
+   * @brief Sets how long rate limits stay in effect without a new advertisement
+   */
+  void setRateLimitLifetime(std::chrono::milliseconds lifetime);
+
+  /**
+   * @brief Applies rate limits, flushes the pending changes and answers snapshot requests
+   */
+  void tick();
+
+  /** @brief Gets the bound endpoint of a data channel (resolves wildcard ports) */
+  std::string endpoint(ClusterProtocol::Channel channel) const;
+
+  /** @brief Gets the bound endpoint of the snapshot server, or an empty string */
+  std::string snapshotEndpoint() const;
+
+  /** @brief Gets the bound endpoint of the rate backchannel, or an empty string */
+  std::string rateEndpoint() const;
+
+  /** @brief Gets the counters */
+  const ClusterPublisherStatistics& statistics() const;
+
+ private:
+  /** @brief Published values, in the order they appear in a frame */
+  enum Field {
+    SpeedField,
+    LaneField,
+    ObstacleField,
+    SignField,
+    DrivingModeField,
+    BatteryField,
+    ChargingField,
+    OdometerField,
+    FieldCount
+  };
+
+  using Clock = std::chrono::steady_clock;
+
+  /** @brief Latest encoded value of a field */
+  struct Value {
+    char text[24] = {};                   ///< Encoded value
+    uint8_t length = 0;                   ///< Bytes used in text (0 = never set)
+    bool pending = false;                 ///< Changed since the last flush
+    Clock::time_point lastSent;           ///< When the field was last published
+    std::chrono::nanoseconds interval{0}; ///< Minimum interval (0 = none, negative = never)
+  };
+
+  /**
+   * @brief Stores a new integer value, suppressing repeats where allowed
+   */
+  void update(Field field, int64_t value);
+
+  /**
+   * @brief Stores a new text value, suppressing repeats where allowed
+   */
+  void update(Field field, const char* text, size_t length);
+
+  /**
+   * @brief Sends the pending changes of one channel
+   * @return True if a frame was sent
+   */
+  bool flushChannel(ClusterProtocol::Channel channel, Clock::time_point now);
+
+  /**
+   * @brief Replaces the rate limits with the ones of an advertisement
+   * @param advertisement "key:hz" pairs; empty to lift all limits
+   */
+  void applyRateLimits(const std::string& advertisement);
+
+  /**
+   * @brief Finds the field of a message key
+   * @return The field, or FieldCount if the key is not published
+   */
+  static Field fieldOf(const char* key, size_t length);
+
+  /**
+   * @brief Encodes the full state into the encoder
+   */
+  void encodeSnapshot();
+
+  zmq::socket_t& socket(ClusterProtocol::Channel channel);
+
+  zmq::context_t m_context;                      ///< ZMQ context of the publisher
+  zmq::socket_t m_critical;                      ///< PUB socket of the critical channel
+  zmq::socket_t m_nonCritical;                   ///< PUB socket of the non-critical channel
+  zmq::socket_t m_snapshot;                      ///< ROUTER socket of the snapshot server
+  bool m_servingSnapshots;                       ///< The snapshot socket is bound
+  zmq::socket_t m_rates;                         ///< PULL socket of the rate backchannel
+  bool m_acceptingRates;                         ///< The rate socket is bound
+  Clock::time_point m_ratesReceived;             ///< Time of the last advertisement
+  std::chrono::milliseconds m_rateLimitLifetime; ///< Limits expire after this
+  Value m_values[FieldCount];                    ///< Latest value per field
+  int64_t m_sequences[2];                        ///< Last sequence number per channel
+  ClusterFrameEncoder m_encoder;                 ///< Reused for every frame
+  ClusterPublisherStatistics m_statistics;       ///< Counters
+};
+
+#endif // CLUSTERPUBLISHER_HPP
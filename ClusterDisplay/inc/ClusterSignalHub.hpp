@@ -0,0 +1,181 @@
+#ifndef CLUSTERSIGNALHUB_HPP
+#define CLUSTERSIGNALHUB_HPP
+
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ZmqMessageParser.hpp"
+#include "ZmqSubscriber.hpp"
+
+/**
+ * @brief In-process fan-out of the cluster data streams
+ *
+ * The hub owns the ZeroMQ subscriptions, decodes every frame once and hands
+ * the values to the listeners registered for each key. A listener is a plain
+ * callback invoked on the GUI thread, so a widget that needs a value costs one
+ * function call per update instead of its own socket, context and copy of
+ * every frame.
+ *
+ * Listeners may be registered and removed at any time, including from within
+ * a listener. A listener added during dispatch receives values from the next
+ * frame on; a removed listener is never called again.
+ *
+ * Frames carrying one of the priority keys are additionally delivered to the
+ * priority listeners before the batch they arrived in is dispatched, decoded
+ * by a parser of their own. Consumers use this for safety alerts that must
+ * not queue behind telemetry. The frames of the batch in front of the priority
+ * frame are dispatched without their priority keys: their values are older
+ * than the one already applied and would roll it back until the priority
+ * frame comes through the regular path.
+ */
+class ClusterSignalHub : public QObject {
+  Q_OBJECT
+
+ public:
+  using ValueListener = std::function<void(const QString& value)>;          ///< Raw value callback
+  using IntListener = std::function<void(int value)>;                       ///< Integer callback
+  using FrameListener = std::function<void(const QMap<QString, QString>&)>; ///< Whole frame
+
+  explicit ClusterSignalHub(QObject* parent = nullptr);
+  virtual ~ClusterSignalHub();
+
+  /**
+   * @brief Subscribe to a publisher and feed its frames into the hub
+   * @param address The ZMQ endpoint address to connect to
+   * @param options Receive-side socket options
+   */
+  void addSource(const QString& address, const ZmqSocketOptions& options = ZmqSocketOptions());
+
+  /**
+   * @brief Set the keys whose frames are delivered ahead of queued frames
+   * Applies to current and future sources.
+   * @param keys Message keys (e.g. "obs")
+   */
+  void setPriorityKeys(const QStringList& keys);
+
+  /**
+   * @brief Get the number of publishers the hub is subscribed to
+   */
+  int sourceCount() const;
+
+  /**
+   * @brief Get the number of publishers that are currently connected
+   */
+  int connectedSourceCount() const;
+
+  /**
+   * @brief Register a callback for the raw value of a key
+   * @param key Message key (e.g. "speed")
+   * @param listener Called with the value of every frame that contains the key
+   * @return Registration id for unsubscribe()
+   */
+  int subscribe(const QString& key, ValueListener listener);
+
+  /**
+   * @brief Register a callback for the integer value of a key
+   *
+   * Values that are not valid integers are dropped.
+   *
+   * @param key Message key (e.g. "battery")
+   * @param listener Called with the converted value of every frame that contains the key
+   * @return Registration id for unsubscribe()
+   */
+  int subscribeInt(const QString& key, IntListener listener);
+
+  /**
+   * @brief Register a callback for complete frames
+   * @param listener Called once per frame with all of its key-value pairs
+   * @return Registration id for unsubscribe()
+   */
+  int subscribeFrames(FrameListener listener);
+
+  /**
+   * @brief Register a callback for frames carrying a priority key
+   *
+   * The callback runs before the frames received together with the priority
+   * frame are dispatched; the frame is afterwards also dispatched normally.
+   *
+   * @param listener Called once per priority frame with all of its key-value pairs
+   * @return Registration id for unsubscribe()
+   */
+  int subscribePriorityFrames(FrameListener listener);
+
+  /**
+   * @brief Remove a listener
+   * @param id Registration id returned by one of the subscribe functions
+   */
+  void unsubscribe(int id);
+
+  /**
+   * @brief Get the number of listeners registered for a key
+   */
+  int listenerCount(const QString& key) const;
+
+ public slots:
+  /**
+   * @brief Decode a frame and dispatch it to the listeners
+   * @param message Frame in "key1:value1;key2:value2;..." format
+   */
+  void dispatchMessage(const QString& message);
+
+  /**
+   * @brief Decode a priority frame and dispatch it to the priority listeners
+   * @param message Frame in "key1:value1;key2:value2;..." format
+   * @param overtakenFrames Next frames passed to dispatchMessage() that were received before it;
+   *                        their priority keys are dropped
+   */
+  void dispatchPriorityMessage(const QString& message, int overtakenFrames = 0);
+
+ signals:
+  /**
+   * @brief Emitted when a publisher connects or disconnects
+   * @param connectedSources Number of publishers connected now
+   */
+  void connectedSourcesChanged(int connectedSources);
+
+ private:
+  /**
+   * @brief A registered callback
+   */
+  struct Listener {
+    int id;              ///< Registration id
+    ValueListener value; ///< Per-key callback (unset for frame listeners)
+    FrameListener frame; ///< Frame callback (unset for per-key listeners)
+  };
+
+  /**
+   * @brief Check whether a listener was removed while the current frame is dispatched
+   */
+  bool removedDuringDispatch(int id) const;
+
+  /**
+   * @brief Call frame listeners, skipping the ones removed meanwhile
+   * @param listeners Implicitly shared snapshot of a listener list, taken by value so that
+   *                  listeners may (un)subscribe while being called
+   * @param frame Decoded frame
+   */
+  void dispatchFrame(QVector<Listener> listeners, const QMap<QString, QString>& frame);
+
+  ZmqMessageParser m_parser;                             ///< Frame decoder
+  ZmqMessageParser m_priorityParser;                     ///< Decoder of the priority path
+  QList<QByteArray> m_priorityKeys;                      ///< Keys of priority frames
+  QStringList m_priorityKeyNames;                        ///< Keys of priority frames, decoded
+  int m_overtakenFrames;                                 ///< Frames to dispatch without them
+  std::vector<std::unique_ptr<ZmqSubscriber>> m_sources; ///< Subscribed publishers
+  QHash<QString, QVector<Listener>> m_valueListeners;    ///< Per-key listeners
+  QVector<Listener> m_frameListeners;                    ///< Whole-frame listeners
+  QVector<Listener> m_priorityListeners;                 ///< Priority frame listeners
+  QSet<int> m_removedIds;                                ///< Removed during the current dispatch
+  int m_nextId;                                          ///< Next registration id
+  int m_dispatchDepth;                                   ///< Nesting level of dispatchMessage()
+};
+
+#endif // CLUSTERSIGNALHUB_HPP
@@ -0,0 +1,124 @@
+#ifndef DBCDATABASE_HPP
+#define DBCDATABASE_HPP
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QtEndian>
+#include <QtGlobal>
+
+/**
+ * @brief A signal of a CAN message, compiled for decoding with one shift and mask
+ */
+struct DbcSignal {
+  QString name;   ///< Signal name from the DBC file
+  QString unit;   ///< Unit from the DBC file
+  quint8 shift;   ///< Position of the least significant bit in the 64-bit payload word
+  quint8 length;  ///< Length in bits
+  bool bigEndian; ///< Motorola byte order; the payload word is then loaded big endian
+  bool isSigned;  ///< Two's complement raw value
+  quint64 mask;   ///< length low bits set
+  double factor;  ///< Physical value = raw * factor + offset
+  double offset;  ///< Physical value = raw * factor + offset
+};
+
+/**
+ * @brief A CAN message and its signals
+ */
+struct DbcMessage {
+  quint32 id;                    ///< CAN identifier, without the DBC extended flag
+  bool extended;                 ///< 29-bit identifier
+  QString name;                  ///< Message name from the DBC file
+  int length;                    ///< Payload length in bytes (DLC)
+  QVector<DbcSignal> dbcSignals; ///< Decoded signals
+};
+
+/**
+ * @brief CAN database read from a DBC file and compiled into lookup tables
+ *
+ * Only the message (BO_) and signal (SG_) definitions are used; everything
+ * else in the file is skipped. Multiplexed signals (`m<n>`) are left out,
+ * since their meaning depends on the multiplexer value; the multiplexer
+ * itself is decoded like any signal.
+ *
+ * Each signal is compiled into a shift and a mask on the 64-bit payload word,
+ * loaded little endian for Intel and big endian for Motorola byte order, so
+ * decoding is a load, a shift, a mask and a multiply-add. Messages with an
+ * 11-bit identifier are found through a direct table of 2048 entries,
+ * extended identifiers through a hash.
+ */
+class DbcDatabase {
+ public:
+  /// Payload bytes the decoder handles (classic CAN)
+  static constexpr int kMaxPayload = 8;
+
+  DbcDatabase();
+
+  /**
+   * @brief Reads and compiles a DBC file
+   * @return False if the file cannot be read or a definition is malformed
+   */
+  bool load(const QString& path);
+
+  /**
+   * @brief Compiles the text of a DBC file, replacing the current contents
+   * @return False if a definition is malformed; see errorString()
+   */
+  bool parse(const QString& text);
+
+  /** @brief Gets the reason load() or parse() failed */
+  QString errorString() const;
+
+  /** @brief Gets the messages in file order */
+  const QVector<DbcMessage>& messages() const;
+
+  /**
+   * @brief Finds a message by its identifier
+   * @return The message, or nullptr if the database does not define it
+   */
+  const DbcMessage* message(quint32 id, bool extended) const {
+    if (!extended) {
+      const int index = id < kStandardIds ? m_standardIndex.at(static_cast<int>(id)) : -1;
+      return index >= 0 ? &m_messages.at(index) : nullptr;
+    }
+    const auto found = m_extendedIndex.constFind(id);
+    return found != m_extendedIndex.cend() ? &m_messages.at(found.value()) : nullptr;
+  }
+
+  /**
+   * @brief Loads a payload of kMaxPayload bytes as the word the signals are extracted from
+   * @param bigEndian Byte order of the signals to extract (DbcSignal::bigEndian)
+   */
+  static quint64 payloadWord(const quint8* payload, bool bigEndian) {
+    return bigEndian ? qFromBigEndian<quint64>(payload) : qFromLittleEndian<quint64>(payload);
+  }
+
+  /**
+   * @brief Decodes the physical value of a signal
+   * @param word payloadWord() in the byte order of the signal
+   */
+  static double decode(const DbcSignal& dbcSignal, quint64 word) {
+    quint64 raw = (word >> dbcSignal.shift) & dbcSignal.mask;
+    if (dbcSignal.isSigned && (raw >> (dbcSignal.length - 1)) != 0) {
+      raw |= ~dbcSignal.mask;
+      return static_cast<double>(static_cast<qint64>(raw)) * dbcSignal.factor + dbcSignal.offset;
+    }
+    return static_cast<double>(raw) * dbcSignal.factor + dbcSignal.offset;
+  }
+
+ private:
+  static constexpr quint32 kStandardIds = 2048; ///< 11-bit identifiers
+
+  /**
+   * @brief Compiles the position of a signal into its shift
+   * @return False if the signal does not fit into the payload
+   */
+  static bool compile(DbcSignal* dbcSignal, int startBit);
+
+  QString m_error;                     ///< Reason of the last failure
+  QVector<DbcMessage> m_messages;      ///< Messages in file order
+  QVector<qint16> m_standardIndex;     ///< Message index per 11-bit identifier (-1 = none)
+  QHash<quint32, int> m_extendedIndex; ///< Message index per 29-bit identifier
+};
+
+#endif // DBCDATABASE_HPP
@@ -0,0 +1,76 @@
+#ifndef DIGITDISPLAY_HPP
+#define DIGITDISPLAY_HPP
+
+#include <QColor>
+#include <QFont>
+#include <QQuickItem>
+#include <QString>
+#include <memory>
+
+#include "GlyphAtlas.hpp"
+
+/**
+ * @brief Numeric text item drawn from a pre-baked glyph atlas
+ *
+ * Replacement for Text in frequently updated readouts (speed, odometer,
+ * clock, battery). The glyphs of `characters` are rendered once into a
+ * GlyphAtlas; a text change only rewrites one textured quad per character,
+ * without text shaping, layout or glyph node rebuilds. Characters that are
+ * not in the atlas are left blank.
+ */
+class DigitDisplay : public QQuickItem {
+  Q_OBJECT
+  QML_ELEMENT
+
+  Q_PROPERTY(QString text READ text WRITE setText NOTIFY textChanged)
+  Q_PROPERTY(QFont font READ font WRITE setFont NOTIFY fontChanged)
+  Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+  Q_PROPERTY(QString characters READ characters WRITE setCharacters NOTIFY charactersChanged)
+
+ public:
+  explicit DigitDisplay(QQuickItem* parent = nullptr);
+  virtual ~DigitDisplay();
+
+  // Getters
+  QString text() const;
+  QFont font() const;
+  QColor color() const;
+  QString characters() const;
+
+  /**
+   * @brief Get the current atlas, rebuilding it if a property changed
+   * @return Atlas used for the next frame (never null)
+   */
+  const GlyphAtlas* atlas();
+
+  // Setters
+  void setText(const QString& text);
+  void setFont(const QFont& font);
+  void setColor(const QColor& color);
+  void setCharacters(const QString& characters);
+
+ signals:
+  void textChanged(const QString& text);
+  void fontChanged(const QFont& font);
+  void colorChanged(const QColor& color);
+  void charactersChanged(const QString& characters);
+
+ protected:
+  QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+  void updatePolish() override;
+  void itemChange(ItemChange change, const ItemChangeData& value) override;
+
+ private:
+  void invalidateAtlas();
+  void updateImplicitSize();
+
+  QString m_text;                      ///< Displayed text
+  QFont m_font;                        ///< Font the atlas is rendered with
+  QColor m_color;                      ///< Glyph color baked into the atlas
+  QString m_characters;                ///< Characters available for display
+  std::unique_ptr<GlyphAtlas> m_atlas; ///< Atlas for the current font, color and characters
+  bool m_atlasDirty;                   ///< Atlas must be rebuilt before the next frame
+  bool m_textureDirty;                 ///< Scene graph texture must be re-uploaded
+};
+
+#endif // DIGITDISPLAY_HPP
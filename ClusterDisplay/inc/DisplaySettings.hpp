@@ -0,0 +1,83 @@
+#ifndef DISPLAYSETTINGS_HPP
+#define DISPLAYSETTINGS_HPP
+
+#include <QJSEngine>
+#include <QObject>
+#include <QQmlEngine>
+
+/**
+ * @brief Rendering options shared by the QML interface
+ *
+ * Exposed to QML as the `DisplaySettings` singleton of the `ClusterDisplay`
+ * module. The application owns the instance and hands it to QML with
+ * setQmlInstance(), like ClusterModel.
+ *
+ * In partial repaint mode the interface avoids animating items that span the
+ * whole window and renders its static background and border frame as cached
+ * layers. The software scene graph backend only repaints dirty rectangles, so
+ * a small change such as a battery digit then no longer recomposites the full
+ * 1280x400 window.
+ *
+ * Overlays that are not safety-critical are created on demand by LazyOverlay
+ * and unloaded again after overlayIdleUnloadMs without being shown.
+ *
+ * Trend graphs are drawn with geometry nodes, which the software backend does
+ * not support; trendGraphs is cleared for it.
+ */
+class DisplaySettings : public QObject {
+  Q_OBJECT
+  QML_ELEMENT
+  QML_SINGLETON
+
+  Q_PROPERTY(bool partialRepaint READ partialRepaint WRITE setPartialRepaint NOTIFY
+                 partialRepaintChanged)
+  Q_PROPERTY(int overlayIdleUnloadMs READ overlayIdleUnloadMs WRITE setOverlayIdleUnloadMs NOTIFY
+                 overlayIdleUnloadMsChanged)
+  Q_PROPERTY(bool trendGraphs READ trendGraphs WRITE setTrendGraphs NOTIFY trendGraphsChanged)
+
+ public:
+  explicit DisplaySettings(QObject* parent = nullptr);
+  virtual ~DisplaySettings();
+
+  /**
+   * @brief Set the instance returned to QML by create()
+   * @param instance Settings owned by the application (must outlive the QML engine)
+   */
+  static void setQmlInstance(DisplaySettings* instance);
+
+  /**
+   * @brief Singleton factory used by the QML engine
+   * @return The instance registered with setQmlInstance()
+   */
+  static DisplaySettings* create(QQmlEngine* qmlEngine, QJSEngine* jsEngine);
+
+  /**
+   * @brief Check whether Qt Quick will use the software (no-GPU) backend
+   * @return True if the software adaptation was requested through the API or QT_QUICK_BACKEND
+   */
+  static bool softwareBackendSelected();
+
+  // Getters
+  bool partialRepaint() const;
+  int overlayIdleUnloadMs() const;
+  bool trendGraphs() const;
+
+  // Setters
+  void setPartialRepaint(bool enabled);
+  void setOverlayIdleUnloadMs(int milliseconds);
+  void setTrendGraphs(bool enabled);
+
+ signals:
+  void partialRepaintChanged(bool enabled);
+  void overlayIdleUnloadMsChanged(int milliseconds);
+  void trendGraphsChanged(bool enabled);
+
+ private:
+  static DisplaySettings* s_qmlInstance; ///< Instance handed to the QML engine
+
+  bool m_partialRepaint;     ///< Static layers cached, full-window animations disabled
+  int m_overlayIdleUnloadMs; ///< Time a hidden lazy overlay is kept before it is unloaded
+  bool m_trendGraphs;        ///< Speed and battery trends are shown
+};
+
+#endif // DISPLAYSETTINGS_HPP
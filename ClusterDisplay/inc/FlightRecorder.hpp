@@ -0,0 +1,176 @@
+#ifndef FLIGHTRECORDER_HPP
+#define FLIGHTRECORDER_HPP
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief Always-on, fixed-size ring of recent runtime events
+ *
+ * Received frames, model changes, rendered frames, queue depths and stalls
+ * are recorded into a preallocated ring that keeps the newest capacity()
+ * events, roughly the last few seconds of operation. Recording takes one
+ * atomic increment, a monotonic clock read and a few relaxed stores, is
+ * lock-free and may be called from any thread, so the recorder can stay
+ * enabled in production.
+ *
+ * The ring is written to disk by dump(), which only uses async-signal-safe
+ * calls and can therefore run from the SIGUSR1 and crash handlers installed
+ * by installSignalHandlers() as well as from the stall watchdog.
+ */
+class FlightRecorder {
+ public:
+  /** @brief Kind of a recorded event; the meaning of the two payload values depends on it */
+  enum EventType : quint16 {
+    NoEvent,       ///< Unused slot
+    FrameReceived, ///< a: frame size in bytes, b: first 8 bytes of the frame
+    PriorityFrame, ///< a: frame size in bytes, b: first 8 bytes of the frame
+    BatchDrained,  ///< a: frames drained from the socket in one pass (queue depth)
+    ModelChanged,  ///< a: speed, b: state revision
+    AlertChanged,  ///< a: alert severity, b: emergency brake << 1 | object alert
+    FrameSwapped,  ///< a: sync-to-swap time in microseconds, b: time since last swap in ns
+    Stall,         ///< a: stalled thread (StallWatchdog::Channel), b: stall duration in ns
+    Marker         ///< a, b: free for ad-hoc instrumentation
+  };
+
+  /**
+   * @brief A recorded event as returned by snapshot()
+   */
+  struct Event {
+    qint64 timeNs;  ///< Time since the recorder was created
+    EventType type; ///< Kind of event
+    qint32 a;       ///< First payload value
+    qint64 b;       ///< Second payload value
+  };
+
+  /**
+   * @brief Creates a recorder
+   * @param capacity Number of events kept; rounded up to a power of two
+   */
+  explicit FlightRecorder(int capacity = 65536);
+  ~FlightRecorder();
+
+  FlightRecorder(const FlightRecorder&) = delete;
+  FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+  /**
+   * @brief Records an event (any thread, lock-free)
+   */
+  void record(EventType type, qint32 a = 0, qint64 b = 0);
+
+  /**
+   * @brief Records an event into the global recorder, if one is installed
+   */
+  static void trace(EventType type, qint32 a = 0, qint64 b = 0) {
+    FlightRecorder* recorder = s_instance.load(std::memory_order_relaxed);
+    if (recorder) {
+      recorder->record(type, a, b);
+    }
+  }
+
+  /**
+   * @brief Packs the first bytes of a frame into a payload value
+   */
+  static qint64 prefix(const char* data, size_t size);
+
+  /**
+   * @brief Installs the recorder used by trace() and the signal handlers
+   * @param recorder Application-owned recorder, or nullptr to disable tracing
+   */
+  static void setInstance(FlightRecorder* recorder);
+
+  /**
+   * @brief Gets the recorder used by trace()
+   */
+  static FlightRecorder* instance();
+
+  /**
+   * @brief Gets the number of events kept in the ring
+   */
+  int capacity() const;
+
+  /**
+   * @brief Gets the number of events recorded since creation, including overwritten ones
+   */
+  quint64 recordedCount() const;
+
+  /**
+   * @brief Copies the events currently in the ring, oldest first
+   * Events being written concurrently are skipped.
+   */
+  QVector<Event> snapshot() const;
+
+  /**
+   * @brief Sets the directory dump() writes to
+   * @param directory Existing directory; paths longer than the internal buffer are rejected
+   * @return True if the directory was accepted
+   */
+  bool setDumpDirectory(const QString& directory);
+
+  /**
+   * @brief Gets the file dump() writes for a reason
+   */
+  QString dumpPath(const char* reason) const;
+
+  /**
+   * @brief Writes the ring as text to "<directory>/flight-<reason>.log" (async-signal-safe)
+   * @param reason Short tag such as "gui-stall", "signal" or "crash"
+   * @return True if the file was written
+   */
+  bool dump(const char* reason) const;
+
+  /**
+   * @brief Writes the ring as text to an open file descriptor (async-signal-safe)
+   */
+  bool dumpTo(int fd, const char* reason) const;
+
+  /**
+   * @brief Gets the name used for an event type in dumps
+   */
+  static const char* typeName(EventType type);
+
+  /**
+   * @brief Monotonic clock shared by the recorder and its users, in nanoseconds
+   */
+  static qint64 nowNs();
+
+  /**
+   * @brief Dumps the global recorder on SIGUSR1 and on fatal signals
+   *
+   * SIGUSR1 writes "flight-signal.log" and continues. SIGSEGV, SIGBUS, SIGFPE,
+   * SIGILL and SIGABRT write "flight-crash.log" and then re-raise the signal
+   * with its default action. Does nothing on platforms without POSIX signals.
+   */
+  static void installSignalHandlers();
+
+ private:
+  /**
+   * @brief Storage of one event; the sequence number tells readers whether it is complete
+   */
+  struct Slot {
+    std::atomic<quint64> sequence; ///< Index + 1 of the event, 0 while being written
+    std::atomic<qint64> timeNs;    ///< Time since the recorder was created
+    std::atomic<qint64> b;         ///< Second payload value
+    std::atomic<qint32> a;         ///< First payload value
+    std::atomic<quint16> type;     ///< EventType
+  };
+
+  /**
+   * @brief Reads a slot consistently
+   * @return False if the slot does not hold event number index
+   */
+  bool readSlot(quint64 index, Event* event) const;
+
+  std::unique_ptr<Slot[]> m_slots;         ///< Ring storage
+  quint64 m_mask;                          ///< Capacity - 1
+  qint64 m_startNs;                        ///< Clock value at construction
+  alignas(64) std::atomic<quint64> m_head; ///< Number of events claimed so far
+  char m_directory[512];                   ///< Dump directory, null-terminated
+
+  static std::atomic<FlightRecorder*> s_instance; ///< Recorder used by trace()
+};
+
+#endif // FLIGHTRECORDER_HPP
@@ -0,0 +1,67 @@
+#ifndef GLYPHATLAS_HPP
+#define GLYPHATLAS_HPP
+
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QImage>
+#include <QRectF>
+#include <QSizeF>
+#include <QString>
+
+/**
+ * @brief Pre-rendered strip of fixed-width glyph cells
+ *
+ * Every character of the set is drawn once, in the requested font and color,
+ * into its own cell of a single image. Cells share the width of the widest
+ * glyph so that numbers keep a stable layout (tabular figures) and a value
+ * update only has to pick different cells, never re-shape text.
+ */
+class GlyphAtlas {
+ public:
+  /**
+   * @brief Render the atlas
+   * @param font Font used for all glyphs
+   * @param color Glyph color baked into the image
+   * @param characters Characters to include (duplicates are ignored)
+   * @param devicePixelRatio Scale of the image relative to logical pixels
+   */
+  GlyphAtlas(const QFont& font, const QColor& color, const QString& characters,
+             qreal devicePixelRatio = 1.0);
+
+  /**
+   * @brief Get the rendered atlas image (premultiplied ARGB)
+   */
+  const QImage& image() const;
+
+  /**
+   * @brief Get the characters stored in the atlas, in cell order
+   */
+  const QString& characters() const;
+
+  /**
+   * @brief Get the size of one glyph cell in logical pixels
+   */
+  QSizeF cellSize() const;
+
+  /**
+   * @brief Find the cell holding a character
+   * @return Cell index, or -1 if the character is not in the atlas
+   */
+  int indexOf(QChar character) const;
+
+  /**
+   * @brief Get the normalized texture coordinates of a cell
+   * @param index Cell index returned by indexOf()
+   */
+  QRectF textureRect(int index) const;
+
+ private:
+  QImage m_image;                ///< Rendered glyph strip
+  QString m_characters;          ///< Characters in cell order
+  QHash<QChar, int> m_cellIndex; ///< Character to cell lookup
+  QSizeF m_cellSize;             ///< Logical cell size
+  int m_cellPixelWidth;          ///< Cell width in image pixels, including padding
+};
+
+#endif // GLYPHATLAS_HPP
@@ -0,0 +1,86 @@
+#ifndef LOCALODOMETER_HPP
+#define LOCALODOMETER_HPP
+
+#include <QtGlobal>
+
+/**
+ * @brief Odometer integrated on the display from the speed, reconciled with the publisher's
+ *
+ * The distance is kept in micrometers: a speed in mm/s held for a number of
+ * milliseconds is exactly that many micrometers, so the integration is exact
+ * integer arithmetic and does not drift however long the display runs.
+ *
+ * The publisher's `odo` (whole meters) is authoritative when it arrives:
+ * - the first value is adopted if the figure has no base yet or is behind it
+ * - then every step of the publisher value must match the locally integrated
+ *   distance to within one meter. A local figure that is behind jumps forward;
+ *   one that is ahead is held until the publisher catches up. The figure never
+ *   goes backwards.
+ * - a step backwards or an implausible jump (a restarted publisher that lost
+ *   its count) rebases the publisher value on the local figure, which goes on
+ *   counting from where it was
+ */
+class LocalOdometer {
+ public:
+  static constexpr qint64 kMicrometersPerMeter = 1000000;
+
+  /// Largest step of the publisher value that is reconciled rather than rebased
+  static constexpr qint64 kMaxPublisherStep = 1000;
+
+  LocalOdometer();
+
+  /**
+   * @brief Sets the base of the figure, e.g. from the journal
+   * Distance integrated before is added to it.
+   * @return False if the figure already has a base
+   */
+  bool seed(qint64 micrometers);
+
+  /** @brief Checks whether a figure is known (seeded, or reported by the publisher) */
+  bool isKnown() const;
+
+  /** @brief Adds a speed sample in mm/s */
+  void addSpeed(qint64 timeMs, int mmPerSecond);
+
+  /**
+   * @brief Reconciles with an odometer value of the publisher
+   * @param meters Value of the `odo` key
+   */
+  void addPublisherValue(qint64 meters);
+
+  /** @brief Accounts for the held speed up to a point in time */
+  void advance(qint64 timeMs);
+
+  /** @brief Stops integrating until the next speed sample (the data link went down) */
+  void interrupt();
+
+  /** @brief Gets the figure in micrometers */
+  qint64 micrometers() const;
+
+  /** @brief Gets the figure in whole meters */
+  qint64 meters() const;
+
+  /**
+   * @brief Gets the distance driven since construction, in micrometers
+   * Everything the figure advanced by, except for the bases it adopted from seed() or the
+   * publisher; a running total for consumers that need the distance of a stretch.
+   */
+  qint64 driven() const;
+
+ private:
+  /**
+   * @brief Adds an integrated distance, first paying off the distance the figure is ahead
+   */
+  void add(qint64 micrometers);
+
+  qint64 m_micrometers;   ///< The figure
+  bool m_known;           ///< The figure has a base
+  qint64 m_ahead;         ///< Distance still to be withheld from the integration
+  qint64 m_publisherLast; ///< Newest publisher value (-1 = none)
+  qint64 m_offset;        ///< Figure minus publisher value, in micrometers
+  qint64 m_driven;        ///< Distance the figure advanced by while driving
+  qint64 m_speedTime;     ///< Time up to which the speed is integrated (-1 = none)
+  int m_speed;            ///< Held speed in mm/s
+};
+
+#endif // LOCALODOMETER_HPP
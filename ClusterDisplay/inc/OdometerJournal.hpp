@@ -0,0 +1,112 @@
+#ifndef ODOMETERJOURNAL_HPP
+#define ODOMETERJOURNAL_HPP
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+
+#include "WriteThrottle.hpp"
+
+/**
+ * @brief Append-only, crash-safe journal of the locally integrated odometer
+ *
+ * Every write appends one small checksummed record with the figure in
+ * micrometers; records are never rewritten in place, so a power loss can at
+ * worst tear the last record, which restore() skips. A WriteThrottle limits
+ * the records to one per minimum write interval, none is appended while the
+ * figure did not move, and the writeback is only started, not waited for, so the UI
+ * thread does not block on the storage. When the journal reaches its maximum
+ * size it is compacted into a new file holding only the newest record, which
+ * replaces the old one atomically.
+ */
+class OdometerJournal : public QObject {
+  Q_OBJECT
+
+ public:
+  /// Records kept before the journal is compacted
+  static constexpr int kMaxRecords = 4096;
+
+  /**
+   * @brief Creates a journal that is not yet backed by a file
+   * @param minWriteIntervalMs Minimum time between two appended records
+   * @param parent The parent QObject
+   */
+  explicit OdometerJournal(int minWriteIntervalMs = 10000, QObject* parent = nullptr);
+
+  /**
+   * @brief Appends the pending figure and waits for it to reach the storage
+   */
+  virtual ~OdometerJournal();
+
+  /**
+   * @brief Opens or creates the journal file
+   * A torn or corrupt tail is cut off, so new records follow the last valid one.
+   * @param path File path; missing parent directories are created
+   * @return False if the file cannot be created
+   */
+  bool open(const QString& path);
+
+  /**
+   * @brief Checks whether a file is open
+   */
+  bool isOpen() const;
+
+  /**
+   * @brief Gets the newest figure of the journal
+   * @return Micrometers, or -1 if the journal holds no valid record
+   */
+  qint64 restore() const;
+
+  /**
+   * @brief Records a new figure, written at the next allowed time
+   */
+  void record(qint64 micrometers);
+
+  /**
+   * @brief Appends the pending figure now, ignoring the minimum write interval
+   */
+  void flush();
+
+  /**
+   * @brief Gets the number of records in the file
+   */
+  int recordCount() const;
+
+  /**
+   * @brief Gets the number of records appended since the file was opened
+   */
+  int writeCount() const;
+
+  /**
+   * @brief Gets the file name used inside the state directory
+   */
+  static QString defaultFileName();
+
+ signals:
+  /**
+   * @brief Emitted after a record has been appended
+   * @param micrometers Figure of the record
+   */
+  void written(qint64 micrometers);
+
+ private:
+  /**
+   * @brief Appends the pending figure if it differs from the last record
+   */
+  void write();
+
+  /**
+   * @brief Replaces the file by one holding only the last record
+   */
+  bool compact();
+
+  WriteThrottle m_throttle; ///< Limits the rate of appended records
+  QFile m_file;             ///< Journal file, open for appending
+  qint64 m_pending;         ///< Figure to write (-1 = none)
+  qint64 m_last;            ///< Figure of the last valid record (-1 = none)
+  quint32 m_sequence;       ///< Sequence number of the last record
+  int m_recordCount;        ///< Records in the file
+  int m_writeCount;         ///< Records appended since open()
+};
+
+#endif // ODOMETERJOURNAL_HPP
@@ -0,0 +1,130 @@
+#ifndef RANGEESTIMATOR_HPP
+#define RANGEESTIMATOR_HPP
+
+#include <QtGlobal>
+
+/**
+ * @brief Linear battery consumption model fitted by recursive least squares
+ *
+ * The battery used over a stretch of driving is modelled as
+ * `perKm * distance + perMinute * time`: a cost of moving and a cost of
+ * being switched on. The weights are refitted after every stretch with
+ * exponential forgetting, so the model follows a change of load or driving
+ * style. All state is in this fixed-size struct.
+ */
+struct ConsumptionModel {
+  double weights[2];       ///< Percentage points per km and per minute
+  double covariance[2][2]; ///< Uncertainty of the weights
+  qint64 observations;     ///< Stretches fitted since the start
+};
+
+/**
+ * @brief Driving between two drops of the battery level
+ */
+struct ConsumptionSegment {
+  bool active;          ///< A drop started the segment and it is being measured
+  int startLevel;       ///< Battery level at the start, in percent
+  qint64 startMs;       ///< Time of the start
+  qint64 startDistance; ///< Distance driven at the start, in micrometers
+};
+
+/**
+ * @brief Remaining range estimated from the battery stream and the distance driven
+ *
+ * The distance is not integrated here: it is the running total of the
+ * display's odometer (LocalOdometer::driven()), which already merges the
+ * integrated speed with the publisher's odometer, so the range, the odometer
+ * and the trip all count the same meters.
+ *
+ * The battery level arrives in whole percent, so every drop of the level
+ * closes a segment whose distance and duration are known: one observation of
+ * the ConsumptionModel. The first drop only starts measuring, since the level
+ * may have been anywhere within the percent before it. Each sample costs
+ * constant time and nothing is allocated.
+ *
+ * Charging suspends the measurement. After charging stops, the level is
+ * only measured again after the settle time, and every time the charger is
+ * plugged in again the wait starts over, so a toggling charging flag or the
+ * level relaxing after a charge is not learned as consumption. The model
+ * itself is kept across charges.
+ *
+ * The range is the battery left divided by the cost of one km at the recent
+ * average speed, which turns the per-minute cost into a per-km cost.
+ */
+class RangeEstimator {
+ public:
+  /// Weight of the previous stretches when a new one is fitted (memory of about 20 drops)
+  static constexpr double kForgetting = 0.95;
+
+  /// Consumption assumed before the first stretch was measured
+  static constexpr double kNominalPercentPerKm = 5.0;
+
+  /// Time after charging before the level is measured again
+  static constexpr qint64 kChargeSettleMs = 60000;
+
+  /// Rise of the level without the charging flag that counts as a recharge
+  static constexpr int kRechargeRise = 5;
+
+  RangeEstimator();
+
+  /** @brief Forgets the measurements and returns to the nominal model */
+  void reset();
+
+  /**
+   * @brief Adds a sample of the distance driven
+   * @param timeMs Time of the sample
+   * @param micrometers Running total that only grows, e.g. LocalOdometer::driven()
+   */
+  void addDistance(qint64 timeMs, qint64 micrometers);
+
+  /** @brief Adds a battery sample in percent */
+  void addBattery(qint64 timeMs, int percent);
+
+  /** @brief Sets whether the battery is charging */
+  void setCharging(qint64 timeMs, bool charging);
+
+  /**
+   * @brief Discards the segment being measured (the data link went down)
+   */
+  void interrupt(qint64 timeMs);
+
+  /**
+   * @brief Gets the estimated remaining range
+   * @return Meters, or -1 while the battery level is unknown
+   */
+  qint64 range() const;
+
+  /** @brief Gets the battery used per km at the recent average speed */
+  double percentPerKm() const;
+
+  /** @brief Gets the fitted model */
+  const ConsumptionModel& model() const;
+
+  /** @brief Checks whether the current segment is being measured */
+  bool isMeasuring() const;
+
+ private:
+  /**
+   * @brief Starts measuring from a level drop
+   */
+  void startSegment(qint64 timeMs, int level);
+
+  /**
+   * @brief Fits the model to one observation
+   * @param features Distance in km and time in minutes of the segment
+   * @param used Battery used in percentage points
+   */
+  void fit(const double features[2], double used);
+
+  ConsumptionModel m_model;     ///< Fitted consumption
+  ConsumptionSegment m_segment; ///< Segment being measured
+  double m_recentKm;            ///< Exponentially weighted distance of the fitted segments
+  double m_recentMinutes;       ///< Exponentially weighted duration of the fitted segments
+  qint64 m_distance;            ///< Newest distance driven, in micrometers
+  int m_level;                  ///< Newest battery level (-1 = unknown)
+  int m_reference;              ///< Level drops are detected from (-1 = none)
+  bool m_charging;              ///< Battery is charging
+  qint64 m_settledFrom;         ///< Time from which the level is trusted again
+};
+
+#endif // RANGEESTIMATOR_HPP
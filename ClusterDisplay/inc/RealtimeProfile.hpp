@@ -0,0 +1,134 @@
+#ifndef REALTIMEPROFILE_HPP
+#define REALTIMEPROFILE_HPP
+
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+#include "ZmqSubscriber.hpp"
+
+class QQuickWindow;
+
+/**
+ * @brief CPU pinning, real-time scheduling and memory locking for the display threads
+ *
+ * The profile describes which CPUs and SCHED_FIFO priorities the GUI thread,
+ * the render thread and the ZeroMQ I/O (ingest) threads should use, and
+ * whether memory should be locked and pre-faulted. Every setting is applied
+ * independently; a setting the process is not allowed to use (missing
+ * CAP_SYS_NICE, RLIMIT_RTPRIO or RLIMIT_MEMLOCK, CPUs outside the cpuset) is
+ * skipped and reported instead of failing startup.
+ *
+ * Settings are validated before they are handed to libzmq, which aborts the
+ * process if its I/O thread cannot apply them.
+ */
+class RealtimeProfile {
+ public:
+  /**
+   * @brief Placement and priority of one thread
+   */
+  struct ThreadSettings {
+    QList<int> cpus;  ///< CPUs the thread may run on (empty = unchanged)
+    int priority = 0; ///< SCHED_FIFO priority, 1-99 (0 = unchanged)
+
+    /** @brief Checks whether anything is requested */
+    bool isSet() const {
+      return !cpus.isEmpty() || priority > 0;
+    }
+  };
+
+  RealtimeProfile();
+
+  /**
+   * @brief Parses a thread specification of the form "CPUS[:PRIORITY]"
+   *
+   * CPUS is a comma-separated list of CPU numbers and ranges, e.g. "2,4-5:70"
+   * or ":60" for a priority without pinning.
+   *
+   * @param spec Specification from the command line
+   * @param settings Receives the parsed settings
+   * @return False if the specification is malformed
+   */
+  static bool parseThreadSettings(const QString& spec, ThreadSettings* settings);
+
+  // Requested settings
+  void setGuiThread(const ThreadSettings& settings);
+  void setRenderThread(const ThreadSettings& settings);
+  void setIngestThreads(const ThreadSettings& settings);
+  void setLockMemory(bool enabled, int prefaultHeapMb = 64);
+
+  /**
+   * @brief Checks whether any setting was requested
+   */
+  bool isEnabled() const;
+
+  /**
+   * @brief Locks and pre-faults memory and applies the GUI thread settings
+   * Must be called on the GUI thread, early in main().
+   */
+  void applyProcessSettings();
+
+  /**
+   * @brief Applies the render thread settings when the window's scene graph starts
+   * @param window Window whose render thread is configured
+   */
+  void attachWindow(QQuickWindow* window);
+
+  /**
+   * @brief Adds the usable ingest settings to the options of the data subscriptions
+   * @param options Options to extend
+   * @return Options with the validated I/O thread CPUs and priority
+   */
+  ZmqSocketOptions ingestSocketOptions(ZmqSocketOptions options = ZmqSocketOptions());
+
+  /**
+   * @brief Applies thread settings to the calling thread
+   * @param role Thread name used in the report
+   * @param settings Requested settings
+   * @return True if every requested setting took effect
+   */
+  bool applyToCurrentThread(const QString& role, const ThreadSettings& settings);
+
+  /**
+   * @brief Gets the outcome of every setting applied so far, one line each
+   *
+   * The ingest threads are inspected when this is called, so call it once the
+   * data subscriptions have started (e.g. after the first frame).
+   */
+  QStringList report() const;
+
+  /**
+   * @brief Gets the CPUs the process may run on
+   */
+  static QList<int> availableCpus();
+
+  /**
+   * @brief Checks whether a thread of this process may use a SCHED_FIFO priority
+   * @param priority Priority to probe
+   * @param error Receives the reason when it may not (may be null)
+   */
+  static bool canUseRealtimePriority(int priority, QString* error = nullptr);
+
+ private:
+  /**
+   * @brief Appends a line to the report (any thread)
+   */
+  void addResult(const QString& line);
+
+  /**
+   * @brief Describes the placement and policy of the libzmq I/O threads
+   */
+  QStringList inspectIngestThreads() const;
+
+  ThreadSettings m_gui;    ///< Requested GUI thread settings
+  ThreadSettings m_render; ///< Requested render thread settings
+  ThreadSettings m_ingest; ///< Requested ZeroMQ I/O thread settings
+  bool m_lockMemory;       ///< Lock all current and future pages
+  int m_prefaultHeapMb;    ///< Heap pre-faulted and kept mapped after locking
+  bool m_ingestRequested;  ///< ingestSocketOptions() handed settings to libzmq
+  mutable QMutex m_mutex;  ///< Guards m_results (render thread writes into it)
+  QStringList m_results;   ///< Outcome of every applied setting
+};
+
+#endif // REALTIMEPROFILE_HPP
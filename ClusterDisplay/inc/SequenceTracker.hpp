@@ -0,0 +1,74 @@
+#ifndef SEQUENCETRACKER_HPP
+#define SEQUENCETRACKER_HPP
+
+#include <QtGlobal>
+
+/**
+ * @brief Accounts for lost, late and restarted frames of one sequence-numbered channel
+ *
+ * The publisher numbers the frames of a channel 1, 2, 3, ... A jump forward
+ * counts the skipped numbers as lost. A number at or below the newest one is
+ * a late frame; it is taken off the lost count again, since it was counted
+ * when it was skipped. A number far below the newest one, or 1 after a
+ * higher number, means the publisher restarted and the tracking starts over.
+ * After a lost connection any lower number is a restart.
+ */
+class SequenceTracker {
+ public:
+  /** @brief Classification of a received frame */
+  enum Result {
+    First,   ///< First frame seen, or first frame after a restart
+    InOrder, ///< The expected next frame
+    Gap,     ///< Frames were skipped before this one
+    Late,    ///< Older than the newest frame already seen
+    Restart  ///< The publisher started counting again
+  };
+
+  /**
+   * @brief Creates a tracker
+   * @param restartWindow A number this far below the newest one is taken as a restart
+   */
+  explicit SequenceTracker(qint64 restartWindow = 1000);
+
+  /**
+   * @brief Accounts for a received frame
+   * @param sequence Sequence number of the frame
+   */
+  Result track(qint64 sequence);
+
+  /** @brief Gets the newest sequence number seen (0 before the first frame) */
+  qint64 lastSequence() const;
+
+  /** @brief Gets the number of frames received */
+  qint64 received() const;
+
+  /** @brief Gets the number of skipped frames that have not arrived late */
+  qint64 lost() const;
+
+  /** @brief Gets the number of frames that arrived after a newer one */
+  qint64 late() const;
+
+  /** @brief Gets the number of detected publisher restarts */
+  int restarts() const;
+
+  /**
+   * @brief Takes the next number at or below the newest one as a restart
+   * Called when the connection was lost, since the first frames of a restarted
+   * publisher may have been missed while the subscription was re-established.
+   */
+  void expectRestart();
+
+  /** @brief Clears all counters */
+  void reset();
+
+ private:
+  qint64 m_restartWindow; ///< Distance below the newest number taken as a restart
+  qint64 m_last;          ///< Newest sequence number seen
+  qint64 m_received;      ///< Frames received
+  qint64 m_lost;          ///< Skipped frames not yet received
+  qint64 m_late;          ///< Frames received out of order
+  int m_restarts;         ///< Publisher restarts
+  bool m_expectRestart;   ///< The connection was lost since the last frame
+};
+
+#endif // SEQUENCETRACKER_HPP
@@ -0,0 +1,333 @@
+#ifndef SIGNALHISTORY_HPP
+#define SIGNALHISTORY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief A value at a point in time
+ */
+struct HistoryPoint {
+  int64_t timeMs; ///< Time of the value in milliseconds
+  float value;    ///< Value
+};
+
+/**
+ * @brief Summary of the values in one time bucket
+ */
+struct HistoryBucket {
+  int64_t startMs; ///< Start of the bucket in milliseconds
+  float min;       ///< Smallest value in the bucket
+  float max;       ///< Largest value in the bucket
+  float average;   ///< Mean of the values in the bucket
+};
+
+/**
+ * @brief Fixed-size ring that keeps the newest Capacity entries
+ */
+template <typename T, size_t Capacity>
+class HistoryRing {
+  static_assert(Capacity > 0, "A history ring needs room for at least one entry");
+
+ public:
+  HistoryRing() : m_head(0), m_size(0), m_pushed(0) {}
+
+  /** @brief Appends an entry, overwriting the oldest one when full */
+  void push(const T& entry) {
+    m_entries[(m_head + m_size) % Capacity] = entry;
+    ++m_pushed;
+    if (m_size < Capacity) {
+      ++m_size;
+    } else {
+      m_head = (m_head + 1) % Capacity;
+    }
+  }
+
+  /** @brief Gets an entry, 0 being the oldest */
+  const T& at(size_t index) const {
+    return m_entries[(m_head + index) % Capacity];
+  }
+
+  /** @brief Gets the newest entry; the ring must not be empty */
+  const T& back() const {
+    return at(m_size - 1);
+  }
+
+  /** @brief Gets the newest entry for an in-place update; the ring must not be empty */
+  T& back() {
+    return m_entries[(m_head + m_size - 1) % Capacity];
+  }
+
+  size_t size() const {
+    return m_size;
+  }
+
+  bool isEmpty() const {
+    return m_size == 0;
+  }
+
+  bool isFull() const {
+    return m_size == Capacity;
+  }
+
+  /** @brief Gets the number of entries pushed since the last clear(), including overwritten ones */
+  uint64_t pushed() const {
+    return m_pushed;
+  }
+
+  void clear() {
+    m_head = 0;
+    m_size = 0;
+    m_pushed = 0;
+  }
+
+ private:
+  T m_entries[Capacity]; ///< Storage
+  size_t m_head;         ///< Index of the oldest entry
+  size_t m_size;         ///< Entries in use
+  uint64_t m_pushed;     ///< Entries pushed since the last clear()
+};
+
+/**
+ * @brief Time series of one signal at three resolutions, in fixed memory
+ *
+ * Every sample is kept in a raw ring and folded into a 1 s bucket; every
+ * closed 1 s bucket is folded into a 1 min bucket. Buckets keep the minimum,
+ * maximum and mean of their values. Each tier is a ring of fixed capacity, so
+ * the memory of a history is fixed at compile time, and append() does a
+ * constant amount of work per sample. By default the raw tier holds about
+ * half a minute of a 60 Hz signal, the 1 s tier a quarter of an hour and the
+ * 1 min tier eight hours.
+ *
+ * Signals are sample-and-hold: the publisher only sends a value when it
+ * changes. When a sample arrives after a gap longer than a tier's resolution,
+ * one entry holding the previous value is inserted right before it, so a
+ * graph shows a step instead of a slope across the gap.
+ *
+ * @tparam RawCapacity Number of raw samples kept
+ * @tparam SecondCapacity Number of 1 s buckets kept
+ * @tparam MinuteCapacity Number of 1 min buckets kept
+ */
+template <size_t RawCapacity = 2048, size_t SecondCapacity = 900, size_t MinuteCapacity = 480>
+class SignalHistory {
+ public:
+  /** @brief Tier of the history */
+  enum Resolution {
+    Raw,     ///< Every sample
+    Seconds, ///< 1 s buckets
+    Minutes  ///< 1 min buckets
+  };
+
+  static constexpr int64_t kSecondMs = 1000;
+  static constexpr int64_t kMinuteMs = 60 * kSecondMs;
+
+  /// Gap after which the raw tier inserts a hold sample
+  static constexpr int64_t kRawHoldGapMs = kSecondMs;
+
+  SignalHistory() {
+    clear();
+  }
+
+  /**
+   * @brief Records a sample
+   * @param timeMs Time of the sample on a monotonic clock, in milliseconds
+   * @param value Sample value
+   * @return False if the sample is older than the newest one and was dropped
+   */
+  bool append(int64_t timeMs, float value) {
+    if (!m_raw.isEmpty() && timeMs < m_raw.back().timeMs) {
+      return false;
+    }
+
+    if (!m_raw.isEmpty() && timeMs - m_raw.back().timeMs > kRawHoldGapMs) {
+      m_raw.push({timeMs - 1, m_lastValue});
+    }
+    m_raw.push({timeMs, value});
+
+    const int64_t second = timeMs / kSecondMs;
+    if (second != m_second.index) {
+      if (m_second.index >= 0) {
+        closeSecond(m_second.bucket(kSecondMs));
+        if (second > m_second.index + 1) {
+          closeSecond({(second - 1) * kSecondMs, m_lastValue, m_lastValue, m_lastValue});
+        }
+      }
+      m_second.start(second);
+    }
+    m_second.add(value, value, value);
+
+    m_lastValue = value;
+    return true;
+  }
+
+  /** @brief Removes every sample */
+  void clear() {
+    m_raw.clear();
+    m_seconds.clear();
+    m_minutes.clear();
+    m_second.index = -1;
+    m_minute.index = -1;
+    m_lastValue = 0.0f;
+  }
+
+  /** @brief Checks whether no sample was recorded */
+  bool isEmpty() const {
+    return m_raw.isEmpty();
+  }
+
+  /** @brief Gets the newest sample; the history must not be empty */
+  HistoryPoint latest() const {
+    return m_raw.back();
+  }
+
+  /**
+   * @brief Gets the number of entries of a tier
+   * Buckets still being filled are not counted.
+   */
+  size_t count(Resolution resolution) const {
+    switch (resolution) {
+      case Raw:
+        return m_raw.size();
+      case Seconds:
+        return m_seconds.size();
+      default:
+        return m_minutes.size();
+    }
+  }
+
+  /**
+   * @brief Gets the number of entries ever added to a tier
+   * The entries added since a previous call are the newest (difference) ones, as long as the
+   * difference does not exceed count().
+   */
+  uint64_t pushed(Resolution resolution) const {
+    switch (resolution) {
+      case Raw:
+        return m_raw.pushed();
+      case Seconds:
+        return m_seconds.pushed();
+      default:
+        return m_minutes.pushed();
+    }
+  }
+
+  /**
+   * @brief Gets an entry of a tier, 0 being the oldest
+   * Raw samples are returned as buckets whose minimum, maximum and mean are the value.
+   */
+  HistoryBucket bucket(Resolution resolution, size_t index) const {
+    switch (resolution) {
+      case Raw: {
+        const HistoryPoint& point = m_raw.at(index);
+        return {point.timeMs, point.value, point.value, point.value};
+      }
+      case Seconds:
+        return m_seconds.at(index);
+      default:
+        return m_minutes.at(index);
+    }
+  }
+
+  /**
+   * @brief Gets the mean of an entry as a point in the middle of its bucket
+   */
+  HistoryPoint point(Resolution resolution, size_t index) const {
+    const HistoryBucket entry = bucket(resolution, index);
+    return {entry.startMs + duration(resolution) / 2, entry.average};
+  }
+
+  /**
+   * @brief Gets the finest tier that still holds everything since a point in time
+   * @param fromMs Start of the time range to show
+   */
+  Resolution resolutionFor(int64_t fromMs) const {
+    if (!m_raw.isFull() || m_raw.at(0).timeMs <= fromMs) {
+      return Raw;
+    }
+    if (!m_seconds.isFull() || m_seconds.at(0).startMs <= fromMs) {
+      return Seconds;
+    }
+    return Minutes;
+  }
+
+  /**
+   * @brief Finds the first entry of a tier that ends at or after a point in time (binary search)
+   * @return Index of the entry, or count() if every entry ends before it
+   */
+  size_t lowerBound(Resolution resolution, int64_t timeMs) const {
+    size_t first = 0;
+    size_t last = count(resolution);
+    while (first < last) {
+      const size_t middle = first + (last - first) / 2;
+      if (bucket(resolution, middle).startMs + duration(resolution) < timeMs) {
+        first = middle + 1;
+      } else {
+        last = middle;
+      }
+    }
+    return first;
+  }
+
+  /** @brief Gets the time covered by one entry of a tier */
+  static constexpr int64_t duration(Resolution resolution) {
+    return resolution == Raw ? 0 : resolution == Seconds ? kSecondMs : kMinuteMs;
+  }
+
+ private:
+  /**
+   * @brief Bucket being filled
+   */
+  struct Accumulator {
+    int64_t index; ///< Start of the bucket in units of its duration (-1 = none)
+    float min;     ///< Smallest value so far
+    float max;     ///< Largest value so far
+    double sum;    ///< Sum of the values so far
+    int64_t count; ///< Number of values so far
+
+    void start(int64_t bucketIndex) {
+      index = bucketIndex;
+      count = 0;
+      sum = 0.0;
+    }
+
+    void add(float low, float high, float average) {
+      min = count == 0 ? low : std::min(min, low);
+      max = count == 0 ? high : std::max(max, high);
+      sum += average;
+      ++count;
+    }
+
+    HistoryBucket bucket(int64_t durationMs) const {
+      return {index * durationMs, min, max, static_cast<float>(sum / count)};
+    }
+  };
+
+  /**
+   * @brief Stores a closed 1 s bucket and folds it into the 1 min tier
+   */
+  void closeSecond(const HistoryBucket& closed) {
+    m_seconds.push(closed);
+
+    const int64_t minute = closed.startMs / kMinuteMs;
+    if (minute != m_minute.index) {
+      if (m_minute.index >= 0) {
+        m_minutes.push(m_minute.bucket(kMinuteMs));
+        if (minute > m_minute.index + 1) {
+          m_minutes.push({(minute - 1) * kMinuteMs, m_lastValue, m_lastValue, m_lastValue});
+        }
+      }
+      m_minute.start(minute);
+    }
+    m_minute.add(closed.min, closed.max, closed.average);
+  }
+
+  HistoryRing<HistoryPoint, RawCapacity> m_raw;         ///< Every sample
+  HistoryRing<HistoryBucket, SecondCapacity> m_seconds; ///< Closed 1 s buckets
+  HistoryRing<HistoryBucket, MinuteCapacity> m_minutes; ///< Closed 1 min buckets
+  Accumulator m_second;                                 ///< 1 s bucket being filled
+  Accumulator m_minute;                                 ///< 1 min bucket being filled
+  float m_lastValue;                                    ///< Value of the newest sample
+};
+
+#endif // SIGNALHISTORY_HPP
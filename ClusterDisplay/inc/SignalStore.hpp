@@ -0,0 +1,151 @@
+#ifndef SIGNALSTORE_HPP
+#define SIGNALSTORE_HPP
+
+#include <QHash>
+#include <QObject>
+#include <QQmlPropertyMap>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Contiguous store of vehicle signal values indexed by compact ids
+ *
+ * A signal is registered once by name and gets the next free id; from then on
+ * it is a slot of one array of doubles. set() compares, stores and marks the
+ * slot in a dirty bitset: no allocation, lookup or Qt signal per update, so
+ * tens of thousands of updates per second cost next to nothing.
+ *
+ * Notifications are coalesced. The first update after a flush posts one
+ * flush to the event loop, and flush() emits valueChanged() once for every
+ * slot that changed since, with its newest value. A signal updated a hundred
+ * times between two frames is thus announced once.
+ */
+class SignalStore : public QObject {
+  Q_OBJECT
+
+ public:
+  using SignalId = quint16; ///< Index of a signal in the store
+
+  /// Returned when a signal cannot be registered or found
+  static constexpr SignalId kInvalidSignal = 0xffff;
+
+  /// Signals the store holds at most
+  static constexpr int kMaxSignals = 1024;
+
+  explicit SignalStore(QObject* parent = nullptr);
+
+  /**
+   * @brief Registers a signal, or finds it if the name is registered already
+   * @param name Unique name, also the key of the signal in a SignalPropertyMap
+   * @param initial Value until the first set()
+   * @return Id of the signal, or kInvalidSignal if the store is full
+   */
+  SignalId registerSignal(const QString& name, double initial = 0.0);
+
+  /**
+   * @brief Finds a signal by name
+   * @return Id of the signal, or kInvalidSignal if it is not registered
+   */
+  SignalId idOf(const QString& name) const;
+
+  /** @brief Gets the name of a signal */
+  QString nameOf(SignalId id) const;
+
+  /** @brief Gets the number of registered signals */
+  int count() const {
+    return m_values.size();
+  }
+
+  /** @brief Gets the value of a signal; the id must be registered */
+  double value(SignalId id) const {
+    return m_values.at(id);
+  }
+
+  /**
+   * @brief Updates a signal
+   * @return True if the value changed
+   */
+  bool set(SignalId id, double value) {
+    if (id >= m_values.size() || m_values.at(id) == value) {
+      return false;
+    }
+    m_values.data()[id] = value;
+    ++m_updateCount;
+    markDirty(id);
+    return true;
+  }
+
+  /** @brief Gets the number of updates that changed a value */
+  qint64 updateCount() const {
+    return m_updateCount;
+  }
+
+  /** @brief Checks whether a change has not been announced yet */
+  bool hasPendingChanges() const {
+    return m_flushPending;
+  }
+
+ public slots:
+  /**
+   * @brief Announces every change since the previous flush
+   * Called from the event loop after changes; may be called directly to announce them now.
+   */
+  void flush();
+
+ signals:
+  /** @brief Emitted by flush() once per changed signal */
+  void valueChanged(SignalStore::SignalId id, double value);
+
+  /** @brief Emitted when a signal is registered */
+  void signalRegistered(SignalStore::SignalId id);
+
+ private:
+  /**
+   * @brief Marks a slot as changed and schedules a flush for the first change
+   */
+  void markDirty(SignalId id) {
+    m_dirty.data()[id >> 6] |= quint64(1) << (id & 63);
+    if (!m_flushPending) {
+      m_flushPending = true;
+      QMetaObject::invokeMethod(this, &SignalStore::flush, Qt::QueuedConnection);
+    }
+  }
+
+  QVector<double> m_values;       ///< Values by id
+  QVector<quint64> m_dirty;       ///< Bit per id changed since the last flush
+  QVector<QString> m_names;       ///< Names by id
+  QHash<QString, SignalId> m_ids; ///< Ids by name
+  qint64 m_updateCount;           ///< Updates that changed a value
+  bool m_flushPending;            ///< A flush is scheduled
+};
+
+/**
+ * @brief Read-only QML view of a SignalStore, one property per signal
+ *
+ * `map.motorTemperature` binds like a property: each key has its own change
+ * notification, and only the keys whose value changed are updated, once per
+ * SignalStore::flush(). Signals registered later appear as new keys. Writes
+ * from QML are ignored.
+ */
+class SignalPropertyMap : public QQmlPropertyMap {
+  Q_OBJECT
+
+ public:
+  /**
+   * @brief Creates a view with every signal registered so far
+   * @param store Viewed store (must outlive this object)
+   * @param parent The parent QObject
+   */
+  explicit SignalPropertyMap(SignalStore* store, QObject* parent = nullptr);
+
+ protected:
+  /**
+   * @brief Keeps the store value when QML writes a key
+   */
+  QVariant updateValue(const QString& key, const QVariant& input) override;
+
+ private:
+  SignalStore* m_store; ///< Viewed store
+};
+
+#endif // SIGNALSTORE_HPP
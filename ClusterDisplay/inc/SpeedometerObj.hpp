@@ -4,16 +4,26 @@
 #include <QObject>
 #include <QQmlEngine>
 
-#include "ZmqSubscriber.hpp"
-
-#define SPEEDOMETER_ADDRESS "tcp://localhost:5555"
-
-class SpeedometerObj : public ZmqSubscriber {
+#include "ClusterSignalHub.hpp"
+
+/**
+ * @brief Speed value fed by the "speed" key of the cluster signal hub
+ *
+ * The speed is received in mm/s and exposed in km/h multiplied by 10.
+ */
+class SpeedometerObj : public QObject {
   Q_OBJECT
   Q_PROPERTY(double speed READ speed WRITE setSpeed NOTIFY speedChanged FINAL)
 
  public:
   explicit SpeedometerObj(QObject* parent = nullptr);
+
+  /**
+   * @brief Constructs a speedometer listening to the hub's "speed" values
+   * @param hub The signal hub owning the subscription (must outlive this object)
+   * @param parent The parent QObject
+   */
+  explicit SpeedometerObj(ClusterSignalHub* hub, QObject* parent = nullptr);
   ~SpeedometerObj();
 
   double speed(void) const;
@@ -23,10 +33,12 @@ class SpeedometerObj : public ZmqSubscriber {
   void speedChanged(double);
 
  protected:
-  void _handleMsg(QString& message);
+  void _handleMsg(const QString& message);
 
  private:
   double m_speed;
+  ClusterSignalHub* m_hub;
+  int m_listenerId;
 };
 
 #endif // SPEEDOMETEROBJ_HPP
@@ -0,0 +1,136 @@
+#ifndef STALLWATCHDOG_HPP
+#define STALLWATCHDOG_HPP
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "FlightRecorder.hpp"
+
+class QQuickWindow;
+
+/**
+ * @brief Detects GUI-thread and render-thread stalls from a thread of its own
+ *
+ * The GUI thread proves it is alive through a timer that beats several times
+ * per threshold. The render thread only runs while a frame is produced, so it
+ * is checked per frame instead: a synchronization or a render pass that has
+ * been running for longer than the threshold is a stall. A synchronization
+ * that finds nothing changed is not followed by a render pass or a swap, so
+ * the two phases are watched separately and the time between them counts as
+ * idle. An idle render thread is never reported.
+ *
+ * A stall is recorded in the FlightRecorder, which is then dumped to disk,
+ * and reported once per stall through stallDetected() when the GUI thread
+ * is responsive again.
+ */
+class StallWatchdog : public QObject {
+  Q_OBJECT
+
+ public:
+  /** @brief Monitored thread */
+  enum Channel { GuiThread, RenderThread };
+  Q_ENUM(Channel)
+
+  /**
+   * @brief Creates a stopped watchdog
+   * @param recorder Recorder that receives stall events and is dumped on a stall (may be null)
+   * @param thresholdMs Minimum blocking time reported as a stall
+   * @param parent The parent QObject
+   */
+  explicit StallWatchdog(FlightRecorder* recorder, int thresholdMs = 500,
+                         QObject* parent = nullptr);
+  virtual ~StallWatchdog();
+
+  /**
+   * @brief Starts the GUI heartbeat and the monitoring thread
+   * Must be called from the GUI thread.
+   */
+  void start();
+
+  /**
+   * @brief Stops monitoring and joins the monitoring thread
+   */
+  void stop();
+
+  /**
+   * @brief Checks whether the watchdog is monitoring
+   */
+  bool isRunning() const;
+
+  /**
+   * @brief Gets the stall threshold in milliseconds
+   */
+  int thresholdMs() const;
+
+  /**
+   * @brief Gets the number of stalls detected so far
+   */
+  int stallCount() const;
+
+  /**
+   * @brief Monitors the render thread of a window and records its frame times
+   * @param window The window whose synchronization and swaps are tracked
+   */
+  void attachWindow(QQuickWindow* window);
+
+  /**
+   * @brief Marks the start of a scene graph synchronization, the first phase of a frame
+   * (any thread)
+   */
+  void renderSyncStarted();
+
+  /**
+   * @brief Marks the end of a synchronization; a render pass may or may not follow (any thread)
+   */
+  void renderSyncFinished();
+
+  /**
+   * @brief Marks the start of a render pass (any thread)
+   */
+  void renderFrameStarted();
+
+  /**
+   * @brief Marks the end of a render-thread frame (any thread)
+   */
+  void renderFrameFinished();
+
+ signals:
+  /**
+   * @brief Emitted on the GUI thread once the stalled thread has been detected
+   * @param channel Thread that stalled
+   * @param durationMs Blocking time when the stall was detected
+   * @param dumpPath Flight recorder dump written for the stall (empty if none)
+   */
+  void stallDetected(StallWatchdog::Channel channel, qint64 durationMs, const QString& dumpPath);
+
+ private:
+  /**
+   * @brief Monitoring loop of the watchdog thread
+   */
+  void run();
+
+  /**
+   * @brief Records, dumps and reports a stall (watchdog thread)
+   */
+  void reportStall(Channel channel, qint64 durationNs);
+
+  FlightRecorder* m_recorder;          ///< Recorder for stall events and dumps
+  const qint64 m_thresholdNs;          ///< Minimum blocking time reported as a stall
+  QTimer m_heartbeatTimer;             ///< GUI-thread heartbeat
+  std::atomic<qint64> m_guiBeatNs;     ///< Last GUI heartbeat
+  std::atomic<qint64> m_renderStartNs; ///< Start of the current phase (0 when idle)
+  std::atomic<qint64> m_frameStartNs;  ///< Start of the current frame (0 when none)
+  std::atomic<qint64> m_lastSwapNs;    ///< Time of the previous swap
+  std::atomic<int> m_stallCount;       ///< Stalls detected so far
+  std::thread m_thread;                ///< Monitoring thread
+  std::mutex m_mutex;                  ///< Guards m_running for the condition variable
+  std::condition_variable m_wakeUp;    ///< Interrupts the monitoring wait on stop()
+  bool m_running;                      ///< Monitoring thread should keep running
+};
+
+#endif // STALLWATCHDOG_HPP
@@ -0,0 +1,101 @@
+#ifndef STARTUPPROFILER_HPP
+#define STARTUPPROFILER_HPP
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+class QQuickWindow;
+
+/**
+ * @brief Records cold-start milestones and reports the time-to-first-frame breakdown
+ *
+ * The profiler is created as early as possible in main() and collects named
+ * milestones (application created, model ready, QML loaded, ...). Once the
+ * first frame has been presented by the attached window, it emits
+ * firstFrameRendered() and reportReady() with a table of the phase durations.
+ *
+ * Time spent before main() (dynamic loading, static initialisation) is taken
+ * from the process start time on Linux and reported as a separate phase.
+ */
+class StartupProfiler : public QObject {
+  Q_OBJECT
+
+ public:
+  /**
+   * @brief A named startup milestone
+   */
+  struct Milestone {
+    QString name;     ///< Milestone label
+    qint64 elapsedNs; ///< Time since the profiler was created
+  };
+
+  explicit StartupProfiler(QObject* parent = nullptr);
+  virtual ~StartupProfiler();
+
+  /**
+   * @brief Record a milestone at the current time
+   * @param name Label of the phase that just finished
+   */
+  void mark(const QString& name);
+
+  /**
+   * @brief Watch a window for its first presented frame
+   * @param window The window whose first frameSwapped() completes the report
+   */
+  void attachWindow(QQuickWindow* window);
+
+  /**
+   * @brief Check whether the first frame has been presented
+   * @return True once markFirstFrame() has run
+   */
+  bool isComplete() const;
+
+  /**
+   * @brief Get the recorded milestones in chronological order
+   */
+  const QVector<Milestone>& milestones() const;
+
+  /**
+   * @brief Get the time between process start and profiler creation
+   * @return Milliseconds spent before main(), or -1 if unavailable on this platform
+   */
+  qint64 preMainMs() const;
+
+  /**
+   * @brief Format the startup breakdown as a human-readable table
+   * @return Multi-line report with per-phase and cumulative durations
+   */
+  QString report() const;
+
+ public slots:
+  /**
+   * @brief Record the first presented frame and publish the report
+   * Called automatically for an attached window; later calls are ignored.
+   */
+  void markFirstFrame();
+
+ signals:
+  /**
+   * @brief Emitted once, on the GUI thread, after the first frame was presented
+   */
+  void firstFrameRendered();
+
+  /**
+   * @brief Emitted together with firstFrameRendered()
+   * @param report The formatted startup breakdown
+   */
+  void reportReady(const QString& report);
+
+ private:
+  QElapsedTimer m_clock;                     ///< Monotonic clock started at construction
+  QVector<Milestone> m_milestones;           ///< Milestones recorded so far
+  qint64 m_preMainMs;                        ///< Process age at construction (-1 if unknown)
+  std::atomic<qint64> m_firstFrameNs;        ///< Swap time captured on the render thread
+  bool m_complete;                           ///< First frame recorded
+  QMetaObject::Connection m_frameConnection; ///< Connection to the window's frameSwapped
+};
+
+#endif // STARTUPPROFILER_HPP
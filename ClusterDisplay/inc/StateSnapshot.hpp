@@ -0,0 +1,129 @@
+#ifndef STATESNAPSHOT_HPP
+#define STATESNAPSHOT_HPP
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+
+#include "ClusterModel.hpp"
+#include "WriteThrottle.hpp"
+
+/**
+ * @brief Crash-safe, memory-mapped copy of the slowly changing ClusterModel values
+ *
+ * Battery, charging, odometer, driving mode and speed limits are kept in a small
+ * file so that the next start can show them before the first frame instead of
+ * the constructor defaults. Restored values are flagged in
+ * ClusterModel::provisionalFields until live data confirms them.
+ *
+ * The file holds two checksummed slots (A/B), each in its own 512-byte sector.
+ * A write always replaces the older slot, so a power loss during a write
+ * leaves the other one intact. Writes only copy into the mapping and schedule
+ * an asynchronous writeback; a WriteThrottle limits them to one per minimum
+ * write interval and they are skipped when nothing persisted has changed,
+ * which keeps the eMMC wear low while driving.
+ */
+class StateSnapshot : public QObject {
+  Q_OBJECT
+
+ public:
+  /**
+   * @brief Persisted values, with a fixed layout independent of the model
+   */
+  struct Record {
+    qint32 battery;          ///< Battery level percentage (0-100)
+    qint32 odometer;         ///< Total distance traveled
+    qint32 speedLimitSignal; ///< Detected speed limit value
+    qint32 lastSpeedLimit;   ///< Last valid speed limit
+    quint8 charging;         ///< Charging state (0 or 1)
+    quint8 drivingMode;      ///< ClusterModel::DrivingMode
+    quint8 reserved[2];      ///< Always zero
+  };
+
+  /**
+   * @brief Creates a snapshot that is not yet backed by a file
+   * @param model Model that is restored and whose changes are persisted
+   * @param minWriteIntervalMs Minimum time between two writes
+   * @param parent The parent QObject
+   */
+  explicit StateSnapshot(ClusterModel* model, int minWriteIntervalMs = 5000,
+                         QObject* parent = nullptr);
+
+  /**
+   * @brief Writes pending changes and waits for them to reach the storage
+   */
+  virtual ~StateSnapshot();
+
+  /**
+   * @brief Opens or creates the snapshot file and maps it
+   * @param path File path; missing parent directories are created
+   * @return False if the file cannot be created or mapped
+   */
+  bool open(const QString& path);
+
+  /**
+   * @brief Checks whether a file is mapped
+   */
+  bool isOpen() const;
+
+  /**
+   * @brief Applies the newest valid slot to the model and marks its values provisional
+   * Call before the first frame and before live data is subscribed.
+   * @return False if no slot holds a valid snapshot
+   */
+  bool restore();
+
+  /**
+   * @brief Writes pending changes now, ignoring the minimum write interval
+   */
+  void flush();
+
+  /**
+   * @brief Gets the sequence number of the newest valid or written slot (0 = none)
+   */
+  quint64 sequence() const;
+
+  /**
+   * @brief Gets the number of slots written since the file was opened
+   */
+  int writeCount() const;
+
+  /**
+   * @brief Gets the file name used inside the state directory
+   */
+  static QString defaultFileName();
+
+ signals:
+  /**
+   * @brief Emitted after a slot has been written
+   * @param sequence Sequence number of the new slot
+   */
+  void written(quint64 sequence);
+
+ private slots:
+  /**
+   * @brief Requests a write from the throttle while a file is mapped
+   */
+  void scheduleWrite();
+
+ private:
+  /**
+   * @brief Copies the current model values into a record
+   */
+  Record capture() const;
+
+  /**
+   * @brief Writes a record into the older slot if it differs from the last one
+   */
+  void write();
+
+  ClusterModel* m_model;    ///< Model that is restored and persisted
+  WriteThrottle m_throttle; ///< Limits the rate of writes
+  QFile m_file;             ///< Snapshot file
+  uchar* m_map;             ///< Mapping of both slots (null when closed)
+  quint64 m_sequence;       ///< Sequence number of the newest slot
+  Record m_lastRecord;      ///< Contents of the newest slot
+  int m_writeCount;         ///< Slots written since open()
+};
+
+#endif // STATESNAPSHOT_HPP
@@ -0,0 +1,171 @@
+#ifndef STREAMINGSTATISTICS_HPP
+#define STREAMINGSTATISTICS_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Count, mean, variance and extremes of a stream of values
+ *
+ * Uses Welford's update, which is numerically stable for long streams and
+ * needs constant time and memory per value.
+ */
+class RunningStatistics {
+ public:
+  RunningStatistics() {
+    reset();
+  }
+
+  /** @brief Adds a value */
+  void add(double value) {
+    ++m_count;
+    const double delta = value - m_mean;
+    m_mean += delta / static_cast<double>(m_count);
+    m_m2 += delta * (value - m_mean);
+    m_min = m_count == 1 ? value : std::fmin(m_min, value);
+    m_max = m_count == 1 ? value : std::fmax(m_max, value);
+  }
+
+  /** @brief Forgets every value */
+  void reset() {
+    m_count = 0;
+    m_mean = 0.0;
+    m_m2 = 0.0;
+    m_min = 0.0;
+    m_max = 0.0;
+  }
+
+  /** @brief Gets the number of values */
+  int64_t count() const {
+    return m_count;
+  }
+
+  /** @brief Gets the mean (0 without values) */
+  double mean() const {
+    return m_mean;
+  }
+
+  /** @brief Gets the population variance (0 with fewer than two values) */
+  double variance() const {
+    return m_count > 1 ? m_m2 / static_cast<double>(m_count) : 0.0;
+  }
+
+  /** @brief Gets the population standard deviation */
+  double standardDeviation() const {
+    return std::sqrt(variance());
+  }
+
+  /** @brief Gets the smallest value (0 without values) */
+  double min() const {
+    return m_min;
+  }
+
+  /** @brief Gets the largest value (0 without values) */
+  double max() const {
+    return m_max;
+  }
+
+ private:
+  int64_t m_count; ///< Values added
+  double m_mean;   ///< Mean so far
+  double m_m2;     ///< Sum of squared differences from the mean
+  double m_min;    ///< Smallest value
+  double m_max;    ///< Largest value
+};
+
+/**
+ * @brief Maximum of the values of the last time window
+ *
+ * A monotonic deque: only values that can still become the maximum are kept,
+ * in decreasing order, so the maximum is always the oldest entry. Each value
+ * is added and removed once, which is amortized constant time per value.
+ *
+ * Times are rounded down to the resolution and values of the same slot are
+ * merged, so the deque never holds more than window / resolution + 1 entries.
+ * It lives in a fixed ring of Capacity entries; if Capacity is smaller than
+ * that, the oldest candidates are dropped early.
+ *
+ * @tparam Capacity Number of entries of the ring
+ */
+template <size_t Capacity>
+class WindowedMaximum {
+  static_assert(Capacity > 0, "A windowed maximum needs room for at least one entry");
+
+ public:
+  /**
+   * @brief Creates an empty window
+   * @param windowMs Length of the window in milliseconds
+   * @param resolutionMs Slot length in milliseconds
+   */
+  WindowedMaximum(int64_t windowMs, int64_t resolutionMs)
+      : m_windowMs(windowMs), m_resolutionMs(resolutionMs > 0 ? resolutionMs : 1) {
+    reset();
+  }
+
+  /**
+   * @brief Adds a value
+   * @param timeMs Time of the value; must not be older than the previous one
+   */
+  void add(int64_t timeMs, double value) {
+    const int64_t slot = timeMs - timeMs % m_resolutionMs;
+    expire(timeMs);
+
+    // Smaller values can never be the maximum again once this one is in the window
+    while (m_size > 0 && entry(m_size - 1).value <= value) {
+      --m_size;
+    }
+    if (m_size > 0 && entry(m_size - 1).slotMs == slot) {
+      return;
+    }
+    if (m_size == Capacity) {
+      m_head = (m_head + 1) % Capacity;
+      --m_size;
+    }
+    m_entries[(m_head + m_size) % Capacity] = {slot, value};
+    ++m_size;
+  }
+
+  /**
+   * @brief Gets the maximum of the window ending at a point in time
+   * @return The maximum, or 0 if no value is in the window
+   */
+  double maximum(int64_t nowMs) {
+    expire(nowMs);
+    return m_size > 0 ? entry(0).value : 0.0;
+  }
+
+  /** @brief Forgets every value */
+  void reset() {
+    m_head = 0;
+    m_size = 0;
+  }
+
+ private:
+  /**
+   * @brief A candidate maximum
+   */
+  struct Entry {
+    int64_t slotMs; ///< Start of the slot
+    double value;   ///< Largest value of the slot
+  };
+
+  const Entry& entry(size_t index) const {
+    return m_entries[(m_head + index) % Capacity];
+  }
+
+  void expire(int64_t nowMs) {
+    while (m_size > 0 && entry(0).slotMs + m_resolutionMs <= nowMs - m_windowMs) {
+      m_head = (m_head + 1) % Capacity;
+      --m_size;
+    }
+  }
+
+  Entry m_entries[Capacity]; ///< Ring storage
+  size_t m_head;             ///< Index of the oldest entry
+  size_t m_size;             ///< Entries in use
+  int64_t m_windowMs;        ///< Length of the window
+  int64_t m_resolutionMs;    ///< Slot length
+};
+
+#endif // STREAMINGSTATISTICS_HPP
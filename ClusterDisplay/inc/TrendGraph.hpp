@@ -0,0 +1,151 @@
+#ifndef TRENDGRAPH_HPP
+#define TRENDGRAPH_HPP
+
+#include <QColor>
+#include <QElapsedTimer>
+#include <QQuickItem>
+#include <QTimer>
+
+#include "SignalHistory.hpp"
+
+/**
+ * @brief Line graph of the recent history of one signal
+ *
+ * Every change of `value` is appended to a SignalHistory in constant time;
+ * the item never keeps more than the history's fixed memory. Each tier of the
+ * history is also folded, as entries arrive, into columns of one time slot
+ * each (about timeSpan / kSlotsPerSpan): for raw samples a column keeps the
+ * sample farthest from the previous column, so peaks survive; for the 1 s and
+ * 1 min buckets it keeps their mean and the min/max envelope. When drawn, the
+ * columns of the finest tier that covers the last `timeSpan` seconds are the
+ * vertices, and the newest value is held up to the right edge.
+ *
+ * The geometry is allocated once and holds times relative to an origin;
+ * scrolling only moves a transform. A new sample appends or rewrites the last
+ * vertices and shifts out the ones that left the tier. While no sample
+ * arrives, the graph is repainted each time it scrolled by one slot, until
+ * the newest sample has left it.
+ *
+ * The graph is a geometry node, which the software renderer does not draw.
+ */
+class TrendGraph : public QQuickItem {
+  Q_OBJECT
+  QML_ELEMENT
+
+  Q_PROPERTY(qreal value READ value WRITE setValue NOTIFY valueChanged)
+  Q_PROPERTY(int timeSpan READ timeSpan WRITE setTimeSpan NOTIFY timeSpanChanged)
+  Q_PROPERTY(qreal minimum READ minimum WRITE setMinimum NOTIFY minimumChanged)
+  Q_PROPERTY(qreal maximum READ maximum WRITE setMaximum NOTIFY maximumChanged)
+  Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+
+ public:
+  using History = SignalHistory<>;
+
+  /// Vertices of the line, including the held newest value
+  static constexpr int kMaxPoints = 256;
+
+  /// Time slots in one time span; the rest of the vertices are for partly shown slots
+  static constexpr int kSlotsPerSpan = kMaxPoints - 4;
+
+  /**
+   * @brief One vertex of the graph
+   */
+  struct PlotPoint {
+    int64_t timeMs; ///< Time of the vertex in milliseconds
+    float value;    ///< Value drawn by the line
+    float min;      ///< Bottom of the envelope (value for raw samples)
+    float max;      ///< Top of the envelope (value for raw samples)
+  };
+
+  explicit TrendGraph(QQuickItem* parent = nullptr);
+  virtual ~TrendGraph();
+
+  // Getters
+  qreal value() const;
+  int timeSpan() const;
+  qreal minimum() const;
+  qreal maximum() const;
+  QColor color() const;
+
+  // Setters
+  void setValue(qreal value);
+  void setTimeSpan(int seconds);
+  void setMinimum(qreal minimum);
+  void setMaximum(qreal maximum);
+  void setColor(const QColor& color);
+
+  /**
+   * @brief Records a sample with an explicit time (used by setValue() with the item's clock)
+   */
+  void appendSample(qint64 timeMs, qreal value);
+
+  /**
+   * @brief Get the recorded history
+   */
+  const History& history() const;
+
+  /**
+   * @brief Compute the points drawn for the time span ending at a point in time
+   * @param nowMs Right edge of the graph on the clock used by appendSample()
+   * @param out Receives at most kMaxPoints points, oldest first
+   * @return Number of points written
+   */
+  int plot(qint64 nowMs, PlotPoint* out) const;
+
+  /**
+   * @brief Get the current time on the clock used by setValue()
+   */
+  qint64 now() const;
+
+ signals:
+  void valueChanged(qreal value);
+  void timeSpanChanged(int seconds);
+  void minimumChanged(qreal minimum);
+  void maximumChanged(qreal maximum);
+  void colorChanged(const QColor& color);
+
+ protected:
+  QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+
+ private:
+  /**
+   * @brief Vertex being built from the entries of one time slot
+   */
+  struct Column {
+    int64_t slot;    ///< Start time of the slot divided by its width
+    PlotPoint point; ///< Vertex drawn for the slot
+    float reference; ///< Raw samples: value the chosen sample is farthest from
+    double sum;      ///< Buckets: sum of their means
+    int64_t timeSum; ///< Buckets: sum of their middle times
+    int64_t count;   ///< Entries folded into the slot
+  };
+
+  /**
+   * @brief Columns of one tier of the history
+   */
+  struct Tier {
+    HistoryRing<Column, kMaxPoints - 1> columns; ///< Newest columns, enough for one span
+    uint64_t consumed;                           ///< Entries of the tier folded so far
+  };
+
+  void foldNewEntries(History::Resolution resolution);
+  void fold(Tier& tier, History::Resolution resolution, const HistoryBucket& entry) const;
+  void rebuildColumns();
+  void scroll();
+  qint64 spanMs() const;
+
+  qreal m_value;         ///< Newest value
+  int m_timeSpan;        ///< Seconds shown
+  qreal m_minimum;       ///< Value at the bottom edge
+  qreal m_maximum;       ///< Value at the top edge
+  QColor m_color;        ///< Line color
+  bool m_colorDirty;     ///< Materials must be updated
+  History m_history;     ///< Recorded samples
+  qint64 m_slotMs;       ///< Width of a raw column
+  Tier m_tiers[3];       ///< Columns per tier, indexed by History::Resolution
+  quint64 m_generation;  ///< Incremented whenever the columns are rebuilt
+  QElapsedTimer m_clock; ///< Time base of setValue()
+  QTimer m_scrollTimer;  ///< Repaints once the graph scrolled by one slot without a sample
+};
+
+#endif // TRENDGRAPH_HPP
@@ -0,0 +1,131 @@
+#ifndef TRIPCOMPUTER_HPP
+#define TRIPCOMPUTER_HPP
+
+#include <QtGlobal>
+
+#include "StreamingStatistics.hpp"
+
+/**
+ * @brief Trip statistics computed incrementally from the speed, odometer and battery stream
+ *
+ * Every input updates running sums in constant time and memory; no history
+ * is kept or rescanned:
+ * - moving time and average speed integrate the held speed between samples,
+ *   since the publisher only sends a value when it changes
+ * - the distance integrates the speed until odometer steps arrive and then
+ *   adds the steps on top of what was integrated so far; a step backwards (a
+ *   restarted publisher) or an implausible jump is not counted
+ * - the maximum speed is kept for the whole trip, with Welford statistics of
+ *   the moving speed, and for the last minute in a monotonic deque
+ * - the energy used sums the battery drops while not charging; the level is
+ *   only followed upwards while charging, so jitter is not counted
+ *
+ * A trip starts with the display, on reset(), and after the vehicle was gone
+ * for longer than the ignition-off time: when a sample arrives that long after
+ * interrupt(), the trip is reset first.
+ */
+class TripComputer {
+ public:
+  /// Speed above which the vehicle counts as moving
+  static constexpr int kMovingSpeedMmPerSecond = 100;
+
+  /// Time of the recent maximum speed window
+  static constexpr qint64 kRecentWindowMs = 60000;
+
+  /// Largest odometer step counted as distance driven
+  static constexpr qint64 kMaxOdometerStep = 1000;
+
+  /// Default time without data after which the next sample starts a new trip
+  static constexpr qint64 kDefaultIgnitionOffMs = 300000;
+
+  /**
+   * @brief Creates a computer with an empty trip
+   * @param ignitionOffMs Time after interrupt() that starts a new trip
+   */
+  explicit TripComputer(qint64 ignitionOffMs = kDefaultIgnitionOffMs);
+
+  /**
+   * @brief Starts a new trip
+   * @param timeMs Start of the trip on the clock of the samples
+   */
+  void reset(qint64 timeMs);
+
+  /** @brief Adds a speed sample in mm/s */
+  void addSpeed(qint64 timeMs, int mmPerSecond);
+
+  /** @brief Adds an odometer sample in meters */
+  void addOdometer(qint64 timeMs, qint64 meters);
+
+  /** @brief Adds a battery sample in percent */
+  void addBattery(qint64 timeMs, int percent);
+
+  /** @brief Sets whether the battery is charging */
+  void setCharging(qint64 timeMs, bool charging);
+
+  /**
+   * @brief Accounts for the held speed up to a point in time
+   * Called periodically, so the moving time advances while the speed does not change.
+   */
+  void advance(qint64 timeMs);
+
+  /**
+   * @brief Stops integrating until the next speed sample (the data link went down)
+   */
+  void interrupt(qint64 timeMs);
+
+  /** @brief Gets the number of trips started, including the first one */
+  int tripCount() const;
+
+  /** @brief Gets the distance of the trip in meters */
+  qint64 distance() const;
+
+  /** @brief Gets the time spent moving in milliseconds */
+  qint64 movingTimeMs() const;
+
+  /** @brief Gets the average speed while moving in mm/s */
+  double averageSpeed() const;
+
+  /** @brief Gets the maximum speed of the trip in mm/s */
+  double maxSpeed() const;
+
+  /** @brief Gets the maximum speed of the last minute in mm/s */
+  double recentMaxSpeed(qint64 nowMs);
+
+  /** @brief Gets the statistics of the speed samples taken while moving */
+  const RunningStatistics& movingSpeedStatistics() const;
+
+  /** @brief Gets the battery used in percentage points */
+  int energyUsed() const;
+
+  /**
+   * @brief Gets the battery used per kilometer
+   * @return Percentage points per km, or 0 below 100 m
+   */
+  double energyPerKilometer() const;
+
+ private:
+  /**
+   * @brief Starts a new trip if the vehicle was gone for the ignition-off time
+   */
+  void checkIgnition(qint64 timeMs);
+
+  qint64 m_ignitionOffMs;              ///< Gap that ends a trip
+  int m_tripCount;                     ///< Trips started
+  qint64 m_interruptedAt;              ///< Time of interrupt() (-1 = running)
+  qint64 m_speedTime;                  ///< Time up to which the speed is integrated (-1 = none)
+  int m_speed;                         ///< Held speed in mm/s
+  double m_movingIntegral;             ///< Sum of speed * time while moving, in mm/s * ms
+  qint64 m_movingTimeMs;               ///< Time spent moving
+  double m_integratedDistance;         ///< Distance from the speed, in meters
+  double m_integratedAtOdometer;       ///< m_integratedDistance at the newest odometer value
+  qint64 m_odometerLast;               ///< Newest odometer value (-1 = none)
+  qint64 m_odometerDistance;           ///< Distance from the odometer, in meters
+  bool m_odometerSeen;                 ///< An odometer step was counted in this trip
+  RunningStatistics m_movingSpeeds;    ///< Speed samples while moving
+  WindowedMaximum<64> m_recentMaximum; ///< Maximum speed per second of the last minute
+  int m_batteryReference;              ///< Level drops are counted from (-1 = none)
+  bool m_charging;                     ///< Battery is charging
+  int m_energyUsed;                    ///< Battery drops while not charging
+};
+
+#endif // TRIPCOMPUTER_HPP
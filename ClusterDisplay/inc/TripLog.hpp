@@ -0,0 +1,195 @@
+#ifndef TRIPLOG_HPP
+#define TRIPLOG_HPP
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief File format of the columnar trip log, shared by TripLogWriter and the cluster-log tool
+ *
+ * A log is a 16-byte FileHeader followed by chunks. Each chunk is a
+ * ChunkHeader, which states the time range and the signals the chunk covers,
+ * and a zlib-compressed payload (qCompress()). The payload holds one column
+ * per signal:
+ *
+ *     signal id (1 byte), sample count (varint), column size (varint),
+ *     then per sample: time delta (zigzag varint), value delta (zigzag varint)
+ *
+ * Deltas are taken from the previous sample of the same column; the first
+ * sample of a column is relative to the chunk start and 0. Signals change
+ * slowly and by small steps, so most samples take two or three bytes before
+ * compression. A reader finds a time range by walking the chunk headers
+ * without decompressing anything, and skips the columns it does not need.
+ */
+namespace TripLog {
+
+/** @brief Logged model values; the numbers are stored in the file and must not change */
+enum Signal : quint8 {
+  Speed,          ///< ClusterModel::speed (km/h * 10)
+  Battery,        ///< ClusterModel::battery (%)
+  Charging,       ///< ClusterModel::charging (0/1)
+  Odometer,       ///< ClusterModel::odometer (m)
+  DrivingMode,    ///< ClusterModel::drivingModeType
+  ObjectAlert,    ///< ClusterModel::objectAlert (0/1)
+  EmergencyBrake, ///< ClusterModel::emergencyBrakeActive (0/1)
+  LaneSide,       ///< ClusterModel::laneSide
+  SpeedLimit,     ///< ClusterModel::speedLimitSignal
+  SignKind,       ///< ClusterModel::signKind
+  AlertSeverity,  ///< ClusterModel::alertSeverity
+  LinkStatus,     ///< ClusterModel::linkStatus
+  EstimatedRange, ///< ClusterModel::estimatedRange (m)
+  SignalCount
+};
+
+/**
+ * @brief A value of a signal; the time is in milliseconds since the start of the log
+ */
+struct Sample {
+  qint64 timeMs; ///< Time since the log was opened
+  qint64 value;  ///< Value of the signal
+};
+
+/**
+ * @brief Start of a log file
+ */
+struct FileHeader {
+  quint32 magic;       ///< kFileMagic
+  quint16 version;     ///< kVersion
+  quint16 reserved;    ///< Always zero
+  qint64 startEpochMs; ///< Wall-clock time of log time 0, in ms since the Unix epoch
+};
+
+/**
+ * @brief Start of a chunk, followed by payloadSize bytes of compressed columns
+ */
+struct ChunkHeader {
+  quint32 magic;       ///< kChunkMagic
+  quint32 payloadSize; ///< Compressed bytes following the header
+  quint32 sampleCount; ///< Samples of all columns
+  quint16 signalMask;  ///< Bit per Signal present in the chunk
+  quint16 checksum;    ///< CRC-16 of the compressed payload
+  qint64 firstMs;      ///< Time of the oldest sample
+  qint64 lastMs;       ///< Time of the newest sample
+};
+
+constexpr quint32 kFileMagic = 0x314c5443;  ///< "CTL1" in little endian
+constexpr quint32 kChunkMagic = 0x4b4e4843; ///< "CHNK" in little endian
+constexpr quint16 kVersion = 1;
+
+/**
+ * @brief Gets the name of a signal as used by the cluster-log tool
+ */
+const char* signalName(Signal signal);
+
+/**
+ * @brief Finds a signal by name
+ * @return False if no signal has that name
+ */
+bool signalFromName(const QString& name, Signal* signal);
+
+/**
+ * @brief Encodes columns into an uncompressed chunk payload
+ * @param columns One column per signal, samples in time order; empty columns are left out
+ * @param firstMs Chunk start the first sample of each column is relative to
+ */
+QByteArray encodeColumns(const QVector<Sample> columns[SignalCount], qint64 firstMs);
+
+/**
+ * @brief Decodes an uncompressed chunk payload
+ * @param payload Payload produced by encodeColumns()
+ * @param firstMs Chunk start used when encoding
+ * @param wanted Bit per Signal to decode; other columns are skipped
+ * @param columns Receives the samples, appended to each column
+ * @return False if the payload is malformed
+ */
+bool decodeColumns(const QByteArray& payload, qint64 firstMs, quint16 wanted,
+                   QVector<Sample> columns[SignalCount]);
+
+/**
+ * @brief Summary of one signal over a time range
+ */
+struct Summary {
+  qint64 count;        ///< Samples in the range
+  qint64 min;          ///< Smallest value
+  qint64 max;          ///< Largest value
+  double mean;         ///< Mean of the samples
+  double timeWeighted; ///< Mean of the held value over the range
+  qint64 firstMs;      ///< Time of the first sample
+  qint64 lastMs;       ///< Time of the last sample
+};
+
+/**
+ * @brief Random access to a trip log by time range
+ *
+ * open() walks the chunk headers only; samples are decompressed on demand,
+ * and only from the chunks overlapping the requested range.
+ */
+class Reader {
+ public:
+  /** @brief Location and contents of a chunk */
+  struct ChunkInfo {
+    qint64 offset;      ///< File offset of the compressed payload
+    ChunkHeader header; ///< Header of the chunk
+  };
+
+  Reader();
+
+  /**
+   * @brief Opens a log and indexes its chunks
+   * A chunk that was cut off by a crash ends the log.
+   * @return False if the file cannot be read or is not a trip log
+   */
+  bool open(const QString& path);
+
+  /** @brief Gets the reason open() or samples() failed */
+  QString errorString() const;
+
+  /** @brief Gets the wall-clock time of log time 0 */
+  qint64 startEpochMs() const;
+
+  /** @brief Gets the indexed chunks in file order */
+  const QVector<ChunkInfo>& chunks() const;
+
+  /** @brief Gets the time of the newest sample (0 for an empty log) */
+  qint64 endMs() const;
+
+  /**
+   * @brief Reads the samples of signals within a time range
+   * @param wanted Bit per Signal to read
+   * @param fromMs Start of the range (inclusive)
+   * @param toMs End of the range (inclusive)
+   * @param columns Receives the samples per signal, in time order
+   * @return False if a chunk is corrupt
+   */
+  bool samples(quint16 wanted, qint64 fromMs, qint64 toMs, QVector<Sample> columns[SignalCount]);
+
+  /**
+   * @brief Gets the value of a signal held at a point in time
+   * @return False if the signal has no sample at or before that time
+   */
+  bool valueAt(Signal signal, qint64 timeMs, qint64* value);
+
+  /**
+   * @brief Summarizes a signal over a time range
+   * The value held when the range starts counts for the time-weighted mean.
+   */
+  Summary summarize(Signal signal, qint64 fromMs, qint64 toMs);
+
+ private:
+  /**
+   * @brief Reads and decodes one chunk
+   */
+  bool readChunk(const ChunkInfo& chunk, quint16 wanted, QVector<Sample> columns[SignalCount]);
+
+  QFile m_file;                ///< Log file
+  QString m_error;             ///< Reason of the last failure
+  qint64 m_startEpochMs;       ///< Wall-clock time of log time 0
+  QVector<ChunkInfo> m_chunks; ///< Chunk index
+};
+
+} // namespace TripLog
+
+#endif // TRIPLOG_HPP
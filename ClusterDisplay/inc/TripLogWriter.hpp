@@ -0,0 +1,154 @@
+#ifndef TRIPLOGWRITER_HPP
+#define TRIPLOGWRITER_HPP
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "ClusterModel.hpp"
+#include "TripLog.hpp"
+
+/**
+ * @brief Writes the ClusterModel changes to a columnar trip log from a thread of its own
+ *
+ * Every change of a logged model value (see TripLog::Signal) is stamped with
+ * the log clock and pushed into a fixed, lock-free single-producer ring. That
+ * is all the GUI thread does: it never waits for the writer, and when the
+ * ring is full the sample is counted as dropped instead.
+ *
+ * The writer thread drains the ring into one column per signal and closes a
+ * chunk once it spans kChunkMs or holds kChunkSamples samples. A chunk is
+ * delta-encoded, compressed and appended with one write, so a crash loses at
+ * most the open chunk. See TripLog for the file format.
+ */
+class TripLogWriter : public QObject {
+  Q_OBJECT
+
+ public:
+  /// Samples the ring holds between two drains
+  static constexpr int kQueueCapacity = 8192;
+
+  /// Time span after which a chunk is closed
+  static constexpr qint64 kChunkMs = 60000;
+
+  /// Samples after which a chunk is closed
+  static constexpr int kChunkSamples = 16384;
+
+  /**
+   * @brief Creates a writer that logs the changes of a model once opened
+   * @param model Model whose changes are logged (must outlive this object)
+   * @param parent The parent QObject
+   */
+  explicit TripLogWriter(ClusterModel* model, QObject* parent = nullptr);
+
+  /**
+   * @brief Writes the open chunk and stops the writer thread
+   */
+  virtual ~TripLogWriter();
+
+  /**
+   * @brief Creates the log file, records the current model values and starts the writer thread
+   * @param path File path; missing parent directories are created
+   * @return False if the file cannot be created
+   */
+  bool open(const QString& path);
+
+  /**
+   * @brief Writes the open chunk, stops the writer thread and closes the file
+   */
+  void close();
+
+  /**
+   * @brief Checks whether a log is being written
+   */
+  bool isOpen() const;
+
+  /**
+   * @brief Records a value (GUI thread; never blocks)
+   * @return False if the log is closed or the ring is full
+   */
+  bool record(TripLog::Signal signal, qint64 value);
+
+  /**
+   * @brief Gets the number of samples accepted since open()
+   */
+  qint64 recordedCount() const;
+
+  /**
+   * @brief Gets the number of samples dropped because the ring was full
+   */
+  qint64 droppedCount() const;
+
+  /**
+   * @brief Gets the number of chunks written since open()
+   */
+  int chunkCount() const;
+
+  /**
+   * @brief Gets a file name for a log started now, e.g. trip-20260101-120000.ctl
+   */
+  static QString defaultFileName();
+
+ private:
+  using Column = QVector<TripLog::Sample>;
+
+  /**
+   * @brief A queued sample
+   */
+  struct QueuedSample {
+    qint64 timeMs;          ///< Log time
+    qint64 value;           ///< Value
+    TripLog::Signal signal; ///< Signal
+  };
+
+  /**
+   * @brief Connects the model signals of every logged value
+   */
+  void connectModel();
+
+  /**
+   * @brief Records every logged value as it is now
+   */
+  void recordAll();
+
+  /**
+   * @brief Loop of the writer thread
+   */
+  void run();
+
+  /**
+   * @brief Moves the queued samples into the columns (writer thread)
+   */
+  void drain();
+
+  /**
+   * @brief Encodes, compresses and appends the columns as one chunk (writer thread)
+   */
+  void writeChunk();
+
+  ClusterModel* m_model;                  ///< Logged model
+  QFile m_file;                           ///< Log file (used by the writer thread)
+  QElapsedTimer m_clock;                  ///< Log time
+  QueuedSample m_queue[kQueueCapacity];   ///< Single-producer ring
+  std::atomic<quint64> m_queueHead;       ///< Next sample to drain (writer)
+  std::atomic<quint64> m_queueTail;       ///< Next free slot (GUI thread)
+  std::atomic<qint64> m_recorded;         ///< Samples accepted
+  std::atomic<qint64> m_dropped;          ///< Samples dropped on a full ring
+  std::atomic<int> m_chunks;              ///< Chunks written
+  Column m_columns[TripLog::SignalCount]; ///< Open chunk (writer thread)
+  int m_columnSamples;                    ///< Samples in the open chunk
+  qint64 m_chunkFirstMs;                  ///< Time of the oldest open sample
+  qint64 m_chunkLastMs;                   ///< Time of the newest open sample
+  std::thread m_thread;                   ///< Writer thread
+  std::mutex m_mutex;                     ///< Guards m_running
+  std::condition_variable m_wakeUp;       ///< Ends the drain wait on close()
+  bool m_running;                         ///< Writer thread should keep running
+};
+
+#endif // TRIPLOGWRITER_HPP
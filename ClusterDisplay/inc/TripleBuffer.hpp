@@ -0,0 +1,110 @@
+#ifndef TRIPLEBUFFER_HPP
+#define TRIPLEBUFFER_HPP
+
+#include <atomic>
+#include <type_traits>
+
+/**
+ * @brief Wait-free single-producer, single-consumer triple buffer
+ *
+ * Hands the newest value of a plain data type from one thread to another
+ * without locks and without either side ever waiting. The writer fills its
+ * private back slot and publishes it by swapping it with the shared middle
+ * slot; the reader swaps the middle slot with its private front slot when a
+ * newer value was published. Each side only touches the slot it owns, so a
+ * value is never read while it is being written, and intermediate values the
+ * reader did not pick up are simply overwritten.
+ *
+ * Exactly one thread may write and exactly one thread may read at a time.
+ *
+ * @tparam T Trivially copyable value type
+ */
+template <typename T>
+class TripleBuffer {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "TripleBuffer values are copied between threads and must be trivially copyable");
+
+ public:
+  TripleBuffer() : m_back(0), m_middle(1), m_front(2) {}
+
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  /**
+   * @brief Get the slot the writer fills before calling publish()
+   */
+  T& writeBuffer() {
+    return m_slots[m_back].value;
+  }
+
+  /**
+   * @brief Make the write buffer the newest value (writer side)
+   *
+   * The write buffer afterwards refers to a recycled slot with stale content.
+   */
+  void publish() {
+    const int previous = m_middle.exchange(m_back | kFreshBit, std::memory_order_acq_rel);
+    m_back = previous & kIndexMask;
+  }
+
+  /**
+   * @brief Copy a value into the write buffer and publish it (writer side)
+   */
+  void write(const T& value) {
+    writeBuffer() = value;
+    publish();
+  }
+
+  /**
+   * @brief Check whether a value was published since the last update() (any thread)
+   */
+  bool hasNewData() const {
+    return (m_middle.load(std::memory_order_relaxed) & kFreshBit) != 0;
+  }
+
+  /**
+   * @brief Take over the newest published value if there is one (reader side)
+   * @return True if the read buffer changed
+   */
+  bool update() {
+    if (!hasNewData()) {
+      return false;
+    }
+    const int previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+    m_front = previous & kIndexMask;
+    return true;
+  }
+
+  /**
+   * @brief Get the value taken over by the last update() (reader side)
+   */
+  const T& readBuffer() const {
+    return m_slots[m_front].value;
+  }
+
+  /**
+   * @brief Get the newest published value (reader side)
+   */
+  const T& read() {
+    update();
+    return readBuffer();
+  }
+
+ private:
+  static constexpr int kIndexMask = 0x3; ///< Slot index bits of m_middle
+  static constexpr int kFreshBit = 0x4;  ///< Set in m_middle when the reader has not seen it
+
+  /**
+   * @brief One buffer slot, on its own cache line so writer and reader do not share lines
+   */
+  struct alignas(64) Slot {
+    T value{};
+  };
+
+  Slot m_slots[3];                       ///< Storage for the back, middle and front values
+  int m_back;                            ///< Slot owned by the writer
+  alignas(64) std::atomic<int> m_middle; ///< Shared slot index plus kFreshBit
+  alignas(64) int m_front;               ///< Slot owned by the reader
+};
+
+#endif // TRIPLEBUFFER_HPP
@@ -0,0 +1,103 @@
+#ifndef VIRTUALCLOCK_HPP
+#define VIRTUALCLOCK_HPP
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QVector>
+
+#include "Clock.hpp"
+
+class VirtualClockTimer;
+
+/**
+ * @brief Clock whose time only moves when it is advanced
+ *
+ * advance() moves the time forward and fires every timer that falls due on
+ * the way, in deadline order, with the time set to the deadline while the
+ * timer's slots run; timers due at the same time fire in the order they were
+ * started. The same calls thus always produce the same sequence of events,
+ * independent of the machine and its load, and an hour of driving takes as
+ * long as its events take to process.
+ *
+ * setRate() makes the time follow the system clock at a multiple of real
+ * time instead, for watching a replay on the display. Timers that are due
+ * keep firing in order; only when they fire in real time depends on the load.
+ *
+ * The clock must outlive the timers it created.
+ */
+class VirtualClock : public Clock {
+ public:
+  /**
+   * @brief Creates a clock at time 0
+   * @param start Date and time shown at time 0
+   */
+  explicit VirtualClock(const QDateTime& start = QDateTime(QDate(2025, 1, 1), QTime(8, 0)));
+  ~VirtualClock() override;
+
+  qint64 elapsedMs() const override;
+  QDateTime currentDateTime() const override;
+  ClockTimer* createTimer(QObject* parent) override;
+
+  /**
+   * @brief Moves the time forward, firing the timers due on the way
+   * @param durationMs Time to advance in milliseconds
+   * @return Number of timeouts fired
+   */
+  qint64 advance(qint64 durationMs);
+
+  /**
+   * @brief Moves the time forward to the next deadline and fires the timers due then
+   * @return False if no timer is running
+   */
+  bool advanceToNextTimer();
+
+  /**
+   * @brief Gets the time until the next deadline, or -1 if no timer is running
+   */
+  qint64 timeToNextTimer() const;
+
+  /**
+   * @brief Lets the time follow the system clock
+   * @param rate Virtual milliseconds per real millisecond (e.g. 60: a minute per second),
+   *             0 to stop; the event loop must be running
+   */
+  void setRate(double rate);
+
+  /** @brief Gets the rate set with setRate() */
+  double rate() const;
+
+  /** @brief Gets the number of timeouts fired so far */
+  qint64 firedCount() const;
+
+ private:
+  friend class VirtualClockTimer;
+
+  /**
+   * @brief Finds the running timer with the earliest deadline
+   * @return The timer, or nullptr if none is running
+   */
+  VirtualClockTimer* nextTimer() const;
+
+  /**
+   * @brief Fires a due timer and schedules its next deadline
+   */
+  void fire(VirtualClockTimer* timer);
+
+  /**
+   * @brief Advances by the real time passed since the previous step, times the rate
+   */
+  void followSystemClock();
+
+  QDateTime m_start;                    ///< Date and time at time 0
+  qint64 m_nowMs;                       ///< Current time
+  quint64 m_nextOrder;                  ///< Start order given to the next started timer
+  qint64 m_firedCount;                  ///< Timeouts fired so far
+  QVector<VirtualClockTimer*> m_timers; ///< Timers created and not yet destroyed
+  double m_rate;                        ///< Virtual per real milliseconds (0 = manual)
+  QTimer m_paceTimer;                   ///< Steps the time while following the system clock
+  QElapsedTimer m_paceClock;            ///< Real time of the previous step
+  double m_paceRemainderMs;             ///< Fraction of a millisecond carried to the next step
+};
+
+#endif // VIRTUALCLOCK_HPP
@@ -0,0 +1,59 @@
+#ifndef WRITETHROTTLE_HPP
+#define WRITETHROTTLE_HPP
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+/**
+ * @brief Rate limit for the files that persist state on the eMMC
+ *
+ * Requests made while a write is scheduled are folded into it, so everything
+ * that changes until the next allowed time costs one write. The first request
+ * after a quiet period is due at once, or as soon as the minimum interval
+ * since the previous write has passed.
+ */
+class WriteThrottle : public QObject {
+  Q_OBJECT
+
+ public:
+  /**
+   * @brief Creates a throttle with no write done yet
+   * @param minIntervalMs Minimum time between two writes
+   * @param parent The parent QObject
+   */
+  explicit WriteThrottle(int minIntervalMs, QObject* parent = nullptr);
+
+  /**
+   * @brief Schedules due() at the next allowed time unless it is already scheduled
+   */
+  void request();
+
+  /**
+   * @brief Drops the scheduled write, e.g. before writing at once
+   */
+  void cancel();
+
+  /**
+   * @brief Starts the minimum interval; call after every completed write
+   */
+  void markWritten();
+
+  /**
+   * @brief Forgets the previous write, so the next request is due at once
+   */
+  void reset();
+
+ signals:
+  /**
+   * @brief Emitted when the scheduled write is allowed
+   */
+  void due();
+
+ private:
+  const int m_minInterval;    ///< Minimum time between two writes in ms
+  QTimer m_timer;             ///< Delays the write to the next allowed time
+  QElapsedTimer m_sinceWrite; ///< Time since the last write
+};
+
+#endif // WRITETHROTTLE_HPP
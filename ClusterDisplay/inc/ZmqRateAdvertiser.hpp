@@ -0,0 +1,86 @@
+#ifndef ZMQRATEADVERTISER_HPP
+#define ZMQRATEADVERTISER_HPP
+
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <zmq.hpp>
+
+/**
+ * @brief Tells the publisher how often each key is worth sending
+ *
+ * The display pushes its maximum useful rate per key to the publisher's
+ * backchannel (a PUSH socket next to the SUB sockets), in the frame format
+ * "key1:hz1;key2:hz2". A rate of 0 means the key is not shown at all; keys
+ * that are not advertised are sent at full rate. A cooperating publisher
+ * (ClusterPublisher) coalesces updates to these rates, so the display does
+ * not receive and parse values it would discard.
+ *
+ * The limits are re-sent periodically. The publisher drops them when they
+ * stop arriving, so a display that went away does not leave the publisher
+ * throttled.
+ */
+class ZmqRateAdvertiser : public QObject {
+  Q_OBJECT
+
+ public:
+  /**
+   * @brief Creates an advertiser connected to the publisher's backchannel
+   * @param address The ZMQ endpoint of the publisher's rate socket
+   * @param intervalMs Time between two advertisements
+   * @param parent The parent QObject
+   */
+  explicit ZmqRateAdvertiser(const QString& address, int intervalMs = 1000,
+                             QObject* parent = nullptr);
+  ~ZmqRateAdvertiser();
+
+  /**
+   * @brief Set the maximum useful rate of a key
+   * @param key Message key (e.g. "battery")
+   * @param hz Maximum rate in Hz; 0 if the key is not shown, negative to remove the limit
+   */
+  void setMaxRate(const QString& key, qreal hz);
+
+  /**
+   * @brief Set several rates from a specification such as "speed=30,battery=0.5"
+   * @param spec Comma-separated key=hz pairs
+   * @return False if the specification is invalid; no rate is changed then
+   */
+  bool setMaxRates(const QString& spec);
+
+  /**
+   * @brief Get the advertised rates by key
+   */
+  QMap<QString, qreal> maxRates() const;
+
+  /**
+   * @brief Encode the rates as they are sent to the publisher
+   */
+  QString encodedRates() const;
+
+  /**
+   * @brief Start advertising periodically, beginning now
+   */
+  void start();
+
+  /**
+   * @brief Get the number of advertisements sent
+   */
+  int advertisementCount() const;
+
+ public slots:
+  /**
+   * @brief Send the current rates once
+   */
+  void advertise();
+
+ private:
+  zmq::context_t _context;     ///< ZMQ context of the backchannel
+  zmq::socket_t _socket;       ///< PUSH socket (only the latest advertisement is queued)
+  QTimer _timer;               ///< Periodic advertisement
+  QMap<QString, qreal> _rates; ///< Maximum rate per key
+  int _advertisements;         ///< Advertisements sent
+};
+
+#endif // ZMQRATEADVERTISER_HPP
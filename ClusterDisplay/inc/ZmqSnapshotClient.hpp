@@ -0,0 +1,92 @@
+#ifndef ZMQSNAPSHOTCLIENT_HPP
+#define ZMQSNAPSHOTCLIENT_HPP
+
+#include <QObject>
+#include <QSocketNotifier>
+#include <QString>
+#include <QTimer>
+#include <memory>
+#include <zmq.hpp>
+
+#include "ClusterProtocol.hpp"
+
+/**
+ * @brief Requests the publisher's full state over a REQ socket
+ *
+ * Late-joining subscribers use this side channel to fetch a snapshot of every
+ * key together with the sequence numbers it covers, and then only apply newer
+ * deltas from the PUB streams (the ZeroMQ "clone" pattern). The publisher
+ * answers on a ROUTER socket.
+ *
+ * The request is resent when no reply arrives within the timeout; a reply to
+ * an earlier attempt is ignored. After the last attempt failed() is emitted
+ * so the caller can continue with live data only.
+ */
+class ZmqSnapshotClient : public QObject {
+  Q_OBJECT
+
+ public:
+  /**
+   * @brief Creates a client connected to the snapshot endpoint
+   * @param address The ZMQ endpoint of the publisher's snapshot socket
+   * @param timeoutMs Time to wait for a reply before the request is resent
+   * @param attempts Number of requests sent before giving up
+   * @param parent The parent QObject
+   */
+  ZmqSnapshotClient(const QString& address, int timeoutMs = 500, int attempts = 3,
+                    QObject* parent = nullptr);
+  ~ZmqSnapshotClient();
+
+  /**
+   * @brief Sends a snapshot request, restarting the attempts if one is pending
+   */
+  void request();
+
+  /**
+   * @brief Checks whether a request is waiting for its reply
+   */
+  bool isPending() const;
+
+  /// Request payload understood by the publisher
+  static constexpr const char* kRequest = ClusterProtocol::kSnapshotRequest;
+
+ signals:
+  /**
+   * @brief Emitted when the publisher has answered
+   * @param snapshot Full state in "key1:value1;key2:value2;..." format, including the
+   *                 sequence number of every channel
+   */
+  void snapshotReceived(const QString& snapshot);
+
+  /**
+   * @brief Emitted when no attempt was answered in time
+   */
+  void failed();
+
+ private slots:
+  /**
+   * @brief Reads the reply when the socket becomes readable
+   */
+  void onReadable();
+
+  /**
+   * @brief Resends the request or gives up
+   */
+  void onTimeout();
+
+ private:
+  /**
+   * @brief Sends one request and starts its timeout
+   */
+  void send();
+
+  zmq::context_t _context;                    ///< ZMQ context of the side channel
+  zmq::socket_t _socket;                      ///< REQ socket (relaxed and correlated)
+  std::unique_ptr<QSocketNotifier> _notifier; ///< Notifier for socket activity
+  QTimer _timeoutTimer;                       ///< Reply timeout of the current attempt
+  const int _attempts;                        ///< Requests sent before giving up
+  int _attemptsLeft;                          ///< Remaining requests of the pending fetch
+  bool _pending;                              ///< A request awaits its reply
+};
+
+#endif // ZMQSNAPSHOTCLIENT_HPP
@@ -1,16 +1,48 @@
 #ifndef ZMQSUBSCRIBER_HPP
 #define ZMQSUBSCRIBER_HPP
 
+#include <QByteArray>
+#include <QList>
 #include <QObject>
 #include <QSocketNotifier>
 #include <memory>
+#include <vector>
 #include <zmq.hpp>
 
+/**
+ * @brief Receive-side socket options of a ZmqSubscriber
+ *
+ * The defaults are the settings used for the vehicle data ports.
+ */
+struct ZmqSocketOptions {
+  int receiveHighWaterMark = 100;    ///< ZMQ_RCVHWM: messages queued before new ones are dropped
+  bool conflate = false;             ///< ZMQ_CONFLATE: keep only the most recent message
+  bool immediate = true;             ///< ZMQ_IMMEDIATE: only queue to completed connections
+  int receiveBufferBytes = 0;        ///< ZMQ_RCVBUF kernel buffer size (0 = OS default)
+  QList<int> ioThreadCpus;           ///< CPUs the I/O thread is pinned to (empty = any)
+  int ioThreadPriority = 0;          ///< SCHED_FIFO priority of the I/O thread (0 = default policy)
+  int reconnectIntervalMs = 100;     ///< ZMQ_RECONNECT_IVL: first retry after a lost connection
+  int reconnectIntervalMaxMs = 2000; ///< ZMQ_RECONNECT_IVL_MAX: backoff limit (0 = no backoff)
+  int heartbeatIntervalMs = 1000;    ///< ZMQ_HEARTBEAT_IVL: ZMTP ping interval (0 = no heartbeat)
+  int heartbeatTimeoutMs = 3000;     ///< ZMQ_HEARTBEAT_TIMEOUT: silent peer is dropped after this
+};
+
 /**
  * @brief ZeroMQ subscriber class for receiving messages from publishers
  *
  * This class handles ZeroMQ socket connections and message reception,
  * integrating with Qt's event system via QSocketNotifier.
+ *
+ * Pending messages are drained in batches of bounded size, one batch per pass
+ * of the event loop. Before a batch is delivered its raw bytes are scanned for
+ * the priority keys; the newest frame carrying one is emitted through
+ * priorityMessageReceived() ahead of the whole batch, so a safety alert does
+ * not wait behind a backlog of telemetry. The batch is then delivered in order
+ * through messageReceived() as before.
+ *
+ * The connection is watched through a socket monitor. ZMTP heartbeats make a
+ * publisher that vanished without closing the connection (power loss, cable)
+ * show up as a disconnect, and the reconnect backoff retries quickly at first.
  */
 class ZmqSubscriber : public QObject {
   Q_OBJECT
@@ -23,17 +55,59 @@ class ZmqSubscriber : public QObject {
    */
   ZmqSubscriber(const QString& address, QObject* parent = nullptr);
 
+  /**
+   * @brief Constructs a ZMQ subscriber with explicit socket options
+   * @param address The ZMQ endpoint address to connect to
+   * @param options Receive-side socket options
+   * @param parent The parent QObject
+   */
+  ZmqSubscriber(const QString& address, const ZmqSocketOptions& options,
+                QObject* parent = nullptr);
+
   /**
    * @brief Destructor
    */
   ~ZmqSubscriber();
 
+  /**
+   * @brief Set the keys whose frames overtake the rest of a batch
+   * @param keys Message keys (e.g. "obs"); an empty list disables the priority path
+   */
+  void setPriorityKeys(const QList<QByteArray>& keys);
+
+  /**
+   * @brief Check whether a raw frame contains one of the given keys
+   *
+   * Works on the undecoded bytes so that frames can be classified before any
+   * string conversion or parsing.
+   *
+   * @param data Frame in "key1:value1;key2:value2;..." format
+   * @param size Frame size in bytes
+   * @param keys Keys to look for
+   */
+  static bool containsKey(const char* data, size_t size, const QList<QByteArray>& keys);
+
+  /**
+   * @brief Check whether the socket is connected to the publisher
+   */
+  bool isConnected() const;
+
+  /**
+   * @brief Get the number of times the connection was established
+   */
+  int connectCount() const;
+
  public slots:
   /**
    * @brief Slot called when new messages are available to read
    */
   void onMessageReceived();
 
+  /**
+   * @brief Slot called when the socket monitor reports connection events
+   */
+  void onMonitorEvent();
+
  signals:
   /**
    * @brief Signal emitted when a message is received
@@ -41,10 +115,36 @@ class ZmqSubscriber : public QObject {
    */
   void messageReceived(const QString& message);
 
+  /**
+   * @brief Signal emitted ahead of a batch for its newest frame with a priority key
+   * @param message The received message content; it is also delivered through messageReceived()
+   * @param overtakenFrames Frames of the batch in front of it, whose priority values are older
+   */
+  void priorityMessageReceived(const QString& message, int overtakenFrames);
+
+  /**
+   * @brief Signal emitted when the connection to the publisher is established or lost
+   * @param connected True if connected
+   */
+  void connectionChanged(bool connected);
+
  private:
-  zmq::context_t _context;                    ///< ZMQ context managing thread resources
-  zmq::socket_t _socket;                      ///< ZMQ socket for receiving messages
-  std::unique_ptr<QSocketNotifier> _notifier; ///< Notifier for socket activity
+  zmq::context_t _context; ///< ZMQ context managing thread resources
+  zmq::socket_t _socket;   ///< ZMQ socket for receiving messages
+  /**
+   * @brief Apply the I/O thread options to the context before the first socket starts it
+   * @return The configured context
+   */
+  static zmq::context_t& configureContext(zmq::context_t& context,
+                                          const ZmqSocketOptions& options);
+
+  std::unique_ptr<QSocketNotifier> _notifier;        ///< Notifier for socket activity
+  zmq::socket_t _monitor;                            ///< Receives the connection events
+  std::unique_ptr<QSocketNotifier> _monitorNotifier; ///< Notifier for connection events
+  bool _connected;                                   ///< Connected to the publisher
+  int _connectCount;                                 ///< Connections established so far
+  QList<QByteArray> _priorityKeys;                   ///< Keys delivered ahead of a batch
+  std::vector<zmq::message_t> _batch;                ///< Messages drained in one pass, reused
 };
 
 #endif // ZMQSUBSCRIBER_HPP
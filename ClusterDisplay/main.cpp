@@ -3,19 +3,42 @@
 #include <QDir>
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
-#include <QQmlContext>
 #include <QQuickStyle>
+#include <QQuickWindow>
+#include <QScreen>
+#include <QStandardPaths>
+#include <QtQml/QQmlExtensionPlugin>
+#include <memory>
 
+#include "CanSource.hpp"
 #include "ClusterDataSubscriber.hpp"
 #include "ClusterModel.hpp"
+#include "ClusterSignalHub.hpp"
+#include "DbcDatabase.hpp"
+#include "DisplaySettings.hpp"
+#include "FlightRecorder.hpp"
+#include "OdometerJournal.hpp"
+#include "RealtimeProfile.hpp"
+#include "StallWatchdog.hpp"
+#include "StateSnapshot.hpp"
+#include "StartupProfiler.hpp"
+#include "TripLogWriter.hpp"
+#include "ZmqRateAdvertiser.hpp"
+
+// The ClusterDisplay QML module is linked statically
+Q_IMPORT_QML_PLUGIN(ClusterDisplayPlugin)
 
 /**
  * @brief Main entry point for the Automotive Cluster Display application
  *
  * Sets up the Qt application, registers the cluster model with QML,
- * and loads the main QML interface.
+ * and loads the main QML interface. Non-critical components are loaded
+ * asynchronously once the first frame is on screen.
  */
 int main(int argc, char* argv[]) {
+  // Start timing as early as possible so the report covers the whole cold start
+  StartupProfiler startupProfiler;
+
   // Create Qt application
   QGuiApplication app(argc, argv);
   app.setApplicationName("Automotive Cluster Display");
@@ -33,9 +56,160 @@ int main(int argc, char* argv[]) {
                                 "Enable data mocking (no ZeroMQ needed)");
   parser.addOption(mockOption);
 
+  // Add option to choose the publisher host (e.g. localhost when running ClusterLoadGen)
+  QCommandLineOption hostOption(
+      QStringList() << "host", "Host of the ZeroMQ data publisher (default: " DEFAULT_DATA_HOST ")",
+      "host", DEFAULT_DATA_HOST);
+  parser.addOption(hostOption);
+
+  // Add option to print the time-to-first-frame breakdown
+  QCommandLineOption startupReportOption(QStringList() << "startup-report",
+                                         "Print a startup timing report after the first frame");
+  parser.addOption(startupReportOption);
+
+  // Add options for units without a usable GPU
+  QCommandLineOption softwareOption(QStringList() << "software",
+                                    "Use the software (no-GPU) Qt Quick renderer");
+  parser.addOption(softwareOption);
+  QCommandLineOption fullRepaintOption(
+      QStringList() << "full-repaint",
+      "Disable partial repaint mode of the software renderer (for comparison)");
+  parser.addOption(fullRepaintOption);
+
+  // Add option to tune how long hidden overlays stay loaded
+  QCommandLineOption overlayIdleOption(
+      QStringList() << "overlay-idle",
+      "Unload hidden non-critical overlays after <ms> milliseconds (default: 30000)", "ms");
+  parser.addOption(overlayIdleOption);
+
+  // Add options for the stall watchdog and its flight recorder dumps
+  QCommandLineOption stallThresholdOption(
+      QStringList() << "stall-threshold",
+      "Report GUI or render thread stalls longer than <ms> milliseconds (default: 500, 0: off)",
+      "ms", "500");
+  parser.addOption(stallThresholdOption);
+  QCommandLineOption flightDirOption(
+      QStringList() << "flight-dir",
+      "Directory for flight recorder dumps on stalls, SIGUSR1 and crashes (default: temp dir)",
+      "dir");
+  parser.addOption(flightDirOption);
+
+  // Add option to choose where the last known vehicle state is persisted
+  QCommandLineOption stateDirOption(
+      QStringList() << "state-dir",
+      "Directory of the persisted vehicle state shown until live data arrives "
+      "(default: application data directory)",
+      "dir");
+  parser.addOption(stateDirOption);
+
+  // Add option to log the model values of the drive for later analysis with cluster-log
+  QCommandLineOption tripLogOption(
+      QStringList() << "trip-log",
+      "Write a columnar trip log into <dir> (read it with cluster-log)", "dir");
+  parser.addOption(tripLogOption);
+
+  // Add options for reading the vehicle data straight from a CAN bus
+  QCommandLineOption canOption(
+      QStringList() << "can",
+      "Read the vehicle data from SocketCAN interface <iface> instead of ZeroMQ (needs --dbc)",
+      "iface");
+  parser.addOption(canOption);
+  QCommandLineOption dbcOption(QStringList() << "dbc", "DBC file describing the CAN frames",
+                               "file");
+  parser.addOption(dbcOption);
+  QCommandLineOption canMapOption(
+      QStringList() << "can-map",
+      "Protocol key per DBC signal, e.g. VehicleSpeed=speed,Soc=battery "
+      "(default: signals named like a key)",
+      "signal=key,...");
+  parser.addOption(canMapOption);
+
+  // Add options for detecting and recovering from a lost publisher
+  QCommandLineOption heartbeatOption(
+      QStringList() << "heartbeat",
+      "Drop a publisher connection after three missed <ms> heartbeats (default: 1000, 0: off)",
+      "ms", "1000");
+  parser.addOption(heartbeatOption);
+  QCommandLineOption reconnectMaxOption(
+      QStringList() << "reconnect-max",
+      "Upper limit of the reconnect backoff in milliseconds (default: 2000)", "ms", "2000");
+  parser.addOption(reconnectMaxOption);
+  QCommandLineOption staleTimeoutOption(
+      QStringList() << "stale-timeout",
+      "Report the data link as stale after <ms> milliseconds without frames (default: 1000)",
+      "ms", "1000");
+  parser.addOption(staleTimeoutOption);
+
+  // Add option to adjust the update rates requested from the publisher
+  QCommandLineOption maxRatesOption(
+      QStringList() << "max-rates",
+      "Highest useful update rate per key, e.g. speed=30,battery=0.5 (0: key not shown, "
+      "default: refresh rate for driving data, 1 Hz for battery and odometer)",
+      "key=hz,...");
+  parser.addOption(maxRatesOption);
+
+  // Add options for the real-time execution profile
+  QCommandLineOption rtGuiOption(QStringList() << "rt-gui",
+                                 "Pin the GUI thread and/or give it a SCHED_FIFO priority",
+                                 "CPUS[:PRIORITY]");
+  parser.addOption(rtGuiOption);
+  QCommandLineOption rtRenderOption(QStringList() << "rt-render",
+                                    "Pin the render thread and/or give it a SCHED_FIFO priority",
+                                    "CPUS[:PRIORITY]");
+  parser.addOption(rtRenderOption);
+  QCommandLineOption rtIngestOption(
+      QStringList() << "rt-ingest",
+      "Pin the ZeroMQ I/O threads and/or give them a SCHED_FIFO priority", "CPUS[:PRIORITY]");
+  parser.addOption(rtIngestOption);
+  QCommandLineOption rtLockMemoryOption(QStringList() << "rt-lock-memory",
+                                        "Lock and pre-fault memory to avoid page faults");
+  parser.addOption(rtLockMemoryOption);
+
   // Process the command line
   parser.process(app);
   bool enableMocking = parser.isSet(mockOption);
+  const bool useCan = parser.isSet(canOption) && !enableMocking;
+  startupProfiler.mark("Application created");
+
+  // The flight recorder is always on; dump it on SIGUSR1 and on crashes
+  FlightRecorder flightRecorder;
+  if (parser.isSet(flightDirOption) &&
+      !flightRecorder.setDumpDirectory(parser.value(flightDirOption))) {
+    qWarning() << "Flight recorder directory path too long, using" << QDir::tempPath();
+  }
+  FlightRecorder::setInstance(&flightRecorder);
+  FlightRecorder::installSignalHandlers();
+
+  // Apply the real-time profile before the other threads are started
+  RealtimeProfile realtimeProfile;
+  const auto threadSettings = [&parser](const QCommandLineOption& option) {
+    RealtimeProfile::ThreadSettings settings;
+    if (parser.isSet(option) &&
+        !RealtimeProfile::parseThreadSettings(parser.value(option), &settings)) {
+      qWarning() << "Ignoring malformed --" + option.names().first() << "specification"
+                 << parser.value(option);
+    }
+    return settings;
+  };
+  realtimeProfile.setGuiThread(threadSettings(rtGuiOption));
+  realtimeProfile.setRenderThread(threadSettings(rtRenderOption));
+  realtimeProfile.setIngestThreads(threadSettings(rtIngestOption));
+  realtimeProfile.setLockMemory(parser.isSet(rtLockMemoryOption));
+  realtimeProfile.applyProcessSettings();
+
+  // The scene graph backend must be chosen before the window is created
+  if (parser.isSet(softwareOption)) {
+    QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+  }
+
+  // Only repaint dirty regions when rendering without a GPU
+  DisplaySettings displaySettings;
+  displaySettings.setPartialRepaint(DisplaySettings::softwareBackendSelected() &&
+                                    !parser.isSet(fullRepaintOption));
+  if (parser.isSet(overlayIdleOption)) {
+    displaySettings.setOverlayIdleUnloadMs(parser.value(overlayIdleOption).toInt());
+  }
+  displaySettings.setTrendGraphs(!DisplaySettings::softwareBackendSelected());
 
   // Apply Material Design style for modern look
   QQuickStyle::setStyle("Material");
@@ -43,31 +217,164 @@ int main(int argc, char* argv[]) {
   // Create and initialize the cluster data model
   ClusterModel clusterModel;
 
+  // Show the last known battery, odometer and mode until live data confirms them
+  StateSnapshot stateSnapshot(&clusterModel);
+  OdometerJournal odometerJournal;
+  if (!enableMocking) {
+    const QString stateDir =
+        parser.isSet(stateDirOption)
+            ? parser.value(stateDirOption)
+            : QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (!stateSnapshot.open(QDir(stateDir).filePath(StateSnapshot::defaultFileName()))) {
+      qWarning() << "Vehicle state cannot be persisted in" << stateDir;
+    } else if (stateSnapshot.restore()) {
+      qDebug() << "Restored vehicle state snapshot" << stateSnapshot.sequence();
+    }
+    if (!odometerJournal.open(QDir(stateDir).filePath(OdometerJournal::defaultFileName()))) {
+      qWarning() << "Odometer cannot be persisted in" << stateDir;
+    }
+  }
+
+  // Subscribe once to the data ports; every consumer is fed from this hub
+  ClusterSignalHub signalHub;
+  ZmqSocketOptions socketOptions = realtimeProfile.ingestSocketOptions();
+  socketOptions.heartbeatIntervalMs = parser.value(heartbeatOption).toInt();
+  socketOptions.heartbeatTimeoutMs = 3 * socketOptions.heartbeatIntervalMs;
+  socketOptions.reconnectIntervalMaxMs = parser.value(reconnectMaxOption).toInt();
+  if (!useCan) {
+    ClusterDataSubscriber::addDataSources(&signalHub, parser.value(hostOption), socketOptions);
+  }
+
   // Create the cluster data subscriber
-  ClusterDataSubscriber dataSubscriber(&clusterModel);
+  ClusterDataSubscriber dataSubscriber(&clusterModel, &signalHub);
+  dataSubscriber.setStaleTimeout(parser.value(staleTimeoutOption).toInt());
+  if (odometerJournal.isOpen()) {
+    dataSubscriber.setOdometerJournal(&odometerJournal);
+  }
 
   // Enable mocking if specified on command line
   dataSubscriber.enableMocking(enableMocking);
 
+  // Read the vehicle data straight from the CAN bus instead of the publisher
+  std::unique_ptr<CanSource> canSource;
+  if (useCan) {
+    DbcDatabase database;
+    if (!database.load(parser.value(dbcOption))) {
+      qCritical() << "Cannot read the CAN database" << parser.value(dbcOption) << ":"
+                  << database.errorString();
+      return -1;
+    }
+    QHash<QString, QString> canMapping;
+    if (!CanSource::parseMapping(parser.value(canMapOption), &canMapping)) {
+      qCritical() << "Invalid --can-map:" << parser.value(canMapOption);
+      return -1;
+    }
+    canSource = std::make_unique<CanSource>(database, canMapping, &clusterModel);
+    if (!canSource->open(parser.value(canOption))) {
+      qCritical() << canSource->errorString();
+      return -1;
+    }
+    dataSubscriber.attachCanSource(canSource.get());
+  }
+
+  // Fetch the full state once instead of waiting for every key to be published again
+  if (!enableMocking && !useCan) {
+    dataSubscriber.synchronize(ClusterDataSubscriber::snapshotAddress(parser.value(hostOption)));
+  }
+
+  // Ask the publisher not to send faster than the display can show
+  std::unique_ptr<ZmqRateAdvertiser> rateAdvertiser;
+  if (!enableMocking && !useCan) {
+    rateAdvertiser = std::make_unique<ZmqRateAdvertiser>(
+        ClusterDataSubscriber::rateAddress(parser.value(hostOption)));
+    const qreal refreshRate = app.primaryScreen() ? app.primaryScreen()->refreshRate() : 60;
+    const QMap<QString, qreal> rates = ClusterDataSubscriber::maxUsefulRates(refreshRate);
+    for (auto it = rates.cbegin(); it != rates.cend(); ++it) {
+      rateAdvertiser->setMaxRate(it.key(), it.value());
+    }
+    if (!rateAdvertiser->setMaxRates(parser.value(maxRatesOption))) {
+      qWarning() << "Invalid --max-rates, using the default rates:" << parser.value(maxRatesOption);
+    }
+    rateAdvertiser->start();
+  }
+
+  // Log the model values from a thread of their own; the GUI thread only queues them
+  std::unique_ptr<TripLogWriter> tripLog;
+  if (parser.isSet(tripLogOption)) {
+    tripLog = std::make_unique<TripLogWriter>(&clusterModel);
+    const QString tripLogPath =
+        QDir(parser.value(tripLogOption)).filePath(TripLogWriter::defaultFileName());
+    if (tripLog->open(tripLogPath)) {
+      qDebug() << "Writing trip log" << tripLogPath;
+    } else {
+      qWarning() << "Trip log cannot be written to" << tripLogPath;
+    }
+  }
+
   // Output mode to console
   if (enableMocking) {
     qDebug() << "Running in MOCK mode (no ZeroMQ connection needed)";
+  } else if (useCan) {
+    qDebug() << "Running in CAN mode (reading" << parser.value(canOption) << "with"
+             << parser.value(dbcOption) << ")";
   } else {
-    qDebug() << "Running in LIVE mode (expecting ZeroMQ data on ports 5555 and 5556)";
+    qDebug() << "Running in LIVE mode (expecting ZeroMQ data from" << parser.value(hostOption)
+             << "on ports 5555 and 5556, state snapshots on port 5557, rate limits to port 5558)";
   }
+  startupProfiler.mark("Model and subscribers ready");
+
+  // Expose the model to QML as the ClusterModel singleton of the ClusterDisplay module
+  ClusterModel::setQmlInstance(&clusterModel);
+  DisplaySettings::setQmlInstance(&displaySettings);
 
-  // Set up QML engine and expose the model to QML
+  // Set up QML engine
   QQmlApplicationEngine engine;
-  engine.rootContext()->setContextProperty("clusterModel", &clusterModel);
+  startupProfiler.mark("QML engine created");
 
   // Load the main QML interface
-  engine.load(QUrl(QStringLiteral("qrc:/main.qml")));
+  engine.load(QUrl(QStringLiteral("qrc:/ClusterDisplay/main.qml")));
 
   // Check if QML loaded successfully
   if (engine.rootObjects().isEmpty()) {
     qCritical() << "Failed to load QML interface";
     return -1;
   }
+  startupProfiler.mark("Critical QML loaded");
+
+  // Release the deferred (non-critical) components once the first frame is on screen
+  QQuickWindow* window = qobject_cast<QQuickWindow*>(engine.rootObjects().first());
+  startupProfiler.attachWindow(window);
+  QObject::connect(&startupProfiler, &StartupProfiler::firstFrameRendered, window,
+                   [window]() { window->setProperty("firstFrameShown", true); });
+
+  // Configure the render thread when it starts; report what took effect once data flows
+  realtimeProfile.attachWindow(window);
+  if (realtimeProfile.isEnabled()) {
+    QObject::connect(&startupProfiler, &StartupProfiler::firstFrameRendered,
+                     [&realtimeProfile]() {
+                       qInfo().noquote() << "Real-time profile:";
+                       for (const QString& line : realtimeProfile.report()) {
+                         qInfo().noquote() << "  " + line;
+                       }
+                     });
+  }
+
+  // Watch the GUI and render threads for stalls
+  const int stallThresholdMs = parser.value(stallThresholdOption).toInt();
+  StallWatchdog stallWatchdog(&flightRecorder, qMax(stallThresholdMs, 1));
+  if (stallThresholdMs > 0) {
+    stallWatchdog.attachWindow(window);
+    stallWatchdog.start();
+  }
+
+  // Present safety alerts with the next possible frame instead of waiting for other updates
+  QObject::connect(&dataSubscriber, &ClusterDataSubscriber::safetyFrameProcessed, window,
+                   &QQuickWindow::update);
+
+  if (parser.isSet(startupReportOption)) {
+    QObject::connect(&startupProfiler, &StartupProfiler::reportReady,
+                     [](const QString& report) { qInfo().noquote() << report; });
+  }
 
   // Start the application event loop
   return app.exec();
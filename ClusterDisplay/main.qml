@@ -1,7 +1,7 @@
 import QtQuick 6.4
 import QtQuick.Window 6.4
 import QtQuick.Controls 6.4
-import "ui"
+import ClusterDisplay 1.0
 
 ApplicationWindow {
     id: window
@@ -12,26 +12,20 @@ ApplicationWindow {
 
     flags: Qt.FramelessWindowHint | Qt.WindowStaysOnTopHint
     visibility: ApplicationWindow.FullScreen
-    color: "transparent"
+    // An opaque window lets the software renderer overwrite dirty rectangles instead of
+    // blending them with the previous contents
+    color: DisplaySettings.partialRepaint ? "#050505" : "transparent"
 
-    readonly property string primaryFont: "'Ubuntu Mono', 'DejaVu Sans Mono', monospace"
-    readonly property string secondaryFont: "'Ubuntu Condensed', 'DejaVu Sans', sans-serif"
-    readonly property string monoFont: "'Ubuntu Mono', 'DejaVu Sans Mono', monospace"
-
-    readonly property int fontLight: Font.Light
-    readonly property int fontNormal: Font.Normal
-    readonly property int fontMedium: Font.Medium
-    readonly property int fontDemiBold: Font.DemiBold
-    readonly property int fontBold: Font.Bold
-
-    readonly property real letterSpacingTight: 0.5
-    readonly property real letterSpacingNormal: 1.0
-    readonly property real letterSpacingWide: 2.0
-    readonly property real letterSpacingExtraWide: 3.0
+    // Set from C++ once the first frame has been presented. Everything that is not
+    // needed to show speed and safety alerts is loaded asynchronously after that.
+    property bool firstFrameShown: false
 
+    // Static background. In partial repaint mode it is cached as a single layer, so a dirty
+    // rectangle only needs one blit instead of recompositing the gradient and the grid.
     Rectangle {
         anchors.fill: parent
         color: "#050505"
+        layer.enabled: DisplaySettings.partialRepaint
 
         Canvas {
             anchors.fill: parent
@@ -46,29 +40,35 @@ ApplicationWindow {
             }
         }
 
-        Canvas {
+        Loader {
             anchors.fill: parent
-            opacity: 0.15
-            onPaint: {
-                var ctx = getContext("2d");
-                var w = width;
-                var h = height;
+            active: window.firstFrameShown
+            asynchronous: true
+            sourceComponent: Component {
+                Canvas {
+                    opacity: 0.15
+                    onPaint: {
+                        var ctx = getContext("2d");
+                        var w = width;
+                        var h = height;
 
-                ctx.strokeStyle = "rgba(100, 120, 180, 0.3)";
-                ctx.lineWidth = 0.5;
+                        ctx.strokeStyle = "rgba(100, 120, 180, 0.3)";
+                        ctx.lineWidth = 0.5;
 
-                for (var y = 0; y < h; y += 40) {
-                    ctx.beginPath();
-                    ctx.moveTo(0, y);
-                    ctx.lineTo(w, y);
-                    ctx.stroke();
-                }
+                        for (var y = 0; y < h; y += 40) {
+                            ctx.beginPath();
+                            ctx.moveTo(0, y);
+                            ctx.lineTo(w, y);
+                            ctx.stroke();
+                        }
 
-                for (var x = 0; x < w; x += 40) {
-                    ctx.beginPath();
-                    ctx.moveTo(x, 0);
-                    ctx.lineTo(x, h);
-                    ctx.stroke();
+                        for (var x = 0; x < w; x += 40) {
+                            ctx.beginPath();
+                            ctx.moveTo(x, 0);
+                            ctx.lineTo(x, h);
+                            ctx.stroke();
+                        }
+                    }
                 }
             }
         }
@@ -79,23 +79,25 @@ ApplicationWindow {
         anchors.fill: parent
         anchors.margins: 20
 
-        ClockDisplay {
-            id: clockDisplay
+        // Critical components: created synchronously so the first frame already shows
+        // speed, battery state and safety alerts
+
+        NumberSpeedometer {
+            id: speedometer
             anchors {
+                horizontalCenter: parent.horizontalCenter
                 top: parent.top
-                left: parent.left
-                topMargin: 10
-                leftMargin: 15
+                topMargin: 50
             }
+            width: 140
+            height: 140
         }
 
-        DrivingModeIndicator {
-            id: modeIndicator
+        // Shown whenever the values on screen are not live
+        LinkStatusIndicator {
             anchors {
+                horizontalCenter: parent.horizontalCenter
                 top: parent.top
-                right: parent.right
-                topMargin: 10
-                rightMargin: 15
             }
         }
 
@@ -109,7 +111,55 @@ ApplicationWindow {
             }
         }
 
-        OdometerDisplay {
+        AlertsDisplay {
+            id: alertsDisplay
+            anchors {
+                left: parent.left
+                leftMargin: 220
+                verticalCenter: parent.verticalCenter
+                verticalCenterOffset: 0
+            }
+            width: 160
+            laneAlertActive: ClusterModel.laneAlert
+            objectAlertActive: ClusterModel.objectAlert
+            highlightedLane: ClusterModel.highlightedLane
+            lastSpeedLimit: ClusterModel.lastSpeedLimit
+        }
+
+        // Non-critical components: compiled and instantiated in the background after
+        // the first frame, so they do not delay time-to-first-speed
+
+        Loader {
+            id: clockDisplay
+            anchors {
+                top: parent.top
+                left: parent.left
+                topMargin: 10
+                leftMargin: 15
+            }
+            active: window.firstFrameShown
+            asynchronous: true
+            sourceComponent: Component {
+                ClockDisplay {}
+            }
+        }
+
+        Loader {
+            id: modeIndicator
+            anchors {
+                top: parent.top
+                right: parent.right
+                topMargin: 10
+                rightMargin: 15
+            }
+            active: window.firstFrameShown
+            asynchronous: true
+            sourceComponent: Component {
+                DrivingModeIndicator {}
+            }
+        }
+
+        Loader {
             id: odometer
             anchors {
                 bottom: parent.bottom
@@ -117,20 +167,29 @@ ApplicationWindow {
                 bottomMargin: 10
                 rightMargin: 15
             }
+            active: window.firstFrameShown
+            asynchronous: true
+            sourceComponent: Component {
+                OdometerDisplay {}
+            }
         }
 
-        NumberSpeedometer {
-            id: speedometer
+        Loader {
+            id: tripDisplay
             anchors {
-                horizontalCenter: parent.horizontalCenter
-                top: parent.top
-                topMargin: 50
+                bottom: parent.bottom
+                left: parent.left
+                bottomMargin: 10
+                leftMargin: 200
+            }
+            active: window.firstFrameShown
+            asynchronous: true
+            sourceComponent: Component {
+                TripDisplay {}
             }
-            width: 140
-            height: 140
         }
 
-        JetracerAlertDisplay {
+        Loader {
             id: jetracerGraphic
             anchors {
                 horizontalCenter: parent.horizontalCenter
@@ -139,45 +198,60 @@ ApplicationWindow {
             }
             width: 300
             height: 180
-            speed: clusterModel.speed
-            objectAlertActive: clusterModel.objectAlert
-            laneAlertActive: clusterModel.laneAlert
-            laneDeviationSide: clusterModel.laneDeviationSide
+            active: window.firstFrameShown
+            asynchronous: true
+            sourceComponent: Component {
+                JetracerAlertDisplay {
+                    speed: ClusterModel.speed
+                    objectAlertActive: ClusterModel.objectAlert
+                    laneAlertActive: ClusterModel.laneAlert
+                    highlightedLane: ClusterModel.highlightedLane
+                }
+            }
         }
 
-        StreetSignDisplay {
-            id: streetSignDisplay
+        // Not available with the software renderer (see DisplaySettings.trendGraphs)
+        Loader {
+            id: trendDisplay
             anchors {
                 right: parent.right
-                rightMargin: 280
+                rightMargin: 15
                 verticalCenter: parent.verticalCenter
             }
-            width: 100
-            height: 100
+            active: window.firstFrameShown && DisplaySettings.trendGraphs
+            asynchronous: true
+            sourceComponent: Component {
+                TrendDisplay {}
+            }
         }
 
-        AlertsDisplay {
-            id: alertsDisplay
+        // Only instantiated while a sign is shown (and for the idle period afterwards)
+        LazyOverlay {
+            id: streetSignDisplay
             anchors {
-                left: parent.left
-                leftMargin: 220
+                right: parent.right
+                rightMargin: 280
                 verticalCenter: parent.verticalCenter
-                verticalCenterOffset: 0
             }
-            width: 160
-            laneAlertActive: clusterModel.laneAlert
-            objectAlertActive: clusterModel.objectAlert
-            laneDeviationSide: clusterModel.laneDeviationSide
-            lastSpeedLimit: clusterModel.lastSpeedLimit
+            width: 100
+            height: 100
+            wanted: window.firstFrameShown && ClusterModel.visibleSign !== ClusterModel.NoSign
+            sourceComponent: Component {
+                StreetSignDisplay {}
+            }
         }
     }
 
+    // Border frame. Its pulse animations cover the whole window, which would force the
+    // software renderer to repaint every pixel on every frame; in partial repaint mode they
+    // are stopped and the frame is cached as a static layer.
     Rectangle {
         id: borderFrame
         anchors.fill: parent
         anchors.margins: 12
         color: "transparent"
         radius: 40
+        layer.enabled: DisplaySettings.partialRepaint
 
         Rectangle {
             id: outerGlowBorder
@@ -185,10 +259,12 @@ ApplicationWindow {
             anchors.margins: -8
             color: "transparent"
             radius: 48
+            opacity: 0.5
             border.width: 6
             border.color: Qt.alpha(batteryPercent.isCharging ? batteryPercent.chargingColor : batteryPercent.batteryColor, 0.4)
 
             SequentialAnimation on opacity {
+                running: !DisplaySettings.partialRepaint
                 loops: Animation.Infinite
                 NumberAnimation {
                     to: 0.3
@@ -209,10 +285,12 @@ ApplicationWindow {
             anchors.margins: -4
             color: "transparent"
             radius: 44
+            opacity: 0.6
             border.width: 6
             border.color: Qt.alpha(batteryPercent.isCharging ? batteryPercent.chargingColor : batteryPercent.batteryColor, 0.6)
 
             SequentialAnimation on opacity {
+                running: !DisplaySettings.partialRepaint
                 loops: Animation.Infinite
                 NumberAnimation {
                     to: 0.4
@@ -232,10 +310,12 @@ ApplicationWindow {
             anchors.fill: parent
             color: "transparent"
             radius: 40
+            opacity: 0.8
             border.width: 8
             border.color: batteryPercent.isCharging ? batteryPercent.chargingColor : batteryPercent.batteryColor
 
             SequentialAnimation on opacity {
+                running: !DisplaySettings.partialRepaint
                 loops: Animation.Infinite
                 NumberAnimation {
                     to: 0.6
@@ -250,7 +330,7 @@ ApplicationWindow {
             }
 
             SequentialAnimation on border.color {
-                running: batteryPercent.isCharging
+                running: batteryPercent.isCharging && !DisplaySettings.partialRepaint
                 loops: Animation.Infinite
                 ColorAnimation {
                     to: batteryPercent.chargingColor
@@ -273,6 +353,7 @@ ApplicationWindow {
             opacity: 0.7
 
             SequentialAnimation on opacity {
+                running: !DisplaySettings.partialRepaint
                 loops: Animation.Infinite
                 NumberAnimation {
                     to: 0.4
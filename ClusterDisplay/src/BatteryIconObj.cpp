@@ -1,12 +1,20 @@
 #include "BatteryIconObj.hpp"
 
-#include <QTimer>
-
 BatteryIconObj::BatteryIconObj(QObject* parent)
-    : ZmqSubscriber(BATTERY_ADDRESS, parent), m_percentage{0} {
+    : QObject(parent), m_percentage{0}, m_hub(nullptr), m_listenerId(0) {
   setPercentage(0);
-};
-BatteryIconObj::~BatteryIconObj() {}
+}
+
+BatteryIconObj::BatteryIconObj(ClusterSignalHub* hub, QObject* parent) : BatteryIconObj(parent) {
+  m_hub = hub;
+  m_listenerId = m_hub->subscribeInt("battery", [this](int value) { setPercentage(value); });
+}
+
+BatteryIconObj::~BatteryIconObj() {
+  if (m_hub) {
+    m_hub->unsubscribe(m_listenerId);
+  }
+}
 
 int BatteryIconObj::percentage(void) const {
   return m_percentage;
@@ -18,6 +26,6 @@ void BatteryIconObj::setPercentage(int newPercentage) {
   emit percentageChanged(newPercentage);
 }
 
-void BatteryIconObj::_handleMsg(QString& message) {
+void BatteryIconObj::_handleMsg(const QString& message) {
   setPercentage(message.toInt());
 }
@@ -0,0 +1,277 @@
+#include "CanSource.hpp"
+
+#include <QDebug>
+#include <QSet>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+#include "ClusterProtocol.hpp"
+#include "FlightRecorder.hpp"
+
+namespace {
+
+// Keys ClusterDataSubscriber::processData() takes from a frame; sequence numbers have no CAN source
+const QSet<QString> DATA_KEYS = {ClusterProtocol::kSpeed,
+                                 ClusterProtocol::kLane,
+                                 ClusterProtocol::kObstacle,
+                                 ClusterProtocol::kSign,
+                                 ClusterProtocol::kDrivingMode,
+                                 ClusterProtocol::kBattery,
+                                 ClusterProtocol::kCharging,
+                                 ClusterProtocol::kOdometer};
+
+} // namespace
+
+CanSource::CanSource(const DbcDatabase& database, const QHash<QString, QString>& mapping,
+                     ClusterModel* clusterModel, QObject* parent)
+    : QObject(parent),
+      m_database(database),
+      m_clusterModel(clusterModel),
+      m_mapping(mapping),
+      m_undelivered(false),
+      m_socket(-1),
+      m_frameCount(0),
+      m_unknownFrameCount(0),
+      m_batchCount(0) {
+  compileRoutes();
+}
+
+CanSource::~CanSource() {
+  close();
+}
+
+bool CanSource::parseMapping(const QString& specification, QHash<QString, QString>* mapping) {
+  QHash<QString, QString> parsed;
+  for (const QString& pair : specification.split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+    const QStringList parts = pair.split(QLatin1Char('='));
+    if (parts.size() != 2 || parts.at(0).trimmed().isEmpty() ||
+        !DATA_KEYS.contains(parts.at(1).trimmed())) {
+      return false;
+    }
+    parsed.insert(parts.at(0).trimmed(), parts.at(1).trimmed());
+  }
+  *mapping = parsed;
+  return true;
+}
+
+void CanSource::compileRoutes() {
+  const QVector<DbcMessage>& messages = m_database.messages();
+  m_routes.resize(messages.size());
+  for (int message = 0; message < messages.size(); ++message) {
+    const QVector<DbcSignal>& dbcSignals = messages.at(message).dbcSignals;
+    for (int signal = 0; signal < dbcSignals.size(); ++signal) {
+      const QString& name = dbcSignals.at(signal).name;
+      Route route{signal, m_mapping.value(name), SignalStore::kInvalidSignal, false};
+      if (route.key.isEmpty() && DATA_KEYS.contains(name)) {
+        route.key = name;
+      }
+      if (route.key.isEmpty()) {
+        route.storeId = m_clusterModel->registerVehicleSignal(name);
+        if (route.storeId == SignalStore::kInvalidSignal) {
+          qWarning() << "CanSource: signal" << name << "cannot be stored, ignoring it";
+          continue;
+        }
+      }
+      m_routes[message].append(route);
+    }
+  }
+}
+
+void CanSource::setPriorityKeys(const QStringList& keys) {
+  for (QVector<Route>& routes : m_routes) {
+    for (Route& route : routes) {
+      route.priority = !route.key.isEmpty() && keys.contains(route.key);
+    }
+  }
+}
+
+bool CanSource::processFrame(quint32 id, bool extended, const quint8* data, int length) {
+  const DbcMessage* message = m_database.message(id, extended);
+  if (!message || length < message->length) {
+    ++m_unknownFrameCount;
+    return false;
+  }
+  ++m_frameCount;
+  m_undelivered = true;
+
+  // The signals are compiled against a full payload; bytes beyond the frame read as zero
+  quint8 payload[DbcDatabase::kMaxPayload] = {};
+  std::copy(data, data + qMin(length, DbcDatabase::kMaxPayload), payload);
+  const quint64 littleEndian = DbcDatabase::payloadWord(payload, false);
+  const quint64 bigEndian = DbcDatabase::payloadWord(payload, true);
+
+  SignalStore& store = m_clusterModel->signalStore();
+  QMap<QString, QString> priority;
+  const int index = static_cast<int>(message - m_database.messages().constData());
+  for (const Route& route : m_routes.at(index)) {
+    const DbcSignal& dbcSignal = message->dbcSignals.at(route.signal);
+    const double value =
+        DbcDatabase::decode(dbcSignal, dbcSignal.bigEndian ? bigEndian : littleEndian);
+    if (route.key.isEmpty()) {
+      store.set(route.storeId, value);
+    } else if (route.priority) {
+      priority.insert(route.key, QString::number(std::llround(value)));
+    } else {
+      // The protocol values are integers
+      m_pending.insert(route.key, QString::number(std::llround(value)));
+    }
+  }
+  if (!priority.isEmpty()) {
+    emit priorityFrameReceived(priority);
+  }
+  return true;
+}
+
+void CanSource::deliver() {
+  if (!m_undelivered) {
+    return;
+  }
+  m_undelivered = false;
+  const QMap<QString, QString> data = std::exchange(m_pending, {});
+  emit frameReceived(data);
+}
+
+qint64 CanSource::frameCount() const {
+  return m_frameCount;
+}
+
+qint64 CanSource::unknownFrameCount() const {
+  return m_unknownFrameCount;
+}
+
+qint64 CanSource::batchCount() const {
+  return m_batchCount;
+}
+
+bool CanSource::isOpen() const {
+  return m_socket >= 0;
+}
+
+QString CanSource::errorString() const {
+  return m_error;
+}
+
+#ifdef Q_OS_LINUX
+
+bool CanSource::open(const QString& interface) {
+  close();
+
+  const int fd = ::socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+  if (fd < 0) {
+    m_error = QStringLiteral("CAN socket: %1").arg(QString::fromLocal8Bit(std::strerror(errno)));
+    return false;
+  }
+
+  // Let the kernel drop the frames the database does not define
+  const QVector<DbcMessage>& messages = m_database.messages();
+  if (messages.size() <= CAN_RAW_FILTER_MAX) {
+    QVector<can_filter> filters;
+    filters.reserve(messages.size());
+    for (const DbcMessage& message : messages) {
+      can_filter filter;
+      filter.can_id = message.extended ? message.id | CAN_EFF_FLAG : message.id;
+      filter.can_mask = (message.extended ? CAN_EFF_MASK : CAN_SFF_MASK) | CAN_EFF_FLAG |
+                        CAN_RTR_FLAG;
+      filters.append(filter);
+    }
+    ::setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, filters.constData(),
+                 static_cast<socklen_t>(filters.size() * sizeof(can_filter)));
+  }
+
+  ifreq request;
+  std::memset(&request, 0, sizeof(request));
+  const QByteArray name = interface.toLocal8Bit();
+  std::strncpy(request.ifr_name, name.constData(), IFNAMSIZ - 1);
+  const bool found = ::ioctl(fd, SIOCGIFINDEX, &request) == 0;
+  sockaddr_can address;
+  std::memset(&address, 0, sizeof(address));
+  address.can_family = AF_CAN;
+  address.can_ifindex = request.ifr_ifindex;
+  if (!found || ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+    m_error = QStringLiteral("CAN interface %1: %2")
+                  .arg(interface, QString::fromLocal8Bit(std::strerror(errno)));
+    ::close(fd);
+    return false;
+  }
+
+  m_socket = fd;
+  m_error.clear();
+  m_notifier = std::make_unique<QSocketNotifier>(fd, QSocketNotifier::Read);
+  connect(m_notifier.get(), &QSocketNotifier::activated, this, &CanSource::onReadyRead);
+  return true;
+}
+
+void CanSource::close() {
+  m_notifier.reset();
+  if (m_socket >= 0) {
+    ::close(m_socket);
+    m_socket = -1;
+  }
+}
+
+void CanSource::onReadyRead() {
+  can_frame frames[kBatchSize];
+  iovec vectors[kBatchSize];
+  mmsghdr headers[kBatchSize];
+  std::memset(headers, 0, sizeof(headers));
+  for (int i = 0; i < kBatchSize; ++i) {
+    vectors[i].iov_base = &frames[i];
+    vectors[i].iov_len = sizeof(can_frame);
+    headers[i].msg_hdr.msg_iov = &vectors[i];
+    headers[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  // The notifier is level-triggered: frames left after kMaxBatches are read on the next pass
+  for (int batch = 0; batch < kMaxBatches; ++batch) {
+    const int received = ::recvmmsg(m_socket, headers, kBatchSize, MSG_DONTWAIT, nullptr);
+    if (received <= 0) {
+      break;
+    }
+    ++m_batchCount;
+    FlightRecorder::trace(FlightRecorder::BatchDrained, received);
+
+    for (int i = 0; i < received; ++i) {
+      const can_frame& frame = frames[i];
+      if (headers[i].msg_len < sizeof(can_frame) ||
+          (frame.can_id & (CAN_ERR_FLAG | CAN_RTR_FLAG)) != 0) {
+        continue;
+      }
+      const bool extended = (frame.can_id & CAN_EFF_FLAG) != 0;
+      processFrame(frame.can_id & (extended ? CAN_EFF_MASK : CAN_SFF_MASK), extended, frame.data,
+                   frame.can_dlc);
+    }
+    if (received < kBatchSize) {
+      break;
+    }
+  }
+  deliver();
+}
+
+#else
+
+// LCOV_EXCL_START - SocketCAN is Linux only
+bool CanSource::open(const QString& interface) {
+  m_error = QStringLiteral("CAN interface %1: SocketCAN is not available").arg(interface);
+  return false;
+}
+
+void CanSource::close() {}
+
+void CanSource::onReadyRead() {}
+// LCOV_EXCL_STOP
+
+#endif
@@ -0,0 +1,85 @@
+#include "Clock.hpp"
+
+#include <QTimer>
+
+namespace {
+
+/**
+ * @brief ClockTimer of the system clock: a QTimer
+ */
+class SystemClockTimer : public ClockTimer {
+ public:
+  explicit SystemClockTimer(QObject* parent) : ClockTimer(parent) {
+    connect(&m_timer, &QTimer::timeout, this, &ClockTimer::timeout);
+  }
+
+  void stop() override {
+    m_timer.stop();
+  }
+
+  bool isActive() const override {
+    return m_timer.isActive();
+  }
+
+ protected:
+  void arm() override {
+    m_timer.setSingleShot(isSingleShot());
+    m_timer.start(interval());
+  }
+
+ private:
+  QTimer m_timer; ///< Timer doing the work (a member, not a child)
+};
+
+} // namespace
+
+ClockTimer::ClockTimer(QObject* parent) : QObject(parent), m_intervalMs(0), m_singleShot(false) {}
+
+void ClockTimer::setInterval(int intervalMs) {
+  m_intervalMs = intervalMs;
+  if (isActive()) {
+    arm();
+  }
+}
+
+int ClockTimer::interval() const {
+  return m_intervalMs;
+}
+
+void ClockTimer::setSingleShot(bool singleShot) {
+  m_singleShot = singleShot;
+}
+
+bool ClockTimer::isSingleShot() const {
+  return m_singleShot;
+}
+
+void ClockTimer::start() {
+  arm();
+}
+
+void ClockTimer::start(int intervalMs) {
+  m_intervalMs = intervalMs;
+  arm();
+}
+
+Clock* Clock::system() {
+  static SystemClock clock;
+  return &clock;
+}
+
+SystemClock::SystemClock() {
+  m_monotonic.start();
+}
+
+qint64 SystemClock::elapsedMs() const {
+  return m_monotonic.elapsed();
+}
+
+QDateTime SystemClock::currentDateTime() const {
+  return QDateTime::currentDateTime();
+}
+
+ClockTimer* SystemClock::createTimer(QObject* parent) {
+  return new SystemClockTimer(parent);
+}
@@ -1,48 +1,131 @@
 #include "ClusterDataSubscriber.hpp"
 
 #include <QDateTime>
+#include <QDebug>
 #include <QRandomGenerator>
-#include <QTimer>
-
-// Connection string templates
-const QString CRITICAL_DATA_ADDRESS = "tcp://100.93.45.188:%1";
-const QString NON_CRITICAL_DATA_ADDRESS = "tcp://100.93.45.188:%1";
+#include <QSet>
+#include <utility>
+
+#include "ClusterProtocol.hpp"
+
+static_assert(CRITICAL_DATA_PORT == ClusterProtocol::kCriticalPort &&
+                  NON_CRITICAL_DATA_PORT == ClusterProtocol::kNonCriticalPort &&
+                  SNAPSHOT_PORT == ClusterProtocol::kSnapshotPort &&
+                  RATE_PORT == ClusterProtocol::kRatePort,
+              "Display ports differ from the protocol definition");
+
+// Connection string template (host, port)
+const QString DATA_ADDRESS = "tcp://%1:%2";
+
+// Keys of safety-critical frames, delivered ahead of queued telemetry
+const QStringList SAFETY_KEYS = {ClusterProtocol::kObstacle};
+
+// Sequence number keys of the critical and non-critical channels
+const QStringList SEQUENCE_KEYS = {ClusterProtocol::kCriticalSequence,
+                                   ClusterProtocol::kNonCriticalSequence};
+
+// Keys handled by processData(); the numeric values of any other key are generic vehicle signals
+const QSet<QString> PROTOCOL_KEYS = {ClusterProtocol::kSpeed,
+                                     ClusterProtocol::kLane,
+                                     ClusterProtocol::kObstacle,
+                                     ClusterProtocol::kSign,
+                                     ClusterProtocol::kDrivingMode,
+                                     ClusterProtocol::kBattery,
+                                     ClusterProtocol::kCharging,
+                                     ClusterProtocol::kOdometer,
+                                     ClusterProtocol::kCriticalSequence,
+                                     ClusterProtocol::kNonCriticalSequence};
+
+// Frames held back while a snapshot is awaited; beyond this, live data is not delayed further
+constexpr int kMaxPendingFrames = 1000;
+
+// Default time without frames before the link is reported stale
+constexpr int kDefaultStaleTimeoutMs = 1000;
+
+// Interval of the trip results while no frame arrives
+constexpr int kTripUpdateIntervalMs = 1000;
+
+// Convert mm/s to the displayed km/h scaled by 10: mm/s * 0.0036 = km/h
+static int displaySpeed(double mmPerSecond) {
+  return static_cast<int>(mmPerSecond * 0.0036 * 10);
+}
 
 ClusterDataSubscriber::ClusterDataSubscriber(ClusterModel* clusterModel, QObject* parent)
+    : ClusterDataSubscriber(clusterModel, nullptr, parent) {}
+
+ClusterDataSubscriber::ClusterDataSubscriber(ClusterModel* clusterModel, ClusterSignalHub* hub,
+                                             QObject* parent)
     : QObject(parent),
       m_clusterModel(clusterModel),
+      m_hub(hub),
+      m_frameListenerId(0),
+      m_priorityListenerId(0),
       m_parser(this),
+      m_clock(clusterModel->clock()),
       m_mockingEnabled(false),
-      m_currentSignType(""),
-      m_currentSignValue("") {
+      m_syncState(Unsynchronized),
+      m_snapshotTimeoutMs(0),
+      m_lastFrameMs(-1),
+      m_staleTimeoutMs(kDefaultStaleTimeoutMs),
+      m_connectedSources(0),
+      m_resyncOnReconnect(false),
+      m_odometerJournal(nullptr),
+      m_tripStartMs(m_clock->elapsedMs()),
+      m_currentSignKind(ClusterModel::NoSign),
+      m_currentSpeedLimit(0) {
   // LCOV_EXCL_START - Network initialization difficult to test in unit tests
-  // Create critical data subscriber (for speed, lane, etc.)
-  m_criticalSub =
-      std::make_unique<ZmqSubscriber>(CRITICAL_DATA_ADDRESS.arg(CRITICAL_DATA_PORT), this);
-  connect(m_criticalSub.get(), &ZmqSubscriber::messageReceived, this,
-          &ClusterDataSubscriber::handleCriticalData);
-
-  // Create non-critical data subscriber (for battery, charging, etc.)
-  m_nonCriticalSub =
-      std::make_unique<ZmqSubscriber>(NON_CRITICAL_DATA_ADDRESS.arg(NON_CRITICAL_DATA_PORT), this);
-  connect(m_nonCriticalSub.get(), &ZmqSubscriber::messageReceived, this,
-          &ClusterDataSubscriber::handleNonCriticalData);
+  // Without a shared hub, subscribe to the critical (speed, lane, etc.) and non-critical
+  // (battery, charging, etc.) data ports directly
+  if (!m_hub) {
+    m_ownedHub = std::make_unique<ClusterSignalHub>();
+    addDataSources(m_ownedHub.get());
+    m_hub = m_ownedHub.get();
+  }
   // LCOV_EXCL_STOP
 
+  // Frames arrive already decoded by the hub
+  m_frameListenerId = m_hub->subscribeFrames([this](const QMap<QString, QString>& data) {
+    if (!m_mockingEnabled) {
+      trackSequences(data);
+      handleFrame(data);
+    }
+  });
+  m_priorityListenerId = m_hub->subscribePriorityFrames(
+      [this](const QMap<QString, QString>& data) { handlePriorityFrame(data); });
+
+  // Link status follows the connections immediately and the frame age periodically
+  m_connectedSources = m_hub->connectedSourceCount();
+  connect(m_hub, &ClusterSignalHub::connectedSourcesChanged, this,
+          &ClusterDataSubscriber::onConnectedSourcesChanged);
+  m_linkTimer = m_clock->createTimer(this);
+  connect(m_linkTimer, &ClockTimer::timeout, this, &ClusterDataSubscriber::updateLinkStatus);
+  setStaleTimeout(kDefaultStaleTimeoutMs);
+  m_linkTimer->start();
+
+  // The trip computer follows the frames and keeps counting while values are held
+  m_tripTimer = m_clock->createTimer(this);
+  m_tripTimer->setInterval(kTripUpdateIntervalMs);
+  connect(m_tripTimer, &ClockTimer::timeout, this, &ClusterDataSubscriber::publishTrip);
+  m_tripTimer->start();
+  connect(m_clusterModel, &ClusterModel::tripResetRequested, this, [this]() {
+    m_tripComputer.reset(tripTimeMs());
+    publishTrip();
+  });
+
   // LCOV_EXCL_START - Timer setup difficult to test in unit tests
   // Create mock timer but don't start it yet
-  m_mockTimer = new QTimer(this);
+  m_mockTimer = m_clock->createTimer(this);
   m_mockTimer->setInterval(500); // Update every 500ms
-  connect(m_mockTimer, &QTimer::timeout, this, &ClusterDataSubscriber::generateMockData);
+  connect(m_mockTimer, &ClockTimer::timeout, this, &ClusterDataSubscriber::generateMockData);
 
   // Create sign hide timer but don't start it yet
-  m_signHideTimer = new QTimer(this);
+  m_signHideTimer = m_clock->createTimer(this);
   m_signHideTimer->setSingleShot(true);
-  connect(m_signHideTimer, &QTimer::timeout, [this]() {
+  connect(m_signHideTimer, &ClockTimer::timeout, [this]() {
     m_clusterModel->setSpeedLimitVisible(false);
     m_clusterModel->setSignVisible(false);
-    m_currentSignType = "";
-    m_currentSignValue = "";
+    m_currentSignKind = ClusterModel::NoSign;
+    m_currentSpeedLimit = 0;
   });
   // LCOV_EXCL_STOP
 }
@@ -59,14 +142,252 @@ ClusterDataSubscriber::~ClusterDataSubscriber() {
     m_signHideTimer->stop();
   }
   // LCOV_EXCL_STOP
+
+  m_hub->unsubscribe(m_frameListenerId);
+  m_hub->unsubscribe(m_priorityListenerId);
+}
+
+// LCOV_EXCL_START - Network initialization difficult to test in unit tests
+void ClusterDataSubscriber::addDataSources(ClusterSignalHub* hub, const QString& host,
+                                           const ZmqSocketOptions& options) {
+  hub->setPriorityKeys(SAFETY_KEYS);
+  hub->addSource(DATA_ADDRESS.arg(host).arg(CRITICAL_DATA_PORT), options);
+  hub->addSource(DATA_ADDRESS.arg(host).arg(NON_CRITICAL_DATA_PORT), options);
+}
+// LCOV_EXCL_STOP
+
+QString ClusterDataSubscriber::snapshotAddress(const QString& host) {
+  return DATA_ADDRESS.arg(host).arg(SNAPSHOT_PORT);
+}
+
+void ClusterDataSubscriber::synchronize(const QString& address, int timeoutMs) {
+  m_snapshotAddress = address;
+  m_snapshotTimeoutMs = timeoutMs;
+  m_snapshotClient = std::make_unique<ZmqSnapshotClient>(address, timeoutMs);
+  connect(m_snapshotClient.get(), &ZmqSnapshotClient::snapshotReceived, this,
+          &ClusterDataSubscriber::applySnapshot);
+  connect(m_snapshotClient.get(), &ZmqSnapshotClient::failed, this, [this]() {
+    qDebug() << "No state snapshot from the publisher, continuing with live data";
+    abandonSnapshot();
+  });
+
+  m_syncState = AwaitingSnapshot;
+  m_pendingFrames.clear();
+  m_snapshotSequences.clear();
+  m_snapshotClient->request();
+}
+
+QString ClusterDataSubscriber::rateAddress(const QString& host) {
+  return DATA_ADDRESS.arg(host).arg(RATE_PORT);
+}
+
+QMap<QString, qreal> ClusterDataSubscriber::maxUsefulRates(qreal refreshRate) {
+  return {
+      {ClusterProtocol::kSpeed, refreshRate},
+      {ClusterProtocol::kLane, refreshRate},
+      {ClusterProtocol::kDrivingMode, refreshRate},
+      // A sign stays up for seconds; repeats only prolong it
+      {ClusterProtocol::kSign, 5},
+      {ClusterProtocol::kBattery, 1},
+      {ClusterProtocol::kCharging, 2},
+      {ClusterProtocol::kOdometer, 1},
+  };
+}
+
+ClusterDataSubscriber::SyncState ClusterDataSubscriber::syncState() const {
+  return m_syncState;
+}
+
+void ClusterDataSubscriber::applySnapshot(const QString& snapshot) {
+  if (m_syncState != AwaitingSnapshot) {
+    return;
+  }
+
+  const QMap<QString, QString> state = m_parser.parseMessage(snapshot);
+  m_snapshotSequences.clear();
+  for (const QString& key : SEQUENCE_KEYS) {
+    bool ok = false;
+    const qint64 sequence = state.value(key).toLongLong(&ok);
+    if (ok) {
+      m_snapshotSequences.insert(key, sequence);
+    }
+  }
+  processData(state);
+  m_syncState = Synchronized;
+
+  // Frames that crossed the request on the wire are only applied if the snapshot predates them
+  const QVector<QMap<QString, QString>> pendingFrames = std::exchange(m_pendingFrames, {});
+  for (const QMap<QString, QString>& data : pendingFrames) {
+    handleFrame(data);
+  }
+  emit stateSynchronized();
+}
+
+void ClusterDataSubscriber::handlePriorityFrame(const QMap<QString, QString>& data) {
+  if (!m_mockingEnabled && processSafetyData(data)) {
+    emit safetyFrameProcessed();
+  }
+}
+
+void ClusterDataSubscriber::handleFrame(const QMap<QString, QString>& data) {
+  if (m_syncState == AwaitingSnapshot) {
+    if (m_pendingFrames.size() < kMaxPendingFrames) {
+      m_pendingFrames.append(data);
+      return;
+    }
+    abandonSnapshot();
+  }
+
+  if (!coveredBySnapshot(data)) {
+    processData(data);
+  }
+}
+
+bool ClusterDataSubscriber::coveredBySnapshot(const QMap<QString, QString>& data) {
+  for (const QString& key : SEQUENCE_KEYS) {
+    const auto sequence = data.constFind(key);
+    const auto snapshotSequence = m_snapshotSequences.constFind(key);
+    if (sequence == data.cend() || snapshotSequence == m_snapshotSequences.cend()) {
+      continue;
+    }
+    if (sequence.value().toLongLong() <= snapshotSequence.value()) {
+      return true;
+    }
+    m_snapshotSequences.remove(key);
+  }
+  return false;
+}
+
+void ClusterDataSubscriber::abandonSnapshot() {
+  if (m_syncState != AwaitingSnapshot) {
+    return;
+  }
+
+  m_syncState = Unsynchronized;
+  m_snapshotSequences.clear();
+  const QVector<QMap<QString, QString>> pendingFrames = std::exchange(m_pendingFrames, {});
+  for (const QMap<QString, QString>& data : pendingFrames) {
+    processData(data);
+  }
+}
+
+SequenceTracker ClusterDataSubscriber::sequenceTracker(const QString& key) const {
+  return m_sequenceTrackers.value(key);
+}
+
+const TripComputer& ClusterDataSubscriber::tripComputer() const {
+  return m_tripComputer;
+}
+
+const RangeEstimator& ClusterDataSubscriber::rangeEstimator() const {
+  return m_rangeEstimator;
+}
+
+const LocalOdometer& ClusterDataSubscriber::localOdometer() const {
+  return m_localOdometer;
+}
+
+void ClusterDataSubscriber::setOdometerJournal(OdometerJournal* journal) {
+  m_odometerJournal = journal;
+  if (!journal) {
+    return;
+  }
+
+  const qint64 journaled = journal->restore();
+  m_localOdometer.seed(journaled >= 0 ? journaled
+                                      : m_clusterModel->odometer() *
+                                            LocalOdometer::kMicrometersPerMeter);
+  publishOdometer();
 }
 
+void ClusterDataSubscriber::attachCanSource(CanSource* source) {
+  source->setPriorityKeys(SAFETY_KEYS);
+  connect(source, &CanSource::priorityFrameReceived, this,
+          &ClusterDataSubscriber::handlePriorityFrame);
+  connect(source, &CanSource::frameReceived, this, [this](const QMap<QString, QString>& data) {
+    if (!m_mockingEnabled) {
+      trackSequences(data);
+      handleFrame(data);
+    }
+  });
+}
+
+void ClusterDataSubscriber::setStaleTimeout(int timeoutMs) {
+  m_staleTimeoutMs = timeoutMs;
+  // Check often enough that a stale link is reported at most a quarter late
+  m_linkTimer->setInterval(qBound(10, timeoutMs / 4, 250));
+}
+
+void ClusterDataSubscriber::trackSequences(const QMap<QString, QString>& data) {
+  m_lastFrameMs = m_clock->elapsedMs();
+
+  for (const QString& key : SEQUENCE_KEYS) {
+    const auto value = data.constFind(key);
+    if (value == data.cend()) {
+      continue;
+    }
+
+    SequenceTracker& tracker = m_sequenceTrackers[key];
+    const qint64 lostBefore = tracker.lost();
+    switch (tracker.track(value.value().toLongLong())) {
+    case SequenceTracker::Gap:
+      qDebug() << "Frames lost on" << key << ":" << tracker.lost() - lostBefore;
+      break;
+    case SequenceTracker::Restart:
+      // The snapshot numbers belong to the previous run of the publisher
+      qDebug() << "Publisher restarted on" << key;
+      m_snapshotSequences.remove(key);
+      break;
+    default:
+      break;
+    }
+  }
+
+  if (m_clusterModel->linkStatus() != ClusterModel::LinkUp) {
+    updateLinkStatus();
+  }
+}
+
+void ClusterDataSubscriber::updateLinkStatus() {
+  ClusterModel::LinkStatus status = ClusterModel::LinkUp;
+  if (!m_mockingEnabled) {
+    // A hub without sockets is fed directly; only the frame age tells its state
+    const bool disconnected = m_hub->sourceCount() > 0 && m_connectedSources == 0;
+    if (disconnected || (m_lastFrameMs < 0 && m_hub->sourceCount() == 0)) {
+      status = ClusterModel::LinkDown;
+    } else if (m_lastFrameMs < 0 || m_clock->elapsedMs() - m_lastFrameMs > m_staleTimeoutMs) {
+      status = ClusterModel::LinkStale;
+    }
+  }
+  m_clusterModel->setLinkStatus(status);
+}
+
+// LCOV_EXCL_START - Connection events require a publisher going up and down
+void ClusterDataSubscriber::onConnectedSourcesChanged(int connectedSources) {
+  const int previous = std::exchange(m_connectedSources, connectedSources);
+  if (connectedSources < previous) {
+    // The first frames of a restarted publisher may be missed while reconnecting
+    for (SequenceTracker& tracker : m_sequenceTrackers) {
+      tracker.expectRestart();
+    }
+    m_resyncOnReconnect = m_resyncOnReconnect || connectedSources == 0;
+  } else if (connectedSources > previous && m_resyncOnReconnect &&
+             !m_snapshotAddress.isEmpty() && m_syncState != AwaitingSnapshot) {
+    // Fetch the state the publisher built up while the display was cut off
+    m_resyncOnReconnect = false;
+    synchronize(m_snapshotAddress, m_snapshotTimeoutMs);
+  }
+  updateLinkStatus();
+}
+// LCOV_EXCL_STOP
+
 void ClusterDataSubscriber::enableMocking(bool enable) {
   if (m_mockingEnabled == enable) {
     return; // No change
   }
 
   m_mockingEnabled = enable;
+  updateLinkStatus();
 
   // LCOV_EXCL_START - Timer operations difficult to test in unit tests
   if (m_mockingEnabled) {
@@ -99,6 +420,23 @@ void ClusterDataSubscriber::handleNonCriticalData(const QString& message) {
   }
 }
 
+void ClusterDataSubscriber::processVehicleSignals(const QMap<QString, QString>& data) {
+  for (auto it = data.cbegin(); it != data.cend(); ++it) {
+    if (PROTOCOL_KEYS.contains(it.key())) {
+      continue;
+    }
+    bool isNumeric = false;
+    const double value = it.value().toDouble(&isNumeric);
+    if (!isNumeric) {
+      continue;
+    }
+    const SignalStore::SignalId id = m_clusterModel->registerVehicleSignal(it.key());
+    if (id != SignalStore::kInvalidSignal) {
+      m_clusterModel->signalStore().set(id, value);
+    }
+  }
+}
+
 // LCOV_EXCL_START - Mock data generation code doesn't need coverage
 void ClusterDataSubscriber::generateMockData() {
   if (!m_mockingEnabled) {
@@ -161,24 +499,112 @@ void ClusterDataSubscriber::generateMockData() {
     mockData["charging"] = QString::number(charging ? 1 : 0);
   }
 
-  // Odometer (constantly increasing)
-  static int odo = 0;
-  odo += speedKmH / 10; // Faster increase at higher speeds
-  mockData["odo"] = QString::number(odo);
+  // No odometer: the local odometer integrates the mock speed
 
   // Process the mock data
   processData(mockData);
 }
 // LCOV_EXCL_STOP
 
+void ClusterDataSubscriber::updateTrip(const QMap<QString, QString>& data) {
+  const qint64 now = tripTimeMs();
+  // Charging first, so a battery rise in the same frame is not taken for jitter
+  const auto charging = data.constFind(ClusterProtocol::kCharging);
+  if (charging != data.cend()) {
+    const bool isCharging = charging.value().toInt() == 1;
+    m_tripComputer.setCharging(now, isCharging);
+    m_rangeEstimator.setCharging(now, isCharging);
+  }
+  const auto battery = data.constFind(ClusterProtocol::kBattery);
+  if (battery != data.cend()) {
+    m_tripComputer.addBattery(now, battery.value().toInt());
+    // A drop closes the measured stretch with the distance driven up to now
+    m_localOdometer.advance(now);
+    m_rangeEstimator.addDistance(now, m_localOdometer.driven());
+    m_rangeEstimator.addBattery(now, battery.value().toInt());
+  }
+  const auto speed = data.constFind(ClusterProtocol::kSpeed);
+  if (speed != data.cend()) {
+    m_tripComputer.addSpeed(now, speed.value().toInt());
+    if (!m_localOdometer.isKnown()) {
+      // Without a journal or publisher value yet, count on from the restored figure
+      m_localOdometer.seed(m_clusterModel->odometer() * LocalOdometer::kMicrometersPerMeter);
+    }
+    m_localOdometer.addSpeed(now, speed.value().toInt());
+  }
+  const auto odometer = data.constFind(ClusterProtocol::kOdometer);
+  if (odometer != data.cend()) {
+    m_tripComputer.addOdometer(now, odometer.value().toLongLong());
+    m_localOdometer.addPublisherValue(odometer.value().toLongLong());
+  }
+  if (speed != data.cend() || odometer != data.cend() || battery != data.cend()) {
+    publishTrip();
+  }
+  if ((speed != data.cend() || odometer != data.cend()) && m_localOdometer.isKnown()) {
+    // A live sample went into the figure, so a restored odometer is confirmed
+    m_clusterModel->setOdometer(static_cast<int>(m_localOdometer.meters()));
+  }
+}
+
+qint64 ClusterDataSubscriber::tripTimeMs() const {
+  return m_clock->elapsedMs() - m_tripStartMs;
+}
+
+void ClusterDataSubscriber::publishTrip() {
+  const qint64 now = tripTimeMs();
+  if (m_clusterModel->linkStatus() == ClusterModel::LinkDown) {
+    m_tripComputer.interrupt(now);
+    m_rangeEstimator.interrupt(now);
+    m_localOdometer.interrupt();
+  } else {
+    m_tripComputer.advance(now);
+    m_localOdometer.advance(now);
+    m_rangeEstimator.addDistance(now, m_localOdometer.driven());
+  }
+
+  m_clusterModel->setTripDistance(static_cast<int>(m_tripComputer.distance()));
+  m_clusterModel->setTripMovingTime(static_cast<int>(m_tripComputer.movingTimeMs() / 1000));
+  m_clusterModel->setTripAverageSpeed(displaySpeed(m_tripComputer.averageSpeed()));
+  m_clusterModel->setTripMaxSpeed(displaySpeed(m_tripComputer.maxSpeed()));
+  m_clusterModel->setRecentMaxSpeed(displaySpeed(m_tripComputer.recentMaxSpeed(now)));
+  m_clusterModel->setTripEnergyUsed(m_tripComputer.energyUsed());
+  m_clusterModel->setEstimatedRange(static_cast<int>(m_rangeEstimator.range()));
+  publishOdometer();
+}
+
+void ClusterDataSubscriber::publishOdometer() {
+  if (!m_localOdometer.isKnown()) {
+    return;
+  }
+  // Journal seeds and held speed are not live data; updateTrip() confirms the figure
+  m_clusterModel->setUnconfirmedOdometer(static_cast<int>(m_localOdometer.meters()));
+  if (m_odometerJournal) {
+    m_odometerJournal->record(m_localOdometer.micrometers());
+  }
+}
+
+bool ClusterDataSubscriber::processSafetyData(const QMap<QString, QString>& data) {
+  const auto obs = data.constFind(ClusterProtocol::kObstacle);
+  if (obs == data.cend()) {
+    return false;
+  }
+
+  int obsValue = obs.value().toInt();
+  bool hasObstacle = obsValue > 0;
+  m_clusterModel->setObjectAlert(hasObstacle);
+
+  // Emergency brake alert is triggered specifically by obs:2
+  m_clusterModel->setEmergencyBrakeActive(obsValue == 2);
+  return true;
+}
+
 void ClusterDataSubscriber::processData(const QMap<QString, QString>& data) {
-  // Handle speed - convert from mm/s to km/h
+  updateTrip(data);
+  processVehicleSignals(data);
+
+  // Handle speed - convert from mm/s to km/h, scaled by 10 for display
   if (data.contains("speed")) {
-    int speedMmPerSec = data["speed"].toInt();
-    // Convert mm/s to km/h: mm/s * 0.0036 = km/h
-    // Then multiply by 10 for scaled display
-    int speedKmPerHour = static_cast<int>(speedMmPerSec * 0.0036 * 10);
-    m_clusterModel->setSpeed(speedKmPerHour);
+    m_clusterModel->setSpeed(displaySpeed(data["speed"].toInt()));
   }
 
   // Handle battery level
@@ -196,66 +622,52 @@ void ClusterDataSubscriber::processData(const QMap<QString, QString>& data) {
     int lane = data["lane"].toInt();
     if (lane == 1) {
       m_clusterModel->setLaneAlert(true);
-      m_clusterModel->setLaneDeviationSide("left");
+      m_clusterModel->setLaneSide(ClusterModel::LeftLane);
     } else if (lane == 2) {
       m_clusterModel->setLaneAlert(true);
-      m_clusterModel->setLaneDeviationSide("right");
+      m_clusterModel->setLaneSide(ClusterModel::RightLane);
     } else {
       m_clusterModel->setLaneAlert(false);
     }
   }
 
   // Handle obstacle detection
-  if (data.contains("obs")) {
-    int obsValue = data["obs"].toInt();
-    bool hasObstacle = obsValue > 0;
-    m_clusterModel->setObjectAlert(hasObstacle);
-
-    // Emergency brake alert is triggered specifically by obs:2
-    m_clusterModel->setEmergencyBrakeActive(obsValue == 2);
-  }
+  processSafetyData(data);
 
   // Handle speed limit signal
   if (data.contains("sign")) {
     QString signValue = data["sign"];
-    QString signType;
-    QString displayValue;
+    ClusterModel::SignKind signKind;
 
-    // Determine sign type and display value
+    // Determine sign kind; only speed limits carry a value of their own
     bool isNumeric;
     int speedLimit = signValue.toInt(&isNumeric);
 
     if (isNumeric) {
       // Traditional speed limit sign
-      signType = "SPEED_LIMIT";
-      displayValue = QString::number(speedLimit);
-    } else if (signValue == "stop") {
-      // Stop sign
-      signType = "STOP";
-      displayValue = "STOP";
-    } else if (signValue == "crosswalk") {
-      // Crosswalk sign
-      signType = "CROSSWALK";
-      displayValue = "CROSSWALK";
-    } else if (signValue == "yield") {
-      // Yield sign
-      signType = "YIELD";
-      displayValue = "YIELD";
+      signKind = ClusterModel::SpeedLimitSign;
+    } else if (signValue == QLatin1String("stop")) {
+      signKind = ClusterModel::StopSign;
+    } else if (signValue == QLatin1String("crosswalk")) {
+      signKind = ClusterModel::CrosswalkSign;
+    } else if (signValue == QLatin1String("yield")) {
+      signKind = ClusterModel::YieldSign;
     } else {
       // Unknown sign type, skip processing
       return;
     }
 
     // Check if this is the same sign we're currently displaying
-    bool isSameSign = (m_currentSignType == signType && m_currentSignValue == displayValue);
+    bool isSameSign = (m_currentSignKind == signKind &&
+                       (!isNumeric || m_currentSpeedLimit == speedLimit));
 
     if (isSameSign) {
       // Same sign detected - just prolong the display by restarting the timer
       m_signHideTimer->start(6000);
     } else {
       // Different sign or no current sign - update display and start new timer
-      m_currentSignType = signType;
-      m_currentSignValue = displayValue;
+      m_currentSignKind = signKind;
+      m_currentSpeedLimit = isNumeric ? speedLimit : 0;
 
       if (isNumeric) {
         // Traditional speed limit sign
@@ -266,13 +678,13 @@ void ClusterDataSubscriber::processData(const QMap<QString, QString>& data) {
         m_clusterModel->setLastSpeedLimit(speedLimit);
 
         // Also update the new generic sign system for consistency
-        m_clusterModel->setSignType(signType);
-        m_clusterModel->setSignValue(displayValue);
+        m_clusterModel->setSignKind(signKind);
+        m_clusterModel->setSignValue(QString::number(speedLimit));
         m_clusterModel->setSignVisible(true);
       } else {
-        // Non-numeric sign (stop, crosswalk, etc.)
-        m_clusterModel->setSignType(signType);
-        m_clusterModel->setSignValue(displayValue);
+        // Non-numeric sign (stop, crosswalk, etc.); the display text is the sign type
+        m_clusterModel->setSignKind(signKind);
+        m_clusterModel->setSignValue(m_clusterModel->signType());
         m_clusterModel->setSignVisible(true);
 
         // Hide old speed limit display
@@ -286,11 +698,9 @@ void ClusterDataSubscriber::processData(const QMap<QString, QString>& data) {
 
   // Handle driving mode
   if (data.contains("mode")) {
-    m_clusterModel->setDrivingMode(data["mode"].toInt() == 1 ? "AUTO" : "MAN");
+    m_clusterModel->setDrivingModeType(data["mode"].toInt() == 1 ? ClusterModel::AutoMode
+                                                                 : ClusterModel::ManualMode);
   }
 
-  // Handle odometer
-  if (data.contains("odo")) {
-    m_clusterModel->setOdometer(data["odo"].toInt());
-  }
+  // The odometer is reconciled with the local one in updateTrip()
 }
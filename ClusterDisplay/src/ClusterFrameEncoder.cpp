@@ -0,0 +1,71 @@
+#include "ClusterFrameEncoder.hpp"
+
+#include <charconv>
+#include <cstring>
+
+#include "ClusterProtocol.hpp"
+
+ClusterFrameEncoder::ClusterFrameEncoder() : m_size(0), m_truncated(false) {}
+
+void ClusterFrameEncoder::clear() {
+  m_size = 0;
+  m_truncated = false;
+}
+
+bool ClusterFrameEncoder::append(const char* key, int64_t value) {
+  // Longest int64 in decimal including the sign
+  char digits[20];
+  const std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+  return append(key, digits, static_cast<size_t>(result.ptr - digits));
+}
+
+bool ClusterFrameEncoder::append(const char* key, const char* value, size_t length) {
+  // The display drops empty values, and a separator would split the value into pairs of its own
+  if (length == 0 || std::memchr(value, ClusterProtocol::kPairSeparator, length) ||
+      std::memchr(value, ClusterProtocol::kKeyValueSeparator, length)) {
+    m_truncated = true;
+    return false;
+  }
+
+  char* destination = beginPair(key, length);
+  if (!destination) {
+    return false;
+  }
+  std::memcpy(destination, value, length);
+  return true;
+}
+
+const char* ClusterFrameEncoder::data() const {
+  return m_buffer;
+}
+
+size_t ClusterFrameEncoder::size() const {
+  return m_size;
+}
+
+bool ClusterFrameEncoder::isEmpty() const {
+  return m_size == 0;
+}
+
+bool ClusterFrameEncoder::isTruncated() const {
+  return m_truncated;
+}
+
+char* ClusterFrameEncoder::beginPair(const char* key, size_t valueLength) {
+  const size_t keyLength = std::strlen(key);
+  const size_t separatorLength = m_size > 0 ? 1 : 0;
+  if (m_size + separatorLength + keyLength + 1 + valueLength > kCapacity) {
+    m_truncated = true;
+    return nullptr;
+  }
+
+  char* position = m_buffer + m_size;
+  if (separatorLength) {
+    *position++ = ClusterProtocol::kPairSeparator;
+  }
+  std::memcpy(position, key, keyLength);
+  position += keyLength;
+  *position++ = ClusterProtocol::kKeyValueSeparator;
+  m_size = static_cast<size_t>(position - m_buffer) + valueLength;
+  return position;
+}
@@ -2,147 +2,436 @@
 
 #include <QDateTime>
 #include <QRandomGenerator>
-#include <QTimer>
 #include <QtMath>
+#include <cstring>
 
-ClusterModel::ClusterModel(QObject* parent)
+#include "FlightRecorder.hpp"
+
+ClusterModel* ClusterModel::s_qmlInstance = nullptr;
+
+ClusterModel::ClusterModel(QObject* parent) : ClusterModel(nullptr, parent) {}
+
+ClusterModel::ClusterModel(Clock* clock, QObject* parent)
     : QObject(parent),
-      m_speed(0),
-      m_battery(100),
-      m_charging(false),
-      m_odometer(0),
-      m_drivingMode("MAN"),
-      m_objectAlert(false),
-      m_emergencyBrakeActive(false),
-      m_laneAlert(false),
-      m_laneDeviationSide("left"),
-      m_speedLimitSignal(50),
-      m_speedLimitVisible(false),
-      m_signType(""),
       m_signValue(""),
-      m_signVisible(false),
-      m_lastSpeedLimit(0) {
+      m_highlightedLane(NoLane),
+      m_visibleSign(NoSign),
+      m_speedLimitExceeded(false),
+      m_alertSeverity(NoAlert),
+      m_tripDistance(0),
+      m_tripMovingTime(0),
+      m_tripAverageSpeed(0),
+      m_tripMaxSpeed(0),
+      m_recentMaxSpeed(0),
+      m_tripEnergyUsed(0),
+      m_estimatedRange(-1),
+      m_linkStatus(LinkDown),
+      m_provisionalFields(NoProvisionalField),
+      m_clock(clock ? clock : Clock::system()),
+      m_stateRevision(0) {
+  // The property values come first in the store, under their property names
+  const struct {
+    const char* name;
+    double initial;
+  } propertyValues[PropertyValueCount] = {
+      {"speed", 0},
+      {"battery", 100},
+      {"charging", 0},
+      {"odometer", 0},
+      {"drivingModeType", ManualMode},
+      {"objectAlert", 0},
+      {"emergencyBrakeActive", 0},
+      {"laneAlert", 0},
+      {"laneSide", LeftLane},
+      {"speedLimitSignal", 50},
+      {"speedLimitVisible", 0},
+      {"signKind", NoSign},
+      {"signVisible", 0},
+      {"lastSpeedLimit", 0},
+  };
+  for (const auto& propertyValue : propertyValues) {
+    m_store.registerSignal(QLatin1String(propertyValue.name), propertyValue.initial);
+  }
+  m_vehicleSignals = new SignalPropertyMap(&m_store, this);
+
   // Initialize time update timer
-  m_timeUpdateTimer = new QTimer(this);
+  m_timeUpdateTimer = m_clock->createTimer(this);
   m_timeUpdateTimer->setInterval(1000); // Update every second
-  connect(m_timeUpdateTimer, &QTimer::timeout, this, &ClusterModel::updateDateTime);
+  connect(m_timeUpdateTimer, &ClockTimer::timeout, this, &ClusterModel::updateDateTime);
   m_timeUpdateTimer->start();
 
   // Initial update of date/time
   updateDateTime();
+
+  // Readers see the initial values before the first change
+  publishState();
 }
 
 ClusterModel::~ClusterModel() {
   m_timeUpdateTimer->stop();
+
+  if (s_qmlInstance == this) {
+    s_qmlInstance = nullptr;
+  }
+}
+
+void ClusterModel::setQmlInstance(ClusterModel* instance) {
+  s_qmlInstance = instance;
+}
+
+ClusterModel* ClusterModel::create(QQmlEngine* qmlEngine, QJSEngine* jsEngine) {
+  Q_UNUSED(qmlEngine);
+  Q_UNUSED(jsEngine);
+  Q_ASSERT(s_qmlInstance);
+
+  // The application owns the model; keep the JS garbage collector away from it
+  QJSEngine::setObjectOwnership(s_qmlInstance, QJSEngine::CppOwnership);
+  return s_qmlInstance;
+}
+
+ClusterModel::State ClusterModel::latestState() const {
+  return m_stateBuffer.read();
+}
+
+QString ClusterModel::drivingMode() const {
+  return drivingModeType() == AutoMode ? QStringLiteral("AUTO") : QStringLiteral("MAN");
+}
+
+QString ClusterModel::laneDeviationSide() const {
+  return laneSide() == RightLane ? QStringLiteral("right") : QStringLiteral("left");
+}
+
+QString ClusterModel::signType() const {
+  switch (signKind()) {
+    case SpeedLimitSign:
+      return QStringLiteral("SPEED_LIMIT");
+    case StopSign:
+      return QStringLiteral("STOP");
+    case CrosswalkSign:
+      return QStringLiteral("CROSSWALK");
+    case YieldSign:
+      return QStringLiteral("YIELD");
+    case NoSign:
+      break;
+  }
+  return QString();
 }
 
 void ClusterModel::setSpeed(int value) {
-  if (m_speed != value) {
-    m_speed = value;
+  if (m_store.set(SpeedValue, value)) {
     emit speedChanged(value);
+    updateDerivedState();
+    publishState();
   }
 }
 
 void ClusterModel::setBattery(int value) {
-  if (m_battery != value) {
-    m_battery = value;
+  confirmField(BatteryField);
+  if (m_store.set(BatteryValue, value)) {
     emit batteryChanged(value);
+    publishState();
   }
 }
 
 void ClusterModel::setCharging(bool value) {
-  if (m_charging != value) {
-    m_charging = value;
+  confirmField(ChargingField);
+  if (m_store.set(ChargingValue, value)) {
     emit chargingChanged(value);
+    publishState();
   }
 }
 
 void ClusterModel::setOdometer(int value) {
-  if (m_odometer != value) {
-    m_odometer = value;
+  confirmField(OdometerField);
+  setUnconfirmedOdometer(value);
+}
+
+void ClusterModel::setUnconfirmedOdometer(int value) {
+  if (m_store.set(OdometerValue, value)) {
     emit odometerChanged(value);
+    publishState();
   }
 }
 
 void ClusterModel::setDrivingMode(const QString& value) {
-  if (m_drivingMode != value) {
-    m_drivingMode = value;
-    emit drivingModeChanged(value);
+  setDrivingModeType(value == QLatin1String("AUTO") ? AutoMode : ManualMode);
+}
+
+void ClusterModel::setDrivingModeType(DrivingMode value) {
+  confirmField(DrivingModeField);
+  if (m_store.set(DrivingModeValue, value)) {
+    emit drivingModeTypeChanged(value);
+    emit drivingModeChanged(drivingMode());
+    publishState();
   }
 }
 
 void ClusterModel::setObjectAlert(bool value) {
-  if (m_objectAlert != value) {
-    m_objectAlert = value;
+  if (m_store.set(ObjectAlertValue, value)) {
     emit objectAlertChanged(value);
+    updateDerivedState();
+    publishState();
   }
 }
 
 void ClusterModel::setEmergencyBrakeActive(bool value) {
-  if (m_emergencyBrakeActive != value) {
-    m_emergencyBrakeActive = value;
+  if (m_store.set(EmergencyBrakeValue, value)) {
     emit emergencyBrakeActiveChanged(value);
+    updateDerivedState();
+    publishState();
   }
 }
 
 void ClusterModel::setLaneAlert(bool value) {
-  if (m_laneAlert != value) {
-    m_laneAlert = value;
+  if (m_store.set(LaneAlertValue, value)) {
     emit laneAlertChanged(value);
+    updateDerivedState();
+    publishState();
   }
 }
 
 void ClusterModel::setLaneDeviationSide(const QString& value) {
-  if (m_laneDeviationSide != value) {
-    m_laneDeviationSide = value;
-    emit laneDeviationSideChanged(value);
+  setLaneSide(value == QLatin1String("right") ? RightLane : LeftLane);
+}
+
+void ClusterModel::setLaneSide(LaneSide value) {
+  if (value == NoLane) {
+    return; // A deviation always has a side; use setLaneAlert(false) to clear it
+  }
+
+  if (m_store.set(LaneSideValue, value)) {
+    emit laneSideChanged(value);
+    emit laneDeviationSideChanged(laneDeviationSide());
+    updateDerivedState();
+    publishState();
   }
 }
 
 void ClusterModel::setSpeedLimitSignal(int value) {
-  if (m_speedLimitSignal != value) {
-    m_speedLimitSignal = value;
+  confirmField(SpeedLimitSignalField);
+  if (m_store.set(SpeedLimitValue, value)) {
     emit speedLimitSignalChanged(value);
+    publishState();
   }
 }
 
 void ClusterModel::setSpeedLimitVisible(bool value) {
-  if (m_speedLimitVisible != value) {
-    m_speedLimitVisible = value;
+  if (m_store.set(SpeedLimitVisibleValue, value)) {
     emit speedLimitVisibleChanged(value);
+    updateDerivedState();
+    publishState();
   }
 }
 
 void ClusterModel::setSignType(const QString& value) {
-  if (m_signType != value) {
-    m_signType = value;
-    emit signTypeChanged(value);
+  SignKind kind = NoSign;
+  if (value == QLatin1String("SPEED_LIMIT")) {
+    kind = SpeedLimitSign;
+  } else if (value == QLatin1String("STOP")) {
+    kind = StopSign;
+  } else if (value == QLatin1String("CROSSWALK")) {
+    kind = CrosswalkSign;
+  } else if (value == QLatin1String("YIELD")) {
+    kind = YieldSign;
+  }
+  setSignKind(kind);
+}
+
+void ClusterModel::setSignKind(SignKind value) {
+  if (m_store.set(SignKindValue, value)) {
+    emit signKindChanged(value);
+    emit signTypeChanged(signType());
+    updateDerivedState();
+    publishState();
   }
 }
 
 void ClusterModel::setSignValue(const QString& value) {
   if (m_signValue != value) {
     m_signValue = value;
+    m_signValueUtf8 = value.toUtf8();
     emit signValueChanged(value);
+    publishState();
   }
 }
 
 void ClusterModel::setSignVisible(bool value) {
-  if (m_signVisible != value) {
-    m_signVisible = value;
+  if (m_store.set(SignVisibleValue, value)) {
     emit signVisibleChanged(value);
+    updateDerivedState();
+    publishState();
   }
 }
 
 void ClusterModel::setLastSpeedLimit(int value) {
-  if (m_lastSpeedLimit != value) {
-    m_lastSpeedLimit = value;
+  confirmField(LastSpeedLimitField);
+  if (m_store.set(LastSpeedLimitValue, value)) {
     emit lastSpeedLimitChanged(value);
+    updateDerivedState();
+    publishState();
+  }
+}
+
+void ClusterModel::setLinkStatus(LinkStatus value) {
+  if (m_linkStatus != value) {
+    m_linkStatus = value;
+    emit linkStatusChanged(value);
+  }
+}
+
+void ClusterModel::setTripDistance(int value) {
+  if (m_tripDistance != value) {
+    m_tripDistance = value;
+    emit tripDistanceChanged(value);
+  }
+}
+
+void ClusterModel::setTripMovingTime(int value) {
+  if (m_tripMovingTime != value) {
+    m_tripMovingTime = value;
+    emit tripMovingTimeChanged(value);
+  }
+}
+
+void ClusterModel::setTripAverageSpeed(int value) {
+  if (m_tripAverageSpeed != value) {
+    m_tripAverageSpeed = value;
+    emit tripAverageSpeedChanged(value);
   }
 }
 
+void ClusterModel::setTripMaxSpeed(int value) {
+  if (m_tripMaxSpeed != value) {
+    m_tripMaxSpeed = value;
+    emit tripMaxSpeedChanged(value);
+  }
+}
+
+void ClusterModel::setRecentMaxSpeed(int value) {
+  if (m_recentMaxSpeed != value) {
+    m_recentMaxSpeed = value;
+    emit recentMaxSpeedChanged(value);
+  }
+}
+
+void ClusterModel::setTripEnergyUsed(int value) {
+  if (m_tripEnergyUsed != value) {
+    m_tripEnergyUsed = value;
+    emit tripEnergyUsedChanged(value);
+  }
+}
+
+void ClusterModel::setEstimatedRange(int value) {
+  if (m_estimatedRange != value) {
+    m_estimatedRange = value;
+    emit estimatedRangeChanged(value);
+  }
+}
+
+void ClusterModel::resetTrip() {
+  emit tripResetRequested();
+}
+
+SignalStore::SignalId ClusterModel::registerVehicleSignal(const QString& name) {
+  // A property value is only changed through its setter, which emits its own signal
+  const SignalStore::SignalId id = m_store.registerSignal(name);
+  return id < PropertyValueCount ? SignalStore::kInvalidSignal : id;
+}
+
+void ClusterModel::setProvisionalFields(ProvisionalFields value) {
+  if (m_provisionalFields != value) {
+    m_provisionalFields = value;
+    emit provisionalFieldsChanged(value);
+  }
+}
+
+void ClusterModel::confirmField(ProvisionalField field) {
+  // Live data confirms a restored value even when it is unchanged
+  if (m_provisionalFields.testFlag(field)) {
+    setProvisionalFields(m_provisionalFields & ~ProvisionalFields(field));
+  }
+}
+
+void ClusterModel::updateDerivedState() {
+  LaneSide highlightedLane = laneAlert() ? laneSide() : NoLane;
+  if (m_highlightedLane != highlightedLane) {
+    m_highlightedLane = highlightedLane;
+    emit highlightedLaneChanged(highlightedLane);
+  }
+
+  // The legacy speed limit display has no sign kind of its own
+  SignKind visibleSign = NoSign;
+  if (signVisible() || speedLimitVisible()) {
+    visibleSign = signKind() != NoSign ? signKind() : SpeedLimitSign;
+  }
+  if (m_visibleSign != visibleSign) {
+    m_visibleSign = visibleSign;
+    emit visibleSignChanged(visibleSign);
+  }
+
+  // Speed is scaled by 10 for display while the speed limit is not
+  bool speedLimitExceeded = lastSpeedLimit() > 0 && speed() > lastSpeedLimit();
+  if (m_speedLimitExceeded != speedLimitExceeded) {
+    m_speedLimitExceeded = speedLimitExceeded;
+    emit speedLimitExceededChanged(speedLimitExceeded);
+  }
+
+  AlertSeverity alertSeverity = NoAlert;
+  if (emergencyBrakeActive()) {
+    alertSeverity = CriticalAlert;
+  } else if (objectAlert()) {
+    alertSeverity = WarningAlert;
+  } else if (laneAlert() || m_speedLimitExceeded) {
+    alertSeverity = AdvisoryAlert;
+  }
+  if (m_alertSeverity != alertSeverity) {
+    m_alertSeverity = alertSeverity;
+    FlightRecorder::trace(FlightRecorder::AlertChanged, alertSeverity,
+                          (emergencyBrakeActive() ? 2 : 0) | (objectAlert() ? 1 : 0));
+    emit alertSeverityChanged(alertSeverity);
+  }
+}
+
+void ClusterModel::publishState() {
+  State& state = m_stateBuffer.writeBuffer();
+  state.revision = ++m_stateRevision;
+  state.speed = speed();
+  state.battery = battery();
+  state.charging = charging();
+  state.odometer = odometer();
+  state.drivingMode = drivingModeType();
+  state.objectAlert = objectAlert();
+  state.emergencyBrakeActive = emergencyBrakeActive();
+  state.laneAlert = laneAlert();
+  state.laneSide = laneSide();
+  state.speedLimitSignal = speedLimitSignal();
+  state.speedLimitVisible = speedLimitVisible();
+  state.signKind = signKind();
+  size_t signValueLength =
+      qMin(static_cast<size_t>(m_signValueUtf8.size()), sizeof(state.signValue) - 1);
+  if (signValueLength < static_cast<size_t>(m_signValueUtf8.size())) {
+    // Cut before the character that does not fit, not inside it (continuation bytes are 10xxxxxx)
+    while (signValueLength > 0 &&
+           (static_cast<uchar>(m_signValueUtf8[signValueLength]) & 0xc0) == 0x80) {
+      --signValueLength;
+    }
+  }
+  std::memcpy(state.signValue, m_signValueUtf8.constData(), signValueLength);
+  state.signValue[signValueLength] = '\0';
+  state.signVisible = signVisible();
+  state.lastSpeedLimit = lastSpeedLimit();
+  state.highlightedLane = m_highlightedLane;
+  state.visibleSign = m_visibleSign;
+  state.speedLimitExceeded = m_speedLimitExceeded;
+  state.alertSeverity = m_alertSeverity;
+  m_stateBuffer.publish();
+
+  FlightRecorder::trace(FlightRecorder::ModelChanged, speed(),
+                        static_cast<qint64>(m_stateRevision));
+}
+
 void ClusterModel::updateDateTime() {
-  QDateTime now = QDateTime::currentDateTime();
+  QDateTime now = m_clock->currentDateTime();
   QString newTime = now.toString("hh:mm");
   QString newDate = now.toString("dd MMM yyyy");
 
@@ -0,0 +1,322 @@
+#include "ClusterPublisher.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using ClusterProtocol::Channel;
+
+namespace {
+
+/**
+ * @brief Protocol properties of a field
+ */
+struct FieldInfo {
+  const char* key; ///< Message key
+  Channel channel; ///< Channel the key is published on
+  bool event;      ///< Sent on every report, not part of the state
+};
+
+/// Indexed by ClusterPublisher::Field
+const FieldInfo kFields[] = {
+    {ClusterProtocol::kSpeed, Channel::Critical, false},
+    {ClusterProtocol::kLane, Channel::Critical, false},
+    {ClusterProtocol::kObstacle, Channel::Critical, false},
+    {ClusterProtocol::kSign, Channel::Critical, true},
+    {ClusterProtocol::kDrivingMode, Channel::Critical, false},
+    {ClusterProtocol::kBattery, Channel::NonCritical, false},
+    {ClusterProtocol::kCharging, Channel::NonCritical, false},
+    {ClusterProtocol::kOdometer, Channel::NonCritical, false},
+};
+
+/// Send-side queue limit; the subscribers drop on their side when they fall behind
+constexpr int kSendHighWaterMark = 1000;
+
+} // namespace
+
+ClusterPublisher::ClusterPublisher(const ClusterPublisherEndpoints& endpoints)
+    : m_context(1),
+      m_critical(m_context, zmq::socket_type::pub),
+      m_nonCritical(m_context, zmq::socket_type::pub),
+      m_snapshot(m_context, zmq::socket_type::router),
+      m_servingSnapshots(!endpoints.snapshot.empty()),
+      m_rates(m_context, zmq::socket_type::pull),
+      m_acceptingRates(!endpoints.rates.empty()),
+      m_rateLimitLifetime(ClusterProtocol::kRateLimitLifetimeMs),
+      m_sequences{0, 0} {
+  for (zmq::socket_t* socket : {&m_critical, &m_nonCritical, &m_snapshot, &m_rates}) {
+    socket->set(zmq::sockopt::linger, 0);
+  }
+  m_critical.set(zmq::sockopt::sndhwm, kSendHighWaterMark);
+  m_nonCritical.set(zmq::sockopt::sndhwm, kSendHighWaterMark);
+
+  m_critical.bind(endpoints.critical);
+  m_nonCritical.bind(endpoints.nonCritical);
+  if (m_servingSnapshots) {
+    m_snapshot.bind(endpoints.snapshot);
+  }
+  if (m_acceptingRates) {
+    m_rates.bind(endpoints.rates);
+  }
+}
+
+ClusterPublisher::~ClusterPublisher() {}
+
+void ClusterPublisher::setSpeed(int mmPerSecond) {
+  update(SpeedField, mmPerSecond);
+}
+
+void ClusterPublisher::setLane(ClusterPublisher::Lane lane) {
+  update(LaneField, static_cast<int64_t>(lane));
+}
+
+void ClusterPublisher::setObstacle(ClusterPublisher::Obstacle obstacle) {
+  update(ObstacleField, static_cast<int64_t>(obstacle));
+  // Alerts must not wait for the next tick; the display takes its priority path for them
+  if (m_values[ObstacleField].pending) {
+    flushChannel(Channel::Critical, Clock::now());
+  }
+}
+
+void ClusterPublisher::setSpeedLimitSign(int kmPerHour) {
+  update(SignField, kmPerHour);
+}
+
+bool ClusterPublisher::setSign(const char* sign) {
+  static const char separators[] = {ClusterProtocol::kPairSeparator,
+                                    ClusterProtocol::kKeyValueSeparator, '\0'};
+  const size_t length = std::strlen(sign);
+  if (length == 0 || length >= sizeof(Value::text) || std::strpbrk(sign, separators)) {
+    return false;
+  }
+  update(SignField, sign, length);
+  return true;
+}
+
+void ClusterPublisher::setAutonomous(bool autonomous) {
+  update(DrivingModeField, autonomous ? 1 : 0);
+}
+
+void ClusterPublisher::setBattery(int percent) {
+  update(BatteryField, percent);
+}
+
+void ClusterPublisher::setCharging(bool charging) {
+  update(ChargingField, charging ? 1 : 0);
+}
+
+void ClusterPublisher::setOdometer(int64_t odometer) {
+  update(OdometerField, odometer);
+}
+
+int ClusterPublisher::flush() {
+  const Clock::time_point now = Clock::now();
+  int frames = 0;
+  frames += flushChannel(Channel::Critical, now) ? 1 : 0;
+  frames += flushChannel(Channel::NonCritical, now) ? 1 : 0;
+  return frames;
+}
+
+int ClusterPublisher::serveSnapshots() {
+  if (!m_servingSnapshots) {
+    return 0;
+  }
+
+  int served = 0;
+  std::vector<zmq::message_t> parts;
+  while (m_snapshot.get(zmq::sockopt::events) & ZMQ_POLLIN) {
+    // Routing envelope and request body
+    parts.clear();
+    do {
+      parts.emplace_back();
+      if (!m_snapshot.recv(parts.back(), zmq::recv_flags::dontwait)) {
+        return served;
+      }
+    } while (parts.back().more());
+
+    const zmq::message_t& request = parts.back();
+    if (request.size() != std::strlen(ClusterProtocol::kSnapshotRequest) ||
+        std::memcmp(request.data(), ClusterProtocol::kSnapshotRequest, request.size()) != 0) {
+      continue;
+    }
+
+    // The snapshot must cover everything set so far, so its sequence numbers are current
+    flush();
+    encodeSnapshot();
+    for (size_t i = 0; i + 1 < parts.size(); ++i) {
+      m_snapshot.send(parts[i], zmq::send_flags::sndmore);
+    }
+    m_snapshot.send(zmq::buffer(m_encoder.data(), m_encoder.size()), zmq::send_flags::dontwait);
+    ++m_statistics.snapshotsServed;
+    ++served;
+  }
+  return served;
+}
+
+int ClusterPublisher::receiveRateLimits() {
+  if (!m_acceptingRates) {
+    return 0;
+  }
+
+  int received = 0;
+  zmq::message_t advertisement;
+  while (m_rates.recv(advertisement, zmq::recv_flags::dontwait)) {
+    applyRateLimits(advertisement.to_string());
+    m_ratesReceived = Clock::now();
+    ++m_statistics.rateAdvertisements;
+    ++received;
+  }
+
+  // A display that stopped advertising must not leave the publisher throttled
+  if (m_ratesReceived != Clock::time_point() &&
+      Clock::now() - m_ratesReceived > m_rateLimitLifetime) {
+    applyRateLimits(std::string());
+    m_ratesReceived = Clock::time_point();
+  }
+  return received;
+}
+
+std::chrono::nanoseconds ClusterPublisher::minimumInterval(const char* key) const {
+  const Field field = fieldOf(key, std::strlen(key));
+  return field == FieldCount ? std::chrono::nanoseconds(0) : m_values[field].interval;
+}
+
+void ClusterPublisher::setRateLimitLifetime(std::chrono::milliseconds lifetime) {
+  m_rateLimitLifetime = lifetime;
+}
+
+void ClusterPublisher::tick() {
+  receiveRateLimits();
+  flush();
+  serveSnapshots();
+}
+
+std::string ClusterPublisher::endpoint(Channel channel) const {
+  const zmq::socket_t& publisher = channel == Channel::Critical ? m_critical : m_nonCritical;
+  return publisher.get(zmq::sockopt::last_endpoint);
+}
+
+std::string ClusterPublisher::snapshotEndpoint() const {
+  return m_servingSnapshots ? m_snapshot.get(zmq::sockopt::last_endpoint) : std::string();
+}
+
+std::string ClusterPublisher::rateEndpoint() const {
+  return m_acceptingRates ? m_rates.get(zmq::sockopt::last_endpoint) : std::string();
+}
+
+const ClusterPublisherStatistics& ClusterPublisher::statistics() const {
+  return m_statistics;
+}
+
+void ClusterPublisher::update(Field field, int64_t value) {
+  // Longest int64 in decimal including the sign
+  char text[20];
+  const std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);
+  update(field, text, static_cast<size_t>(result.ptr - text));
+}
+
+void ClusterPublisher::update(Field field, const char* text, size_t length) {
+  Value& current = m_values[field];
+  if (!kFields[field].event && current.length == length &&
+      std::memcmp(current.text, text, length) == 0) {
+    ++m_statistics.suppressedUpdates;
+    return;
+  }
+
+  if (current.pending) {
+    // The previous value was held back and is never sent
+    ++m_statistics.coalescedUpdates;
+  }
+  std::memcpy(current.text, text, length);
+  current.length = static_cast<uint8_t>(length);
+  current.pending = true;
+  ++m_statistics.updates;
+}
+
+bool ClusterPublisher::flushChannel(Channel channel, Clock::time_point now) {
+  m_encoder.clear();
+  for (int field = 0; field < FieldCount; ++field) {
+    Value& value = m_values[field];
+    if (!value.pending || kFields[field].channel != channel) {
+      continue;
+    }
+
+    // Held back until the display wants the key again; obstacle alerts are never held back
+    const bool limited = field != ObstacleField && value.interval.count() != 0;
+    if (limited && (value.interval.count() < 0 || now - value.lastSent < value.interval)) {
+      continue;
+    }
+
+    if (m_encoder.isEmpty()) {
+      const int index = static_cast<int>(channel);
+      m_encoder.append(ClusterProtocol::sequenceKey(channel), ++m_sequences[index]);
+    }
+    m_encoder.append(kFields[field].key, value.text, value.length);
+    value.pending = false;
+    value.lastSent = now;
+  }
+  if (m_encoder.isEmpty()) {
+    return false;
+  }
+
+  socket(channel).send(zmq::buffer(m_encoder.data(), m_encoder.size()),
+                       zmq::send_flags::dontwait);
+  ++m_statistics.framesSent;
+  m_statistics.bytesSent += m_encoder.size();
+  return true;
+}
+
+void ClusterPublisher::encodeSnapshot() {
+  m_encoder.clear();
+  for (Channel channel : {Channel::Critical, Channel::NonCritical}) {
+    m_encoder.append(ClusterProtocol::sequenceKey(channel),
+                     m_sequences[static_cast<int>(channel)]);
+  }
+  for (int field = 0; field < FieldCount; ++field) {
+    // A sign is only shown while it is reported; replaying an old one would be wrong
+    const Value& value = m_values[field];
+    if (value.length > 0 && !kFields[field].event) {
+      m_encoder.append(kFields[field].key, value.text, value.length);
+    }
+  }
+}
+
+void ClusterPublisher::applyRateLimits(const std::string& advertisement) {
+  for (Value& value : m_values) {
+    value.interval = std::chrono::nanoseconds(0);
+  }
+
+  size_t start = 0;
+  while (start < advertisement.size()) {
+    size_t end = advertisement.find(ClusterProtocol::kPairSeparator, start);
+    end = end == std::string::npos ? advertisement.size() : end;
+    const size_t colon = advertisement.find(ClusterProtocol::kKeyValueSeparator, start);
+    if (colon != std::string::npos && colon < end) {
+      const Field field = fieldOf(advertisement.data() + start, colon - start);
+      const std::string rate = advertisement.substr(colon + 1, end - colon - 1);
+      char* parsed = nullptr;
+      const double hz = std::strtod(rate.c_str(), &parsed);
+      if (field != FieldCount && parsed != rate.c_str() && *parsed == '\0' && std::isfinite(hz)) {
+        m_values[field].interval = hz > 0.0 ? std::chrono::nanoseconds(std::llround(1e9 / hz))
+                                            : std::chrono::nanoseconds(-1);
+      }
+    }
+    start = end + 1;
+  }
+}
+
+ClusterPublisher::Field ClusterPublisher::fieldOf(const char* key, size_t length) {
+  for (int field = 0; field < FieldCount; ++field) {
+    if (std::strlen(kFields[field].key) == length &&
+        std::memcmp(kFields[field].key, key, length) == 0) {
+      return static_cast<Field>(field);
+    }
+  }
+  return FieldCount;
+}
+
+zmq::socket_t& ClusterPublisher::socket(Channel channel) {
+  return channel == Channel::Critical ? m_critical : m_nonCritical;
+}
@@ -0,0 +1,162 @@
+#include "ClusterSignalHub.hpp"
+
+ClusterSignalHub::ClusterSignalHub(QObject* parent)
+    : QObject(parent),
+      m_parser(this),
+      m_priorityParser(this),
+      m_overtakenFrames(0),
+      m_nextId(1),
+      m_dispatchDepth(0) {}
+
+ClusterSignalHub::~ClusterSignalHub() {}
+
+// LCOV_EXCL_START - Network initialization difficult to test in unit tests
+void ClusterSignalHub::addSource(const QString& address, const ZmqSocketOptions& options) {
+  auto source = std::make_unique<ZmqSubscriber>(address, options);
+  source->setPriorityKeys(m_priorityKeys);
+  connect(source.get(), &ZmqSubscriber::messageReceived, this,
+          &ClusterSignalHub::dispatchMessage);
+  connect(source.get(), &ZmqSubscriber::priorityMessageReceived, this,
+          &ClusterSignalHub::dispatchPriorityMessage);
+  connect(source.get(), &ZmqSubscriber::connectionChanged, this,
+          [this]() { emit connectedSourcesChanged(connectedSourceCount()); });
+  m_sources.push_back(std::move(source));
+}
+// LCOV_EXCL_STOP
+
+void ClusterSignalHub::setPriorityKeys(const QStringList& keys) {
+  m_priorityKeyNames = keys;
+  m_priorityKeys.clear();
+  for (const QString& key : keys) {
+    m_priorityKeys.append(key.toUtf8());
+  }
+  for (const auto& source : m_sources) {
+    source->setPriorityKeys(m_priorityKeys);
+  }
+}
+
+int ClusterSignalHub::sourceCount() const {
+  return static_cast<int>(m_sources.size());
+}
+
+int ClusterSignalHub::connectedSourceCount() const {
+  int connected = 0;
+  for (const auto& source : m_sources) {
+    connected += source->isConnected() ? 1 : 0;
+  }
+  return connected;
+}
+
+int ClusterSignalHub::subscribe(const QString& key, ValueListener listener) {
+  const int id = m_nextId++;
+  m_valueListeners[key].append({id, std::move(listener), FrameListener()});
+  return id;
+}
+
+int ClusterSignalHub::subscribeInt(const QString& key, IntListener listener) {
+  return subscribe(key, [listener = std::move(listener)](const QString& value) {
+    bool ok = false;
+    const int number = value.toInt(&ok);
+    if (ok) {
+      listener(number);
+    }
+  });
+}
+
+int ClusterSignalHub::subscribeFrames(FrameListener listener) {
+  const int id = m_nextId++;
+  m_frameListeners.append({id, ValueListener(), std::move(listener)});
+  return id;
+}
+
+int ClusterSignalHub::subscribePriorityFrames(FrameListener listener) {
+  const int id = m_nextId++;
+  m_priorityListeners.append({id, ValueListener(), std::move(listener)});
+  return id;
+}
+
+void ClusterSignalHub::unsubscribe(int id) {
+  const auto matches = [id](const Listener& listener) { return listener.id == id; };
+
+  m_frameListeners.removeIf(matches);
+  m_priorityListeners.removeIf(matches);
+  for (auto it = m_valueListeners.begin(); it != m_valueListeners.end();) {
+    it.value().removeIf(matches);
+    it = it.value().isEmpty() ? m_valueListeners.erase(it) : std::next(it);
+  }
+
+  // The frame being dispatched works on a snapshot of the listeners; make sure it skips this one
+  if (m_dispatchDepth > 0) {
+    m_removedIds.insert(id);
+  }
+}
+
+int ClusterSignalHub::listenerCount(const QString& key) const {
+  return static_cast<int>(m_valueListeners.value(key).size());
+}
+
+bool ClusterSignalHub::removedDuringDispatch(int id) const {
+  return !m_removedIds.isEmpty() && m_removedIds.contains(id);
+}
+
+void ClusterSignalHub::dispatchMessage(const QString& message) {
+  // Decode once for all listeners
+  QMap<QString, QString> frame = m_parser.parseMessage(message);
+
+  // A newer priority frame was already applied ahead of this one
+  if (m_overtakenFrames > 0) {
+    --m_overtakenFrames;
+    for (const QString& key : std::as_const(m_priorityKeyNames)) {
+      frame.remove(key);
+    }
+  }
+  if (frame.isEmpty()) {
+    return;
+  }
+
+  ++m_dispatchDepth;
+
+  // Iterate over implicitly shared snapshots so listeners may (un)subscribe while being called
+  dispatchFrame(m_frameListeners, frame);
+
+  for (auto entry = frame.cbegin(); entry != frame.cend(); ++entry) {
+    const auto found = m_valueListeners.constFind(entry.key());
+    if (found == m_valueListeners.cend()) {
+      continue;
+    }
+    const QVector<Listener> listeners = found.value();
+    for (const Listener& listener : listeners) {
+      if (!removedDuringDispatch(listener.id)) {
+        listener.value(entry.value());
+      }
+    }
+  }
+
+  if (--m_dispatchDepth == 0) {
+    m_removedIds.clear();
+  }
+}
+
+void ClusterSignalHub::dispatchPriorityMessage(const QString& message, int overtakenFrames) {
+  // A parser of its own, so the priority path never touches the state of the regular one
+  const QMap<QString, QString> frame = m_priorityParser.parseMessage(message);
+  if (frame.isEmpty()) {
+    return;
+  }
+  m_overtakenFrames = overtakenFrames;
+
+  ++m_dispatchDepth;
+  dispatchFrame(m_priorityListeners, frame);
+  if (--m_dispatchDepth == 0) {
+    m_removedIds.clear();
+  }
+}
+
+void ClusterSignalHub::dispatchFrame(QVector<Listener> listeners,
+                                     const QMap<QString, QString>& frame) {
+  for (const Listener& listener : listeners) {
+    if (!removedDuringDispatch(listener.id)) {
+      listener.frame(frame);
+    }
+  }
+}
@@ -0,0 +1,150 @@
+#include "DbcDatabase.hpp"
+
+#include <QFile>
+#include <QRegularExpression>
+
+namespace {
+
+/// Set in a DBC message identifier for a 29-bit identifier
+constexpr quint32 kDbcExtendedFlag = 0x80000000u;
+
+/// Pseudo-message of the signals not sent by any node
+const QString kIndependentSignals = QStringLiteral("VECTOR__INDEPENDENT_SIG_MSG");
+
+} // namespace
+
+DbcDatabase::DbcDatabase() {
+  m_standardIndex.fill(-1, kStandardIds);
+}
+
+bool DbcDatabase::load(const QString& path) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    m_error = file.errorString();
+    return false;
+  }
+  return parse(QString::fromUtf8(file.readAll()));
+}
+
+bool DbcDatabase::parse(const QString& text) {
+  // BO_ <id> <name>: <dlc> <sender>
+  static const QRegularExpression messagePattern(
+      QStringLiteral("^BO_\\s+(\\d+)\\s+(\\w+)\\s*:\\s*(\\d+)"));
+  // SG_ <name> [M|m<n>] : <start>|<length>@<order><sign> (<factor>,<offset>) [<min>|<max>] "<unit>"
+  static const QRegularExpression signalPattern(QStringLiteral(
+      "^SG_\\s+(\\w+)\\s*(M|m\\d+)?\\s*:\\s*(\\d+)\\|(\\d+)@([01])([+-])\\s*"
+      "\\(\\s*([^,\\s]+)\\s*,\\s*([^)\\s]+)\\s*\\)\\s*\\[[^\\]]*\\]\\s*\"([^\"]*)\""));
+
+  m_error.clear();
+  m_messages.clear();
+  m_standardIndex.fill(-1, kStandardIds);
+  m_extendedIndex.clear();
+
+  DbcMessage* current = nullptr;
+  const QStringList lines = text.split(QLatin1Char('\n'));
+  for (int number = 0; number < lines.size(); ++number) {
+    const QString line = lines.at(number).trimmed();
+    const QString where = QStringLiteral("Line %1: ").arg(number + 1);
+
+    if (line.startsWith(QLatin1String("BO_ "))) {
+      const QRegularExpressionMatch match = messagePattern.match(line);
+      if (!match.hasMatch()) {
+        m_error = where + QStringLiteral("malformed message");
+        return false;
+      }
+      current = nullptr;
+      if (match.captured(2) == kIndependentSignals) {
+        continue;
+      }
+
+      DbcMessage message;
+      const quint32 rawId = match.captured(1).toUInt();
+      message.extended = (rawId & kDbcExtendedFlag) != 0;
+      message.id = rawId & ~kDbcExtendedFlag;
+      message.name = match.captured(2);
+      message.length = match.captured(3).toInt();
+      if ((!message.extended && message.id >= kStandardIds) || message.id > 0x1fffffffu ||
+          message.length > kMaxPayload) {
+        m_error = where + QStringLiteral("unsupported message %1").arg(message.name);
+        return false;
+      }
+      if (this->message(message.id, message.extended) != nullptr) {
+        m_error = where + QStringLiteral("duplicate message %1").arg(message.name);
+        return false;
+      }
+
+      const int index = m_messages.size();
+      if (message.extended) {
+        m_extendedIndex.insert(message.id, index);
+      } else {
+        m_standardIndex[static_cast<int>(message.id)] = static_cast<qint16>(index);
+      }
+      m_messages.append(message);
+      current = &m_messages.last();
+    } else if (line.startsWith(QLatin1String("SG_ "))) {
+      const QRegularExpressionMatch match = signalPattern.match(line);
+      if (!match.hasMatch()) {
+        m_error = where + QStringLiteral("malformed signal");
+        return false;
+      }
+      // Signals of the skipped pseudo-message, and multiplexed signals
+      if (current == nullptr || match.captured(2).startsWith(QLatin1Char('m'))) {
+        continue;
+      }
+
+      DbcSignal dbcSignal;
+      dbcSignal.name = match.captured(1);
+      dbcSignal.unit = match.captured(9);
+      dbcSignal.bigEndian = match.captured(5) == QLatin1String("0");
+      dbcSignal.isSigned = match.captured(6) == QLatin1String("-");
+      bool factorOk = false;
+      bool offsetOk = false;
+      dbcSignal.factor = match.captured(7).toDouble(&factorOk);
+      dbcSignal.offset = match.captured(8).toDouble(&offsetOk);
+      const int length = match.captured(4).toInt();
+      if (!factorOk || !offsetOk || length < 1 || length > 64) {
+        m_error = where + QStringLiteral("malformed signal %1").arg(dbcSignal.name);
+        return false;
+      }
+      dbcSignal.length = static_cast<quint8>(length);
+      if (!compile(&dbcSignal, match.captured(3).toInt())) {
+        m_error = where + QStringLiteral("signal %1 exceeds the payload").arg(dbcSignal.name);
+        return false;
+      }
+      current->dbcSignals.append(dbcSignal);
+    } else if (!line.isEmpty() && !lines.at(number).at(0).isSpace()) {
+      // Any other top-level definition ends the signal list of a message
+      current = nullptr;
+    }
+  }
+  return true;
+}
+
+QString DbcDatabase::errorString() const {
+  return m_error;
+}
+
+const QVector<DbcMessage>& DbcDatabase::messages() const {
+  return m_messages;
+}
+
+bool DbcDatabase::compile(DbcSignal* dbcSignal, int startBit) {
+  const int length = dbcSignal->length;
+  int shift = 0;
+  if (dbcSignal->bigEndian) {
+    // The start bit is the most significant bit, numbered from bit 0 of byte 0;
+    // in the word loaded big endian, byte 0 is the most significant byte
+    const int msb = (7 - startBit / 8) * 8 + startBit % 8;
+    shift = msb - (length - 1);
+  } else {
+    // The start bit is the least significant bit of the word loaded little endian
+    shift = startBit;
+  }
+  if (startBit >= kMaxPayload * 8 || shift < 0 || shift + length > kMaxPayload * 8) {
+    return false;
+  }
+
+  dbcSignal->shift = static_cast<quint8>(shift);
+  dbcSignal->mask = length == 64 ? ~quint64(0) : (quint64(1) << length) - 1;
+  return true;
+}
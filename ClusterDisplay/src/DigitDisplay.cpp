@@ -0,0 +1,191 @@
+#include "DigitDisplay.hpp"
+
+#include <QQuickWindow>
+#include <QSGImageNode>
+#include <QSGTexture>
+
+namespace {
+
+/**
+ * @brief Scene graph node owning the atlas texture of a DigitDisplay
+ *
+ * Each character is a QSGImageNode child showing one atlas cell. Image nodes are supported by
+ * every scene graph backend, including the software renderer, and the RHI renderer batches
+ * children that share a texture into a single draw call.
+ */
+class DigitNode : public QSGNode {
+ public:
+  QSGTexture* texture() const {
+    return m_texture.get();
+  }
+
+  void setTexture(QSGTexture* texture) {
+    for (QSGNode* child = firstChild(); child; child = child->nextSibling()) {
+      static_cast<QSGImageNode*>(child)->setTexture(texture);
+    }
+    m_texture.reset(texture);
+  }
+
+ private:
+  std::unique_ptr<QSGTexture> m_texture;
+};
+
+} // namespace
+
+DigitDisplay::DigitDisplay(QQuickItem* parent)
+    : QQuickItem(parent), m_color(Qt::white), m_characters(QStringLiteral("0123456789")),
+      m_atlasDirty(true), m_textureDirty(true) {
+  setFlag(ItemHasContents, true);
+}
+
+DigitDisplay::~DigitDisplay() {}
+
+QString DigitDisplay::text() const {
+  return m_text;
+}
+
+QFont DigitDisplay::font() const {
+  return m_font;
+}
+
+QColor DigitDisplay::color() const {
+  return m_color;
+}
+
+QString DigitDisplay::characters() const {
+  return m_characters;
+}
+
+const GlyphAtlas* DigitDisplay::atlas() {
+  if (m_atlasDirty || !m_atlas) {
+    const qreal ratio = window() ? window()->effectiveDevicePixelRatio() : 1.0;
+    m_atlas = std::make_unique<GlyphAtlas>(m_font, m_color, m_characters, ratio);
+    m_atlasDirty = false;
+    m_textureDirty = true;
+  }
+  return m_atlas.get();
+}
+
+void DigitDisplay::setText(const QString& text) {
+  if (m_text != text) {
+    m_text = text;
+    // Until the atlas is rebuilt the cell size is unknown; updatePolish() sizes the item then
+    if (m_atlasDirty) {
+      polish();
+    } else {
+      updateImplicitSize();
+    }
+    update();
+    emit textChanged(m_text);
+  }
+}
+
+void DigitDisplay::setFont(const QFont& font) {
+  if (m_font != font) {
+    m_font = font;
+    invalidateAtlas();
+    emit fontChanged(m_font);
+  }
+}
+
+void DigitDisplay::setColor(const QColor& color) {
+  if (m_color != color) {
+    m_color = color;
+    invalidateAtlas();
+    emit colorChanged(m_color);
+  }
+}
+
+void DigitDisplay::setCharacters(const QString& characters) {
+  if (m_characters != characters) {
+    m_characters = characters;
+    invalidateAtlas();
+    emit charactersChanged(m_characters);
+  }
+}
+
+void DigitDisplay::invalidateAtlas() {
+  // Defer the rebuild so that several property changes (e.g. font.family and font.pixelSize
+  // during component creation) only render the atlas once
+  m_atlasDirty = true;
+  polish();
+  update();
+}
+
+void DigitDisplay::updateImplicitSize() {
+  const QSizeF cell = atlas()->cellSize();
+  setImplicitSize(cell.width() * m_text.size(), cell.height());
+}
+
+void DigitDisplay::updatePolish() {
+  updateImplicitSize();
+}
+
+// LCOV_EXCL_START - Requires a window and a running scene graph
+void DigitDisplay::itemChange(ItemChange change, const ItemChangeData& value) {
+  if (change == ItemDevicePixelRatioHasChanged ||
+      (change == ItemSceneChange && value.window != nullptr)) {
+    invalidateAtlas();
+  }
+  QQuickItem::itemChange(change, value);
+}
+
+QSGNode* DigitDisplay::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) {
+  Q_UNUSED(data);
+  auto* node = static_cast<DigitNode*>(oldNode);
+
+  if (m_text.isEmpty()) {
+    delete node;
+    return nullptr;
+  }
+
+  const GlyphAtlas* glyphs = atlas();
+  if (!node) {
+    node = new DigitNode();
+    m_textureDirty = true;
+  }
+  if (m_textureDirty) {
+    node->setTexture(window()->createTextureFromImage(glyphs->image()));
+    m_textureDirty = false;
+  }
+
+  // One image node per character; nodes are only created or removed when the number of
+  // characters changes
+  const int glyphCount = static_cast<int>(m_text.size());
+  while (node->childCount() < glyphCount) {
+    QSGImageNode* glyph = window()->createImageNode();
+    glyph->setOwnsTexture(false);
+    glyph->setFiltering(QSGTexture::Linear);
+    glyph->setTexture(node->texture());
+    node->appendChildNode(glyph);
+  }
+  while (node->childCount() > glyphCount) {
+    QSGNode* last = node->lastChild();
+    node->removeChildNode(last);
+    delete last;
+  }
+
+  const QSizeF cell = glyphs->cellSize();
+  const QSizeF textureSize = node->texture()->textureSize();
+  QSGNode* child = node->firstChild();
+  for (int i = 0; i < glyphCount; ++i, child = child->nextSibling()) {
+    auto* glyph = static_cast<QSGImageNode*>(child);
+    const int cellIndex = glyphs->indexOf(m_text.at(i));
+
+    // Unknown characters collapse to an empty rectangle but still take up a cell
+    if (cellIndex < 0) {
+      glyph->setRect(QRectF());
+      continue;
+    }
+
+    const QRectF source = glyphs->textureRect(cellIndex);
+    glyph->setRect(QRectF(i * cell.width(), 0.0, cell.width(), cell.height()));
+    glyph->setSourceRect(QRectF(source.x() * textureSize.width(),
+                                source.y() * textureSize.height(),
+                                source.width() * textureSize.width(),
+                                source.height() * textureSize.height()));
+  }
+
+  return node;
+}
+// LCOV_EXCL_STOP
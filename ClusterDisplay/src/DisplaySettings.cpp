@@ -0,0 +1,78 @@
+#include "DisplaySettings.hpp"
+
+#include <QQuickWindow>
+#include <QSGRendererInterface>
+
+DisplaySettings* DisplaySettings::s_qmlInstance = nullptr;
+
+namespace {
+
+/// Default time a hidden overlay stays loaded, long enough to absorb flickering detections
+constexpr int kDefaultOverlayIdleUnloadMs = 30000;
+
+} // namespace
+
+DisplaySettings::DisplaySettings(QObject* parent)
+    : QObject(parent),
+      m_partialRepaint(false),
+      m_overlayIdleUnloadMs(kDefaultOverlayIdleUnloadMs),
+      m_trendGraphs(true) {}
+
+DisplaySettings::~DisplaySettings() {
+  if (s_qmlInstance == this) {
+    s_qmlInstance = nullptr;
+  }
+}
+
+void DisplaySettings::setQmlInstance(DisplaySettings* instance) {
+  s_qmlInstance = instance;
+}
+
+DisplaySettings* DisplaySettings::create(QQmlEngine* qmlEngine, QJSEngine* jsEngine) {
+  Q_UNUSED(qmlEngine);
+  Q_UNUSED(jsEngine);
+  Q_ASSERT(s_qmlInstance);
+
+  // The application owns the settings; keep the JS garbage collector away from them
+  QJSEngine::setObjectOwnership(s_qmlInstance, QJSEngine::CppOwnership);
+  return s_qmlInstance;
+}
+
+bool DisplaySettings::softwareBackendSelected() {
+  return QQuickWindow::graphicsApi() == QSGRendererInterface::Software ||
+         qEnvironmentVariable("QT_QUICK_BACKEND") == QLatin1String("software");
+}
+
+bool DisplaySettings::partialRepaint() const {
+  return m_partialRepaint;
+}
+
+int DisplaySettings::overlayIdleUnloadMs() const {
+  return m_overlayIdleUnloadMs;
+}
+
+bool DisplaySettings::trendGraphs() const {
+  return m_trendGraphs;
+}
+
+void DisplaySettings::setPartialRepaint(bool enabled) {
+  if (m_partialRepaint != enabled) {
+    m_partialRepaint = enabled;
+    emit partialRepaintChanged(m_partialRepaint);
+  }
+}
+
+void DisplaySettings::setOverlayIdleUnloadMs(int milliseconds) {
+  milliseconds = qMax(0, milliseconds);
+  if (m_overlayIdleUnloadMs != milliseconds) {
+    m_overlayIdleUnloadMs = milliseconds;
+    emit overlayIdleUnloadMsChanged(m_overlayIdleUnloadMs);
+  }
+}
+
+void DisplaySettings::setTrendGraphs(bool enabled) {
+  if (m_trendGraphs != enabled) {
+    m_trendGraphs = enabled;
+    emit trendGraphsChanged(m_trendGraphs);
+  }
+}
@@ -0,0 +1,343 @@
+#include "FlightRecorder.hpp"
+
+#include <QDir>
+#include <chrono>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+std::atomic<FlightRecorder*> FlightRecorder::s_instance{nullptr};
+
+namespace {
+
+/**
+ * @brief Minimal text builder for dumps
+ *
+ * Formats into a fixed stack buffer without allocating, so it can be used from
+ * signal handlers.
+ */
+class LineWriter {
+ public:
+  explicit LineWriter(int fd) : m_fd(fd), m_length(0), m_ok(true) {}
+
+  void text(const char* value) {
+    while (*value) {
+      put(*value++);
+    }
+  }
+
+  void number(qint64 value) {
+    char digits[24];
+    int count = 0;
+    const bool negative = value < 0;
+    quint64 magnitude = negative ? 0 - static_cast<quint64>(value) : static_cast<quint64>(value);
+    do {
+      digits[count++] = static_cast<char>('0' + magnitude % 10);
+      magnitude /= 10;
+    } while (magnitude > 0);
+    if (negative) {
+      put('-');
+    }
+    while (count > 0) {
+      put(digits[--count]);
+    }
+  }
+
+  /// Nanoseconds as milliseconds with microsecond resolution
+  void milliseconds(qint64 ns) {
+    number(ns / 1000000);
+    put('.');
+    const qint64 micros = (ns < 0 ? -ns : ns) / 1000 % 1000;
+    put(static_cast<char>('0' + micros / 100));
+    put(static_cast<char>('0' + micros / 10 % 10));
+    put(static_cast<char>('0' + micros % 10));
+  }
+
+  /// Printable characters packed by FlightRecorder::prefix()
+  void prefix(qint64 value) {
+    put('"');
+    for (int i = 0; i < 8; ++i) {
+      const char c = static_cast<char>((static_cast<quint64>(value) >> (8 * i)) & 0xff);
+      if (c == '\0') {
+        break;
+      }
+      put(c >= 0x20 && c < 0x7f && c != '"' ? c : '?');
+    }
+    put('"');
+  }
+
+  void put(char c) {
+    if (m_length == sizeof(m_buffer)) {
+      flush();
+    }
+    m_buffer[m_length++] = c;
+  }
+
+  bool flush() {
+#ifdef Q_OS_UNIX
+    size_t written = 0;
+    while (m_ok && written < m_length) {
+      const ssize_t result = ::write(m_fd, m_buffer + written, m_length - written);
+      if (result <= 0) {
+        m_ok = false;
+      } else {
+        written += static_cast<size_t>(result);
+      }
+    }
+#else
+    m_ok = false;
+#endif
+    m_length = 0;
+    return m_ok;
+  }
+
+ private:
+  int m_fd;
+  char m_buffer[4096];
+  size_t m_length;
+  bool m_ok;
+};
+
+// LCOV_EXCL_START - Signal handlers are exercised by crashing the process
+#ifdef Q_OS_UNIX
+void onDumpSignal(int) {
+  FlightRecorder* recorder = FlightRecorder::instance();
+  if (recorder) {
+    recorder->dump("signal");
+  }
+}
+
+void onFatalSignal(int signalNumber) {
+  FlightRecorder* recorder = FlightRecorder::instance();
+  if (recorder) {
+    recorder->dump("crash");
+  }
+
+  // The handler was installed with SA_RESETHAND: the default action terminates the process
+  raise(signalNumber);
+}
+#endif
+// LCOV_EXCL_STOP
+
+} // namespace
+
+FlightRecorder::FlightRecorder(int capacity) : m_startNs(nowNs()), m_head(0) {
+  quint64 size = 1;
+  while (size < static_cast<quint64>(qMax(capacity, 1))) {
+    size <<= 1;
+  }
+  m_mask = size - 1;
+  // Value-initialized: every sequence number starts at 0 (empty)
+  m_slots = std::make_unique<Slot[]>(size);
+
+  const QByteArray tempPath = QDir::tempPath().toLocal8Bit();
+  qstrncpy(m_directory, tempPath.constData(), sizeof(m_directory));
+}
+
+FlightRecorder::~FlightRecorder() {
+  FlightRecorder* self = this;
+  s_instance.compare_exchange_strong(self, nullptr);
+}
+
+void FlightRecorder::record(EventType type, qint32 a, qint64 b) {
+  const quint64 index = m_head.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = m_slots[index & m_mask];
+
+  // Mark the slot as incomplete while its fields are being replaced
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.timeNs.store(nowNs() - m_startNs, std::memory_order_relaxed);
+  slot.type.store(type, std::memory_order_relaxed);
+  slot.a.store(a, std::memory_order_relaxed);
+  slot.b.store(b, std::memory_order_relaxed);
+  slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+qint64 FlightRecorder::prefix(const char* data, size_t size) {
+  quint64 packed = 0;
+  const size_t count = size < 8 ? size : 8;
+  for (size_t i = 0; i < count; ++i) {
+    packed |= static_cast<quint64>(static_cast<unsigned char>(data[i])) << (8 * i);
+  }
+  return static_cast<qint64>(packed);
+}
+
+void FlightRecorder::setInstance(FlightRecorder* recorder) {
+  s_instance.store(recorder, std::memory_order_release);
+}
+
+FlightRecorder* FlightRecorder::instance() {
+  return s_instance.load(std::memory_order_acquire);
+}
+
+int FlightRecorder::capacity() const {
+  return static_cast<int>(m_mask + 1);
+}
+
+quint64 FlightRecorder::recordedCount() const {
+  return m_head.load(std::memory_order_acquire);
+}
+
+bool FlightRecorder::readSlot(quint64 index, Event* event) const {
+  const Slot& slot = m_slots[index & m_mask];
+  if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+    return false;
+  }
+  event->timeNs = slot.timeNs.load(std::memory_order_relaxed);
+  event->type = static_cast<EventType>(slot.type.load(std::memory_order_relaxed));
+  event->a = slot.a.load(std::memory_order_relaxed);
+  event->b = slot.b.load(std::memory_order_relaxed);
+
+  // A writer that claimed the slot meanwhile invalidates the copy
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.sequence.load(std::memory_order_relaxed) == index + 1;
+}
+
+QVector<FlightRecorder::Event> FlightRecorder::snapshot() const {
+  const quint64 head = recordedCount();
+  const quint64 first = head > m_mask + 1 ? head - (m_mask + 1) : 0;
+
+  QVector<Event> events;
+  events.reserve(static_cast<int>(head - first));
+  for (quint64 index = first; index < head; ++index) {
+    Event event;
+    if (readSlot(index, &event)) {
+      events.append(event);
+    }
+  }
+  return events;
+}
+
+bool FlightRecorder::setDumpDirectory(const QString& directory) {
+  const QByteArray path = QDir::cleanPath(directory).toLocal8Bit();
+  if (path.isEmpty() || static_cast<size_t>(path.size()) + 32 > sizeof(m_directory)) {
+    return false;
+  }
+  qstrncpy(m_directory, path.constData(), sizeof(m_directory));
+  return true;
+}
+
+QString FlightRecorder::dumpPath(const char* reason) const {
+  return QStringLiteral("%1/flight-%2.log")
+      .arg(QString::fromLocal8Bit(m_directory), QString::fromLatin1(reason));
+}
+
+bool FlightRecorder::dump(const char* reason) const {
+#ifdef Q_OS_UNIX
+  // Build the path by hand: no allocation is allowed in a signal handler
+  char path[sizeof(m_directory) + 64];
+  size_t length = 0;
+  const auto append = [&path, &length](const char* text) {
+    while (*text && length + 1 < sizeof(path)) {
+      path[length++] = *text++;
+    }
+  };
+  append(m_directory);
+  append("/flight-");
+  append(reason);
+  append(".log");
+  path[length] = '\0';
+
+  const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  const bool ok = dumpTo(fd, reason);
+  ::close(fd);
+  return ok;
+#else
+  Q_UNUSED(reason);
+  return false;
+#endif
+}
+
+bool FlightRecorder::dumpTo(int fd, const char* reason) const {
+  LineWriter out(fd);
+  out.text("# ClusterDisplay flight recorder dump: ");
+  out.text(reason);
+  out.text("\n# now_ms=");
+  out.milliseconds(nowNs() - m_startNs);
+  out.text(" recorded=");
+  out.number(static_cast<qint64>(recordedCount()));
+  out.text(" capacity=");
+  out.number(capacity());
+  out.text("\n# time_ms event a b\n");
+
+  const quint64 head = recordedCount();
+  const quint64 first = head > m_mask + 1 ? head - (m_mask + 1) : 0;
+  for (quint64 index = first; index < head; ++index) {
+    Event event;
+    if (!readSlot(index, &event)) {
+      continue;
+    }
+    out.milliseconds(event.timeNs);
+    out.put(' ');
+    out.text(typeName(event.type));
+    out.put(' ');
+    out.number(event.a);
+    out.put(' ');
+    if (event.type == FrameReceived || event.type == PriorityFrame) {
+      out.prefix(event.b);
+    } else {
+      out.number(event.b);
+    }
+    out.put('\n');
+  }
+  return out.flush();
+}
+
+const char* FlightRecorder::typeName(EventType type) {
+  switch (type) {
+    case NoEvent:
+      break;
+    case FrameReceived:
+      return "frame";
+    case PriorityFrame:
+      return "priority-frame";
+    case BatchDrained:
+      return "batch";
+    case ModelChanged:
+      return "model";
+    case AlertChanged:
+      return "alert";
+    case FrameSwapped:
+      return "swap";
+    case Stall:
+      return "stall";
+    case Marker:
+      return "marker";
+  }
+  return "none";
+}
+
+qint64 FlightRecorder::nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// LCOV_EXCL_START - Process-wide signal setup
+void FlightRecorder::installSignalHandlers() {
+#ifdef Q_OS_UNIX
+  struct sigaction dumpAction;
+  std::memset(&dumpAction, 0, sizeof(dumpAction));
+  dumpAction.sa_handler = onDumpSignal;
+  sigemptyset(&dumpAction.sa_mask);
+  dumpAction.sa_flags = SA_RESTART;
+  sigaction(SIGUSR1, &dumpAction, nullptr);
+
+  struct sigaction fatalAction;
+  std::memset(&fatalAction, 0, sizeof(fatalAction));
+  fatalAction.sa_handler = onFatalSignal;
+  sigemptyset(&fatalAction.sa_mask);
+  fatalAction.sa_flags = SA_RESETHAND;
+  for (int signalNumber : {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT}) {
+    sigaction(signalNumber, &fatalAction, nullptr);
+  }
+#endif
+}
+// LCOV_EXCL_STOP
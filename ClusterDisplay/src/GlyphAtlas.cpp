@@ -0,0 +1,75 @@
+#include "GlyphAtlas.hpp"
+
+#include <QFontMetricsF>
+#include <QPainter>
+#include <QtMath>
+
+namespace {
+
+/// Transparent pixels kept between cells so linear filtering never bleeds into a neighbour
+constexpr int kCellPadding = 1;
+
+} // namespace
+
+GlyphAtlas::GlyphAtlas(const QFont& font, const QColor& color, const QString& characters,
+                       qreal devicePixelRatio)
+    : m_cellPixelWidth(0) {
+  for (const QChar character : characters) {
+    if (!m_cellIndex.contains(character)) {
+      m_cellIndex.insert(character, m_characters.size());
+      m_characters.append(character);
+    }
+  }
+
+  const QFontMetricsF metrics(font);
+  qreal cellWidth = 0.0;
+  for (const QChar character : m_characters) {
+    cellWidth = qMax(cellWidth, metrics.horizontalAdvance(character));
+  }
+  m_cellSize = QSizeF(qCeil(cellWidth), qCeil(metrics.height()));
+
+  const qreal ratio = devicePixelRatio > 0.0 ? devicePixelRatio : 1.0;
+  m_cellPixelWidth = qCeil(m_cellSize.width() * ratio) + 2 * kCellPadding;
+  const int pixelHeight = qMax(1, qCeil(m_cellSize.height() * ratio));
+
+  m_image = QImage(qMax(1, m_cellPixelWidth * static_cast<int>(m_characters.size())),
+                   pixelHeight, QImage::Format_ARGB32_Premultiplied);
+  m_image.fill(Qt::transparent);
+  m_image.setDevicePixelRatio(ratio);
+
+  QPainter painter(&m_image);
+  painter.setRenderHint(QPainter::TextAntialiasing);
+  painter.setFont(font);
+  painter.setPen(color);
+  for (int index = 0; index < m_characters.size(); ++index) {
+    // Glyphs are centered in their cell, which keeps narrow digits like "1" balanced
+    const qreal cellX = (index * m_cellPixelWidth + kCellPadding) / ratio;
+    const QRectF cell(cellX, 0.0, m_cellSize.width(), m_cellSize.height());
+    painter.drawText(cell, Qt::AlignCenter, QString(m_characters.at(index)));
+  }
+}
+
+const QImage& GlyphAtlas::image() const {
+  return m_image;
+}
+
+const QString& GlyphAtlas::characters() const {
+  return m_characters;
+}
+
+QSizeF GlyphAtlas::cellSize() const {
+  return m_cellSize;
+}
+
+int GlyphAtlas::indexOf(QChar character) const {
+  return m_cellIndex.value(character, -1);
+}
+
+QRectF GlyphAtlas::textureRect(int index) const {
+  if (index < 0 || index >= m_characters.size()) {
+    return QRectF();
+  }
+  const qreal imageWidth = m_image.width();
+  return QRectF((index * m_cellPixelWidth + kCellPadding) / imageWidth, 0.0,
+                (m_cellPixelWidth - 2 * kCellPadding) / imageWidth, 1.0);
+}
@@ -0,0 +1,94 @@
+#include "LocalOdometer.hpp"
+
+LocalOdometer::LocalOdometer()
+    : m_micrometers(0),
+      m_known(false),
+      m_ahead(0),
+      m_publisherLast(-1),
+      m_offset(0),
+      m_driven(0),
+      m_speedTime(-1),
+      m_speed(0) {}
+
+bool LocalOdometer::seed(qint64 micrometers) {
+  if (m_known || micrometers < 0) {
+    return false;
+  }
+  m_micrometers += micrometers;
+  m_known = true;
+  return true;
+}
+
+bool LocalOdometer::isKnown() const {
+  return m_known;
+}
+
+void LocalOdometer::addSpeed(qint64 timeMs, int mmPerSecond) {
+  advance(timeMs);
+  // Reversing does not wind the odometer back
+  m_speed = qMax(mmPerSecond, 0);
+  m_speedTime = timeMs;
+}
+
+void LocalOdometer::addPublisherValue(qint64 meters) {
+  const qint64 reported = meters * kMicrometersPerMeter;
+  const qint64 step = meters - m_publisherLast;
+
+  if (m_publisherLast < 0 || step < 0 || step > kMaxPublisherStep) {
+    if (m_publisherLast < 0 && (!m_known || reported > m_micrometers)) {
+      // Ahead of everything integrated or restored: the publisher's count is the truth
+      m_micrometers = reported;
+      m_ahead = 0;
+    }
+    m_offset = m_micrometers - reported;
+    m_publisherLast = meters;
+    m_known = true;
+    return;
+  }
+  m_publisherLast = meters;
+
+  // The publisher truncates, so the true distance is within one meter above its value
+  const qint64 lowest = reported + m_offset;
+  if (m_micrometers < lowest) {
+    m_driven += lowest - m_micrometers;
+    m_micrometers = lowest;
+    m_ahead = 0;
+  } else if (m_micrometers >= lowest + kMicrometersPerMeter) {
+    // Aim for the middle of the meter
+    m_ahead = m_micrometers - lowest - kMicrometersPerMeter / 2;
+  } else {
+    m_ahead = 0;
+  }
+}
+
+void LocalOdometer::advance(qint64 timeMs) {
+  if (m_speedTime < 0 || timeMs <= m_speedTime) {
+    return;
+  }
+  // mm/s * ms = um
+  add(static_cast<qint64>(m_speed) * (timeMs - m_speedTime));
+  m_speedTime = timeMs;
+}
+
+void LocalOdometer::interrupt() {
+  m_speedTime = -1;
+}
+
+qint64 LocalOdometer::micrometers() const {
+  return m_micrometers;
+}
+
+qint64 LocalOdometer::meters() const {
+  return m_micrometers / kMicrometersPerMeter;
+}
+
+qint64 LocalOdometer::driven() const {
+  return m_driven;
+}
+
+void LocalOdometer::add(qint64 micrometers) {
+  const qint64 withheld = qMin(m_ahead, micrometers);
+  m_ahead -= withheld;
+  m_micrometers += micrometers - withheld;
+  m_driven += micrometers - withheld;
+}
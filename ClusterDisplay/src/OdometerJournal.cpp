@@ -0,0 +1,225 @@
+#include "OdometerJournal.hpp"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <cstddef>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr quint32 kMagic = 0x314a4f43; ///< "COJ1" in little endian
+constexpr quint16 kVersion = 1;
+
+/**
+ * @brief Start of the journal file
+ */
+struct Header {
+  quint32 magic;      ///< kMagic
+  quint16 version;    ///< kVersion
+  quint16 recordSize; ///< sizeof(Record)
+  quint64 reserved;   ///< Always zero
+};
+
+/**
+ * @brief One appended figure
+ */
+struct Record {
+  qint64 micrometers; ///< Odometer figure
+  quint32 sequence;   ///< One more than the previous record, starting at 1
+  quint16 reserved;   ///< Always zero
+  quint16 checksum;   ///< CRC-16 of all preceding fields
+};
+static_assert(sizeof(Header) == 16 && sizeof(Record) == 16, "Journal layout must not change");
+
+quint16 recordChecksum(const Record& record) {
+  return qChecksum(QByteArrayView(reinterpret_cast<const char*>(&record),
+                                  offsetof(Record, checksum)));
+}
+
+Header makeHeader() {
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.recordSize = sizeof(Record);
+  return header;
+}
+
+Record makeRecord(qint64 micrometers, quint32 sequence) {
+  Record record;
+  std::memset(&record, 0, sizeof(record));
+  record.micrometers = micrometers;
+  record.sequence = sequence;
+  record.checksum = recordChecksum(record);
+  return record;
+}
+
+} // namespace
+
+OdometerJournal::OdometerJournal(int minWriteIntervalMs, QObject* parent)
+    : QObject(parent),
+      m_throttle(minWriteIntervalMs),
+      m_pending(-1),
+      m_last(-1),
+      m_sequence(0),
+      m_recordCount(0),
+      m_writeCount(0) {
+  connect(&m_throttle, &WriteThrottle::due, this, &OdometerJournal::write);
+}
+
+OdometerJournal::~OdometerJournal() {
+  if (!m_file.isOpen()) {
+    return;
+  }
+
+  flush();
+#ifdef Q_OS_UNIX
+  ::fsync(m_file.handle());
+#endif
+}
+
+bool OdometerJournal::open(const QString& path) {
+  if (m_file.isOpen()) {
+    flush();
+    m_file.close();
+  }
+
+  QFileInfo info(path);
+  if (!info.absoluteDir().mkpath(QStringLiteral("."))) {
+    return false;
+  }
+
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::ReadWrite)) {
+    return false;
+  }
+
+  m_pending = -1;
+  m_last = -1;
+  m_sequence = 0;
+  m_recordCount = 0;
+  m_writeCount = 0;
+  m_throttle.reset();
+
+  // A file without a valid header was not written by this version; start over
+  Header header;
+  const Header expected = makeHeader();
+  if (m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+      std::memcmp(&header, &expected, sizeof(header)) != 0) {
+    if (!m_file.resize(0) || !m_file.seek(0) ||
+        m_file.write(reinterpret_cast<const char*>(&expected), sizeof(expected)) !=
+            sizeof(expected)) {
+      m_file.close();
+      return false;
+    }
+    m_file.flush();
+    return true;
+  }
+
+  // Records up to the first torn or out-of-sequence one are valid
+  Record record;
+  while (m_file.read(reinterpret_cast<char*>(&record), sizeof(record)) == sizeof(record) &&
+         record.checksum == recordChecksum(record) && record.sequence == m_sequence + 1) {
+    m_sequence = record.sequence;
+    m_last = record.micrometers;
+    ++m_recordCount;
+  }
+  const qint64 end = sizeof(Header) + static_cast<qint64>(m_recordCount) * sizeof(Record);
+  if (m_file.size() != end && !m_file.resize(end)) {
+    m_file.close();
+    return false;
+  }
+  return m_file.seek(end);
+}
+
+bool OdometerJournal::isOpen() const {
+  return m_file.isOpen();
+}
+
+qint64 OdometerJournal::restore() const {
+  return m_last;
+}
+
+void OdometerJournal::record(qint64 micrometers) {
+  m_pending = micrometers;
+  if (m_file.isOpen() && micrometers != m_last) {
+    m_throttle.request();
+  }
+}
+
+void OdometerJournal::flush() {
+  m_throttle.cancel();
+  write();
+}
+
+int OdometerJournal::recordCount() const {
+  return m_recordCount;
+}
+
+int OdometerJournal::writeCount() const {
+  return m_writeCount;
+}
+
+QString OdometerJournal::defaultFileName() {
+  return QStringLiteral("cluster-odometer.journal");
+}
+
+void OdometerJournal::write() {
+  if (!m_file.isOpen() || m_pending < 0 || m_pending == m_last) {
+    return;
+  }
+
+  if (m_recordCount >= kMaxRecords && !compact()) {
+    return;
+  }
+
+  const Record record = makeRecord(m_pending, m_sequence + 1);
+  const qint64 offset = m_file.pos();
+  if (m_file.write(reinterpret_cast<const char*>(&record), sizeof(record)) != sizeof(record) ||
+      !m_file.flush()) {
+    // Cut off a partial record so the next one is appended after the last valid one
+    m_file.resize(offset);
+    m_file.seek(offset);
+    return;
+  }
+#ifdef Q_OS_LINUX
+  // Queue the record for writeback; only the destructor waits for the storage
+  ::sync_file_range(m_file.handle(), offset, sizeof(record), SYNC_FILE_RANGE_WRITE);
+#endif
+
+  m_sequence = record.sequence;
+  m_last = record.micrometers;
+  ++m_recordCount;
+  ++m_writeCount;
+  m_throttle.markWritten();
+  emit written(m_last);
+}
+
+bool OdometerJournal::compact() {
+  // The old journal stays in place until the new one is complete and synced
+  QSaveFile compacted(m_file.fileName());
+  if (!compacted.open(QIODevice::WriteOnly)) {
+    return false;
+  }
+  const Header header = makeHeader();
+  const Record last = makeRecord(m_last, 1);
+  compacted.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  compacted.write(reinterpret_cast<const char*>(&last), sizeof(last));
+  if (!compacted.commit()) {
+    return false;
+  }
+
+  m_file.close();
+  if (!m_file.open(QIODevice::ReadWrite) || !m_file.seek(sizeof(Header) + sizeof(Record))) {
+    return false;
+  }
+  m_sequence = 1;
+  m_recordCount = 1;
+  return true;
+}
@@ -0,0 +1,143 @@
+#include "RangeEstimator.hpp"
+
+#include <cmath>
+
+namespace {
+
+// Prior variance of the weights: a few %/km either way, and about 1 %/min
+constexpr double kInitialVariance[2] = {25.0, 1.0};
+
+// Bound of the covariance trace; keeps the gain finite when a direction is never excited
+constexpr double kMaxCovarianceTrace = 1e4;
+
+} // namespace
+
+RangeEstimator::RangeEstimator() : m_distance(0), m_level(-1) {
+  reset();
+}
+
+void RangeEstimator::reset() {
+  m_model = {{kNominalPercentPerKm, 0.0},
+             {{kInitialVariance[0], 0.0}, {0.0, kInitialVariance[1]}},
+             0};
+  m_segment.active = false;
+  m_recentKm = 0.0;
+  m_recentMinutes = 0.0;
+  m_reference = -1;
+  m_charging = false;
+  m_settledFrom = 0;
+}
+
+void RangeEstimator::addDistance(qint64 timeMs, qint64 micrometers) {
+  Q_UNUSED(timeMs);
+  m_distance = micrometers;
+}
+
+void RangeEstimator::addBattery(qint64 timeMs, int percent) {
+  m_level = percent;
+
+  // While charging and settling, the level is followed but not measured
+  if (m_charging || timeMs < m_settledFrom || m_reference < 0 ||
+      percent >= m_reference + kRechargeRise) {
+    m_reference = percent;
+    m_segment.active = false;
+    return;
+  }
+  // Smaller rises are jitter around the level that was reached
+  if (percent >= m_reference) {
+    return;
+  }
+
+  if (m_segment.active) {
+    // um -> km
+    const double features[2] = {static_cast<double>(m_distance - m_segment.startDistance) / 1e9,
+                                static_cast<double>(timeMs - m_segment.startMs) / 60000.0};
+    fit(features, m_segment.startLevel - percent);
+  }
+  startSegment(timeMs, percent);
+  m_reference = percent;
+}
+
+void RangeEstimator::setCharging(qint64 timeMs, bool charging) {
+  if (charging) {
+    m_segment.active = false;
+  } else if (m_charging) {
+    m_settledFrom = timeMs + kChargeSettleMs;
+  }
+  m_charging = charging;
+}
+
+void RangeEstimator::interrupt(qint64 timeMs) {
+  Q_UNUSED(timeMs);
+  m_segment.active = false;
+  // The level may have dropped unseen; the next drop only starts measuring
+  m_reference = -1;
+}
+
+qint64 RangeEstimator::range() const {
+  const double perKm = percentPerKm();
+  if (m_level < 0) {
+    return -1;
+  }
+  if (perKm <= 0.0) {
+    return 0;
+  }
+  return std::llround(m_level / perKm * 1000.0);
+}
+
+double RangeEstimator::percentPerKm() const {
+  const double perKm = m_model.weights[0];
+  if (m_recentKm < 0.01) {
+    return perKm;
+  }
+  return perKm + m_model.weights[1] * m_recentMinutes / m_recentKm;
+}
+
+const ConsumptionModel& RangeEstimator::model() const {
+  return m_model;
+}
+
+bool RangeEstimator::isMeasuring() const {
+  return m_segment.active;
+}
+
+void RangeEstimator::startSegment(qint64 timeMs, int level) {
+  m_segment.active = true;
+  m_segment.startLevel = level;
+  m_segment.startMs = timeMs;
+  m_segment.startDistance = m_distance;
+}
+
+void RangeEstimator::fit(const double features[2], double used) {
+  double(&w)[2] = m_model.weights;
+  double(&p)[2][2] = m_model.covariance;
+
+  const double px[2] = {p[0][0] * features[0] + p[0][1] * features[1],
+                        p[1][0] * features[0] + p[1][1] * features[1]};
+  const double denominator = kForgetting + features[0] * px[0] + features[1] * px[1];
+  const double gain[2] = {px[0] / denominator, px[1] / denominator};
+  const double error = used - (w[0] * features[0] + w[1] * features[1]);
+
+  // Consumption is never negative
+  w[0] = std::fmax(w[0] + gain[0] * error, 0.0);
+  w[1] = std::fmax(w[1] + gain[1] * error, 0.0);
+
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      p[i][j] = (p[i][j] - gain[i] * px[j]) / kForgetting;
+    }
+  }
+  // Forgetting inflates the directions the data does not excite; keep them bounded
+  const double trace = p[0][0] + p[1][1];
+  if (trace > kMaxCovarianceTrace) {
+    const double scale = kMaxCovarianceTrace / trace;
+    for (auto& row : p) {
+      row[0] *= scale;
+      row[1] *= scale;
+    }
+  }
+  ++m_model.observations;
+
+  m_recentKm = kForgetting * m_recentKm + features[0];
+  m_recentMinutes = kForgetting * m_recentMinutes + features[1];
+}
@@ -0,0 +1,373 @@
+#include "RealtimeProfile.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QQuickWindow>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#ifdef Q_OS_LINUX
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+/// Stack pre-faulted on the GUI thread so that deep call chains never fault
+constexpr int kPrefaultStackKb = 256;
+
+QString formatCpus(const QList<int>& cpus) {
+  QStringList numbers;
+  for (int cpu : cpus) {
+    numbers << QString::number(cpu);
+  }
+  return numbers.join(',');
+}
+
+#ifdef Q_OS_LINUX
+QString formatLimit(int resource) {
+  struct rlimit limit;
+  if (getrlimit(resource, &limit) != 0) {
+    return QStringLiteral("unknown");
+  }
+  if (limit.rlim_cur == RLIM_INFINITY) {
+    return QStringLiteral("unlimited");
+  }
+  return QString::number(static_cast<qulonglong>(limit.rlim_cur));
+}
+
+// LCOV_EXCL_START - Outcome depends on the limits of the test environment
+/**
+ * @brief Touches stack pages below the current frame so they are mapped (and locked)
+ */
+void prefaultStack() {
+  volatile char stack[kPrefaultStackKb * 1024];
+  for (size_t i = 0; i < sizeof(stack); i += 4096) {
+    stack[i] = 0;
+  }
+}
+// LCOV_EXCL_STOP
+#endif
+
+} // namespace
+
+RealtimeProfile::RealtimeProfile()
+    : m_lockMemory(false), m_prefaultHeapMb(0), m_ingestRequested(false) {}
+
+bool RealtimeProfile::parseThreadSettings(const QString& spec, ThreadSettings* settings) {
+  ThreadSettings parsed;
+  const QStringList parts = spec.split(':');
+  if (parts.size() > 2) {
+    return false;
+  }
+
+  for (const QString& item : parts.first().split(',', Qt::SkipEmptyParts)) {
+    const QStringList range = item.split('-');
+    bool firstOk = false;
+    bool lastOk = false;
+    const int first = range.first().trimmed().toInt(&firstOk);
+    const int last = range.size() == 2 ? range.last().trimmed().toInt(&lastOk) : first;
+    if (!firstOk || (range.size() == 2 && !lastOk) || range.size() > 2 || first < 0 ||
+        last < first) {
+      return false;
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      if (!parsed.cpus.contains(cpu)) {
+        parsed.cpus.append(cpu);
+      }
+    }
+  }
+
+  if (parts.size() == 2) {
+    bool ok = false;
+    parsed.priority = parts.last().trimmed().toInt(&ok);
+    if (!ok || parsed.priority < 1 || parsed.priority > 99) {
+      return false;
+    }
+  }
+
+  if (!parsed.isSet()) {
+    return false;
+  }
+  *settings = parsed;
+  return true;
+}
+
+void RealtimeProfile::setGuiThread(const ThreadSettings& settings) {
+  m_gui = settings;
+}
+
+void RealtimeProfile::setRenderThread(const ThreadSettings& settings) {
+  m_render = settings;
+}
+
+void RealtimeProfile::setIngestThreads(const ThreadSettings& settings) {
+  m_ingest = settings;
+}
+
+void RealtimeProfile::setLockMemory(bool enabled, int prefaultHeapMb) {
+  m_lockMemory = enabled;
+  m_prefaultHeapMb = qMax(prefaultHeapMb, 0);
+}
+
+bool RealtimeProfile::isEnabled() const {
+  return m_lockMemory || m_gui.isSet() || m_render.isSet() || m_ingest.isSet();
+}
+
+// LCOV_EXCL_START - Outcome depends on the limits of the test environment
+void RealtimeProfile::applyProcessSettings() {
+  if (m_lockMemory) {
+#ifdef Q_OS_LINUX
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+      addResult(QStringLiteral("memory: locked (mlockall current and future pages)"));
+    } else {
+      addResult(QStringLiteral("memory: not locked (%1; RLIMIT_MEMLOCK is %2 bytes)")
+                    .arg(qt_error_string(errno), formatLimit(RLIMIT_MEMLOCK)));
+    }
+
+    // Keep freed heap mapped so later allocations do not fault pages back in
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+    const size_t heapBytes = static_cast<size_t>(m_prefaultHeapMb) * 1024 * 1024;
+    if (heapBytes > 0) {
+      char* heap = static_cast<char*>(std::malloc(heapBytes));
+      if (heap) {
+        for (size_t i = 0; i < heapBytes; i += 4096) {
+          heap[i] = 0;
+        }
+        std::free(heap);
+      }
+    }
+    prefaultStack();
+    addResult(QStringLiteral("memory: pre-faulted %1 MB heap and %2 KB stack")
+                  .arg(m_prefaultHeapMb)
+                  .arg(kPrefaultStackKb));
+#else
+    addResult(QStringLiteral("memory: locking not supported on this platform"));
+#endif
+  }
+
+  if (m_gui.isSet()) {
+    applyToCurrentThread(QStringLiteral("GUI thread"), m_gui);
+  }
+}
+
+void RealtimeProfile::attachWindow(QQuickWindow* window) {
+  if (!window || !m_render.isSet()) {
+    return;
+  }
+
+  // Emitted on the render thread (or the GUI thread with the basic render loop)
+  QObject::connect(
+      window, &QQuickWindow::sceneGraphInitialized, window,
+      [this]() { applyToCurrentThread(QStringLiteral("render thread"), m_render); },
+      Qt::DirectConnection);
+}
+// LCOV_EXCL_STOP
+
+ZmqSocketOptions RealtimeProfile::ingestSocketOptions(ZmqSocketOptions options) {
+  if (!m_ingest.isSet()) {
+    return options;
+  }
+  m_ingestRequested = true;
+
+  // libzmq aborts when its I/O thread cannot apply a setting: only pass what is known to work
+  const QList<int> available = availableCpus();
+  QList<int> cpus;
+  for (int cpu : m_ingest.cpus) {
+    if (available.contains(cpu)) {
+      cpus.append(cpu);
+    }
+  }
+  if (cpus.size() != m_ingest.cpus.size()) {
+    addResult(QStringLiteral("ingest threads: CPUs %1 requested, only %2 available to the process")
+                  .arg(formatCpus(m_ingest.cpus), formatCpus(cpus)));
+  }
+  options.ioThreadCpus = cpus;
+
+  if (m_ingest.priority > 0) {
+    QString error;
+    if (canUseRealtimePriority(m_ingest.priority, &error)) {
+      options.ioThreadPriority = m_ingest.priority;
+    } else {
+      addResult(QStringLiteral("ingest threads: SCHED_FIFO %1 not permitted (%2)")
+                    .arg(m_ingest.priority)
+                    .arg(error));
+    }
+  }
+  return options;
+}
+
+bool RealtimeProfile::applyToCurrentThread(const QString& role, const ThreadSettings& settings) {
+#ifdef Q_OS_LINUX
+  bool complete = true;
+
+  if (!settings.cpus.isEmpty()) {
+    const QList<int> available = availableCpus();
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    QList<int> pinned;
+    for (int cpu : settings.cpus) {
+      if (available.contains(cpu) && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &set);
+        pinned.append(cpu);
+      }
+    }
+
+    const int rc =
+        pinned.isEmpty() ? EINVAL : pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc == 0 && pinned.size() == settings.cpus.size()) {
+      addResult(QStringLiteral("%1: pinned to CPUs %2").arg(role, formatCpus(pinned)));
+    } else if (rc == 0) {
+      complete = false;
+      addResult(QStringLiteral("%1: pinned to CPUs %2 (requested %3)")
+                    .arg(role, formatCpus(pinned), formatCpus(settings.cpus)));
+    } else {
+      complete = false;
+      addResult(QStringLiteral("%1: not pinned to CPUs %2 (%3)")
+                    .arg(role, formatCpus(settings.cpus), qt_error_string(rc)));
+    }
+  }
+
+  if (settings.priority > 0) {
+    struct sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    param.sched_priority = settings.priority;
+    const int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (rc == 0) {
+      addResult(QStringLiteral("%1: SCHED_FIFO priority %2").arg(role).arg(settings.priority));
+    } else {
+      complete = false;
+      addResult(QStringLiteral("%1: SCHED_FIFO %2 not permitted (%3; RLIMIT_RTPRIO is %4), "
+                               "keeping the default policy")
+                    .arg(role)
+                    .arg(settings.priority)
+                    .arg(qt_error_string(rc), formatLimit(RLIMIT_RTPRIO)));
+    }
+  }
+  return complete;
+#else
+  addResult(QStringLiteral("%1: thread placement not supported on this platform").arg(role));
+  return !settings.isSet();
+#endif
+}
+
+QStringList RealtimeProfile::report() const {
+  QStringList lines;
+  {
+    QMutexLocker locker(&m_mutex);
+    lines = m_results;
+  }
+  if (m_ingestRequested) {
+    lines << inspectIngestThreads();
+  }
+  return lines;
+}
+
+QList<int> RealtimeProfile::availableCpus() {
+  QList<int> cpus;
+#ifdef Q_OS_LINUX
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.append(cpu);
+      }
+    }
+  }
+#endif
+  return cpus;
+}
+
+bool RealtimeProfile::canUseRealtimePriority(int priority, QString* error) {
+#ifdef Q_OS_LINUX
+  if (priority < sched_get_priority_min(SCHED_FIFO) ||
+      priority > sched_get_priority_max(SCHED_FIFO)) {
+    if (error) {
+      *error = QStringLiteral("priority out of range");
+    }
+    return false;
+  }
+
+  // Probe on a throw-away thread so the caller's own scheduling is not changed
+  int rc = 0;
+  std::thread probe([priority, &rc]() {
+    struct sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+    rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+  });
+  probe.join();
+
+  if (rc != 0 && error) {
+    *error = QStringLiteral("%1; RLIMIT_RTPRIO is %2")
+                 .arg(qt_error_string(rc), formatLimit(RLIMIT_RTPRIO));
+  }
+  return rc == 0;
+#else
+  Q_UNUSED(priority);
+  if (error) {
+    *error = QStringLiteral("not supported on this platform");
+  }
+  return false;
+#endif
+}
+
+void RealtimeProfile::addResult(const QString& line) {
+  QMutexLocker locker(&m_mutex);
+  m_results.append(line);
+}
+
+// LCOV_EXCL_START - Requires running libzmq I/O threads
+QStringList RealtimeProfile::inspectIngestThreads() const {
+  QStringList lines;
+#ifdef Q_OS_LINUX
+  const QDir tasks(QStringLiteral("/proc/self/task"));
+  for (const QString& tid : tasks.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+    QFile commFile(tasks.filePath(tid + QStringLiteral("/comm")));
+    if (!commFile.open(QIODevice::ReadOnly)) {
+      continue;
+    }
+    const QString name = QString::fromLocal8Bit(commFile.readAll()).trimmed();
+
+    // libzmq names its I/O threads "ZMQbg/IO/<n>" (older releases "ZMQbg/<n>")
+    if (!name.startsWith(QLatin1String("ZMQbg/")) || name.contains(QLatin1String("Reaper"))) {
+      continue;
+    }
+
+    const pid_t threadId = tid.toInt();
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    QList<int> cpus;
+    if (sched_getaffinity(threadId, sizeof(set), &set) == 0) {
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) {
+          cpus.append(cpu);
+        }
+      }
+    }
+    struct sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    const int policy = sched_getscheduler(threadId);
+    sched_getparam(threadId, &param);
+
+    lines << QStringLiteral("ingest thread %1 (tid %2): CPUs %3, %4")
+                 .arg(name, tid, formatCpus(cpus),
+                      policy == SCHED_FIFO
+                          ? QStringLiteral("SCHED_FIFO priority %1").arg(param.sched_priority)
+                          : QStringLiteral("default policy"));
+  }
+  if (lines.isEmpty()) {
+    lines << QStringLiteral("ingest threads: no ZeroMQ I/O thread found");
+  }
+#endif
+  return lines;
+}
+// LCOV_EXCL_STOP
@@ -0,0 +1,75 @@
+#include "SequenceTracker.hpp"
+
+#include <utility>
+
+SequenceTracker::SequenceTracker(qint64 restartWindow)
+    : m_restartWindow(qMax<qint64>(restartWindow, 1)) {
+  reset();
+}
+
+SequenceTracker::Result SequenceTracker::track(qint64 sequence) {
+  ++m_received;
+  const bool expectRestart = std::exchange(m_expectRestart, false);
+
+  if (m_last == 0) {
+    m_last = sequence;
+    return First;
+  }
+
+  if (sequence == m_last + 1) {
+    m_last = sequence;
+    return InOrder;
+  }
+
+  if (sequence > m_last) {
+    m_lost += sequence - m_last - 1;
+    m_last = sequence;
+    return Gap;
+  }
+
+  // A restarted publisher counts from 1 again; its frames are not late ones
+  if (expectRestart || sequence == 1 || m_last - sequence >= m_restartWindow) {
+    ++m_restarts;
+    m_last = sequence;
+    return Restart;
+  }
+
+  ++m_late;
+  if (m_lost > 0) {
+    --m_lost;
+  }
+  return Late;
+}
+
+qint64 SequenceTracker::lastSequence() const {
+  return m_last;
+}
+
+qint64 SequenceTracker::received() const {
+  return m_received;
+}
+
+qint64 SequenceTracker::lost() const {
+  return m_lost;
+}
+
+qint64 SequenceTracker::late() const {
+  return m_late;
+}
+
+int SequenceTracker::restarts() const {
+  return m_restarts;
+}
+
+void SequenceTracker::expectRestart() {
+  m_expectRestart = m_last != 0;
+}
+
+void SequenceTracker::reset() {
+  m_last = 0;
+  m_received = 0;
+  m_lost = 0;
+  m_late = 0;
+  m_restarts = 0;
+  m_expectRestart = false;
+}
@@ -0,0 +1,74 @@
+#include "SignalStore.hpp"
+
+#include <QtAlgorithms>
+
+SignalStore::SignalStore(QObject* parent)
+    : QObject(parent), m_updateCount(0), m_flushPending(false) {
+  // Reserved up front: registering never moves the values the hot path writes
+  m_values.reserve(kMaxSignals);
+  m_names.reserve(kMaxSignals);
+  m_dirty.fill(0, kMaxSignals / 64);
+}
+
+SignalStore::SignalId SignalStore::registerSignal(const QString& name, double initial) {
+  const auto existing = m_ids.constFind(name);
+  if (existing != m_ids.cend()) {
+    return existing.value();
+  }
+  if (m_values.size() >= kMaxSignals) {
+    return kInvalidSignal;
+  }
+
+  const SignalId id = static_cast<SignalId>(m_values.size());
+  m_values.append(initial);
+  m_names.append(name);
+  m_ids.insert(name, id);
+  emit signalRegistered(id);
+  return id;
+}
+
+SignalStore::SignalId SignalStore::idOf(const QString& name) const {
+  return m_ids.value(name, kInvalidSignal);
+}
+
+QString SignalStore::nameOf(SignalId id) const {
+  return m_names.value(id);
+}
+
+void SignalStore::flush() {
+  if (!m_flushPending) {
+    return;
+  }
+  m_flushPending = false;
+
+  // Walk the dirty words; a listener changing values meanwhile schedules the next flush
+  const int words = (m_values.size() + 63) / 64;
+  for (int word = 0; word < words; ++word) {
+    quint64 bits = m_dirty.at(word);
+    m_dirty.data()[word] = 0;
+    while (bits != 0) {
+      const SignalId id = static_cast<SignalId>(word * 64 + qCountTrailingZeroBits(bits));
+      bits &= bits - 1;
+      emit valueChanged(id, m_values.at(id));
+    }
+  }
+}
+
+SignalPropertyMap::SignalPropertyMap(SignalStore* store, QObject* parent)
+    : QQmlPropertyMap(this, parent), m_store(store) {
+  for (int id = 0; id < store->count(); ++id) {
+    insert(store->nameOf(id), store->value(id));
+  }
+
+  connect(store, &SignalStore::signalRegistered, this, [this](SignalStore::SignalId id) {
+    insert(m_store->nameOf(id), m_store->value(id));
+  });
+  connect(store, &SignalStore::valueChanged, this, [this](SignalStore::SignalId id, double value) {
+    insert(m_store->nameOf(id), value);
+  });
+}
+
+QVariant SignalPropertyMap::updateValue(const QString& key, const QVariant& input) {
+  Q_UNUSED(input);
+  return value(key);
+}
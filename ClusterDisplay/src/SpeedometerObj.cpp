@@ -1,10 +1,22 @@
 #include "SpeedometerObj.hpp"
 
+#include <cmath>
+
 SpeedometerObj::SpeedometerObj(QObject* parent)
-    : ZmqSubscriber(SPEEDOMETER_ADDRESS, parent), m_speed{0} {
+    : QObject(parent), m_speed{0}, m_hub(nullptr), m_listenerId(0) {
   setSpeed(0); // Needed so the first value gets displayed on screen
 }
-SpeedometerObj::~SpeedometerObj() {}
+
+SpeedometerObj::SpeedometerObj(ClusterSignalHub* hub, QObject* parent) : SpeedometerObj(parent) {
+  m_hub = hub;
+  m_listenerId = m_hub->subscribe("speed", [this](const QString& value) { _handleMsg(value); });
+}
+
+SpeedometerObj::~SpeedometerObj() {
+  if (m_hub) {
+    m_hub->unsubscribe(m_listenerId);
+  }
+}
 
 double SpeedometerObj::speed(void) const {
   return (m_speed);
@@ -16,7 +28,7 @@ void SpeedometerObj::setSpeed(int newSpeed) {
   emit speedChanged(newSpeed); // This is what makes the value be updated on screen.
 }
 
-void SpeedometerObj::_handleMsg(QString& message) {
+void SpeedometerObj::_handleMsg(const QString& message) {
   int speedMmPerSec = message.toInt();
   // Convert mm/s to km/h: mm/s * 0.0036 = km/h
   // Then multiply by 10 for scaled display
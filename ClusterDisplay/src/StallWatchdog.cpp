@@ -0,0 +1,178 @@
+#include "StallWatchdog.hpp"
+
+#include <QDebug>
+#include <QQuickWindow>
+#include <chrono>
+
+StallWatchdog::StallWatchdog(FlightRecorder* recorder, int thresholdMs, QObject* parent)
+    : QObject(parent),
+      m_recorder(recorder),
+      m_thresholdNs(qMax(thresholdMs, 1) * qint64(1000000)),
+      m_guiBeatNs(0),
+      m_renderStartNs(0),
+      m_frameStartNs(0),
+      m_lastSwapNs(0),
+      m_stallCount(0),
+      m_running(false) {
+  // Several beats per threshold so that timer jitter is never mistaken for a stall
+  m_heartbeatTimer.setInterval(qMax(thresholdMs / 4, 1));
+  connect(&m_heartbeatTimer, &QTimer::timeout, this, [this]() {
+    m_guiBeatNs.store(FlightRecorder::nowNs(), std::memory_order_relaxed);
+  });
+}
+
+StallWatchdog::~StallWatchdog() {
+  stop();
+}
+
+void StallWatchdog::start() {
+  if (isRunning()) {
+    return;
+  }
+
+  m_guiBeatNs.store(FlightRecorder::nowNs(), std::memory_order_relaxed);
+  m_heartbeatTimer.start();
+  m_running = true;
+  m_thread = std::thread(&StallWatchdog::run, this);
+}
+
+void StallWatchdog::stop() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running) {
+      return;
+    }
+    m_running = false;
+  }
+  m_wakeUp.notify_all();
+  m_thread.join();
+  m_heartbeatTimer.stop();
+}
+
+bool StallWatchdog::isRunning() const {
+  return m_thread.joinable();
+}
+
+int StallWatchdog::thresholdMs() const {
+  return static_cast<int>(m_thresholdNs / 1000000);
+}
+
+int StallWatchdog::stallCount() const {
+  return m_stallCount.load(std::memory_order_relaxed);
+}
+
+// LCOV_EXCL_START - Requires a live scene graph to emit the render-thread signals
+void StallWatchdog::attachWindow(QQuickWindow* window) {
+  if (!window) {
+    return;
+  }
+
+  // The signals are emitted on the render thread and must be handled there
+  connect(
+      window, &QQuickWindow::beforeSynchronizing, this, [this]() { renderSyncStarted(); },
+      Qt::DirectConnection);
+  connect(
+      window, &QQuickWindow::afterSynchronizing, this, [this]() { renderSyncFinished(); },
+      Qt::DirectConnection);
+  connect(
+      window, &QQuickWindow::beforeRendering, this, [this]() { renderFrameStarted(); },
+      Qt::DirectConnection);
+  connect(
+      window, &QQuickWindow::frameSwapped, this, [this]() { renderFrameFinished(); },
+      Qt::DirectConnection);
+}
+// LCOV_EXCL_STOP
+
+void StallWatchdog::renderSyncStarted() {
+  const qint64 now = FlightRecorder::nowNs();
+  m_frameStartNs.store(now, std::memory_order_relaxed);
+  m_renderStartNs.store(now, std::memory_order_relaxed);
+}
+
+void StallWatchdog::renderSyncFinished() {
+  // Without scene changes the frame ends here, with no render pass and no swap
+  m_renderStartNs.store(0, std::memory_order_relaxed);
+}
+
+void StallWatchdog::renderFrameStarted() {
+  const qint64 now = FlightRecorder::nowNs();
+  m_renderStartNs.store(now, std::memory_order_relaxed);
+
+  // A frame without a synchronization before it is timed from here
+  qint64 none = 0;
+  m_frameStartNs.compare_exchange_strong(none, now, std::memory_order_relaxed);
+}
+
+void StallWatchdog::renderFrameFinished() {
+  const qint64 now = FlightRecorder::nowNs();
+  m_renderStartNs.store(0, std::memory_order_relaxed);
+  const qint64 start = m_frameStartNs.exchange(0, std::memory_order_relaxed);
+  const qint64 lastSwap = m_lastSwapNs.exchange(now, std::memory_order_relaxed);
+  if (m_recorder) {
+    m_recorder->record(FlightRecorder::FrameSwapped,
+                       start > 0 ? static_cast<qint32>((now - start) / 1000) : 0,
+                       lastSwap > 0 ? now - lastSwap : 0);
+  }
+}
+
+void StallWatchdog::run() {
+  const auto pollInterval = std::chrono::nanoseconds(qMax(m_thresholdNs / 4, qint64(1000000)));
+  bool guiStalled = false;
+  bool renderStalled = false;
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (m_running) {
+    m_wakeUp.wait_for(lock, pollInterval, [this]() { return !m_running; });
+    if (!m_running) {
+      break;
+    }
+
+    const qint64 now = FlightRecorder::nowNs();
+
+    // Report each stall once and re-arm when the thread is responsive again
+    const qint64 guiBlockedNs = now - m_guiBeatNs.load(std::memory_order_relaxed);
+    if (guiBlockedNs > m_thresholdNs) {
+      if (!guiStalled) {
+        guiStalled = true;
+        reportStall(GuiThread, guiBlockedNs);
+      }
+    } else {
+      guiStalled = false;
+    }
+
+    const qint64 renderStart = m_renderStartNs.load(std::memory_order_relaxed);
+    const qint64 renderBlockedNs = renderStart > 0 ? now - renderStart : 0;
+    if (renderBlockedNs > m_thresholdNs) {
+      if (!renderStalled) {
+        renderStalled = true;
+        reportStall(RenderThread, renderBlockedNs);
+      }
+    } else {
+      renderStalled = false;
+    }
+  }
+}
+
+void StallWatchdog::reportStall(Channel channel, qint64 durationNs) {
+  m_stallCount.fetch_add(1, std::memory_order_relaxed);
+
+  QString dumpPath;
+  if (m_recorder) {
+    m_recorder->record(FlightRecorder::Stall, channel, durationNs);
+    const char* reason = channel == GuiThread ? "gui-stall" : "render-stall";
+    if (m_recorder->dump(reason)) {
+      dumpPath = m_recorder->dumpPath(reason);
+    }
+  }
+
+  const qint64 durationMs = durationNs / 1000000;
+  qWarning() << "StallWatchdog:" << (channel == GuiThread ? "GUI" : "render")
+             << "thread blocked for" << durationMs << "ms, flight recorder dump:" << dumpPath;
+
+  // Delivered once the GUI thread processes events again
+  QMetaObject::invokeMethod(
+      this, [this, channel, durationMs, dumpPath]() {
+        emit stallDetected(channel, durationMs, dumpPath);
+      },
+      Qt::QueuedConnection);
+}
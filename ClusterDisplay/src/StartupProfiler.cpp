@@ -0,0 +1,148 @@
+#include "StartupProfiler.hpp"
+
+#include <QFile>
+#include <QQuickWindow>
+#include <QStringList>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace {
+
+// LCOV_EXCL_START - Depends on procfs contents of the running process
+/**
+ * @brief Compute how long the current process has been alive
+ * @return Process age in milliseconds, or -1 if it cannot be determined
+ */
+qint64 processAgeMs() {
+#ifdef Q_OS_LINUX
+  QFile statFile(QStringLiteral("/proc/self/stat"));
+  QFile uptimeFile(QStringLiteral("/proc/uptime"));
+  if (!statFile.open(QIODevice::ReadOnly) || !uptimeFile.open(QIODevice::ReadOnly)) {
+    return -1;
+  }
+
+  // The command name may contain spaces, so fields are counted after its closing parenthesis
+  const QByteArray stat = statFile.readAll();
+  const int commEnd = stat.lastIndexOf(')');
+  if (commEnd < 0) {
+    return -1;
+  }
+  const QList<QByteArray> fields = stat.mid(commEnd + 2).split(' ');
+
+  // Field 22 (starttime) is the 20th field after the command name
+  constexpr int kStartTimeIndex = 19;
+  if (fields.size() <= kStartTimeIndex) {
+    return -1;
+  }
+
+  bool ok = false;
+  const qint64 startTicks = fields.at(kStartTimeIndex).toLongLong(&ok);
+  const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+  if (!ok || ticksPerSecond <= 0) {
+    return -1;
+  }
+
+  const double uptimeSeconds = uptimeFile.readAll().split(' ').value(0).toDouble(&ok);
+  if (!ok) {
+    return -1;
+  }
+
+  const double ageMs = uptimeSeconds * 1000.0 - startTicks * 1000.0 / ticksPerSecond;
+  return ageMs >= 0 ? static_cast<qint64>(ageMs) : -1;
+#else
+  return -1;
+#endif
+}
+// LCOV_EXCL_STOP
+
+} // namespace
+
+StartupProfiler::StartupProfiler(QObject* parent)
+    : QObject(parent), m_preMainMs(processAgeMs()), m_firstFrameNs(-1), m_complete(false) {
+  m_clock.start();
+}
+
+StartupProfiler::~StartupProfiler() {}
+
+void StartupProfiler::mark(const QString& name) {
+  m_milestones.append({name, m_clock.nsecsElapsed()});
+}
+
+// LCOV_EXCL_START - Requires a live scene graph to emit frameSwapped
+void StartupProfiler::attachWindow(QQuickWindow* window) {
+  if (!window) {
+    return;
+  }
+
+  // frameSwapped is emitted on the render thread: capture the timestamp there,
+  // then finish the report on the GUI thread
+  m_frameConnection = connect(
+      window, &QQuickWindow::frameSwapped, this,
+      [this]() {
+        qint64 expected = -1;
+        if (m_firstFrameNs.compare_exchange_strong(expected, m_clock.nsecsElapsed())) {
+          QMetaObject::invokeMethod(this, &StartupProfiler::markFirstFrame, Qt::QueuedConnection);
+        }
+      },
+      Qt::DirectConnection);
+}
+// LCOV_EXCL_STOP
+
+bool StartupProfiler::isComplete() const {
+  return m_complete;
+}
+
+const QVector<StartupProfiler::Milestone>& StartupProfiler::milestones() const {
+  return m_milestones;
+}
+
+qint64 StartupProfiler::preMainMs() const {
+  return m_preMainMs;
+}
+
+void StartupProfiler::markFirstFrame() {
+  if (m_complete) {
+    return;
+  }
+  m_complete = true;
+  disconnect(m_frameConnection);
+
+  // Use the render-thread timestamp when available, otherwise the time of this call
+  qint64 expected = -1;
+  m_firstFrameNs.compare_exchange_strong(expected, m_clock.nsecsElapsed());
+  m_milestones.append({QStringLiteral("First frame presented"), m_firstFrameNs.load()});
+
+  emit firstFrameRendered();
+  emit reportReady(report());
+}
+
+QString StartupProfiler::report() const {
+  QStringList lines;
+  lines << QStringLiteral("Startup report (time to first frame)");
+
+  if (m_preMainMs >= 0) {
+    lines << QStringLiteral("  %1 %2 ms").arg(QStringLiteral("Process start to main()"), -32).arg(
+                 m_preMainMs);
+  }
+
+  qint64 previousNs = 0;
+  for (const Milestone& milestone : m_milestones) {
+    const double phaseMs = (milestone.elapsedNs - previousNs) / 1e6;
+    const double totalMs = milestone.elapsedNs / 1e6;
+    lines << QStringLiteral("  %1 %2 ms  (at %3 ms)")
+                 .arg(milestone.name, -32)
+                 .arg(phaseMs, 0, 'f', 2)
+                 .arg(totalMs, 0, 'f', 2);
+    previousNs = milestone.elapsedNs;
+  }
+
+  if (m_complete && m_preMainMs >= 0) {
+    const double totalMs = m_preMainMs + m_firstFrameNs.load() / 1e6;
+    lines << QStringLiteral("  %1 %2 ms").arg(QStringLiteral("Total since process start"), -32)
+                 .arg(totalMs, 0, 'f', 2);
+  }
+
+  return lines.join('\n');
+}
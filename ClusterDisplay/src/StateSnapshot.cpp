@@ -0,0 +1,236 @@
+#include "StateSnapshot.hpp"
+
+#include <QDir>
+#include <QFileInfo>
+#include <cstddef>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+constexpr quint32 kMagic = 0x31534343; ///< "CCS1" in little endian
+constexpr quint16 kVersion = 1;
+
+/// One slot per sector, so writing a slot never touches the other one
+constexpr qint64 kSlotSize = 512;
+constexpr qint64 kFileSize = 2 * kSlotSize;
+
+/**
+ * @brief On-disk layout of a slot
+ */
+struct Slot {
+  quint32 magic;                ///< kMagic
+  quint16 version;              ///< kVersion
+  quint16 recordSize;           ///< sizeof(StateSnapshot::Record)
+  quint64 sequence;             ///< Incremented with every write, 0 = never written
+  StateSnapshot::Record record; ///< Persisted values
+  quint32 checksum;             ///< CRC-32 of all preceding fields
+};
+static_assert(sizeof(Slot) <= kSlotSize, "A slot must fit into one sector");
+
+/**
+ * @brief CRC-32 (IEEE 802.3), bitwise; the slots are too small to need a table
+ */
+quint32 crc32(const uchar* data, size_t size) {
+  quint32 crc = 0xffffffffu;
+  for (size_t i = 0; i < size; ++i) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (0xedb88320u & (0u - (crc & 1u)));
+    }
+  }
+  return ~crc;
+}
+
+quint32 slotChecksum(const Slot& slot) {
+  return crc32(reinterpret_cast<const uchar*>(&slot), offsetof(Slot, checksum));
+}
+
+/**
+ * @brief Reads a slot and checks its header, checksum and value ranges
+ */
+bool readSlot(const uchar* map, int index, Slot* slot) {
+  std::memcpy(slot, map + index * kSlotSize, sizeof(Slot));
+  if (slot->magic != kMagic || slot->version != kVersion ||
+      slot->recordSize != sizeof(StateSnapshot::Record) || slot->sequence == 0 ||
+      slot->checksum != slotChecksum(*slot)) {
+    return false;
+  }
+
+  const StateSnapshot::Record& record = slot->record;
+  return record.battery >= 0 && record.battery <= 100 && record.charging <= 1 &&
+         record.drivingMode <= ClusterModel::AutoMode;
+}
+
+} // namespace
+
+StateSnapshot::StateSnapshot(ClusterModel* model, int minWriteIntervalMs, QObject* parent)
+    : QObject(parent),
+      m_model(model),
+      m_throttle(minWriteIntervalMs),
+      m_map(nullptr),
+      m_sequence(0),
+      m_writeCount(0) {
+  std::memset(&m_lastRecord, 0, sizeof(m_lastRecord));
+
+  connect(&m_throttle, &WriteThrottle::due, this, &StateSnapshot::write);
+
+  // Only the slowly changing values are persisted; alerts and speed are live-only
+  connect(m_model, &ClusterModel::batteryChanged, this, &StateSnapshot::scheduleWrite);
+  connect(m_model, &ClusterModel::chargingChanged, this, &StateSnapshot::scheduleWrite);
+  connect(m_model, &ClusterModel::odometerChanged, this, &StateSnapshot::scheduleWrite);
+  connect(m_model, &ClusterModel::drivingModeTypeChanged, this, &StateSnapshot::scheduleWrite);
+  connect(m_model, &ClusterModel::speedLimitSignalChanged, this, &StateSnapshot::scheduleWrite);
+  connect(m_model, &ClusterModel::lastSpeedLimitChanged, this, &StateSnapshot::scheduleWrite);
+}
+
+StateSnapshot::~StateSnapshot() {
+  if (!m_map) {
+    return;
+  }
+
+  flush();
+#ifdef Q_OS_UNIX
+  msync(m_map, kFileSize, MS_SYNC);
+#endif
+}
+
+bool StateSnapshot::open(const QString& path) {
+  if (m_map) {
+    flush();
+    m_file.unmap(m_map);
+    m_file.close();
+    m_map = nullptr;
+  }
+
+  QFileInfo info(path);
+  if (!info.absoluteDir().mkpath(QStringLiteral("."))) {
+    return false;
+  }
+
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::ReadWrite)) {
+    return false;
+  }
+
+  // A file of another size was not written by this version; its slots fail validation
+  if (m_file.size() != kFileSize && !m_file.resize(kFileSize)) {
+    m_file.close();
+    return false;
+  }
+
+  m_map = m_file.map(0, kFileSize);
+  if (!m_map) {
+    m_file.close();
+    return false;
+  }
+
+  // Continue the sequence of the existing slots
+  m_sequence = 0;
+  m_writeCount = 0;
+  m_throttle.reset();
+  for (int index = 0; index < 2; ++index) {
+    Slot slot;
+    if (readSlot(m_map, index, &slot) && slot.sequence > m_sequence) {
+      m_sequence = slot.sequence;
+      m_lastRecord = slot.record;
+    }
+  }
+  return true;
+}
+
+bool StateSnapshot::isOpen() const {
+  return m_map != nullptr;
+}
+
+bool StateSnapshot::restore() {
+  if (!m_map || m_sequence == 0) {
+    return false;
+  }
+
+  // m_lastRecord holds the newest valid slot; re-applying it does not trigger a write
+  const Record record = m_lastRecord;
+  m_model->setBattery(record.battery);
+  m_model->setCharging(record.charging != 0);
+  m_model->setOdometer(record.odometer);
+  m_model->setDrivingModeType(static_cast<ClusterModel::DrivingMode>(record.drivingMode));
+  m_model->setSpeedLimitSignal(record.speedLimitSignal);
+  m_model->setLastSpeedLimit(record.lastSpeedLimit);
+  m_model->setProvisionalFields(ClusterModel::BatteryField | ClusterModel::ChargingField |
+                                ClusterModel::OdometerField | ClusterModel::DrivingModeField |
+                                ClusterModel::SpeedLimitSignalField |
+                                ClusterModel::LastSpeedLimitField);
+  return true;
+}
+
+void StateSnapshot::flush() {
+  m_throttle.cancel();
+  write();
+}
+
+quint64 StateSnapshot::sequence() const {
+  return m_sequence;
+}
+
+int StateSnapshot::writeCount() const {
+  return m_writeCount;
+}
+
+QString StateSnapshot::defaultFileName() {
+  return QStringLiteral("cluster-state.bin");
+}
+
+void StateSnapshot::scheduleWrite() {
+  if (m_map) {
+    m_throttle.request();
+  }
+}
+
+StateSnapshot::Record StateSnapshot::capture() const {
+  Record record;
+  std::memset(&record, 0, sizeof(record));
+  record.battery = m_model->battery();
+  record.odometer = m_model->odometer();
+  record.speedLimitSignal = m_model->speedLimitSignal();
+  record.lastSpeedLimit = m_model->lastSpeedLimit();
+  record.charging = m_model->charging() ? 1 : 0;
+  record.drivingMode = static_cast<quint8>(m_model->drivingModeType());
+  return record;
+}
+
+void StateSnapshot::write() {
+  if (!m_map) {
+    return;
+  }
+
+  const Record record = capture();
+  if (m_sequence > 0 && std::memcmp(&record, &m_lastRecord, sizeof(record)) == 0) {
+    return;
+  }
+
+  Slot slot;
+  std::memset(&slot, 0, sizeof(slot));
+  slot.magic = kMagic;
+  slot.version = kVersion;
+  slot.recordSize = sizeof(Record);
+  slot.sequence = m_sequence + 1;
+  slot.record = record;
+  slot.checksum = slotChecksum(slot);
+
+  // Overwrite the older slot; the newest one stays valid until this one is complete
+  uchar* target = m_map + (slot.sequence % 2) * kSlotSize;
+  std::memcpy(target, &slot, sizeof(slot));
+#ifdef Q_OS_UNIX
+  // MS_ASYNC only queues the dirty sector; the destructor syncs with MS_SYNC
+  msync(m_map, kFileSize, MS_ASYNC);
+#endif
+
+  m_sequence = slot.sequence;
+  m_lastRecord = record;
+  ++m_writeCount;
+  m_throttle.markWritten();
+  emit written(m_sequence);
+}
@@ -0,0 +1,339 @@
+#include "TrendGraph.hpp"
+
+#include <QMatrix4x4>
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGTransformNode>
+#include <cmath>
+#include <cstring>
+
+// LCOV_EXCL_START - Requires a window and a running scene graph
+namespace {
+
+/// Vertices hold times relative to an origin as float; moving it up hourly keeps them to the ms
+constexpr qint64 kOriginMaxAgeMs = 60 * 60 * 1000;
+
+/// Opacity of the min/max envelope relative to the line
+constexpr qreal kEnvelopeOpacity = 0.3;
+
+QSGGeometryNode* createStrip(unsigned int drawingMode, int vertexCount) {
+  auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), vertexCount);
+  geometry->setDrawingMode(drawingMode);
+  geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+  auto* node = new QSGGeometryNode();
+  node->setGeometry(geometry);
+  node->setFlag(QSGNode::OwnsGeometry);
+  node->setMaterial(new QSGFlatColorMaterial());
+  node->setFlag(QSGNode::OwnsMaterial);
+  return node;
+}
+
+/**
+ * @brief Envelope and line of a TrendGraph under the transform that scrolls them
+ */
+class TrendGraphNode : public QSGTransformNode {
+ public:
+  TrendGraphNode()
+      : envelope(createStrip(QSGGeometry::DrawTriangleStrip, 2 * TrendGraph::kMaxPoints)),
+        line(createStrip(QSGGeometry::DrawLineStrip, TrendGraph::kMaxPoints)), resolution(-1),
+        generation(0), drawn(0), size(0), originMs(0), height(0.0), minimum(0.0), maximum(0.0) {
+    line->geometry()->setLineWidth(2);
+    appendChildNode(envelope);
+    appendChildNode(line);
+  }
+
+  QSGGeometryNode* envelope; ///< Min/max band, two vertices per column
+  QSGGeometryNode* line;     ///< One vertex per column, then the held value
+  int resolution;            ///< Tier drawn (-1 = none yet)
+  quint64 generation;        ///< Generation of the columns drawn
+  uint64_t drawn;            ///< Columns pushed to the tier when last drawn
+  size_t size;               ///< Columns in the vertices
+  qint64 originMs;           ///< Time at x = 0 of the vertices
+  qreal height;              ///< Item height the vertices were mapped to
+  qreal minimum;             ///< Minimum the vertices were mapped with
+  qreal maximum;             ///< Maximum the vertices were mapped with
+};
+
+} // namespace
+// LCOV_EXCL_STOP
+
+TrendGraph::TrendGraph(QQuickItem* parent)
+    : QQuickItem(parent), m_value(0.0), m_timeSpan(60), m_minimum(0.0), m_maximum(100.0),
+      m_color(Qt::white), m_colorDirty(true), m_slotMs(1), m_generation(0) {
+  setFlag(ItemHasContents, true);
+  // The line enters from outside the left edge
+  setClip(true);
+  m_clock.start();
+
+  m_scrollTimer.setSingleShot(true);
+  connect(&m_scrollTimer, &QTimer::timeout, this, &TrendGraph::scroll);
+  rebuildColumns();
+}
+
+TrendGraph::~TrendGraph() {}
+
+qreal TrendGraph::value() const {
+  return m_value;
+}
+
+int TrendGraph::timeSpan() const {
+  return m_timeSpan;
+}
+
+qreal TrendGraph::minimum() const {
+  return m_minimum;
+}
+
+qreal TrendGraph::maximum() const {
+  return m_maximum;
+}
+
+QColor TrendGraph::color() const {
+  return m_color;
+}
+
+void TrendGraph::setValue(qreal value) {
+  appendSample(now(), value);
+  if (m_value != value) {
+    m_value = value;
+    emit valueChanged(m_value);
+  }
+}
+
+void TrendGraph::setTimeSpan(int seconds) {
+  seconds = qMax(seconds, 1);
+  if (m_timeSpan != seconds) {
+    m_timeSpan = seconds;
+    rebuildColumns();
+    scroll();
+    emit timeSpanChanged(m_timeSpan);
+  }
+}
+
+void TrendGraph::setMinimum(qreal minimum) {
+  if (m_minimum != minimum) {
+    m_minimum = minimum;
+    update();
+    emit minimumChanged(m_minimum);
+  }
+}
+
+void TrendGraph::setMaximum(qreal maximum) {
+  if (m_maximum != maximum) {
+    m_maximum = maximum;
+    update();
+    emit maximumChanged(m_maximum);
+  }
+}
+
+void TrendGraph::setColor(const QColor& color) {
+  if (m_color != color) {
+    m_color = color;
+    m_colorDirty = true;
+    update();
+    emit colorChanged(m_color);
+  }
+}
+
+void TrendGraph::appendSample(qint64 timeMs, qreal value) {
+  if (!m_history.append(timeMs, static_cast<float>(value))) {
+    return;
+  }
+  foldNewEntries(History::Raw);
+  foldNewEntries(History::Seconds);
+  foldNewEntries(History::Minutes);
+  update();
+  m_scrollTimer.start();
+}
+
+const TrendGraph::History& TrendGraph::history() const {
+  return m_history;
+}
+
+int TrendGraph::plot(qint64 nowMs, PlotPoint* out) const {
+  if (m_history.isEmpty()) {
+    return 0;
+  }
+
+  // Start at the last vertex at or before the left edge so the line enters the graph from outside
+  const qint64 fromMs = nowMs - spanMs();
+  const auto& columns = m_tiers[m_history.resolutionFor(fromMs)].columns;
+  size_t first = 0;
+  while (first + 1 < columns.size() && columns.at(first + 1).point.timeMs <= fromMs) {
+    ++first;
+  }
+  int written = 0;
+  for (size_t i = first; i < columns.size(); ++i) {
+    out[written++] = columns.at(i).point;
+  }
+
+  // The newest value is held until the next change; buckets still being filled end there too
+  const HistoryPoint latest = m_history.latest();
+  const int64_t lastMs = written > 0 ? out[written - 1].timeMs : latest.timeMs;
+  out[written++] = {qMax<int64_t>(nowMs, lastMs), latest.value, latest.value, latest.value};
+  return written;
+}
+
+qint64 TrendGraph::now() const {
+  return m_clock.elapsed();
+}
+
+void TrendGraph::foldNewEntries(History::Resolution resolution) {
+  Tier& tier = m_tiers[resolution];
+  const uint64_t pushed = m_history.pushed(resolution);
+  const size_t count = m_history.count(resolution);
+
+  // Entries pushed since the last call are the newest ones, unless they wrapped the whole tier
+  const size_t fresh = static_cast<size_t>(qMin<uint64_t>(pushed - tier.consumed, count));
+  for (size_t i = count - fresh; i < count; ++i) {
+    fold(tier, resolution, m_history.bucket(resolution, i));
+  }
+  tier.consumed = pushed;
+}
+
+void TrendGraph::fold(Tier& tier, History::Resolution resolution,
+                      const HistoryBucket& entry) const {
+  // A column never spans less than one entry of its tier
+  const int64_t duration = History::duration(resolution);
+  const int64_t slot = entry.startMs / qMax<int64_t>(m_slotMs, duration);
+  const int64_t timeMs = entry.startMs + duration / 2;
+  auto& columns = tier.columns;
+
+  if (columns.isEmpty() || columns.back().slot != slot) {
+    const float reference = columns.isEmpty() ? entry.average : columns.back().point.value;
+    columns.push({slot, {timeMs, entry.average, entry.min, entry.max}, reference, entry.average,
+                  timeMs, 1});
+    return;
+  }
+
+  Column& column = columns.back();
+  ++column.count;
+  if (resolution == History::Raw) {
+    // The sample farthest from the previous vertex, so a one-sample peak is still drawn
+    if (std::abs(entry.average - column.reference) >
+        std::abs(column.point.value - column.reference)) {
+      column.point = {timeMs, entry.average, entry.average, entry.average};
+    }
+    return;
+  }
+  column.sum += entry.average;
+  column.timeSum += timeMs;
+  column.point = {column.timeSum / column.count, static_cast<float>(column.sum / column.count),
+                  qMin(column.point.min, entry.min), qMax(column.point.max, entry.max)};
+}
+
+void TrendGraph::rebuildColumns() {
+  m_slotMs = qMax<qint64>(1, (spanMs() + kSlotsPerSpan - 1) / kSlotsPerSpan);
+  for (Tier& tier : m_tiers) {
+    tier.columns.clear();
+    tier.consumed = 0;
+  }
+  foldNewEntries(History::Raw);
+  foldNewEntries(History::Seconds);
+  foldNewEntries(History::Minutes);
+  ++m_generation;
+  m_scrollTimer.setInterval(static_cast<int>(m_slotMs));
+}
+
+void TrendGraph::scroll() {
+  update();
+  // Once the newest sample has left the graph only the held value is shown, which does not move
+  if (!m_history.isEmpty() && now() - m_history.latest().timeMs <= spanMs()) {
+    m_scrollTimer.start();
+  }
+}
+
+qint64 TrendGraph::spanMs() const {
+  return static_cast<qint64>(m_timeSpan) * History::kSecondMs;
+}
+
+// LCOV_EXCL_START - Requires a window and a running scene graph
+QSGNode* TrendGraph::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) {
+  Q_UNUSED(data);
+  auto* node = static_cast<TrendGraphNode*>(oldNode);
+
+  if (m_history.isEmpty() || width() <= 0 || height() <= 0 || m_maximum <= m_minimum) {
+    delete node;
+    m_colorDirty = true;
+    return nullptr;
+  }
+
+  if (!node) {
+    node = new TrendGraphNode();
+    m_colorDirty = true;
+  }
+  if (m_colorDirty) {
+    QColor envelopeColor = m_color;
+    envelopeColor.setAlphaF(m_color.alphaF() * kEnvelopeOpacity);
+    static_cast<QSGFlatColorMaterial*>(node->line->material())->setColor(m_color);
+    static_cast<QSGFlatColorMaterial*>(node->envelope->material())->setColor(envelopeColor);
+    node->line->markDirty(QSGNode::DirtyMaterial);
+    node->envelope->markDirty(QSGNode::DirtyMaterial);
+    m_colorDirty = false;
+  }
+
+  const qint64 nowMs = now();
+  const qint64 fromMs = nowMs - spanMs();
+  const History::Resolution resolution = m_history.resolutionFor(fromMs);
+  const auto& columns = m_tiers[resolution].columns;
+  QSGGeometry::Point2D* line = node->line->geometry()->vertexDataAsPoint2D();
+  QSGGeometry::Point2D* envelope = node->envelope->geometry()->vertexDataAsPoint2D();
+
+  // Vertices of unchanged columns are kept and shifted past the columns that left the tier;
+  // the newest column drawn last time may have grown since, so it is rewritten
+  size_t first = 0;
+  const uint64_t added = columns.pushed() - node->drawn;
+  if (node->resolution == resolution && node->generation == m_generation &&
+      node->height == height() && node->minimum == m_minimum && node->maximum == m_maximum &&
+      nowMs - node->originMs < kOriginMaxAgeMs && node->size > 0 && added < columns.size()) {
+    const size_t dropped = node->size + added - columns.size();
+    first = node->size - dropped - 1;
+    if (dropped > 0) {
+      std::memmove(line, line + dropped, first * sizeof(*line));
+      std::memmove(envelope, envelope + 2 * dropped, 2 * first * sizeof(*envelope));
+    }
+  } else {
+    node->resolution = resolution;
+    node->generation = m_generation;
+    node->height = height();
+    node->minimum = m_minimum;
+    node->maximum = m_maximum;
+    node->originMs = nowMs;
+  }
+
+  const qreal range = m_maximum - m_minimum;
+  const auto y = [this, range](float value) {
+    return static_cast<float>((1.0 - qBound(0.0, (value - m_minimum) / range, 1.0)) * height());
+  };
+  const auto set = [&](size_t index, const PlotPoint& point) {
+    const float x = static_cast<float>(point.timeMs - node->originMs);
+    line[index].set(x, y(point.value));
+    envelope[2 * index].set(x, y(point.max));
+    envelope[2 * index + 1].set(x, y(point.min));
+  };
+  for (size_t i = first; i < columns.size(); ++i) {
+    set(i, columns.at(i).point);
+  }
+
+  // The newest value is held to the right edge; unused vertices repeat it and draw nothing
+  const HistoryPoint latest = m_history.latest();
+  const int64_t lastMs = columns.isEmpty() ? latest.timeMs : columns.back().point.timeMs;
+  const PlotPoint held = {qMax<int64_t>(nowMs, lastMs), latest.value, latest.value, latest.value};
+  const size_t end = columns.isFull() ? columns.size() + 1 : kMaxPoints;
+  for (size_t i = columns.size(); i < end; ++i) {
+    set(i, held);
+  }
+  node->drawn = columns.pushed();
+  node->size = columns.size();
+
+  // Scrolling and resizing only change the transform: x of a vertex is its time from the origin
+  QMatrix4x4 matrix;
+  matrix.scale(static_cast<float>(width() / spanMs()), 1.0f);
+  matrix.translate(static_cast<float>(node->originMs - fromMs), 0.0f);
+  node->setMatrix(matrix);
+  node->line->markDirty(QSGNode::DirtyGeometry);
+  node->envelope->markDirty(QSGNode::DirtyGeometry);
+
+  return node;
+}
+// LCOV_EXCL_STOP
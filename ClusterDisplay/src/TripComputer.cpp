@@ -0,0 +1,148 @@
+#include "TripComputer.hpp"
+
+#include <cmath>
+
+TripComputer::TripComputer(qint64 ignitionOffMs)
+    : m_ignitionOffMs(ignitionOffMs),
+      m_tripCount(0),
+      m_speedTime(-1),
+      m_speed(0),
+      m_odometerLast(-1),
+      m_recentMaximum(kRecentWindowMs, 1000),
+      m_batteryReference(-1),
+      m_charging(false) {
+  reset(0);
+}
+
+void TripComputer::reset(qint64 timeMs) {
+  ++m_tripCount;
+  m_interruptedAt = -1;
+  // A trip reset while driving starts integrating the current speed right away
+  m_speedTime = m_speedTime >= 0 ? timeMs : -1;
+  m_movingIntegral = 0.0;
+  m_movingTimeMs = 0;
+  m_integratedDistance = 0.0;
+  m_integratedAtOdometer = 0.0;
+  m_odometerDistance = 0;
+  m_odometerSeen = false;
+  m_movingSpeeds.reset();
+  m_recentMaximum.reset();
+  m_energyUsed = 0;
+}
+
+void TripComputer::addSpeed(qint64 timeMs, int mmPerSecond) {
+  checkIgnition(timeMs);
+  advance(timeMs);
+
+  m_speed = mmPerSecond;
+  m_speedTime = timeMs;
+  if (mmPerSecond > kMovingSpeedMmPerSecond) {
+    m_movingSpeeds.add(mmPerSecond);
+  }
+  m_recentMaximum.add(timeMs, mmPerSecond);
+}
+
+void TripComputer::addOdometer(qint64 timeMs, qint64 meters) {
+  checkIgnition(timeMs);
+
+  const qint64 step = m_odometerLast >= 0 ? meters - m_odometerLast : 0;
+  if (step > 0 && step <= kMaxOdometerStep) {
+    if (!m_odometerSeen) {
+      // Go on from the distance integrated up to the previous value, so the trip never falls back
+      m_odometerDistance = std::llround(m_integratedAtOdometer);
+      m_odometerSeen = true;
+    }
+    m_odometerDistance += step;
+  }
+  m_odometerLast = meters;
+  m_integratedAtOdometer = m_integratedDistance;
+}
+
+void TripComputer::addBattery(qint64 timeMs, int percent) {
+  checkIgnition(timeMs);
+
+  if (m_batteryReference >= 0 && !m_charging && percent < m_batteryReference) {
+    m_energyUsed += m_batteryReference - percent;
+  }
+  if (m_batteryReference < 0 || m_charging || percent < m_batteryReference) {
+    m_batteryReference = percent;
+  }
+}
+
+void TripComputer::setCharging(qint64 timeMs, bool charging) {
+  checkIgnition(timeMs);
+  m_charging = charging;
+}
+
+void TripComputer::advance(qint64 timeMs) {
+  if (m_speedTime < 0 || timeMs <= m_speedTime) {
+    return;
+  }
+
+  const qint64 elapsedMs = timeMs - m_speedTime;
+  // mm/s * ms = 1e-6 m
+  m_integratedDistance += m_speed * static_cast<double>(elapsedMs) * 1e-6;
+  if (m_speed > kMovingSpeedMmPerSecond) {
+    m_movingTimeMs += elapsedMs;
+    m_movingIntegral += m_speed * static_cast<double>(elapsedMs);
+  }
+  // The held speed is still the current one
+  m_recentMaximum.add(timeMs, m_speed);
+  m_speedTime = timeMs;
+}
+
+void TripComputer::interrupt(qint64 timeMs) {
+  advance(timeMs);
+  m_speedTime = -1;
+  if (m_interruptedAt < 0) {
+    m_interruptedAt = timeMs;
+  }
+}
+
+int TripComputer::tripCount() const {
+  return m_tripCount;
+}
+
+qint64 TripComputer::distance() const {
+  return m_odometerSeen ? m_odometerDistance : std::llround(m_integratedDistance);
+}
+
+qint64 TripComputer::movingTimeMs() const {
+  return m_movingTimeMs;
+}
+
+double TripComputer::averageSpeed() const {
+  return m_movingTimeMs > 0 ? m_movingIntegral / static_cast<double>(m_movingTimeMs) : 0.0;
+}
+
+double TripComputer::maxSpeed() const {
+  return m_movingSpeeds.max();
+}
+
+double TripComputer::recentMaxSpeed(qint64 nowMs) {
+  return m_recentMaximum.maximum(nowMs);
+}
+
+const RunningStatistics& TripComputer::movingSpeedStatistics() const {
+  return m_movingSpeeds;
+}
+
+int TripComputer::energyUsed() const {
+  return m_energyUsed;
+}
+
+double TripComputer::energyPerKilometer() const {
+  const qint64 meters = distance();
+  return meters >= 100 ? m_energyUsed * 1000.0 / static_cast<double>(meters) : 0.0;
+}
+
+void TripComputer::checkIgnition(qint64 timeMs) {
+  if (m_interruptedAt < 0) {
+    return;
+  }
+  const bool ignitionOff = timeMs - m_interruptedAt >= m_ignitionOffMs;
+  m_interruptedAt = -1;
+  if (ignitionOff) {
+    reset(timeMs);
+  }
+}
@@ -0,0 +1,301 @@
+#include "TripLog.hpp"
+
+#include <cstring>
+
+#include "StreamingStatistics.hpp"
+
+namespace TripLog {
+
+namespace {
+
+// Indexed by Signal
+const char* const kSignalNames[SignalCount] = {
+    "speed", "battery", "charging", "odometer", "mode", "object", "brake",
+    "lane", "speedlimit", "sign", "severity", "link", "range"};
+
+void appendVarint(QByteArray* out, quint64 value) {
+  while (value >= 0x80) {
+    out->append(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->append(static_cast<char>(value));
+}
+
+void appendSigned(QByteArray* out, qint64 value) {
+  // Zigzag: small magnitudes of either sign become small unsigned numbers
+  appendVarint(out, (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63));
+}
+
+bool readVarint(const QByteArray& in, int* position, quint64* value) {
+  quint64 result = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (*position >= in.size()) {
+      return false;
+    }
+    const quint8 byte = static_cast<quint8>(in.at((*position)++));
+    result |= static_cast<quint64>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool readSigned(const QByteArray& in, int* position, qint64* value) {
+  quint64 encoded = 0;
+  if (!readVarint(in, position, &encoded)) {
+    return false;
+  }
+  *value = static_cast<qint64>(encoded >> 1) ^ -static_cast<qint64>(encoded & 1);
+  return true;
+}
+
+} // namespace
+
+const char* signalName(Signal signal) {
+  return signal < SignalCount ? kSignalNames[signal] : "";
+}
+
+bool signalFromName(const QString& name, Signal* signal) {
+  for (int index = 0; index < SignalCount; ++index) {
+    if (name == QLatin1String(kSignalNames[index])) {
+      *signal = static_cast<Signal>(index);
+      return true;
+    }
+  }
+  return false;
+}
+
+QByteArray encodeColumns(const QVector<Sample> columns[SignalCount], qint64 firstMs) {
+  QByteArray payload;
+  QByteArray column;
+  for (int signal = 0; signal < SignalCount; ++signal) {
+    if (columns[signal].isEmpty()) {
+      continue;
+    }
+
+    column.clear();
+    qint64 previousMs = firstMs;
+    qint64 previousValue = 0;
+    for (const Sample& sample : columns[signal]) {
+      appendSigned(&column, sample.timeMs - previousMs);
+      appendSigned(&column, sample.value - previousValue);
+      previousMs = sample.timeMs;
+      previousValue = sample.value;
+    }
+
+    payload.append(static_cast<char>(signal));
+    appendVarint(&payload, static_cast<quint64>(columns[signal].size()));
+    appendVarint(&payload, static_cast<quint64>(column.size()));
+    payload.append(column);
+  }
+  return payload;
+}
+
+bool decodeColumns(const QByteArray& payload, qint64 firstMs, quint16 wanted,
+                   QVector<Sample> columns[SignalCount]) {
+  int position = 0;
+  while (position < payload.size()) {
+    const quint8 signal = static_cast<quint8>(payload.at(position++));
+    quint64 count = 0;
+    quint64 size = 0;
+    if (signal >= SignalCount || !readVarint(payload, &position, &count) ||
+        !readVarint(payload, &position, &size) ||
+        size > static_cast<quint64>(payload.size() - position)) {
+      return false;
+    }
+
+    const int end = position + static_cast<int>(size);
+    if ((wanted & (1u << signal)) == 0) {
+      position = end;
+      continue;
+    }
+
+    QVector<Sample>& column = columns[signal];
+    column.reserve(column.size() + static_cast<int>(qMin<quint64>(count, size)));
+    Sample sample = {firstMs, 0};
+    for (quint64 i = 0; i < count; ++i) {
+      qint64 timeDelta = 0;
+      qint64 valueDelta = 0;
+      if (!readSigned(payload, &position, &timeDelta) ||
+          !readSigned(payload, &position, &valueDelta) || position > end) {
+        return false;
+      }
+      sample.timeMs += timeDelta;
+      sample.value += valueDelta;
+      column.append(sample);
+    }
+    if (position != end) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Reader::Reader() : m_startEpochMs(0) {}
+
+bool Reader::open(const QString& path) {
+  m_file.close();
+  m_chunks.clear();
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::ReadOnly)) {
+    m_error = m_file.errorString();
+    return false;
+  }
+
+  FileHeader header;
+  if (m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+      header.magic != kFileMagic || header.version != kVersion) {
+    m_error = QStringLiteral("Not a trip log");
+    m_file.close();
+    return false;
+  }
+  m_startEpochMs = header.startEpochMs;
+
+  // Only the headers are read; a truncated last chunk ends the index
+  ChunkInfo chunk;
+  const qint64 size = m_file.size();
+  while (m_file.read(reinterpret_cast<char*>(&chunk.header), sizeof(chunk.header)) ==
+             sizeof(chunk.header) &&
+         chunk.header.magic == kChunkMagic) {
+    chunk.offset = m_file.pos();
+    if (chunk.offset + chunk.header.payloadSize > size) {
+      break;
+    }
+    m_chunks.append(chunk);
+    m_file.seek(chunk.offset + chunk.header.payloadSize);
+  }
+  return true;
+}
+
+QString Reader::errorString() const {
+  return m_error;
+}
+
+qint64 Reader::startEpochMs() const {
+  return m_startEpochMs;
+}
+
+const QVector<Reader::ChunkInfo>& Reader::chunks() const {
+  return m_chunks;
+}
+
+qint64 Reader::endMs() const {
+  return m_chunks.isEmpty() ? 0 : m_chunks.last().header.lastMs;
+}
+
+bool Reader::samples(quint16 wanted, qint64 fromMs, qint64 toMs,
+                     QVector<Sample> columns[SignalCount]) {
+  QVector<Sample> chunkColumns[SignalCount];
+  for (const ChunkInfo& chunk : m_chunks) {
+    if (chunk.header.lastMs < fromMs || chunk.header.firstMs > toMs ||
+        (chunk.header.signalMask & wanted) == 0) {
+      continue;
+    }
+
+    for (QVector<Sample>& column : chunkColumns) {
+      column.clear();
+    }
+    if (!readChunk(chunk, wanted, chunkColumns)) {
+      return false;
+    }
+    for (int signal = 0; signal < SignalCount; ++signal) {
+      for (const Sample& sample : chunkColumns[signal]) {
+        if (sample.timeMs >= fromMs && sample.timeMs <= toMs) {
+          columns[signal].append(sample);
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool Reader::valueAt(Signal signal, qint64 timeMs, qint64* value) {
+  // The newest chunk at or before the time that has the signal holds its value
+  const quint16 bit = 1u << signal;
+  QVector<Sample> columns[SignalCount];
+  for (int index = m_chunks.size() - 1; index >= 0; --index) {
+    const ChunkInfo& chunk = m_chunks.at(index);
+    if (chunk.header.firstMs > timeMs || (chunk.header.signalMask & bit) == 0) {
+      continue;
+    }
+
+    columns[signal].clear();
+    if (!readChunk(chunk, bit, columns)) {
+      return false;
+    }
+    for (int i = columns[signal].size() - 1; i >= 0; --i) {
+      if (columns[signal].at(i).timeMs <= timeMs) {
+        *value = columns[signal].at(i).value;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+Summary Reader::summarize(Signal signal, qint64 fromMs, qint64 toMs) {
+  Summary summary;
+  std::memset(&summary, 0, sizeof(summary));
+  toMs = qMin(toMs, endMs());
+
+  QVector<Sample> columns[SignalCount];
+  samples(1u << signal, fromMs, toMs, columns);
+  const QVector<Sample>& column = columns[signal];
+
+  RunningStatistics statistics;
+  for (const Sample& sample : column) {
+    statistics.add(static_cast<double>(sample.value));
+  }
+  summary.count = statistics.count();
+  summary.min = static_cast<qint64>(statistics.min());
+  summary.max = static_cast<qint64>(statistics.max());
+  summary.mean = statistics.mean();
+  summary.firstMs = column.isEmpty() ? 0 : column.first().timeMs;
+  summary.lastMs = column.isEmpty() ? 0 : column.last().timeMs;
+
+  // Sample-and-hold: each value counts for as long as it was shown
+  qint64 held = 0;
+  bool holding = valueAt(signal, fromMs - 1, &held);
+  qint64 since = fromMs;
+  double area = 0.0;
+  qint64 covered = 0;
+  for (const Sample& sample : column) {
+    if (holding) {
+      area += static_cast<double>(held) * static_cast<double>(sample.timeMs - since);
+      covered += sample.timeMs - since;
+    }
+    held = sample.value;
+    holding = true;
+    since = sample.timeMs;
+  }
+  if (holding && toMs > since) {
+    area += static_cast<double>(held) * static_cast<double>(toMs - since);
+    covered += toMs - since;
+  }
+  summary.timeWeighted = covered > 0 ? area / static_cast<double>(covered) : summary.mean;
+  return summary;
+}
+
+bool Reader::readChunk(const ChunkInfo& chunk, quint16 wanted,
+                       QVector<Sample> columns[SignalCount]) {
+  if (!m_file.seek(chunk.offset)) {
+    m_error = m_file.errorString();
+    return false;
+  }
+  const QByteArray compressed = m_file.read(chunk.header.payloadSize);
+  if (compressed.size() != static_cast<int>(chunk.header.payloadSize) ||
+      qChecksum(compressed) != chunk.header.checksum) {
+    m_error = QStringLiteral("Corrupt chunk at offset %1").arg(chunk.offset);
+    return false;
+  }
+  const QByteArray payload = qUncompress(compressed);
+  if (!decodeColumns(payload, chunk.header.firstMs, wanted, columns)) {
+    m_error = QStringLiteral("Malformed chunk at offset %1").arg(chunk.offset);
+    return false;
+  }
+  return true;
+}
+
+} // namespace TripLog
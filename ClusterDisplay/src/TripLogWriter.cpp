@@ -0,0 +1,233 @@
+#include "TripLogWriter.hpp"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+// Time between two drains of the ring; the ring holds many times the samples arriving meanwhile
+constexpr int kDrainIntervalMs = 250;
+
+} // namespace
+
+TripLogWriter::TripLogWriter(ClusterModel* model, QObject* parent)
+    : QObject(parent),
+      m_model(model),
+      m_queueHead(0),
+      m_queueTail(0),
+      m_recorded(0),
+      m_dropped(0),
+      m_chunks(0),
+      m_columnSamples(0),
+      m_chunkFirstMs(0),
+      m_chunkLastMs(0),
+      m_running(false) {
+  connectModel();
+}
+
+TripLogWriter::~TripLogWriter() {
+  close();
+}
+
+bool TripLogWriter::open(const QString& path) {
+  close();
+
+  QFileInfo info(path);
+  if (!info.absoluteDir().mkpath(QStringLiteral("."))) {
+    return false;
+  }
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    return false;
+  }
+
+  m_clock.start();
+  TripLog::FileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic = TripLog::kFileMagic;
+  header.version = TripLog::kVersion;
+  header.startEpochMs = QDateTime::currentMSecsSinceEpoch();
+  if (m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header)) {
+    m_file.close();
+    return false;
+  }
+
+  m_queueHead.store(0, std::memory_order_relaxed);
+  m_queueTail.store(0, std::memory_order_relaxed);
+  m_recorded.store(0, std::memory_order_relaxed);
+  m_dropped.store(0, std::memory_order_relaxed);
+  m_chunks.store(0, std::memory_order_relaxed);
+  m_columnSamples = 0;
+  m_running = true;
+  m_thread = std::thread(&TripLogWriter::run, this);
+
+  // Each log starts with every value, so it can be read without the ones before it
+  recordAll();
+  return true;
+}
+
+void TripLogWriter::close() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running) {
+      return;
+    }
+    m_running = false;
+  }
+  m_wakeUp.notify_all();
+  m_thread.join();
+  m_file.close();
+}
+
+bool TripLogWriter::isOpen() const {
+  return m_thread.joinable();
+}
+
+bool TripLogWriter::record(TripLog::Signal signal, qint64 value) {
+  if (!m_thread.joinable()) {
+    return false;
+  }
+
+  const quint64 tail = m_queueTail.load(std::memory_order_relaxed);
+  if (tail - m_queueHead.load(std::memory_order_acquire) >= kQueueCapacity) {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  m_queue[tail % kQueueCapacity] = {m_clock.elapsed(), value, signal};
+  m_queueTail.store(tail + 1, std::memory_order_release);
+  m_recorded.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+qint64 TripLogWriter::recordedCount() const {
+  return m_recorded.load(std::memory_order_relaxed);
+}
+
+qint64 TripLogWriter::droppedCount() const {
+  return m_dropped.load(std::memory_order_relaxed);
+}
+
+int TripLogWriter::chunkCount() const {
+  return m_chunks.load(std::memory_order_relaxed);
+}
+
+QString TripLogWriter::defaultFileName() {
+  return QStringLiteral("trip-%1.ctl")
+      .arg(QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-HHmmss")));
+}
+
+void TripLogWriter::connectModel() {
+  connect(m_model, &ClusterModel::speedChanged, this,
+          [this](int value) { record(TripLog::Speed, value); });
+  connect(m_model, &ClusterModel::batteryChanged, this,
+          [this](int value) { record(TripLog::Battery, value); });
+  connect(m_model, &ClusterModel::chargingChanged, this,
+          [this](bool value) { record(TripLog::Charging, value); });
+  connect(m_model, &ClusterModel::odometerChanged, this,
+          [this](int value) { record(TripLog::Odometer, value); });
+  connect(m_model, &ClusterModel::drivingModeTypeChanged, this,
+          [this](ClusterModel::DrivingMode value) { record(TripLog::DrivingMode, value); });
+  connect(m_model, &ClusterModel::objectAlertChanged, this,
+          [this](bool value) { record(TripLog::ObjectAlert, value); });
+  connect(m_model, &ClusterModel::emergencyBrakeActiveChanged, this,
+          [this](bool value) { record(TripLog::EmergencyBrake, value); });
+  connect(m_model, &ClusterModel::laneSideChanged, this,
+          [this](ClusterModel::LaneSide value) { record(TripLog::LaneSide, value); });
+  connect(m_model, &ClusterModel::speedLimitSignalChanged, this,
+          [this](int value) { record(TripLog::SpeedLimit, value); });
+  connect(m_model, &ClusterModel::signKindChanged, this,
+          [this](ClusterModel::SignKind value) { record(TripLog::SignKind, value); });
+  connect(m_model, &ClusterModel::alertSeverityChanged, this,
+          [this](ClusterModel::AlertSeverity value) { record(TripLog::AlertSeverity, value); });
+  connect(m_model, &ClusterModel::linkStatusChanged, this,
+          [this](ClusterModel::LinkStatus value) { record(TripLog::LinkStatus, value); });
+  connect(m_model, &ClusterModel::estimatedRangeChanged, this,
+          [this](int value) { record(TripLog::EstimatedRange, value); });
+}
+
+void TripLogWriter::recordAll() {
+  record(TripLog::Speed, m_model->speed());
+  record(TripLog::Battery, m_model->battery());
+  record(TripLog::Charging, m_model->charging());
+  record(TripLog::Odometer, m_model->odometer());
+  record(TripLog::DrivingMode, m_model->drivingModeType());
+  record(TripLog::ObjectAlert, m_model->objectAlert());
+  record(TripLog::EmergencyBrake, m_model->emergencyBrakeActive());
+  record(TripLog::LaneSide, m_model->laneSide());
+  record(TripLog::SpeedLimit, m_model->speedLimitSignal());
+  record(TripLog::SignKind, m_model->signKind());
+  record(TripLog::AlertSeverity, m_model->alertSeverity());
+  record(TripLog::LinkStatus, m_model->linkStatus());
+  record(TripLog::EstimatedRange, m_model->estimatedRange());
+}
+
+void TripLogWriter::run() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (m_running) {
+    m_wakeUp.wait_for(lock, std::chrono::milliseconds(kDrainIntervalMs));
+    lock.unlock();
+    drain();
+    lock.lock();
+  }
+  lock.unlock();
+
+  // Everything recorded before close() is written
+  drain();
+  writeChunk();
+}
+
+void TripLogWriter::drain() {
+  const quint64 tail = m_queueTail.load(std::memory_order_acquire);
+  quint64 head = m_queueHead.load(std::memory_order_relaxed);
+  for (; head != tail; ++head) {
+    const QueuedSample& queued = m_queue[head % kQueueCapacity];
+    if (m_columnSamples > 0 && (queued.timeMs - m_chunkFirstMs >= kChunkMs ||
+                                m_columnSamples >= kChunkSamples)) {
+      writeChunk();
+    }
+    if (m_columnSamples == 0) {
+      m_chunkFirstMs = queued.timeMs;
+    }
+    m_columns[queued.signal].append({queued.timeMs, queued.value});
+    m_chunkLastMs = queued.timeMs;
+    ++m_columnSamples;
+  }
+  m_queueHead.store(head, std::memory_order_release);
+}
+
+void TripLogWriter::writeChunk() {
+  if (m_columnSamples == 0) {
+    return;
+  }
+
+  TripLog::ChunkHeader header;
+  std::memset(&header, 0, sizeof(header));
+  for (int signal = 0; signal < TripLog::SignalCount; ++signal) {
+    if (!m_columns[signal].isEmpty()) {
+      header.signalMask |= 1u << signal;
+    }
+  }
+  const QByteArray payload = qCompress(TripLog::encodeColumns(m_columns, m_chunkFirstMs), 6);
+  header.magic = TripLog::kChunkMagic;
+  header.payloadSize = static_cast<quint32>(payload.size());
+  header.sampleCount = static_cast<quint32>(m_columnSamples);
+  header.checksum = qChecksum(payload);
+  header.firstMs = m_chunkFirstMs;
+  header.lastMs = m_chunkLastMs;
+
+  // One write per chunk: a crash leaves at most a truncated last chunk, which readers ignore
+  QByteArray chunk(reinterpret_cast<const char*>(&header), sizeof(header));
+  chunk.append(payload);
+  if (m_file.write(chunk) == chunk.size()) {
+    m_file.flush();
+    m_chunks.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  for (QVector<TripLog::Sample>& column : m_columns) {
+    column.clear();
+  }
+  m_columnSamples = 0;
+}
@@ -0,0 +1,159 @@
+#include "VirtualClock.hpp"
+
+#include <cmath>
+#include <utility>
+
+namespace {
+
+/// Real time between two steps while following the system clock
+constexpr int kPaceIntervalMs = 10;
+
+} // namespace
+
+/**
+ * @brief ClockTimer of a VirtualClock: a deadline in virtual time
+ */
+class VirtualClockTimer : public ClockTimer {
+ public:
+  VirtualClockTimer(VirtualClock* clock, QObject* parent)
+      : ClockTimer(parent), m_clock(clock), m_active(false), m_deadlineMs(0), m_order(0) {
+    m_clock->m_timers.append(this);
+  }
+
+  ~VirtualClockTimer() override {
+    if (m_clock) {
+      m_clock->m_timers.removeOne(this);
+    }
+  }
+
+  void stop() override {
+    m_active = false;
+  }
+
+  bool isActive() const override {
+    return m_active;
+  }
+
+  VirtualClock* m_clock; ///< Clock the timer runs on (null once it is destroyed)
+  bool m_active;         ///< Running
+  qint64 m_deadlineMs;   ///< Time of the next timeout
+  quint64 m_order;       ///< Start order, breaks ties between equal deadlines
+
+ protected:
+  void arm() override {
+    if (!m_clock) {
+      return;
+    }
+    m_active = true;
+    m_deadlineMs = m_clock->m_nowMs + qMax(interval(), 0);
+    m_order = m_clock->m_nextOrder++;
+  }
+};
+
+VirtualClock::VirtualClock(const QDateTime& start)
+    : m_start(start),
+      m_nowMs(0),
+      m_nextOrder(0),
+      m_firedCount(0),
+      m_rate(0),
+      m_paceRemainderMs(0) {
+  m_paceTimer.setTimerType(Qt::PreciseTimer);
+  m_paceTimer.setInterval(kPaceIntervalMs);
+  QObject::connect(&m_paceTimer, &QTimer::timeout, [this]() { followSystemClock(); });
+}
+
+VirtualClock::~VirtualClock() {
+  for (VirtualClockTimer* timer : std::as_const(m_timers)) {
+    timer->m_clock = nullptr;
+    timer->m_active = false;
+  }
+}
+
+qint64 VirtualClock::elapsedMs() const {
+  return m_nowMs;
+}
+
+QDateTime VirtualClock::currentDateTime() const {
+  return m_start.addMSecs(m_nowMs);
+}
+
+ClockTimer* VirtualClock::createTimer(QObject* parent) {
+  return new VirtualClockTimer(this, parent);
+}
+
+qint64 VirtualClock::advance(qint64 durationMs) {
+  const qint64 targetMs = m_nowMs + qMax<qint64>(durationMs, 0);
+  const qint64 firedBefore = m_firedCount;
+  for (VirtualClockTimer* timer = nextTimer(); timer && timer->m_deadlineMs <= targetMs;
+       timer = nextTimer()) {
+    fire(timer);
+  }
+  m_nowMs = targetMs;
+  return m_firedCount - firedBefore;
+}
+
+bool VirtualClock::advanceToNextTimer() {
+  const qint64 durationMs = timeToNextTimer();
+  if (durationMs < 0) {
+    return false;
+  }
+  advance(durationMs);
+  return true;
+}
+
+qint64 VirtualClock::timeToNextTimer() const {
+  const VirtualClockTimer* timer = nextTimer();
+  return timer ? timer->m_deadlineMs - m_nowMs : -1;
+}
+
+void VirtualClock::setRate(double rate) {
+  m_rate = qMax(rate, 0.0);
+  m_paceRemainderMs = 0;
+  if (m_rate > 0) {
+    m_paceClock.start();
+    m_paceTimer.start();
+  } else {
+    m_paceTimer.stop();
+  }
+}
+
+double VirtualClock::rate() const {
+  return m_rate;
+}
+
+qint64 VirtualClock::firedCount() const {
+  return m_firedCount;
+}
+
+VirtualClockTimer* VirtualClock::nextTimer() const {
+  VirtualClockTimer* next = nullptr;
+  for (VirtualClockTimer* timer : m_timers) {
+    if (timer->m_active &&
+        (!next || timer->m_deadlineMs < next->m_deadlineMs ||
+         (timer->m_deadlineMs == next->m_deadlineMs && timer->m_order < next->m_order))) {
+      next = timer;
+    }
+  }
+  return next;
+}
+
+void VirtualClock::fire(VirtualClockTimer* timer) {
+  m_nowMs = timer->m_deadlineMs;
+  if (timer->isSingleShot()) {
+    timer->m_active = false;
+  } else {
+    // A zero interval fires on every event loop pass with a QTimer; here once per millisecond,
+    // so that advancing always ends
+    timer->m_deadlineMs += qMax(timer->interval(), 1);
+    timer->m_order = m_nextOrder++;
+  }
+  ++m_firedCount;
+  emit timer->timeout();
+}
+
+void VirtualClock::followSystemClock() {
+  const double stepMs = m_paceClock.restart() * m_rate + m_paceRemainderMs;
+  const double wholeMs = std::floor(stepMs);
+  m_paceRemainderMs = stepMs - wholeMs;
+  advance(static_cast<qint64>(wholeMs));
+}
@@ -0,0 +1,32 @@
+#include "WriteThrottle.hpp"
+
+WriteThrottle::WriteThrottle(int minIntervalMs, QObject* parent)
+    : QObject(parent), m_minInterval(qMax(minIntervalMs, 0)) {
+  m_timer.setSingleShot(true);
+  connect(&m_timer, &QTimer::timeout, this, &WriteThrottle::due);
+}
+
+void WriteThrottle::request() {
+  if (m_timer.isActive()) {
+    return;
+  }
+
+  qint64 delay = 0;
+  if (m_sinceWrite.isValid()) {
+    delay = qMax<qint64>(m_minInterval - m_sinceWrite.elapsed(), 0);
+  }
+  m_timer.start(static_cast<int>(delay));
+}
+
+void WriteThrottle::cancel() {
+  m_timer.stop();
+}
+
+void WriteThrottle::markWritten() {
+  m_sinceWrite.restart();
+}
+
+void WriteThrottle::reset() {
+  m_timer.stop();
+  m_sinceWrite.invalidate();
+}
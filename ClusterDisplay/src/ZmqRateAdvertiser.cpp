@@ -0,0 +1,82 @@
+#include "ZmqRateAdvertiser.hpp"
+
+#include <QStringList>
+
+#include "ClusterProtocol.hpp"
+
+ZmqRateAdvertiser::ZmqRateAdvertiser(const QString& address, int intervalMs, QObject* parent)
+    : QObject(parent), _context(1), _socket(_context, zmq::socket_type::push), _advertisements(0) {
+  // LCOV_EXCL_START - Network initialization difficult to test in unit tests
+  // Only the newest advertisement matters; older ones are replaced while the publisher is away
+  _socket.set(zmq::sockopt::conflate, 1);
+
+  // Set zero linger period for clean exits
+  _socket.set(zmq::sockopt::linger, 0);
+
+  _socket.connect(address.toStdString());
+  // LCOV_EXCL_STOP
+
+  _timer.setInterval(qMax(intervalMs, 1));
+  connect(&_timer, &QTimer::timeout, this, &ZmqRateAdvertiser::advertise);
+}
+
+ZmqRateAdvertiser::~ZmqRateAdvertiser() {}
+
+void ZmqRateAdvertiser::setMaxRate(const QString& key, qreal hz) {
+  if (hz < 0) {
+    _rates.remove(key);
+  } else {
+    _rates.insert(key, hz);
+  }
+}
+
+bool ZmqRateAdvertiser::setMaxRates(const QString& spec) {
+  QMap<QString, qreal> rates;
+  for (const QString& entry : spec.split(',', Qt::SkipEmptyParts)) {
+    const QStringList parts = entry.split('=');
+    bool ok = parts.size() == 2;
+    const qreal hz = ok ? parts.at(1).toDouble(&ok) : 0;
+    const QString key = parts.at(0).trimmed();
+    if (!ok || key.isEmpty() || key.contains(QLatin1Char(ClusterProtocol::kKeyValueSeparator)) ||
+        key.contains(QLatin1Char(ClusterProtocol::kPairSeparator))) {
+      return false;
+    }
+    rates.insert(key, hz);
+  }
+
+  for (auto it = rates.cbegin(); it != rates.cend(); ++it) {
+    setMaxRate(it.key(), it.value());
+  }
+  return true;
+}
+
+QMap<QString, qreal> ZmqRateAdvertiser::maxRates() const {
+  return _rates;
+}
+
+QString ZmqRateAdvertiser::encodedRates() const {
+  QStringList pairs;
+  for (auto it = _rates.cbegin(); it != _rates.cend(); ++it) {
+    pairs << it.key() + QLatin1Char(ClusterProtocol::kKeyValueSeparator) +
+                 QString::number(it.value(), 'g', 6);
+  }
+  return pairs.join(QLatin1Char(ClusterProtocol::kPairSeparator));
+}
+
+void ZmqRateAdvertiser::start() {
+  advertise();
+  _timer.start();
+}
+
+int ZmqRateAdvertiser::advertisementCount() const {
+  return _advertisements;
+}
+
+void ZmqRateAdvertiser::advertise() {
+  // An empty advertisement tells the publisher to lift the limits right away
+  const QByteArray payload = encodedRates().toUtf8();
+  if (_socket.send(zmq::buffer(payload.constData(), payload.size()),
+                   zmq::send_flags::dontwait)) {
+    ++_advertisements;
+  }
+}
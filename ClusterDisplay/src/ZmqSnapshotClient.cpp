@@ -0,0 +1,86 @@
+#include "ZmqSnapshotClient.hpp"
+
+#include <QDebug>
+
+ZmqSnapshotClient::ZmqSnapshotClient(const QString& address, int timeoutMs, int attempts,
+                                     QObject* parent)
+    : QObject(parent),
+      _context(1),
+      _socket(_context, zmq::socket_type::req),
+      _attempts(qMax(attempts, 1)),
+      _attemptsLeft(0),
+      _pending(false) {
+  // LCOV_EXCL_START - Network initialization difficult to test in unit tests
+  // Allow resending without a reply and drop replies to earlier attempts
+  _socket.set(zmq::sockopt::req_relaxed, 1);
+  _socket.set(zmq::sockopt::req_correlate, 1);
+
+  // Set zero linger period for clean exits
+  _socket.set(zmq::sockopt::linger, 0);
+
+  _socket.connect(address.toStdString());
+
+  // Set up socket notifier for Qt event integration
+  int socketFd = _socket.get(zmq::sockopt::fd);
+  _notifier = std::make_unique<QSocketNotifier>(socketFd, QSocketNotifier::Read);
+  connect(_notifier.get(), &QSocketNotifier::activated, this, &ZmqSnapshotClient::onReadable);
+  // LCOV_EXCL_STOP
+
+  _timeoutTimer.setSingleShot(true);
+  _timeoutTimer.setInterval(qMax(timeoutMs, 1));
+  connect(&_timeoutTimer, &QTimer::timeout, this, &ZmqSnapshotClient::onTimeout);
+}
+
+ZmqSnapshotClient::~ZmqSnapshotClient() {}
+
+void ZmqSnapshotClient::request() {
+  _attemptsLeft = _attempts;
+  _pending = true;
+  send();
+}
+
+bool ZmqSnapshotClient::isPending() const {
+  return _pending;
+}
+
+void ZmqSnapshotClient::send() {
+  --_attemptsLeft;
+  _socket.send(zmq::buffer(kRequest, qstrlen(kRequest)), zmq::send_flags::dontwait);
+  _timeoutTimer.start();
+
+  // The socket descriptor is edge-triggered: sending may have consumed the readable event
+  onReadable();
+}
+
+void ZmqSnapshotClient::onReadable() {
+  // LCOV_EXCL_START - Requires a publisher answering on the snapshot socket
+  while (_socket.get(zmq::sockopt::events) & ZMQ_POLLIN) {
+    zmq::message_t reply;
+    if (!_socket.recv(reply, zmq::recv_flags::dontwait)) {
+      break;
+    }
+    if (!_pending) {
+      continue;
+    }
+
+    _pending = false;
+    _timeoutTimer.stop();
+    emit snapshotReceived(QString::fromUtf8(reply.data<char>(), reply.size()));
+  }
+  // LCOV_EXCL_STOP
+}
+
+void ZmqSnapshotClient::onTimeout() {
+  if (!_pending) {
+    return;
+  }
+
+  if (_attemptsLeft > 0) {
+    qDebug() << "ZmqSnapshotClient: no snapshot reply, retrying";
+    send();
+    return;
+  }
+
+  _pending = false;
+  emit failed();
+}
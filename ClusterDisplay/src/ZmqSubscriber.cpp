@@ -1,29 +1,87 @@
 #include "ZmqSubscriber.hpp"
 
 #include <QDebug>
+#include <QLoggingCategory>
 #include <QThread>
+#include <cstring>
+#include <iterator>
+#include <string>
+
+#ifdef Q_OS_UNIX
+#include <sched.h>
+#endif
+
+#include "FlightRecorder.hpp"
+
+namespace {
+
+/// Messages delivered per pass; bounds the time the GUI thread spends before it returns to the
+/// event loop
+constexpr size_t kMaxBatchSize = 256;
+
+/// Every received frame; off by default (QT_LOGGING_RULES="cluster.zmq.frames.debug=true")
+Q_LOGGING_CATEGORY(lcFrames, "cluster.zmq.frames", QtInfoMsg)
+
+} // namespace
 
 ZmqSubscriber::ZmqSubscriber(const QString& address, QObject* parent)
-    : QObject(parent), _context(1), _socket(_context, zmq::socket_type::sub) {
+    : ZmqSubscriber(address, ZmqSocketOptions(), parent) {}
+
+ZmqSubscriber::ZmqSubscriber(const QString& address, const ZmqSocketOptions& options,
+                             QObject* parent)
+    : QObject(parent),
+      _context(1),
+      _socket(configureContext(_context, options), zmq::socket_type::sub),
+      _monitor(_context, zmq::socket_type::pair),
+      _connected(false),
+      _connectCount(0) {
   // LCOV_EXCL_START - Network initialization difficult to test in unit tests
   // Configure socket options for optimal performance
 
   // Set high water mark to allow more messages to be queued
-  _socket.set(zmq::sockopt::rcvhwm, 100);
+  _socket.set(zmq::sockopt::rcvhwm, options.receiveHighWaterMark);
 
   // Disable conflate option to receive all messages (not just the latest)
-  _socket.set(zmq::sockopt::conflate, 0);
+  _socket.set(zmq::sockopt::conflate, options.conflate ? 1 : 0);
 
   // Set zero linger period for clean exits
   _socket.set(zmq::sockopt::linger, 0);
 
+  // Set kernel receive buffer size if requested
+  if (options.receiveBufferBytes > 0) {
+    _socket.set(zmq::sockopt::rcvbuf, options.receiveBufferBytes);
+  }
+
   // Set immediate option to receive messages as soon as they arrive
   try {
-    _socket.set(zmq::sockopt::immediate, 1);
+    _socket.set(zmq::sockopt::immediate, options.immediate ? 1 : 0);
   } catch (const zmq::error_t& e) {
     qDebug() << "ZmqSubscriber: immediate option not supported, continuing without it";
   }
 
+  // Retry quickly after a lost connection, backing off while the publisher stays away
+  _socket.set(zmq::sockopt::reconnect_ivl, options.reconnectIntervalMs);
+  _socket.set(zmq::sockopt::reconnect_ivl_max, options.reconnectIntervalMaxMs);
+
+#ifdef ZMQ_HEARTBEAT_IVL
+  // Detect a publisher that disappeared without closing the connection
+  if (options.heartbeatIntervalMs > 0) {
+    _socket.set(zmq::sockopt::heartbeat_ivl, options.heartbeatIntervalMs);
+    _socket.set(zmq::sockopt::heartbeat_timeout, options.heartbeatTimeoutMs);
+  }
+#endif
+
+  // Watch the connection; the monitor must be attached before connecting to see the first event
+  const std::string monitorAddress =
+      "inproc://zmq-subscriber-monitor-" + std::to_string(reinterpret_cast<quintptr>(this));
+  zmq_socket_monitor(_socket.handle(), monitorAddress.c_str(),
+                     ZMQ_EVENT_CONNECTED | ZMQ_EVENT_DISCONNECTED);
+  _monitor.connect(monitorAddress);
+  _monitorNotifier = std::make_unique<QSocketNotifier>(_monitor.get(zmq::sockopt::fd),
+                                                       QSocketNotifier::Read);
+  connect(_monitorNotifier.get(), &QSocketNotifier::activated, this,
+          &ZmqSubscriber::onMonitorEvent);
+
   // Connect to the specified address
   _socket.connect(address.toStdString());
 
@@ -35,6 +93,8 @@ ZmqSubscriber::ZmqSubscriber(const QString& address, QObject* parent)
   _notifier = std::make_unique<QSocketNotifier>(socketFd, QSocketNotifier::Read);
   connect(_notifier.get(), &QSocketNotifier::activated, this, &ZmqSubscriber::onMessageReceived);
   // LCOV_EXCL_STOP
+
+  _batch.reserve(kMaxBatchSize);
 }
 
 ZmqSubscriber::~ZmqSubscriber() {
@@ -43,22 +103,135 @@ ZmqSubscriber::~ZmqSubscriber() {
   // LCOV_EXCL_STOP
 }
 
+// LCOV_EXCL_START - Thread scheduling depends on the privileges of the test environment
+zmq::context_t& ZmqSubscriber::configureContext(zmq::context_t& context,
+                                                const ZmqSocketOptions& options) {
+  // libzmq applies these when it starts the I/O thread and aborts if they fail, so the
+  // caller must only pass CPUs and priorities that are known to be usable
+#ifdef ZMQ_THREAD_AFFINITY_CPU_ADD
+  for (int cpu : options.ioThreadCpus) {
+    zmq_ctx_set(context.handle(), ZMQ_THREAD_AFFINITY_CPU_ADD, cpu);
+  }
+#endif
+#if defined(ZMQ_THREAD_SCHED_POLICY) && defined(SCHED_FIFO)
+  if (options.ioThreadPriority > 0) {
+    zmq_ctx_set(context.handle(), ZMQ_THREAD_SCHED_POLICY, SCHED_FIFO);
+    zmq_ctx_set(context.handle(), ZMQ_THREAD_PRIORITY, options.ioThreadPriority);
+  }
+#endif
+  return context;
+}
+// LCOV_EXCL_STOP
+
+bool ZmqSubscriber::isConnected() const {
+  return _connected;
+}
+
+int ZmqSubscriber::connectCount() const {
+  return _connectCount;
+}
+
+void ZmqSubscriber::setPriorityKeys(const QList<QByteArray>& keys) {
+  _priorityKeys = keys;
+}
+
+bool ZmqSubscriber::containsKey(const char* data, size_t size, const QList<QByteArray>& keys) {
+  for (const QByteArray& key : keys) {
+    const size_t keySize = static_cast<size_t>(key.size());
+
+    // A key starts the frame or follows a ';' and is terminated by ':'
+    size_t start = 0;
+    while (start + keySize < size) {
+      if (data[start + keySize] == ':' &&
+          std::memcmp(data + start, key.constData(), keySize) == 0) {
+        return true;
+      }
+      const void* separator = std::memchr(data + start, ';', size - start);
+      if (!separator) {
+        break;
+      }
+      start = static_cast<const char*>(separator) - data + 1;
+    }
+  }
+  return false;
+}
+
 void ZmqSubscriber::onMessageReceived() {
-  // Process all available messages in the queue
-  while (true) {
+  _batch.clear();
+  while (_batch.size() < kMaxBatchSize) {
     zmq::message_t message;
     zmq::recv_result_t result = _socket.recv(message, zmq::recv_flags::dontwait);
 
-    // Break if no more messages
+    // Stop if no more messages
     if (!result)
       break;
 
-    // Convert message to QString and emit signal
-    // LCOV_EXCL_START - ZMQ message processing difficult to test without real network messages
-    QString msgContent = QString::fromStdString(message.to_string());
-    qDebug() << "ZMQ received:" << msgContent;
+    _batch.push_back(std::move(message));
+  }
+
+  if (_batch.empty())
+    return;
+
+  FlightRecorder::trace(FlightRecorder::BatchDrained, static_cast<qint32>(_batch.size()));
+
+  // LCOV_EXCL_START - ZMQ message processing difficult to test without real network messages
+  // Let the newest safety frame overtake the backlog in front of it
+  if (!_priorityKeys.isEmpty()) {
+    for (auto it = _batch.rbegin(); it != _batch.rend(); ++it) {
+      if (containsKey(it->data<char>(), it->size(), _priorityKeys)) {
+        FlightRecorder::trace(FlightRecorder::PriorityFrame, static_cast<qint32>(it->size()),
+                              FlightRecorder::prefix(it->data<char>(), it->size()));
+        emit priorityMessageReceived(QString::fromUtf8(it->data<char>(), it->size()),
+                                     static_cast<int>(std::distance(it, _batch.rend()) - 1));
+        break;
+      }
+    }
+  }
+
+  // Convert messages to QString and emit them in arrival order
+  for (const zmq::message_t& message : _batch) {
+    FlightRecorder::trace(FlightRecorder::FrameReceived, static_cast<qint32>(message.size()),
+                          FlightRecorder::prefix(message.data<char>(), message.size()));
+    QString msgContent = QString::fromUtf8(message.data<char>(), message.size());
+    qCDebug(lcFrames) << "ZMQ received:" << msgContent;
 
     emit messageReceived(msgContent);
-    // LCOV_EXCL_STOP
+  }
+
+  // The descriptor is edge-triggered and does not fire again for messages left behind by a full
+  // batch; continue from the event loop so input and rendering get their turn in between
+  if (_batch.size() == kMaxBatchSize) {
+    QMetaObject::invokeMethod(this, &ZmqSubscriber::onMessageReceived, Qt::QueuedConnection);
+  }
+  // LCOV_EXCL_STOP
+}
+
+// LCOV_EXCL_START - Connection events require a publisher going up and down
+void ZmqSubscriber::onMonitorEvent() {
+  // Edge-triggered like the data socket: read every queued event
+  while (_monitor.get(zmq::sockopt::events) & ZMQ_POLLIN) {
+    // Each event is a 6-byte (event id, value) frame followed by the endpoint
+    zmq::message_t event;
+    zmq::message_t endpoint;
+    if (!_monitor.recv(event, zmq::recv_flags::dontwait) ||
+        !_monitor.recv(endpoint, zmq::recv_flags::dontwait) || event.size() < sizeof(quint16)) {
+      break;
+    }
+
+    quint16 id = 0;
+    std::memcpy(&id, event.data(), sizeof(id));
+    const bool connected = id == ZMQ_EVENT_CONNECTED;
+    if (connected == _connected) {
+      continue;
+    }
+
+    _connected = connected;
+    if (connected) {
+      ++_connectCount;
+    }
+    qDebug() << "ZmqSubscriber:" << (connected ? "connected to" : "disconnected from")
+             << QString::fromUtf8(endpoint.data<char>(), endpoint.size());
+    emit connectionChanged(connected);
   }
 }
+// LCOV_EXCL_STOP
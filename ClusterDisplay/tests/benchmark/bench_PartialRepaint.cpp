@@ -0,0 +1,148 @@
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QGuiApplication>
+#include <QQmlApplicationEngine>
+#include <QQuickWindow>
+#include <QTimer>
+#include <QVector>
+#include <QtQml/QQmlExtensionPlugin>
+#include <algorithm>
+#include <cstdio>
+
+#include "ClusterModel.hpp"
+#include "DisplaySettings.hpp"
+
+// The ClusterDisplay QML module is linked statically
+Q_IMPORT_QML_PLUGIN(ClusterDisplayPlugin)
+
+namespace {
+
+/**
+ * @brief Frame cost statistics of one benchmark run
+ */
+struct RunResult {
+  QVector<double> frameMs; ///< Render + flush time of every measured frame
+  int droppedUpdates;      ///< Updates that did not produce a frame in time
+};
+
+/**
+ * @brief Wait until the window has presented a frame
+ * @return False if no frame was presented within the timeout
+ */
+bool waitForFrame(QQuickWindow* window, int timeoutMs) {
+  QEventLoop loop;
+  QTimer timeout;
+  timeout.setSingleShot(true);
+  QObject::connect(&timeout, &QTimer::timeout, &loop, [&loop]() { loop.exit(1); });
+  QObject::connect(window, &QQuickWindow::frameSwapped, &loop, [&loop]() { loop.exit(0); });
+  timeout.start(timeoutMs);
+  return loop.exec() == 0;
+}
+
+/**
+ * @brief Load main.qml and measure the cost of frames caused by small battery updates
+ * @param model Model driven by the benchmark
+ * @param updates Number of battery updates to apply
+ */
+RunResult run(ClusterModel& model, int updates) {
+  RunResult result{{}, 0};
+
+  QQmlApplicationEngine engine;
+  engine.load(QUrl(QStringLiteral("qrc:/ClusterDisplay/main.qml")));
+  if (engine.rootObjects().isEmpty()) {
+    return result;
+  }
+
+  auto* window = qobject_cast<QQuickWindow*>(engine.rootObjects().first());
+  window->setVisibility(QWindow::Windowed);
+  window->resize(1280, 400);
+  window->setProperty("firstFrameShown", true);
+
+  // Let the deferred components load and settle before measuring
+  waitForFrame(window, 2000);
+  QElapsedTimer settle;
+  settle.start();
+  while (settle.elapsed() < 1000) {
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+  }
+
+  // The software render loop renders and flushes on the GUI thread: time from the start of
+  // rendering until the frame has been flushed to the window
+  QElapsedTimer frameClock;
+  QObject::connect(
+      window, &QQuickWindow::beforeRendering, window, [&frameClock]() { frameClock.start(); },
+      Qt::DirectConnection);
+
+  for (int i = 0; i < updates; ++i) {
+    model.setBattery(i % 2 == 0 ? 57 : 58);
+    if (waitForFrame(window, 200) && frameClock.isValid()) {
+      result.frameMs.append(frameClock.nsecsElapsed() / 1e6);
+    } else {
+      ++result.droppedUpdates;
+    }
+  }
+
+  window->close();
+  return result;
+}
+
+void printResult(const char* label, RunResult result) {
+  if (result.frameMs.isEmpty()) {
+    std::printf("%-16s no frames measured\n", label);
+    return;
+  }
+
+  std::sort(result.frameMs.begin(), result.frameMs.end());
+  double total = 0.0;
+  for (double ms : result.frameMs) {
+    total += ms;
+  }
+  const int count = static_cast<int>(result.frameMs.size());
+  std::printf("%-16s frames %5d  mean %7.3f ms  p50 %7.3f ms  p95 %7.3f ms  max %7.3f ms"
+              "  missed %d\n",
+              label, count, total / count, result.frameMs.at(count / 2),
+              result.frameMs.at(std::min(count - 1, count * 95 / 100)), result.frameMs.last(),
+              result.droppedUpdates);
+}
+
+} // namespace
+
+/**
+ * @brief Compare full and partial repaint cost of main.qml on the software renderer
+ *
+ * Loads the cluster interface twice with the software scene graph backend, once
+ * with DisplaySettings.partialRepaint disabled and once enabled, and toggles the
+ * battery value to produce a small change per frame.
+ *
+ * Run on the target (e.g. with QT_QPA_PLATFORM=linuxfb or eglfs); the offscreen
+ * platform also works for relative comparisons on a development machine.
+ */
+int main(int argc, char* argv[]) {
+  QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+  QGuiApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Full vs partial repaint benchmark (software renderer)");
+  parser.addHelpOption();
+  QCommandLineOption updatesOption(QStringList() << "n" << "updates",
+                                   "Number of battery updates per run", "count", "300");
+  parser.addOption(updatesOption);
+  parser.process(app);
+  const int updates = qMax(1, parser.value(updatesOption).toInt());
+
+  ClusterModel model;
+  DisplaySettings settings;
+  ClusterModel::setQmlInstance(&model);
+  DisplaySettings::setQmlInstance(&settings);
+
+  settings.setPartialRepaint(false);
+  RunResult full = run(model, updates);
+
+  settings.setPartialRepaint(true);
+  RunResult partial = run(model, updates);
+
+  printResult("full repaint", full);
+  printResult("partial repaint", partial);
+  return full.frameMs.isEmpty() || partial.frameMs.isEmpty() ? 1 : 0;
+}
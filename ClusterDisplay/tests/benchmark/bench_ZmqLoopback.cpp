@@ -0,0 +1,224 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QStringList>
+#include <QVector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <zmq.hpp>
+
+#include "ClusterDataSubscriber.hpp"
+#include "ClusterModel.hpp"
+#include "ClusterSignalHub.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+qint64 nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * @brief One point of the parameter sweep
+ */
+struct RunConfig {
+  int messageBytes;         ///< Approximate size of every frame
+  ZmqSocketOptions options; ///< Subscriber socket options
+  int messages;             ///< Frames to publish
+  int rate;                 ///< Frames per second (0 = as fast as possible)
+};
+
+/**
+ * @brief Measurements of one run
+ */
+struct RunResult {
+  int received = 0;          ///< Frames that reached ClusterModel
+  double throughput = 0.0;   ///< Sustained frames per second at the model
+  QVector<double> latencyUs; ///< Publish-to-model latency of every received frame
+};
+
+/**
+ * @brief Publish "seq:<seq>;odo:<seq>;pad:<...>" frames from a separate thread
+ *
+ * The sequence number travels through ZmqSubscriber and ClusterSignalHub, and
+ * the receive side looks up its send time once ClusterDataSubscriber has
+ * applied the frame to ClusterModel. It has a key of its own because the
+ * odometer is reconciled, not copied: after a dropped or conflated stretch
+ * ClusterModel::odometer no longer equals the newest `odo`.
+ */
+void publish(zmq::socket_t* socket, const RunConfig& config, std::atomic<qint64>* sendTimes,
+             std::atomic<bool>* done) {
+  const Clock::time_point start = Clock::now();
+  for (int seq = 1; seq <= config.messages; ++seq) {
+    if (config.rate > 0) {
+      std::this_thread::sleep_until(start + std::chrono::nanoseconds(
+                                                static_cast<qint64>(seq * 1e9 / config.rate)));
+    }
+
+    std::string frame = "seq:" + std::to_string(seq) + ";odo:" + std::to_string(seq) + ";pad:";
+    if (static_cast<int>(frame.size()) < config.messageBytes) {
+      frame.append(config.messageBytes - frame.size(), 'x');
+    }
+
+    sendTimes[seq].store(nowNs(), std::memory_order_release);
+    socket->send(zmq::buffer(frame), zmq::send_flags::none);
+  }
+  done->store(true, std::memory_order_release);
+}
+
+RunResult run(const RunConfig& config) {
+  RunResult result;
+
+  // Publisher on an ephemeral loopback port
+  zmq::context_t context(1);
+  zmq::socket_t publisher(context, zmq::socket_type::pub);
+  publisher.set(zmq::sockopt::sndhwm, 1000);
+  publisher.set(zmq::sockopt::linger, 0);
+  publisher.bind("tcp://127.0.0.1:*");
+  const QString endpoint = QString::fromStdString(publisher.get(zmq::sockopt::last_endpoint));
+
+  // The real receive chain: ZmqSubscriber -> ClusterSignalHub -> ClusterDataSubscriber -> model
+  ClusterModel model;
+  ClusterSignalHub hub;
+  hub.addSource(endpoint, config.options);
+  ClusterDataSubscriber subscriber(&model, &hub);
+
+  auto sendTimes = std::make_unique<std::atomic<qint64>[]>(config.messages + 1);
+  result.latencyUs.reserve(config.messages);
+  qint64 firstReceiveNs = 0;
+  qint64 lastReceiveNs = 0;
+
+  // Registered after the subscriber, so it runs once the frame reached the model
+  hub.subscribeFrames([&](const QMap<QString, QString>& frame) {
+    const qint64 receivedNs = nowNs();
+    const int seq = frame.value(QStringLiteral("seq")).toInt();
+    if (seq <= 0 || seq > config.messages) {
+      return;
+    }
+    const qint64 sentNs = sendTimes[seq].load(std::memory_order_acquire);
+    if (sentNs == 0) {
+      return;
+    }
+    if (result.received == 0) {
+      firstReceiveNs = receivedNs;
+    }
+    lastReceiveNs = receivedNs;
+    ++result.received;
+    result.latencyUs.append((receivedNs - sentNs) / 1e3);
+  });
+
+  // Give the subscription time to reach the publisher (PUB drops frames before that)
+  QElapsedTimer clock;
+  clock.start();
+  while (clock.elapsed() < 300) {
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+  }
+
+  std::atomic<bool> done{false};
+  std::thread sender(publish, &publisher, config, sendTimes.get(), &done);
+
+  // Run the event loop until the publisher is done and nothing arrived for a while
+  int lastCount = -1;
+  QElapsedTimer idle;
+  idle.start();
+  while (!done.load(std::memory_order_acquire) || idle.elapsed() < 500) {
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    if (result.received != lastCount) {
+      lastCount = result.received;
+      idle.restart();
+    }
+  }
+  sender.join();
+
+  const double spanSeconds = (lastReceiveNs - firstReceiveNs) / 1e9;
+  result.throughput = spanSeconds > 0.0 ? (result.received - 1) / spanSeconds : 0.0;
+  std::sort(result.latencyUs.begin(), result.latencyUs.end());
+  return result;
+}
+
+double percentile(const QVector<double>& sorted, double fraction) {
+  if (sorted.isEmpty()) {
+    return 0.0;
+  }
+  const int index = std::min(static_cast<int>(sorted.size()) - 1,
+                             static_cast<int>(fraction * sorted.size()));
+  return sorted.at(index);
+}
+
+QVector<int> parseIntList(const QString& list) {
+  QVector<int> values;
+  for (const QString& item : list.split(',', Qt::SkipEmptyParts)) {
+    values.append(item.toInt());
+  }
+  return values;
+}
+
+} // namespace
+
+/**
+ * @brief Loopback throughput and latency benchmark of the ZeroMQ receive path
+ *
+ * Publishes sequence-numbered frames on a local PUB socket and measures them
+ * after they went through the real chain ZmqSubscriber -> ClusterSignalHub ->
+ * ClusterDataSubscriber -> ClusterModel in a live event loop. Sweeps message
+ * sizes and subscriber socket options and reports sustained frames/s, latency
+ * percentiles and the share of frames dropped at the high-water mark.
+ */
+int main(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("ZeroMQ loopback throughput/latency benchmark");
+  parser.addHelpOption();
+  QCommandLineOption messagesOption(QStringList() << "n" << "messages", "Frames per run",
+                                    "count", "50000");
+  QCommandLineOption rateOption("rate", "Frames per second (0 = as fast as possible)", "hz", "0");
+  QCommandLineOption sizesOption("sizes", "Comma-separated frame sizes in bytes", "bytes",
+                                 "32,256,4096");
+  QCommandLineOption hwmOption("hwm", "Comma-separated ZMQ_RCVHWM values", "messages",
+                               "100,1000,10000");
+  QCommandLineOption conflateOption("conflate", "Comma-separated ZMQ_CONFLATE values (0/1)",
+                                    "flags", "0");
+  QCommandLineOption debugOption("debug-log", "Keep the per-message debug output enabled");
+  parser.addOptions(
+      {messagesOption, rateOption, sizesOption, hwmOption, conflateOption, debugOption});
+  parser.process(app);
+
+  // The subscriber logs every frame with qDebug; that would dominate the measurement
+  if (!parser.isSet(debugOption)) {
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+  }
+
+  const int messages = qMax(1, parser.value(messagesOption).toInt());
+  const int rate = qMax(0, parser.value(rateOption).toInt());
+
+  std::printf("%7s %7s %8s %12s %10s %10s %10s %10s %8s\n", "bytes", "rcvhwm", "conflate",
+              "msg/s", "p50 us", "p95 us", "p99 us", "max us", "dropped");
+
+  for (int conflate : parseIntList(parser.value(conflateOption))) {
+    for (int hwm : parseIntList(parser.value(hwmOption))) {
+      for (int bytes : parseIntList(parser.value(sizesOption))) {
+        RunConfig config{bytes, ZmqSocketOptions(), messages, rate};
+        config.options.receiveHighWaterMark = hwm;
+        config.options.conflate = conflate != 0;
+
+        const RunResult result = run(config);
+        const double droppedPercent = 100.0 * (messages - result.received) / messages;
+        std::printf("%7d %7d %8d %12.0f %10.1f %10.1f %10.1f %10.1f %7.2f%%\n", bytes, hwm,
+                    conflate, result.throughput, percentile(result.latencyUs, 0.50),
+                    percentile(result.latencyUs, 0.95), percentile(result.latencyUs, 0.99),
+                    result.latencyUs.isEmpty() ? 0.0 : result.latencyUs.last(), droppedPercent);
+        std::fflush(stdout);
+      }
+    }
+  }
+  return 0;
+}
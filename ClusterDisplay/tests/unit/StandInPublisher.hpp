@@ -0,0 +1,188 @@
+#ifndef STANDINPUBLISHER_HPP
+#define STANDINPUBLISHER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <zmq.hpp>
+
+/**
+ * @brief Local stand-in for the vehicle publisher, for tests over loopback
+ *
+ * Publishes frames on a critical and a non-critical PUB socket, prefixed with
+ * the sequence number of the channel ("cseq" / "nseq"), and keeps the latest
+ * value of every key. Snapshot requests are answered on a ROUTER socket from
+ * a thread of its own with the full state and both sequence numbers, as the
+ * vehicle publisher does. By default all sockets bind to ephemeral loopback
+ * ports; a publisher restarted on the endpoints of an earlier one stands in
+ * for a restarted vehicle publisher.
+ *
+ * publish() must always be called from the same thread.
+ */
+class StandInPublisher {
+ public:
+  /** @brief Data channel of a frame */
+  enum Channel { Critical, NonCritical };
+
+  StandInPublisher() : StandInPublisher(kAnyPort, kAnyPort, kAnyPort) {}
+
+  /**
+   * @brief Binds to the given endpoints
+   * @param critical Endpoint of the critical channel
+   * @param nonCritical Endpoint of the non-critical channel
+   * @param snapshot Endpoint of the snapshot socket
+   */
+  StandInPublisher(const std::string& critical, const std::string& nonCritical,
+                   const std::string& snapshot)
+      : m_critical(m_context, zmq::socket_type::pub),
+        m_nonCritical(m_context, zmq::socket_type::pub),
+        m_router(m_context, zmq::socket_type::router),
+        m_running(true),
+        m_answering(true),
+        m_replyDelayMs(0),
+        m_requests(0),
+        m_sequences{0, 0} {
+    const std::pair<zmq::socket_t*, const std::string*> bindings[] = {
+        {&m_critical, &critical}, {&m_nonCritical, &nonCritical}, {&m_router, &snapshot}};
+    for (const auto& binding : bindings) {
+      binding.first->set(zmq::sockopt::linger, 0);
+      binding.first->bind(*binding.second);
+    }
+    m_server = std::thread(&StandInPublisher::serve, this);
+  }
+
+  ~StandInPublisher() {
+    m_running = false;
+    m_server.join();
+  }
+
+  /** @brief Gets the endpoint of a data channel */
+  std::string endpoint(Channel channel) {
+    return socket(channel).get(zmq::sockopt::last_endpoint);
+  }
+
+  /** @brief Gets the endpoint of the snapshot socket */
+  std::string snapshotEndpoint() {
+    return m_router.get(zmq::sockopt::last_endpoint);
+  }
+
+  /**
+   * @brief Records the values of a frame and publishes it with the next sequence number
+   * @param channel Channel to publish on
+   * @param payload Frame in "key1:value1;key2:value2" format
+   * @return Sequence number of the frame
+   */
+  long long publish(Channel channel, const std::string& payload) {
+    std::string frame;
+    long long sequence = 0;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      sequence = ++m_sequences[channel];
+      size_t start = 0;
+      while (start < payload.size()) {
+        size_t end = payload.find(';', start);
+        end = end == std::string::npos ? payload.size() : end;
+        const size_t colon = payload.find(':', start);
+        if (colon != std::string::npos && colon < end) {
+          m_state[payload.substr(start, colon - start)] =
+              payload.substr(colon + 1, end - colon - 1);
+        }
+        start = end + 1;
+      }
+      frame = sequenceKey(channel) + ":" + std::to_string(sequence) + ";" + payload;
+    }
+    socket(channel).send(zmq::buffer(frame), zmq::send_flags::none);
+    return sequence;
+  }
+
+  /** @brief Gets the full state as it is sent in reply to a snapshot request */
+  std::string snapshot() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string frame = sequenceKey(Critical) + ":" + std::to_string(m_sequences[Critical]) +
+                        ";" + sequenceKey(NonCritical) + ":" +
+                        std::to_string(m_sequences[NonCritical]);
+    for (const auto& entry : m_state) {
+      frame += ";" + entry.first + ":" + entry.second;
+    }
+    return frame;
+  }
+
+  /** @brief Answers requests (default) or silently drops them */
+  void setAnswering(bool answering) {
+    m_answering = answering;
+  }
+
+  /** @brief Delays replies; the snapshot is still taken when the request arrives */
+  void setReplyDelayMs(int delayMs) {
+    m_replyDelayMs = delayMs;
+  }
+
+  /** @brief Gets the number of snapshot requests received so far */
+  int snapshotRequests() const {
+    return m_requests;
+  }
+
+ private:
+  /// Loopback endpoint on an ephemeral port
+  static constexpr const char* kAnyPort = "tcp://127.0.0.1:*";
+
+  static std::string sequenceKey(Channel channel) {
+    return channel == Critical ? "cseq" : "nseq";
+  }
+
+  zmq::socket_t& socket(Channel channel) {
+    return channel == Critical ? m_critical : m_nonCritical;
+  }
+
+  /// Snapshot server loop; the ROUTER socket is only used by this thread
+  void serve() {
+    while (m_running) {
+      zmq::pollitem_t item = {m_router.handle(), 0, ZMQ_POLLIN, 0};
+      zmq::poll(&item, 1, std::chrono::milliseconds(10));
+      if (!(item.revents & ZMQ_POLLIN)) {
+        continue;
+      }
+
+      // Routing envelope, empty delimiter and request body
+      std::vector<zmq::message_t> parts;
+      do {
+        parts.emplace_back();
+        if (!m_router.recv(parts.back(), zmq::recv_flags::none)) {
+          break;
+        }
+      } while (parts.back().more());
+
+      const std::string reply = snapshot();
+      ++m_requests;
+      if (!m_answering) {
+        continue;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(m_replyDelayMs.load()));
+
+      for (size_t i = 0; i + 1 < parts.size(); ++i) {
+        m_router.send(parts[i], zmq::send_flags::sndmore);
+      }
+      m_router.send(zmq::buffer(reply), zmq::send_flags::none);
+    }
+  }
+
+  zmq::context_t m_context{1};
+  zmq::socket_t m_critical;
+  zmq::socket_t m_nonCritical;
+  zmq::socket_t m_router;
+  std::thread m_server;
+  std::atomic<bool> m_running;
+  std::atomic<bool> m_answering;
+  std::atomic<int> m_replyDelayMs;
+  std::atomic<int> m_requests;
+  std::mutex m_mutex;
+  long long m_sequences[2];
+  std::map<std::string, std::string> m_state;
+};
+
+#endif // STANDINPUBLISHER_HPP
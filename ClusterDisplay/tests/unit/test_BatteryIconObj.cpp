@@ -89,6 +89,30 @@ TEST_F(BatteryIconObjTest, HandleInvalidMessage) {
   EXPECT_EQ(spy.count(), 1);
 }
 
+TEST_F(BatteryIconObjTest, UpdatesFromSignalHub) {
+  ClusterSignalHub hub;
+  BatteryIconObj hubBattery(&hub);
+  QSignalSpy spy(&hubBattery, &BatteryIconObj::percentageChanged);
+
+  // The hub delivers the "battery" value of each frame; invalid values are dropped
+  hub.dispatchMessage("speed:1000;battery:72");
+  hub.dispatchMessage("battery:invalid");
+
+  EXPECT_EQ(hubBattery.percentage(), 72);
+  EXPECT_EQ(spy.count(), 1);
+  EXPECT_EQ(hub.listenerCount("battery"), 1);
+}
+
+TEST_F(BatteryIconObjTest, UnsubscribesFromSignalHub) {
+  ClusterSignalHub hub;
+  {
+    BatteryIconObj hubBattery(&hub);
+    EXPECT_EQ(hub.listenerCount("battery"), 1);
+  }
+  EXPECT_EQ(hub.listenerCount("battery"), 0);
+  EXPECT_NO_THROW(hub.dispatchMessage("battery:40"));
+}
+
 int main(int argc, char** argv) {
   QCoreApplication app(argc, argv);
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,276 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QDeadlineTimer>
+#include <QSignalSpy>
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <linux/can.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+#include "CanSource.hpp"
+#include "ClusterDataSubscriber.hpp"
+#include "DbcDatabase.hpp"
+
+namespace {
+
+// Intel signals in a standard frame, Motorola signals in an extended frame (0x400)
+const char* const kDbc = R"(VERSION ""
+
+BU_: Vcu Bms
+
+BO_ 256 VehicleStatus: 8 Vcu
+ SG_ speed : 0|16@1+ (1,0) [0|65535] "mm/s" Bms
+ SG_ SteeringAngle : 16|16@1- (0.1,0) [-800|800] "deg" Bms
+ SG_ DriveMode M : 32|8@1+ (1,0) [0|3] "" Bms
+ SG_ TorqueRequest m1 : 40|16@1- (0.1,0) [-500|500] "Nm" Bms
+
+BO_ 2147484672 BatteryStatus: 4 Bms
+ SG_ Soc : 7|8@0+ (1,0) [0|100] "%" Vcu
+ SG_ Charging : 15|1@0+ (1,0) [0|1] "" Vcu
+ SG_ PackCurrent : 23|16@0- (0.01,0) [-300|300] "A" Vcu
+
+BO_ 3221225472 VECTOR__INDEPENDENT_SIG_MSG: 0 Vector__XXX
+ SG_ Unused : 0|8@1+ (1,0) [0|0] "" Vector__XXX
+
+CM_ SG_ 256 speed "Speed of the vehicle";
+BA_DEF_ BO_ "GenMsgCycleTime" INT 0 10000;
+)";
+
+// speed 2780 mm/s, steering -45.5 deg, drive mode 2
+const quint8 kVehicleStatus[8] = {0xdc, 0x0a, 0x39, 0xfe, 0x02, 0x00, 0x00, 0x00};
+
+// 85 % charging, -12.34 A
+const quint8 kBatteryStatus[4] = {0x55, 0x80, 0xfb, 0x2e};
+
+DbcDatabase loadDatabase() {
+  DbcDatabase database;
+  EXPECT_TRUE(database.parse(QString::fromUtf8(kDbc))) << qPrintable(database.errorString());
+  return database;
+}
+
+double decoded(const DbcMessage* message, int signal, const quint8* data, int length) {
+  quint8 payload[DbcDatabase::kMaxPayload] = {};
+  std::copy(data, data + length, payload);
+  const DbcSignal& dbcSignal = message->dbcSignals.at(signal);
+  return DbcDatabase::decode(dbcSignal, DbcDatabase::payloadWord(payload, dbcSignal.bigEndian));
+}
+
+} // namespace
+
+TEST(DbcDatabaseTest, ParsesMessagesAndSignals) {
+  const DbcDatabase database = loadDatabase();
+  ASSERT_EQ(database.messages().size(), 2);
+
+  const DbcMessage* status = database.message(0x100, false);
+  ASSERT_NE(status, nullptr);
+  EXPECT_EQ(status->name, "VehicleStatus");
+  EXPECT_EQ(status->length, 8);
+  // The multiplexed TorqueRequest is left out, the multiplexer is kept
+  ASSERT_EQ(status->dbcSignals.size(), 3);
+  EXPECT_EQ(status->dbcSignals.at(1).unit, "deg");
+  EXPECT_EQ(status->dbcSignals.at(2).name, "DriveMode");
+
+  const DbcMessage* battery = database.message(0x400, true);
+  ASSERT_NE(battery, nullptr);
+  EXPECT_EQ(battery->name, "BatteryStatus");
+  EXPECT_TRUE(battery->dbcSignals.at(0).bigEndian);
+
+  EXPECT_EQ(database.message(0x400, false), nullptr);
+  EXPECT_EQ(database.message(0x100, true), nullptr);
+  EXPECT_EQ(database.message(0x7ff, false), nullptr);
+  EXPECT_EQ(database.message(0x1fffffff, true), nullptr);
+}
+
+TEST(DbcDatabaseTest, DecodesIntelAndMotorolaSignals) {
+  const DbcDatabase database = loadDatabase();
+  const DbcMessage* status = database.message(0x100, false);
+  ASSERT_NE(status, nullptr);
+  EXPECT_DOUBLE_EQ(decoded(status, 0, kVehicleStatus, 8), 2780.0);
+  EXPECT_NEAR(decoded(status, 1, kVehicleStatus, 8), -45.5, 1e-9);
+  EXPECT_DOUBLE_EQ(decoded(status, 2, kVehicleStatus, 8), 2.0);
+
+  const DbcMessage* battery = database.message(0x400, true);
+  ASSERT_NE(battery, nullptr);
+  EXPECT_EQ(battery->dbcSignals.at(0).shift, 56);
+  EXPECT_DOUBLE_EQ(decoded(battery, 0, kBatteryStatus, 4), 85.0);
+  EXPECT_DOUBLE_EQ(decoded(battery, 1, kBatteryStatus, 4), 1.0);
+  EXPECT_NEAR(decoded(battery, 2, kBatteryStatus, 4), -12.34, 1e-9);
+}
+
+TEST(DbcDatabaseTest, RejectsMalformedDefinitions) {
+  DbcDatabase database;
+  EXPECT_FALSE(
+      database.parse("BO_ 256 Status: 8 Vcu\n SG_ Wide : 56|16@1+ (1,0) [0|0] \"\" Bms\n"));
+  EXPECT_TRUE(database.errorString().startsWith("Line 2"));
+
+  EXPECT_FALSE(database.parse("BO_ 256 Status: 8 Vcu\n SG_ Broken : 0|16@1+ (1,0\n"));
+  EXPECT_FALSE(database.parse("BO_ 4096 TooLong: 8 Vcu\n"));
+  EXPECT_FALSE(database.parse("BO_ 256 First: 8 Vcu\nBO_ 256 Second: 8 Vcu\n"));
+  EXPECT_FALSE(database.load("/nonexistent/vehicle.dbc"));
+  EXPECT_FALSE(database.errorString().isEmpty());
+
+  EXPECT_TRUE(database.parse(""));
+  EXPECT_TRUE(database.messages().isEmpty());
+}
+
+TEST(CanSourceTest, ParsesTheMapping) {
+  QHash<QString, QString> mapping;
+  ASSERT_TRUE(CanSource::parseMapping("VehicleSpeed=speed, Soc=battery", &mapping));
+  EXPECT_EQ(mapping.value("VehicleSpeed"), "speed");
+  EXPECT_EQ(mapping.value("Soc"), "battery");
+  EXPECT_TRUE(CanSource::parseMapping("", &mapping));
+  EXPECT_TRUE(mapping.isEmpty());
+
+  EXPECT_FALSE(CanSource::parseMapping("Soc", &mapping));
+  EXPECT_FALSE(CanSource::parseMapping("Soc=fuel", &mapping));
+  EXPECT_FALSE(CanSource::parseMapping("Seq=cseq", &mapping));
+}
+
+TEST(CanSourceTest, RoutesSignalsToKeysAndTheStore) {
+  ClusterModel model;
+  CanSource source(loadDatabase(), {{"Soc", "battery"}, {"Charging", "charging"}}, &model);
+  QSignalSpy frames(&source, &CanSource::frameReceived);
+
+  quint8 slower[8] = {0xe8, 0x03, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00};
+  EXPECT_TRUE(source.processFrame(0x100, false, slower, 8));
+  EXPECT_TRUE(source.processFrame(0x100, false, kVehicleStatus, 8));
+  EXPECT_TRUE(source.processFrame(0x400, true, kBatteryStatus, 4));
+  EXPECT_FALSE(source.processFrame(0x200, false, kVehicleStatus, 8));
+  EXPECT_FALSE(source.processFrame(0x100, false, kVehicleStatus, 4));
+  EXPECT_EQ(source.frameCount(), 3);
+  EXPECT_EQ(source.unknownFrameCount(), 2);
+
+  // Unmapped signals are in the store at once
+  const SignalStore& store = model.signalStore();
+  ASSERT_NE(store.idOf("SteeringAngle"), SignalStore::kInvalidSignal);
+  EXPECT_NEAR(store.value(store.idOf("SteeringAngle")), -45.5, 1e-9);
+  EXPECT_DOUBLE_EQ(store.value(store.idOf("DriveMode")), 2.0);
+  EXPECT_NEAR(store.value(store.idOf("PackCurrent")), -12.34, 1e-9);
+  EXPECT_EQ(store.idOf("Soc"), SignalStore::kInvalidSignal);
+
+  // Mapped signals are delivered together, with their newest values
+  EXPECT_EQ(frames.count(), 0);
+  source.deliver();
+  ASSERT_EQ(frames.count(), 1);
+  const auto data = frames.at(0).at(0).value<QMap<QString, QString>>();
+  EXPECT_EQ(data.size(), 3);
+  EXPECT_EQ(data.value("speed"), "2780");
+  EXPECT_EQ(data.value("battery"), "85");
+  EXPECT_EQ(data.value("charging"), "1");
+
+  source.deliver();
+  EXPECT_EQ(frames.count(), 1);
+}
+
+TEST(CanSourceTest, FeedsTheSubscriber) {
+  ClusterModel model;
+  ClusterSignalHub hub;
+  ClusterDataSubscriber subscriber(&model, &hub);
+  CanSource source(loadDatabase(), {{"Soc", "battery"}}, &model);
+  subscriber.attachCanSource(&source);
+
+  quint8 payload[8] = {0xe8, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  source.processFrame(0x100, false, payload, 8);
+  source.processFrame(0x400, true, kBatteryStatus, 4);
+  source.deliver();
+
+  EXPECT_EQ(model.speed(), 36);
+  EXPECT_EQ(model.battery(), 85);
+  EXPECT_EQ(model.linkStatus(), ClusterModel::LinkUp);
+}
+
+TEST(CanSourceTest, AppliesObstaclesPerFrameOnThePriorityPath) {
+  ClusterModel model;
+  ClusterSignalHub hub;
+  ClusterDataSubscriber subscriber(&model, &hub);
+  CanSource source(loadDatabase(), {{"DriveMode", "obs"}}, &model);
+  subscriber.attachCanSource(&source);
+  QSignalSpy safety(&subscriber, &ClusterDataSubscriber::safetyFrameProcessed);
+  QSignalSpy frames(&source, &CanSource::frameReceived);
+  bool brakeShown = false;
+  QObject::connect(&model, &ClusterModel::emergencyBrakeActiveChanged,
+                   [&](bool active) { brakeShown = brakeShown || active; });
+
+  // An emergency brake cleared again within one read pass is still shown
+  quint8 brake[8] = {0xe8, 0x03, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00};
+  quint8 clear[8] = {0xe8, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  source.processFrame(0x100, false, brake, 8);
+  EXPECT_TRUE(model.emergencyBrakeActive());
+  EXPECT_EQ(safety.count(), 1);
+  source.processFrame(0x100, false, clear, 8);
+  EXPECT_FALSE(model.emergencyBrakeActive());
+  EXPECT_EQ(safety.count(), 2);
+  EXPECT_EQ(frames.count(), 0);
+
+  // The coalesced frame carries only the telemetry
+  source.deliver();
+  ASSERT_EQ(frames.count(), 1);
+  EXPECT_FALSE(frames.at(0).at(0).value<QMap<QString, QString>>().contains("obs"));
+  EXPECT_TRUE(brakeShown);
+  EXPECT_FALSE(model.emergencyBrakeActive());
+  EXPECT_EQ(model.speed(), 36);
+}
+
+#ifdef Q_OS_LINUX
+TEST(CanSourceTest, ReadsAVirtualInterface) {
+  // Needs "ip link add dev vcan0 type vcan && ip link set up vcan0"
+  ClusterModel model;
+  CanSource source(loadDatabase(), {}, &model);
+  if (!source.open("vcan0")) {
+    GTEST_SKIP() << qPrintable(source.errorString());
+  }
+  QSignalSpy frames(&source, &CanSource::frameReceived);
+
+  const int sender = ::socket(PF_CAN, SOCK_RAW, CAN_RAW);
+  ASSERT_GE(sender, 0);
+  ifreq request;
+  std::memset(&request, 0, sizeof(request));
+  std::strncpy(request.ifr_name, "vcan0", IFNAMSIZ - 1);
+  ASSERT_EQ(::ioctl(sender, SIOCGIFINDEX, &request), 0);
+  sockaddr_can address;
+  std::memset(&address, 0, sizeof(address));
+  address.can_family = AF_CAN;
+  address.can_ifindex = request.ifr_ifindex;
+  ASSERT_EQ(::bind(sender, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+
+  // A burst of speed frames, with frames the database does not define in between
+  constexpr int kFrames = 200;
+  for (int i = 0; i < kFrames; ++i) {
+    can_frame frame;
+    std::memset(&frame, 0, sizeof(frame));
+    frame.can_id = i % 10 == 9 ? 0x123 : 0x100;
+    frame.can_dlc = 8;
+    frame.data[0] = static_cast<quint8>(i);
+    frame.data[1] = static_cast<quint8>(i >> 8);
+    ASSERT_EQ(::write(sender, &frame, sizeof(frame)), static_cast<ssize_t>(sizeof(frame)));
+  }
+  ::close(sender);
+
+  QDeadlineTimer deadline(2000);
+  while (source.frameCount() < kFrames - kFrames / 10 && !deadline.hasExpired()) {
+    QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 10);
+  }
+
+  // The kernel filter keeps the undefined frames out, and the frames come in batches
+  EXPECT_EQ(source.frameCount(), kFrames - kFrames / 10);
+  EXPECT_EQ(source.unknownFrameCount(), 0);
+  EXPECT_LT(source.batchCount(), source.frameCount());
+  ASSERT_GE(frames.count(), 1);
+  EXPECT_EQ(frames.last().at(0).value<QMap<QString, QString>>().value("speed"),
+            QString::number(kFrames - 2));
+}
+#endif
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -394,4 +394,75 @@ TEST_F(ClusterDataSubscriberTest, ProcessInvalidData) {
   EXPECT_LE(model->battery(), 100);
 }
 
+TEST_F(ClusterDataSubscriberTest, SharedSignalHub) {
+  ClusterSignalHub hub;
+  ClusterDataSubscriber hubSubscriber(model, &hub);
+
+  // Frames dispatched by the hub update the model without any socket of its own
+  hub.dispatchMessage("speed:27778;battery:64;lane:2");
+
+  EXPECT_EQ(model->speed(), 1000);
+  EXPECT_EQ(model->battery(), 64);
+  EXPECT_TRUE(model->laneAlert());
+  EXPECT_EQ(model->laneSide(), ClusterModel::RightLane);
+  EXPECT_EQ(hub.sourceCount(), 0);
+}
+
+TEST_F(ClusterDataSubscriberTest, SharedSignalHubIgnoredWhileMocking) {
+  ClusterSignalHub hub;
+  ClusterDataSubscriber hubSubscriber(model, &hub);
+  hubSubscriber.enableMocking(true);
+
+  hub.dispatchMessage("battery:12");
+
+  EXPECT_EQ(model->battery(), 100);
+}
+
+TEST_F(ClusterDataSubscriberTest, SafetyFramesTakePriorityPath) {
+  ClusterSignalHub hub;
+  ClusterDataSubscriber hubSubscriber(model, &hub);
+  QSignalSpy processedSpy(&hubSubscriber, &ClusterDataSubscriber::safetyFrameProcessed);
+
+  hub.dispatchPriorityMessage("obs:2;speed:27778");
+
+  // Only the safety data is applied ahead of the queue; the rest follows with the regular path
+  EXPECT_TRUE(model->objectAlert());
+  EXPECT_TRUE(model->emergencyBrakeActive());
+  EXPECT_EQ(model->speed(), 0);
+  EXPECT_EQ(processedSpy.count(), 1);
+
+  // Frames without safety data do not request a frame
+  hub.dispatchPriorityMessage("speed:27778");
+  EXPECT_EQ(processedSpy.count(), 1);
+}
+
+TEST_F(ClusterDataSubscriberTest, OlderSafetyFramesDoNotRollTheAlertBack) {
+  ClusterSignalHub hub;
+  hub.setPriorityKeys({"obs"});
+  ClusterDataSubscriber hubSubscriber(model, &hub);
+  QSignalSpy alertSpy(model, &ClusterModel::emergencyBrakeActiveChanged);
+
+  // The newest of three alerts overtakes the two in front of it
+  hub.dispatchPriorityMessage("obs:2", 2);
+  hub.dispatchMessage("obs:0;speed:27778");
+  hub.dispatchMessage("obs:1");
+  hub.dispatchMessage("obs:2");
+
+  EXPECT_TRUE(model->emergencyBrakeActive());
+  EXPECT_EQ(alertSpy.count(), 1);
+  EXPECT_GT(model->speed(), 0);
+}
+
+TEST_F(ClusterDataSubscriberTest, SafetyFramesIgnoredWhileMocking) {
+  ClusterSignalHub hub;
+  ClusterDataSubscriber hubSubscriber(model, &hub);
+  QSignalSpy processedSpy(&hubSubscriber, &ClusterDataSubscriber::safetyFrameProcessed);
+  hubSubscriber.enableMocking(true);
+
+  hub.dispatchPriorityMessage("obs:2");
+
+  EXPECT_FALSE(model->emergencyBrakeActive());
+  EXPECT_EQ(processedSpy.count(), 0);
+}
+
 // Mock data generation tests removed - mock code is excluded from coverage
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <QString>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "ClusterFrameEncoder.hpp"
+#include "ClusterProtocol.hpp"
+#include "ZmqMessageParser.hpp"
+
+namespace {
+
+std::string frame(const ClusterFrameEncoder& encoder) {
+  return std::string(encoder.data(), encoder.size());
+}
+
+} // namespace
+
+TEST(ClusterFrameEncoderTest, EncodesPairsInOrder) {
+  ClusterFrameEncoder encoder;
+  EXPECT_TRUE(encoder.isEmpty());
+
+  EXPECT_TRUE(encoder.append("cseq", 7));
+  EXPECT_TRUE(encoder.append("speed", -1250));
+  EXPECT_TRUE(encoder.append("sign", "stop", 4));
+  EXPECT_EQ(frame(encoder), "cseq:7;speed:-1250;sign:stop");
+  EXPECT_FALSE(encoder.isTruncated());
+
+  encoder.clear();
+  EXPECT_TRUE(encoder.isEmpty());
+  EXPECT_TRUE(encoder.append("odo", std::numeric_limits<int64_t>::min()));
+  EXPECT_EQ(frame(encoder), "odo:-9223372036854775808");
+}
+
+TEST(ClusterFrameEncoderTest, DisplayParsesEncodedFrame) {
+  ClusterFrameEncoder encoder;
+  encoder.append(ClusterProtocol::kNonCriticalSequence, 3);
+  encoder.append(ClusterProtocol::kBattery, 80);
+  encoder.append(ClusterProtocol::kCharging, 1);
+  encoder.append(ClusterProtocol::kOdometer, 12345);
+
+  ZmqMessageParser parser;
+  const QMap<QString, QString> data =
+      parser.parseMessage(QString::fromUtf8(encoder.data(), static_cast<int>(encoder.size())));
+  EXPECT_EQ(data.size(), 4);
+  EXPECT_EQ(data.value("nseq"), "3");
+  EXPECT_EQ(data.value("battery"), "80");
+  EXPECT_EQ(data.value("charging"), "1");
+  EXPECT_EQ(data.value("odo"), "12345");
+}
+
+TEST(ClusterFrameEncoderTest, RejectsValuesTheDisplayCannotParse) {
+  ClusterFrameEncoder encoder;
+  encoder.append("speed", 10);
+  EXPECT_FALSE(encoder.append("sign", "a;b", 3));
+  EXPECT_FALSE(encoder.append("sign", "a:b", 3));
+  EXPECT_FALSE(encoder.append("sign", "", 0));
+  EXPECT_TRUE(encoder.isTruncated());
+  EXPECT_EQ(frame(encoder), "speed:10");
+}
+
+TEST(ClusterFrameEncoderTest, DropsPairsThatDoNotFit) {
+  ClusterFrameEncoder encoder;
+  int pairs = 0;
+  while (encoder.append("odo", 123456)) {
+    ++pairs;
+  }
+  EXPECT_TRUE(encoder.isTruncated());
+  EXPECT_LE(encoder.size(), ClusterFrameEncoder::kCapacity);
+
+  // Only whole pairs were written
+  const std::string encoded = frame(encoder);
+  EXPECT_EQ(QString::fromStdString(encoded).split(';').size(), pairs);
+  EXPECT_EQ(encoded.back(), '6');
+}
+
+TEST(ClusterFrameEncoderTest, ChannelsMatchTheDisplay) {
+  using ClusterProtocol::Channel;
+  EXPECT_EQ(ClusterProtocol::channelOf("speed"), Channel::Critical);
+  EXPECT_EQ(ClusterProtocol::channelOf("obs"), Channel::Critical);
+  EXPECT_EQ(ClusterProtocol::channelOf("battery"), Channel::NonCritical);
+  EXPECT_EQ(ClusterProtocol::channelOf("odo"), Channel::NonCritical);
+  EXPECT_STREQ(ClusterProtocol::sequenceKey(Channel::NonCritical), "nseq");
+}
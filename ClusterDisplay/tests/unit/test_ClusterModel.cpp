@@ -376,6 +376,231 @@ TEST_F(ClusterModelTest, DateTimeInitialization) {
   EXPECT_EQ(model->currentDate().at(6), ' ');
 }
 
+TEST_F(ClusterModelTest, TypedPropertiesMirrorStrings) {
+  QSignalSpy modeSpy(model, &ClusterModel::drivingModeTypeChanged);
+  QSignalSpy sideSpy(model, &ClusterModel::laneSideChanged);
+  QSignalSpy kindSpy(model, &ClusterModel::signKindChanged);
+
+  // Initial typed values match the initial strings
+  EXPECT_EQ(model->drivingModeType(), ClusterModel::ManualMode);
+  EXPECT_EQ(model->laneSide(), ClusterModel::LeftLane);
+  EXPECT_EQ(model->signKind(), ClusterModel::NoSign);
+
+  // Typed setters update the string views
+  model->setDrivingModeType(ClusterModel::AutoMode);
+  model->setLaneSide(ClusterModel::RightLane);
+  model->setSignKind(ClusterModel::YieldSign);
+  EXPECT_EQ(model->drivingMode(), "AUTO");
+  EXPECT_EQ(model->laneDeviationSide(), "right");
+  EXPECT_EQ(model->signType(), "YIELD");
+
+  // String setters update the typed values
+  model->setSignType("CROSSWALK");
+  EXPECT_EQ(model->signKind(), ClusterModel::CrosswalkSign);
+
+  EXPECT_EQ(modeSpy.count(), 1);
+  EXPECT_EQ(sideSpy.count(), 1);
+  EXPECT_EQ(kindSpy.count(), 2);
+}
+
+TEST_F(ClusterModelTest, HighlightedLaneFollowsLaneAlert) {
+  QSignalSpy spy(model, &ClusterModel::highlightedLaneChanged);
+
+  // No lane is highlighted without an alert, whatever the deviation side
+  model->setLaneSide(ClusterModel::RightLane);
+  EXPECT_EQ(model->highlightedLane(), ClusterModel::NoLane);
+
+  model->setLaneAlert(true);
+  EXPECT_EQ(model->highlightedLane(), ClusterModel::RightLane);
+
+  model->setLaneSide(ClusterModel::LeftLane);
+  EXPECT_EQ(model->highlightedLane(), ClusterModel::LeftLane);
+
+  model->setLaneAlert(false);
+  EXPECT_EQ(model->highlightedLane(), ClusterModel::NoLane);
+  EXPECT_EQ(spy.count(), 3);
+}
+
+TEST_F(ClusterModelTest, VisibleSignSelectsPanel) {
+  QSignalSpy spy(model, &ClusterModel::visibleSignChanged);
+  EXPECT_EQ(model->visibleSign(), ClusterModel::NoSign);
+
+  // The legacy speed limit display shows the speed limit panel
+  model->setSpeedLimitVisible(true);
+  EXPECT_EQ(model->visibleSign(), ClusterModel::SpeedLimitSign);
+
+  model->setSignKind(ClusterModel::StopSign);
+  model->setSignVisible(true);
+  model->setSpeedLimitVisible(false);
+  EXPECT_EQ(model->visibleSign(), ClusterModel::StopSign);
+
+  model->setSignVisible(false);
+  EXPECT_EQ(model->visibleSign(), ClusterModel::NoSign);
+  EXPECT_EQ(spy.count(), 3);
+}
+
+TEST_F(ClusterModelTest, SpeedLimitExceeded) {
+  QSignalSpy spy(model, &ClusterModel::speedLimitExceededChanged);
+
+  // No limit known yet
+  model->setSpeed(500);
+  EXPECT_FALSE(model->speedLimitExceeded());
+
+  model->setLastSpeedLimit(80);
+  EXPECT_TRUE(model->speedLimitExceeded());
+
+  model->setSpeed(80);
+  EXPECT_FALSE(model->speedLimitExceeded());
+  EXPECT_EQ(spy.count(), 2);
+}
+
+TEST_F(ClusterModelTest, AlertSeverityUsesMostImportantAlert) {
+  QSignalSpy spy(model, &ClusterModel::alertSeverityChanged);
+  EXPECT_EQ(model->alertSeverity(), ClusterModel::NoAlert);
+
+  model->setLaneAlert(true);
+  EXPECT_EQ(model->alertSeverity(), ClusterModel::AdvisoryAlert);
+
+  model->setObjectAlert(true);
+  EXPECT_EQ(model->alertSeverity(), ClusterModel::WarningAlert);
+
+  model->setEmergencyBrakeActive(true);
+  EXPECT_EQ(model->alertSeverity(), ClusterModel::CriticalAlert);
+
+  // Clearing the emergency brake falls back to the next active alert
+  model->setEmergencyBrakeActive(false);
+  model->setObjectAlert(false);
+  EXPECT_EQ(model->alertSeverity(), ClusterModel::AdvisoryAlert);
+
+  model->setLaneAlert(false);
+  EXPECT_EQ(model->alertSeverity(), ClusterModel::NoAlert);
+  EXPECT_EQ(spy.count(), 6);
+}
+
+TEST_F(ClusterModelTest, LatestStateStartsWithInitialValues) {
+  ClusterModel::State state = model->latestState();
+  EXPECT_EQ(state.speed, 0);
+  EXPECT_EQ(state.battery, 100);
+  EXPECT_EQ(state.drivingMode, ClusterModel::ManualMode);
+  EXPECT_EQ(state.laneSide, ClusterModel::LeftLane);
+  EXPECT_EQ(state.alertSeverity, ClusterModel::NoAlert);
+  EXPECT_STREQ(state.signValue, "");
+}
+
+TEST_F(ClusterModelTest, LatestStateFollowsEveryChange) {
+  const quint64 initialRevision = model->latestState().revision;
+
+  model->setSpeed(120);
+  model->setBattery(42);
+  model->setEmergencyBrakeActive(true);
+  model->setSignKind(ClusterModel::SpeedLimitSign);
+  model->setSignValue("80");
+  model->setSignVisible(true);
+
+  ClusterModel::State state = model->latestState();
+  EXPECT_EQ(state.revision, initialRevision + 6);
+  EXPECT_EQ(state.speed, 120);
+  EXPECT_EQ(state.battery, 42);
+  EXPECT_TRUE(state.emergencyBrakeActive);
+  EXPECT_EQ(state.alertSeverity, ClusterModel::CriticalAlert);
+  EXPECT_EQ(state.visibleSign, ClusterModel::SpeedLimitSign);
+  EXPECT_STREQ(state.signValue, "80");
+
+  // Setting an unchanged value publishes nothing
+  model->setSpeed(120);
+  EXPECT_EQ(model->latestState().revision, initialRevision + 6);
+}
+
+TEST_F(ClusterModelTest, LatestStateTruncatesLongSignValue) {
+  model->setSignValue("A very long sign value text");
+  ClusterModel::State state = model->latestState();
+  EXPECT_EQ(qstrlen(state.signValue), sizeof(state.signValue) - 1);
+  EXPECT_TRUE(QByteArray("A very long sign value text").startsWith(state.signValue));
+}
+
+TEST_F(ClusterModelTest, LatestStateTruncatesSignValueAtCharacterBoundary) {
+  // The two-byte e-acute would be split by the 15-byte limit and is left out entirely
+  model->setSignValue(QString::fromUtf8("Rue de la Fert\xc3\xa9"));
+  EXPECT_STREQ(model->latestState().signValue, "Rue de la Fert");
+
+  // So is a three-byte euro sign of which only the first two bytes would fit
+  model->setSignValue(QString::fromUtf8("Toll 1234567 \xe2\x82\xac"));
+  EXPECT_STREQ(model->latestState().signValue, "Toll 1234567 ");
+
+  // A character ending exactly at the limit is kept
+  model->setSignValue(QString::fromUtf8("Toll 123456 \xe2\x82\xac and more"));
+  EXPECT_STREQ(model->latestState().signValue, "Toll 123456 \xe2\x82\xac");
+}
+
+TEST_F(ClusterModelTest, ProvisionalFieldsClearedByLiveData) {
+  EXPECT_EQ(model->provisionalFields(), ClusterModel::NoProvisionalField);
+  QSignalSpy spy(model, &ClusterModel::provisionalFieldsChanged);
+
+  model->setProvisionalFields(ClusterModel::BatteryField | ClusterModel::DrivingModeField |
+                              ClusterModel::LastSpeedLimitField);
+  EXPECT_EQ(spy.count(), 1);
+
+  // Unrelated values leave the flags alone
+  model->setSpeed(50);
+  EXPECT_EQ(spy.count(), 1);
+
+  // A live value confirms the field even if it equals the restored one
+  model->setBattery(model->battery());
+  EXPECT_FALSE(model->provisionalFields().testFlag(ClusterModel::BatteryField));
+  model->setDrivingMode("AUTO");
+  EXPECT_FALSE(model->provisionalFields().testFlag(ClusterModel::DrivingModeField));
+  EXPECT_EQ(model->provisionalFields(), ClusterModel::LastSpeedLimitField);
+
+  model->setLastSpeedLimit(30);
+  EXPECT_EQ(model->provisionalFields(), ClusterModel::NoProvisionalField);
+  EXPECT_EQ(spy.count(), 4);
+}
+
+TEST_F(ClusterModelTest, LinkStatusStartsDown) {
+  EXPECT_EQ(model->linkStatus(), ClusterModel::LinkDown);
+  QSignalSpy spy(model, &ClusterModel::linkStatusChanged);
+
+  model->setLinkStatus(ClusterModel::LinkUp);
+  model->setLinkStatus(ClusterModel::LinkUp);
+  EXPECT_EQ(spy.count(), 1);
+  EXPECT_EQ(spy.at(0).at(0).value<ClusterModel::LinkStatus>(), ClusterModel::LinkUp);
+
+  model->setLinkStatus(ClusterModel::LinkStale);
+  EXPECT_EQ(model->linkStatus(), ClusterModel::LinkStale);
+  EXPECT_EQ(spy.count(), 2);
+}
+
+TEST_F(ClusterModelTest, TripValues) {
+  EXPECT_EQ(model->tripDistance(), 0);
+  EXPECT_EQ(model->tripMovingTime(), 0);
+  EXPECT_EQ(model->tripAverageSpeed(), 0);
+  EXPECT_EQ(model->tripMaxSpeed(), 0);
+  EXPECT_EQ(model->recentMaxSpeed(), 0);
+  EXPECT_EQ(model->tripEnergyUsed(), 0);
+
+  QSignalSpy distanceSpy(model, &ClusterModel::tripDistanceChanged);
+  model->setTripDistance(1200);
+  model->setTripDistance(1200);
+  EXPECT_EQ(model->tripDistance(), 1200);
+  EXPECT_EQ(distanceSpy.count(), 1);
+
+  // The model only forwards the request; the trip computer resets and publishes zeros
+  QSignalSpy resetSpy(model, &ClusterModel::tripResetRequested);
+  model->resetTrip();
+  EXPECT_EQ(resetSpy.count(), 1);
+  EXPECT_EQ(model->tripDistance(), 1200);
+}
+
+TEST_F(ClusterModelTest, EstimatedRange) {
+  EXPECT_EQ(model->estimatedRange(), -1);
+
+  QSignalSpy spy(model, &ClusterModel::estimatedRangeChanged);
+  model->setEstimatedRange(8500);
+  model->setEstimatedRange(8500);
+  EXPECT_EQ(model->estimatedRange(), 8500);
+  EXPECT_EQ(spy.count(), 1);
+}
+
 int main(int argc, char** argv) {
   QCoreApplication app(argc, argv);
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QVector>
+
+#include "ClusterDataSubscriber.hpp"
+#include "ClusterModel.hpp"
+#include "ClusterPublisher.hpp"
+#include "ClusterSignalHub.hpp"
+
+using ClusterProtocol::Channel;
+
+namespace {
+
+/**
+ * @brief Process events until a condition holds or the timeout expires
+ */
+template <typename Condition>
+bool waitFor(Condition condition, int timeoutMs = 2000) {
+  QElapsedTimer timer;
+  timer.start();
+  while (!condition() && timer.elapsed() < timeoutMs) {
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+  }
+  return condition();
+}
+
+/// Binds every socket to an ephemeral loopback port
+ClusterPublisherEndpoints loopbackEndpoints() {
+  ClusterPublisherEndpoints endpoints;
+  endpoints.critical = "tcp://127.0.0.1:*";
+  endpoints.nonCritical = "tcp://127.0.0.1:*";
+  endpoints.snapshot = "tcp://127.0.0.1:*";
+  return endpoints;
+}
+
+} // namespace
+
+/**
+ * @brief ClusterPublisher feeding the display over loopback
+ */
+class ClusterPublisherTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    hub.setPriorityKeys({"obs"});
+    hub.addSource(QString::fromStdString(publisher.endpoint(Channel::Critical)));
+    hub.addSource(QString::fromStdString(publisher.endpoint(Channel::NonCritical)));
+    subscriber = new ClusterDataSubscriber(&model, &hub);
+    frameListener = hub.subscribeFrames(
+        [this](const QMap<QString, QString>& frame) { frames.append(frame); });
+
+    // PUB drops frames until the subscription has arrived; changing values get through
+    int probe = 0;
+    connected = waitFor([this, &probe]() {
+      publisher.setSpeed(++probe);
+      publisher.setOdometer(probe);
+      publisher.flush();
+      QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+      return model.speed() > 0 && model.odometer() > 0;
+    });
+    // Let the last probes arrive before frames are counted
+    waitFor([]() { return false; }, 20);
+    frames.clear();
+  }
+
+  void TearDown() override {
+    hub.unsubscribe(frameListener);
+    delete subscriber;
+  }
+
+  ClusterPublisher publisher{loopbackEndpoints()};
+  ClusterModel model;
+  ClusterSignalHub hub;
+  ClusterDataSubscriber* subscriber;
+  QVector<QMap<QString, QString>> frames;
+  int frameListener;
+  bool connected;
+};
+
+TEST_F(ClusterPublisherTest, BatchesChangesIntoOneFramePerChannel) {
+  ASSERT_TRUE(connected);
+  const ClusterPublisherStatistics before = publisher.statistics();
+
+  publisher.setSpeed(5000);
+  publisher.setLane(ClusterPublisher::Lane::Left);
+  publisher.setAutonomous(true);
+  publisher.setBattery(55);
+  publisher.setCharging(true);
+  EXPECT_EQ(publisher.flush(), 2);
+  EXPECT_EQ(publisher.flush(), 0);
+
+  ASSERT_TRUE(waitFor([this]() { return frames.size() == 2; }));
+  EXPECT_EQ(publisher.statistics().framesSent - before.framesSent, 2u);
+
+  // The channels are separate sockets, so the frames may arrive in either order
+  const int critical = frames.at(0).contains("cseq") ? 0 : 1;
+  EXPECT_EQ(frames.at(critical).keys(), QStringList({"cseq", "lane", "mode", "speed"}));
+  EXPECT_EQ(frames.at(1 - critical).keys(), QStringList({"battery", "charging", "nseq"}));
+
+  EXPECT_EQ(model.speed(), 180);
+  EXPECT_EQ(model.laneSide(), ClusterModel::LeftLane);
+  EXPECT_EQ(model.drivingModeType(), ClusterModel::AutoMode);
+  EXPECT_EQ(model.battery(), 55);
+  EXPECT_TRUE(model.charging());
+}
+
+TEST_F(ClusterPublisherTest, SuppressesUnchangedValues) {
+  ASSERT_TRUE(connected);
+  publisher.setBattery(40);
+  publisher.flush();
+  const ClusterPublisherStatistics before = publisher.statistics();
+
+  publisher.setBattery(40);
+  publisher.setBattery(40);
+  EXPECT_EQ(publisher.flush(), 0);
+  EXPECT_EQ(publisher.statistics().suppressedUpdates - before.suppressedUpdates, 2u);
+
+  // A change in between is not suppressed, even if the value returns before the flush
+  publisher.setBattery(41);
+  publisher.setBattery(40);
+  EXPECT_EQ(publisher.flush(), 1);
+}
+
+TEST_F(ClusterPublisherTest, RepeatsSignsWhileDetected) {
+  ASSERT_TRUE(connected);
+  EXPECT_TRUE(publisher.setSign("stop"));
+  EXPECT_EQ(publisher.flush(), 1);
+  EXPECT_TRUE(publisher.setSign("stop"));
+  EXPECT_EQ(publisher.flush(), 1);
+  EXPECT_FALSE(publisher.setSign("stop;speed:0"));
+
+  ASSERT_TRUE(waitFor([this]() { return frames.size() == 2; }));
+  EXPECT_EQ(model.signKind(), ClusterModel::StopSign);
+}
+
+TEST_F(ClusterPublisherTest, SendsObstacleWithoutFlush) {
+  ASSERT_TRUE(connected);
+  publisher.setObstacle(ClusterPublisher::Obstacle::EmergencyBrake);
+  EXPECT_TRUE(waitFor([this]() { return model.emergencyBrakeActive(); }));
+}
+
+TEST_F(ClusterPublisherTest, ServesSnapshotToLateJoiningDisplay) {
+  ASSERT_TRUE(connected);
+  publisher.setBattery(72);
+  publisher.setOdometer(9000);
+  publisher.setAutonomous(true);
+  publisher.setSign("yield");
+  publisher.flush();
+
+  ClusterModel lateModel;
+  ClusterSignalHub lateHub;
+  ClusterDataSubscriber lateSubscriber(&lateModel, &lateHub);
+  lateSubscriber.synchronize(QString::fromStdString(publisher.snapshotEndpoint()));
+  ASSERT_TRUE(waitFor([this, &lateSubscriber]() {
+    publisher.tick();
+    return lateSubscriber.syncState() == ClusterDataSubscriber::Synchronized;
+  }));
+
+  EXPECT_EQ(publisher.statistics().snapshotsServed, 1u);
+  EXPECT_EQ(lateModel.battery(), 72);
+  EXPECT_EQ(lateModel.odometer(), 9000);
+  EXPECT_EQ(lateModel.drivingModeType(), ClusterModel::AutoMode);
+  // Signs are events; an old one is not replayed
+  EXPECT_EQ(lateModel.signKind(), ClusterModel::NoSign);
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+
+  // Every received frame is logged at debug level
+  QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
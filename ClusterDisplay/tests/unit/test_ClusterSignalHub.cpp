@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QStringList>
+
+#include "ClusterSignalHub.hpp"
+
+class ClusterSignalHubTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    hub = new ClusterSignalHub();
+  }
+
+  void TearDown() override {
+    delete hub;
+  }
+
+  ClusterSignalHub* hub;
+};
+
+TEST_F(ClusterSignalHubTest, InitialState) {
+  EXPECT_EQ(hub->sourceCount(), 0);
+  EXPECT_EQ(hub->listenerCount("speed"), 0);
+}
+
+TEST_F(ClusterSignalHubTest, DispatchesValuesPerKey) {
+  QStringList speeds;
+  QStringList batteries;
+  hub->subscribe("speed", [&speeds](const QString& value) { speeds << value; });
+  hub->subscribe("battery", [&batteries](const QString& value) { batteries << value; });
+
+  hub->dispatchMessage("speed:1200;lane:1");
+  hub->dispatchMessage("battery:80");
+
+  EXPECT_EQ(speeds, QStringList({"1200"}));
+  EXPECT_EQ(batteries, QStringList({"80"}));
+}
+
+TEST_F(ClusterSignalHubTest, FansOutToEveryListener) {
+  int first = 0;
+  int second = 0;
+  hub->subscribeInt("speed", [&first](int value) { first = value; });
+  hub->subscribeInt("speed", [&second](int value) { second = value; });
+
+  hub->dispatchMessage("speed:42");
+
+  EXPECT_EQ(hub->listenerCount("speed"), 2);
+  EXPECT_EQ(first, 42);
+  EXPECT_EQ(second, 42);
+}
+
+TEST_F(ClusterSignalHubTest, IntListenerDropsInvalidValues) {
+  QList<int> values;
+  hub->subscribeInt("battery", [&values](int value) { values << value; });
+
+  hub->dispatchMessage("battery:55");
+  hub->dispatchMessage("battery:full");
+
+  EXPECT_EQ(values, QList<int>({55}));
+}
+
+TEST_F(ClusterSignalHubTest, FrameListenerReceivesWholeFrame) {
+  QList<QMap<QString, QString>> frames;
+  hub->subscribeFrames([&frames](const QMap<QString, QString>& frame) { frames << frame; });
+
+  hub->dispatchMessage("speed:10;odo:300");
+  hub->dispatchMessage("invalid");
+
+  // Frames without any key-value pair are not dispatched
+  ASSERT_EQ(frames.size(), 1);
+  EXPECT_EQ(frames.at(0).value("speed"), "10");
+  EXPECT_EQ(frames.at(0).value("odo"), "300");
+}
+
+TEST_F(ClusterSignalHubTest, UnsubscribeStopsDelivery) {
+  int calls = 0;
+  int frameCalls = 0;
+  int id = hub->subscribe("speed", [&calls](const QString&) { ++calls; });
+  int frameId =
+      hub->subscribeFrames([&frameCalls](const QMap<QString, QString>&) { ++frameCalls; });
+
+  hub->dispatchMessage("speed:1");
+  hub->unsubscribe(id);
+  hub->unsubscribe(frameId);
+  hub->dispatchMessage("speed:2");
+
+  EXPECT_EQ(calls, 1);
+  EXPECT_EQ(frameCalls, 1);
+  EXPECT_EQ(hub->listenerCount("speed"), 0);
+}
+
+TEST_F(ClusterSignalHubTest, ListenerRemovedDuringDispatchIsSkipped) {
+  int secondCalls = 0;
+  int secondId = 0;
+  hub->subscribe("speed", [this, &secondId](const QString&) { hub->unsubscribe(secondId); });
+  secondId = hub->subscribe("speed", [&secondCalls](const QString&) { ++secondCalls; });
+
+  hub->dispatchMessage("speed:1");
+  hub->dispatchMessage("speed:2");
+
+  EXPECT_EQ(secondCalls, 0);
+  EXPECT_EQ(hub->listenerCount("speed"), 1);
+}
+
+TEST_F(ClusterSignalHubTest, ListenerAddedDuringDispatchStartsWithNextFrame) {
+  int lateCalls = 0;
+  bool added = false;
+  hub->subscribe("speed", [this, &added, &lateCalls](const QString&) {
+    if (!added) {
+      added = true;
+      hub->subscribe("speed", [&lateCalls](const QString&) { ++lateCalls; });
+    }
+  });
+
+  hub->dispatchMessage("speed:1");
+  EXPECT_EQ(lateCalls, 0);
+
+  hub->dispatchMessage("speed:2");
+  EXPECT_EQ(lateCalls, 1);
+}
+
+TEST_F(ClusterSignalHubTest, PriorityListenerOnlyReceivesPriorityFrames) {
+  QStringList priorityFrames;
+  int regularFrames = 0;
+  hub->subscribePriorityFrames(
+      [&priorityFrames](const QMap<QString, QString>& frame) { priorityFrames << frame["obs"]; });
+  hub->subscribeFrames([&regularFrames](const QMap<QString, QString>&) { ++regularFrames; });
+
+  hub->dispatchPriorityMessage("obs:2;speed:10");
+  hub->dispatchMessage("speed:20");
+
+  EXPECT_EQ(priorityFrames, QStringList({"2"}));
+  EXPECT_EQ(regularFrames, 1);
+}
+
+TEST_F(ClusterSignalHubTest, OvertakenFramesLoseTheirPriorityKeys) {
+  QStringList obstacles;
+  QStringList speeds;
+  hub->setPriorityKeys({"obs"});
+  hub->subscribe("obs", [&obstacles](const QString& value) { obstacles << value; });
+  hub->subscribe("speed", [&speeds](const QString& value) { speeds << value; });
+
+  // A batch of four frames whose third carries the newest alert
+  hub->dispatchPriorityMessage("obs:2", 2);
+  hub->dispatchMessage("obs:0;speed:10");
+  hub->dispatchMessage("obs:1");
+  hub->dispatchMessage("obs:2");
+  hub->dispatchMessage("speed:20");
+
+  // The older alerts are not replayed after the newest one; the other values still are
+  EXPECT_EQ(obstacles, QStringList({"2"}));
+  EXPECT_EQ(speeds, QStringList({"10", "20"}));
+
+  hub->dispatchMessage("obs:0");
+  EXPECT_EQ(obstacles, QStringList({"2", "0"}));
+}
+
+TEST_F(ClusterSignalHubTest, UnsubscribeRemovesPriorityListener) {
+  int calls = 0;
+  int id = hub->subscribePriorityFrames([&calls](const QMap<QString, QString>&) { ++calls; });
+
+  hub->dispatchPriorityMessage("obs:1");
+  hub->unsubscribe(id);
+  hub->dispatchPriorityMessage("obs:2");
+
+  EXPECT_EQ(calls, 1);
+}
+
+TEST_F(ClusterSignalHubTest, PriorityPathIgnoresEmptyFrames) {
+  int calls = 0;
+  hub->subscribePriorityFrames([&calls](const QMap<QString, QString>&) { ++calls; });
+  hub->setPriorityKeys({"obs"});
+
+  hub->dispatchPriorityMessage("");
+
+  EXPECT_EQ(calls, 0);
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
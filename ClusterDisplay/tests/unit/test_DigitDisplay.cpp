@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <QGuiApplication>
+#include <QSignalSpy>
+
+#include "DigitDisplay.hpp"
+#include "GlyphAtlas.hpp"
+
+class GlyphAtlasTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    font.setPixelSize(30);
+  }
+
+  QFont font;
+};
+
+TEST_F(GlyphAtlasTest, DuplicateCharactersShareACell) {
+  GlyphAtlas atlas(font, Qt::white, "0123456789 0m");
+
+  EXPECT_EQ(atlas.characters(), "0123456789 m");
+  EXPECT_EQ(atlas.indexOf('0'), 0);
+  EXPECT_EQ(atlas.indexOf('9'), 9);
+  EXPECT_EQ(atlas.indexOf('m'), 11);
+  EXPECT_EQ(atlas.indexOf('%'), -1);
+}
+
+TEST_F(GlyphAtlasTest, CellsHaveFixedWidth) {
+  GlyphAtlas atlas(font, Qt::white, "0123456789");
+
+  EXPECT_GT(atlas.cellSize().width(), 0);
+  EXPECT_GT(atlas.cellSize().height(), 0);
+  EXPECT_FALSE(atlas.image().isNull());
+
+  // Every cell covers the same slice of the texture, left to right
+  QRectF first = atlas.textureRect(0);
+  QRectF last = atlas.textureRect(9);
+  EXPECT_DOUBLE_EQ(first.width(), last.width());
+  EXPECT_LT(first.left(), last.left());
+  EXPECT_LE(last.right(), 1.0);
+  EXPECT_TRUE(atlas.textureRect(-1).isNull());
+  EXPECT_TRUE(atlas.textureRect(10).isNull());
+}
+
+TEST_F(GlyphAtlasTest, DevicePixelRatioScalesImageOnly) {
+  GlyphAtlas standard(font, Qt::white, "0123456789", 1.0);
+  GlyphAtlas scaled(font, Qt::white, "0123456789", 2.0);
+
+  EXPECT_EQ(standard.cellSize(), scaled.cellSize());
+  EXPECT_GT(scaled.image().width(), standard.image().width());
+  EXPECT_GT(scaled.image().height(), standard.image().height());
+}
+
+class DigitDisplayTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    display = new DigitDisplay();
+  }
+
+  void TearDown() override {
+    delete display;
+  }
+
+  DigitDisplay* display;
+};
+
+TEST_F(DigitDisplayTest, InitialValues) {
+  EXPECT_TRUE(display->text().isEmpty());
+  EXPECT_EQ(display->color(), QColor(Qt::white));
+  EXPECT_EQ(display->characters(), "0123456789");
+  EXPECT_TRUE(display->flags().testFlag(QQuickItem::ItemHasContents));
+}
+
+TEST_F(DigitDisplayTest, PropertySignals) {
+  QSignalSpy textSpy(display, &DigitDisplay::textChanged);
+  QSignalSpy colorSpy(display, &DigitDisplay::colorChanged);
+  QSignalSpy fontSpy(display, &DigitDisplay::fontChanged);
+  QSignalSpy charactersSpy(display, &DigitDisplay::charactersChanged);
+
+  display->setText("120");
+  display->setText("120");
+  display->setColor(QColor("#00c293"));
+  QFont font;
+  font.setPixelSize(105);
+  display->setFont(font);
+  display->setCharacters("0123456789:");
+
+  EXPECT_EQ(textSpy.count(), 1);
+  EXPECT_EQ(colorSpy.count(), 1);
+  EXPECT_EQ(fontSpy.count(), 1);
+  EXPECT_EQ(charactersSpy.count(), 1);
+  EXPECT_EQ(display->text(), "120");
+}
+
+TEST_F(DigitDisplayTest, AtlasFollowsProperties) {
+  display->setCharacters("0123456789%");
+  EXPECT_EQ(display->atlas()->indexOf('%'), 10);
+
+  display->setCharacters("0123456789:");
+  EXPECT_EQ(display->atlas()->indexOf('%'), -1);
+  EXPECT_EQ(display->atlas()->indexOf(':'), 10);
+}
+
+TEST_F(DigitDisplayTest, ImplicitSizeFollowsCharacterCount) {
+  const QSizeF cell = display->atlas()->cellSize();
+
+  display->setText("42");
+  EXPECT_DOUBLE_EQ(display->implicitWidth(), cell.width() * 2);
+  EXPECT_DOUBLE_EQ(display->implicitHeight(), cell.height());
+
+  // Updating to a value of the same length keeps the layout unchanged
+  QSignalSpy widthSpy(display, &QQuickItem::implicitWidthChanged);
+  display->setText("57");
+  EXPECT_EQ(widthSpy.count(), 0);
+
+  display->setText("100");
+  EXPECT_DOUBLE_EQ(display->implicitWidth(), cell.width() * 3);
+}
+
+int main(int argc, char** argv) {
+  // Fonts need a GUI application; the offscreen platform keeps the test headless
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+  QGuiApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QSignalSpy>
+
+#include "DisplaySettings.hpp"
+
+class DisplaySettingsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    settings = new DisplaySettings();
+  }
+
+  void TearDown() override {
+    delete settings;
+  }
+
+  DisplaySettings* settings;
+};
+
+TEST_F(DisplaySettingsTest, InitialValues) {
+  EXPECT_FALSE(settings->partialRepaint());
+  EXPECT_EQ(settings->overlayIdleUnloadMs(), 30000);
+  EXPECT_TRUE(settings->trendGraphs());
+}
+
+TEST_F(DisplaySettingsTest, PartialRepaintSignal) {
+  QSignalSpy spy(settings, &DisplaySettings::partialRepaintChanged);
+
+  settings->setPartialRepaint(true);
+  settings->setPartialRepaint(true);
+
+  EXPECT_TRUE(settings->partialRepaint());
+  ASSERT_EQ(spy.count(), 1);
+  EXPECT_TRUE(spy.at(0).at(0).toBool());
+}
+
+TEST_F(DisplaySettingsTest, OverlayIdleUnloadMs) {
+  QSignalSpy spy(settings, &DisplaySettings::overlayIdleUnloadMsChanged);
+
+  settings->setOverlayIdleUnloadMs(5000);
+  EXPECT_EQ(settings->overlayIdleUnloadMs(), 5000);
+
+  // Negative values unload immediately
+  settings->setOverlayIdleUnloadMs(-1);
+  EXPECT_EQ(settings->overlayIdleUnloadMs(), 0);
+  EXPECT_EQ(spy.count(), 2);
+}
+
+TEST_F(DisplaySettingsTest, QmlInstanceIsTheRegisteredObject) {
+  DisplaySettings::setQmlInstance(settings);
+  EXPECT_EQ(DisplaySettings::create(nullptr, nullptr), settings);
+}
+
+TEST_F(DisplaySettingsTest, SoftwareBackendFromEnvironment) {
+  const QByteArray previous = qgetenv("QT_QUICK_BACKEND");
+
+  qputenv("QT_QUICK_BACKEND", "software");
+  EXPECT_TRUE(DisplaySettings::softwareBackendSelected());
+
+  qunsetenv("QT_QUICK_BACKEND");
+  EXPECT_FALSE(DisplaySettings::softwareBackendSelected());
+
+  if (!previous.isEmpty()) {
+    qputenv("QT_QUICK_BACKEND", previous);
+  }
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
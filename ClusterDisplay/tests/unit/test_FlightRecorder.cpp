@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QTemporaryDir>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "FlightRecorder.hpp"
+
+TEST(FlightRecorderTest, CapacityIsRoundedUpToPowerOfTwo) {
+  FlightRecorder recorder(100);
+  EXPECT_EQ(recorder.capacity(), 128);
+  EXPECT_EQ(recorder.recordedCount(), 0u);
+  EXPECT_TRUE(recorder.snapshot().isEmpty());
+}
+
+TEST(FlightRecorderTest, SnapshotReturnsEventsInOrder) {
+  FlightRecorder recorder(16);
+  recorder.record(FlightRecorder::FrameReceived, 12, FlightRecorder::prefix("speed:10", 8));
+  recorder.record(FlightRecorder::ModelChanged, 100, 1);
+  recorder.record(FlightRecorder::AlertChanged, 3, 2);
+
+  const QVector<FlightRecorder::Event> events = recorder.snapshot();
+  ASSERT_EQ(events.size(), 3);
+  EXPECT_EQ(events[0].type, FlightRecorder::FrameReceived);
+  EXPECT_EQ(events[0].a, 12);
+  EXPECT_EQ(events[1].type, FlightRecorder::ModelChanged);
+  EXPECT_EQ(events[1].b, 1);
+  EXPECT_EQ(events[2].type, FlightRecorder::AlertChanged);
+  EXPECT_LE(events[0].timeNs, events[1].timeNs);
+  EXPECT_LE(events[1].timeNs, events[2].timeNs);
+}
+
+TEST(FlightRecorderTest, RingKeepsNewestEvents) {
+  FlightRecorder recorder(8);
+  for (int i = 0; i < 20; ++i) {
+    recorder.record(FlightRecorder::Marker, i);
+  }
+
+  const QVector<FlightRecorder::Event> events = recorder.snapshot();
+  EXPECT_EQ(recorder.recordedCount(), 20u);
+  ASSERT_EQ(events.size(), 8);
+  EXPECT_EQ(events.first().a, 12);
+  EXPECT_EQ(events.last().a, 19);
+}
+
+TEST(FlightRecorderTest, TraceUsesInstalledInstance) {
+  FlightRecorder recorder(8);
+  FlightRecorder::trace(FlightRecorder::Marker, 1);
+  EXPECT_EQ(recorder.recordedCount(), 0u);
+
+  FlightRecorder::setInstance(&recorder);
+  FlightRecorder::trace(FlightRecorder::Marker, 2);
+  EXPECT_EQ(recorder.recordedCount(), 1u);
+
+  FlightRecorder::setInstance(nullptr);
+  FlightRecorder::trace(FlightRecorder::Marker, 3);
+  EXPECT_EQ(recorder.recordedCount(), 1u);
+}
+
+TEST(FlightRecorderTest, DestroyedRecorderIsUninstalled) {
+  auto* recorder = new FlightRecorder(8);
+  FlightRecorder::setInstance(recorder);
+  delete recorder;
+  EXPECT_EQ(FlightRecorder::instance(), nullptr);
+}
+
+TEST(FlightRecorderTest, ConcurrentWritersProduceCompleteEvents) {
+  constexpr int kThreads = 4;
+  constexpr int kEventsPerThread = 10000;
+  FlightRecorder recorder(1024);
+
+  std::vector<std::thread> writers;
+  for (int t = 0; t < kThreads; ++t) {
+    writers.emplace_back([&recorder, t]() {
+      for (int i = 0; i < kEventsPerThread; ++i) {
+        recorder.record(FlightRecorder::Marker, t, qint64(t) * 1000000 + i);
+      }
+    });
+  }
+
+  // Read while the writers are running; every event returned must be consistent
+  bool consistent = true;
+  for (int i = 0; i < 100; ++i) {
+    for (const FlightRecorder::Event& event : recorder.snapshot()) {
+      consistent = consistent && event.type == FlightRecorder::Marker &&
+                   event.b / 1000000 == event.a;
+    }
+  }
+  for (std::thread& writer : writers) {
+    writer.join();
+  }
+
+  EXPECT_TRUE(consistent);
+  EXPECT_EQ(recorder.recordedCount(), quint64(kThreads * kEventsPerThread));
+  EXPECT_EQ(recorder.snapshot().size(), 1024);
+}
+
+TEST(FlightRecorderTest, DumpWritesReadableFile) {
+  QTemporaryDir directory;
+  ASSERT_TRUE(directory.isValid());
+
+  FlightRecorder recorder(16);
+  ASSERT_TRUE(recorder.setDumpDirectory(directory.path()));
+  recorder.record(FlightRecorder::FrameReceived, 9, FlightRecorder::prefix("obs:2", 5));
+  recorder.record(FlightRecorder::Stall, 0, 750000000);
+
+  ASSERT_TRUE(recorder.dump("test"));
+  EXPECT_EQ(recorder.dumpPath("test"), directory.filePath("flight-test.log"));
+
+  QFile file(recorder.dumpPath("test"));
+  ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+  const QList<QByteArray> lines = file.readAll().split('\n');
+  ASSERT_GE(lines.size(), 5);
+  EXPECT_TRUE(lines[0].contains("dump: test"));
+  EXPECT_TRUE(lines[1].contains("recorded=2 capacity=16"));
+  EXPECT_TRUE(lines[3].endsWith(" frame 9 \"obs:2\""));
+  EXPECT_TRUE(lines[4].endsWith(" stall 0 750000000"));
+}
+
+TEST(FlightRecorderTest, RejectsTooLongDumpDirectory) {
+  FlightRecorder recorder(8);
+  EXPECT_FALSE(recorder.setDumpDirectory(QString(600, 'x')));
+  EXPECT_FALSE(recorder.setDumpDirectory(QString()));
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
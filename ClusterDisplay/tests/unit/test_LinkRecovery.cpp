@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <memory>
+
+#include "ClusterDataSubscriber.hpp"
+#include "ClusterModel.hpp"
+#include "ClusterSignalHub.hpp"
+#include "StandInPublisher.hpp"
+
+namespace {
+
+/**
+ * @brief Process events until a condition holds or the timeout expires
+ */
+template <typename Condition>
+bool waitFor(Condition condition, int timeoutMs = 2000) {
+  QElapsedTimer timer;
+  timer.start();
+  while (!condition() && timer.elapsed() < timeoutMs) {
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+  }
+  return condition();
+}
+
+} // namespace
+
+/**
+ * @brief Gap accounting and link status, fed directly through the hub
+ */
+class LinkRecoveryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    subscriber = new ClusterDataSubscriber(&model, &hub);
+  }
+
+  void TearDown() override {
+    delete subscriber;
+  }
+
+  ClusterModel model;
+  ClusterSignalHub hub;
+  ClusterDataSubscriber* subscriber;
+};
+
+TEST_F(LinkRecoveryTest, CountsLostAndLateFramesPerChannel) {
+  hub.dispatchMessage("cseq:1;speed:1000");
+  hub.dispatchMessage("cseq:2;speed:1000");
+  hub.dispatchMessage("cseq:6;speed:1000");
+  hub.dispatchMessage("nseq:10;battery:50");
+  hub.dispatchMessage("nseq:12;battery:50");
+  hub.dispatchMessage("nseq:11;battery:50");
+
+  const SequenceTracker critical = subscriber->sequenceTracker("cseq");
+  EXPECT_EQ(critical.received(), 3);
+  EXPECT_EQ(critical.lost(), 3);
+  EXPECT_EQ(critical.late(), 0);
+
+  const SequenceTracker nonCritical = subscriber->sequenceTracker("nseq");
+  EXPECT_EQ(nonCritical.received(), 3);
+  EXPECT_EQ(nonCritical.lost(), 0);
+  EXPECT_EQ(nonCritical.late(), 1);
+
+  // Frames without a sequence number are not accounted for
+  hub.dispatchMessage("odo:5");
+  EXPECT_EQ(subscriber->sequenceTracker("cseq").received(), 3);
+}
+
+TEST_F(LinkRecoveryTest, ReportsStaleLinkWithoutFrames) {
+  subscriber->setStaleTimeout(50);
+  EXPECT_EQ(model.linkStatus(), ClusterModel::LinkDown);
+
+  hub.dispatchMessage("cseq:1;speed:1000");
+  EXPECT_EQ(model.linkStatus(), ClusterModel::LinkUp);
+
+  EXPECT_TRUE(waitFor([this]() { return model.linkStatus() == ClusterModel::LinkStale; }));
+
+  // The next frame restores the link right away
+  hub.dispatchMessage("cseq:2;speed:1000");
+  EXPECT_EQ(model.linkStatus(), ClusterModel::LinkUp);
+}
+
+TEST_F(LinkRecoveryTest, MockDataKeepsLinkUp) {
+  subscriber->enableMocking(true);
+  EXPECT_EQ(model.linkStatus(), ClusterModel::LinkUp);
+  subscriber->enableMocking(false);
+  EXPECT_EQ(model.linkStatus(), ClusterModel::LinkDown);
+}
+
+/**
+ * @brief Publisher restarts against a stand-in publisher over loopback
+ */
+class LinkRecoveryLoopbackTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    publisher = std::make_unique<StandInPublisher>();
+    hub.addSource(QString::fromStdString(publisher->endpoint(StandInPublisher::Critical)));
+    hub.addSource(QString::fromStdString(publisher->endpoint(StandInPublisher::NonCritical)));
+    subscriber = new ClusterDataSubscriber(&model, &hub);
+    connected = waitForProbes();
+  }
+
+  void TearDown() override {
+    delete subscriber;
+  }
+
+  /// PUB drops frames until the subscription has arrived; probe until one gets through
+  bool waitForProbes() {
+    int probes = 0;
+    const int listener = hub.subscribe("probe", [&probes](const QString&) { ++probes; });
+    const bool received = waitFor([this, &probes]() {
+      publisher->publish(StandInPublisher::Critical, "probe:1");
+      publisher->publish(StandInPublisher::NonCritical, "probe:1");
+      QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+      return probes >= 2;
+    });
+    hub.unsubscribe(listener);
+    return received;
+  }
+
+  /// Stops the publisher and starts a new one on the same endpoints
+  void restartPublisher() {
+    const std::string critical = publisher->endpoint(StandInPublisher::Critical);
+    const std::string nonCritical = publisher->endpoint(StandInPublisher::NonCritical);
+    const std::string snapshot = publisher->snapshotEndpoint();
+    publisher.reset();
+    ASSERT_TRUE(waitFor([this]() { return model.linkStatus() == ClusterModel::LinkDown; }));
+    publisher = std::make_unique<StandInPublisher>(critical, nonCritical, snapshot);
+  }
+
+  std::unique_ptr<StandInPublisher> publisher;
+  ClusterModel model;
+  ClusterSignalHub hub;
+  ClusterDataSubscriber* subscriber;
+  bool connected;
+};
+
+TEST_F(LinkRecoveryLoopbackTest, ReportsLinkUpWhileConnected) {
+  ASSERT_TRUE(connected);
+  EXPECT_TRUE(waitFor([this]() { return hub.connectedSourceCount() == 2; }));
+  EXPECT_EQ(model.linkStatus(), ClusterModel::LinkUp);
+}
+
+TEST_F(LinkRecoveryLoopbackTest, RecoversStateAfterPublisherRestart) {
+  ASSERT_TRUE(connected);
+  subscriber->synchronize(QString::fromStdString(publisher->snapshotEndpoint()));
+  ASSERT_TRUE(waitFor([this]() {
+    return subscriber->syncState() == ClusterDataSubscriber::Synchronized;
+  }));
+  publisher->publish(StandInPublisher::NonCritical, "odo:100");
+  ASSERT_TRUE(waitFor([this]() { return model.odometer() == 100; }));
+
+  restartPublisher();
+  QElapsedTimer timer;
+  timer.start();
+
+  // Published before the display has reconnected; only the snapshot can deliver it
+  publisher->publish(StandInPublisher::NonCritical, "odo:150;battery:35");
+  ASSERT_TRUE(waitFor([this]() { return model.odometer() == 150; }));
+  const qint64 recoveryMs = timer.elapsed();
+
+  RecordProperty("recovery_ms", static_cast<int>(recoveryMs));
+  EXPECT_LT(recoveryMs, 1000);
+  EXPECT_EQ(model.battery(), 35);
+  EXPECT_EQ(model.linkStatus(), ClusterModel::LinkUp);
+}
+
+TEST_F(LinkRecoveryLoopbackTest, CountsRestartInsteadOfLateFrames) {
+  ASSERT_TRUE(connected);
+  // Well within the restart window, so only the lost connection tells a restart from late frames
+  for (int i = 0; i < 500; ++i) {
+    publisher->publish(StandInPublisher::Critical, "speed:1000");
+  }
+  ASSERT_TRUE(waitFor([this]() {
+    return subscriber->sequenceTracker("cseq").lastSequence() > 500;
+  }));
+
+  restartPublisher();
+  ASSERT_TRUE(waitForProbes());
+
+  const SequenceTracker critical = subscriber->sequenceTracker("cseq");
+  EXPECT_EQ(critical.restarts(), 1);
+  EXPECT_EQ(critical.late(), 0);
+  EXPECT_LT(critical.lastSequence(), 500);
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+
+  // Every received frame and connection event is logged at debug level
+  QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
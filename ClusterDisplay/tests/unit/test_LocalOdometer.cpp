@@ -0,0 +1,280 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "ClusterDataSubscriber.hpp"
+#include "LocalOdometer.hpp"
+#include "OdometerJournal.hpp"
+#include "StateSnapshot.hpp"
+
+TEST(LocalOdometerTest, IntegratesExactlyInFixedPoint) {
+  LocalOdometer odometer;
+  odometer.seed(0);
+
+  // 1 mm/s for a day is 86.4 m; a float accumulation of 10 ms steps would drift
+  for (qint64 time = 0; time <= 86400000; time += 10) {
+    odometer.addSpeed(time, 1);
+  }
+  EXPECT_EQ(odometer.micrometers(), 86400000);
+  EXPECT_EQ(odometer.meters(), 86);
+}
+
+TEST(LocalOdometerTest, HeldSpeedAdvancesBetweenSamples) {
+  LocalOdometer odometer;
+  odometer.seed(5 * LocalOdometer::kMicrometersPerMeter);
+  odometer.addSpeed(0, 2000);
+  odometer.advance(1500);
+  EXPECT_EQ(odometer.meters(), 8);
+
+  // Nothing is counted while the link is down
+  odometer.interrupt();
+  odometer.advance(60000);
+  EXPECT_EQ(odometer.meters(), 8);
+}
+
+TEST(LocalOdometerTest, AdoptsThePublisherWhenAhead) {
+  LocalOdometer odometer;
+  EXPECT_FALSE(odometer.isKnown());
+  odometer.addPublisherValue(12345);
+  EXPECT_TRUE(odometer.isKnown());
+  EXPECT_EQ(odometer.meters(), 12345);
+
+  // A figure restored from the journal is replaced by a publisher that is further
+  LocalOdometer restored;
+  restored.seed(100 * LocalOdometer::kMicrometersPerMeter);
+  restored.addPublisherValue(500);
+  EXPECT_EQ(restored.meters(), 500);
+}
+
+TEST(LocalOdometerTest, ReconcilesWithPublisherSteps) {
+  LocalOdometer odometer;
+  odometer.addPublisherValue(100);
+
+  // Behind: jumps to the publisher value
+  odometer.addSpeed(0, 1000);
+  odometer.advance(2000);
+  odometer.addPublisherValue(110);
+  EXPECT_EQ(odometer.meters(), 110);
+
+  // Within the publisher's meter: steady
+  odometer.advance(2500);
+  odometer.addPublisherValue(110);
+  EXPECT_EQ(odometer.micrometers(), 110500000);
+
+  // Ahead: held until the publisher catches up, never going back
+  odometer.addSpeed(2500, 10000);
+  odometer.advance(3500);
+  EXPECT_EQ(odometer.meters(), 120);
+  odometer.addPublisherValue(115);
+  EXPECT_EQ(odometer.meters(), 120);
+  odometer.addSpeed(3500, 1000);
+  odometer.advance(7000);
+  EXPECT_EQ(odometer.meters(), 120);
+  odometer.advance(8000);
+  EXPECT_EQ(odometer.meters(), 120);
+  odometer.addPublisherValue(120);
+  odometer.advance(9000);
+  EXPECT_EQ(odometer.meters(), 121);
+}
+
+TEST(LocalOdometerTest, KeepsCountingWhenThePublisherRestarts) {
+  LocalOdometer odometer;
+  odometer.addPublisherValue(5000);
+  odometer.addPublisherValue(5010);
+
+  // The restarted publisher counts from zero again
+  odometer.addPublisherValue(0);
+  EXPECT_EQ(odometer.meters(), 5010);
+  odometer.addPublisherValue(20);
+  EXPECT_EQ(odometer.meters(), 5030);
+
+  // An implausible jump is rebased as well
+  odometer.addPublisherValue(900000);
+  EXPECT_EQ(odometer.meters(), 5030);
+  odometer.addPublisherValue(900005);
+  EXPECT_EQ(odometer.meters(), 5035);
+}
+
+TEST(LocalOdometerTest, DrivenCountsOnlyTheDistanceAdvanced) {
+  LocalOdometer odometer;
+  odometer.seed(100 * LocalOdometer::kMicrometersPerMeter);
+  odometer.addPublisherValue(500);
+  EXPECT_EQ(odometer.driven(), 0);
+
+  // Integrated and caught-up distance both count, the adopted base does not
+  odometer.addSpeed(0, 1000);
+  odometer.advance(2000);
+  EXPECT_EQ(odometer.driven(), 2 * LocalOdometer::kMicrometersPerMeter);
+  odometer.addPublisherValue(505);
+  EXPECT_EQ(odometer.driven(), 5 * LocalOdometer::kMicrometersPerMeter);
+
+  // A restarted publisher is rebased without moving the total
+  odometer.addPublisherValue(0);
+  EXPECT_EQ(odometer.driven(), 5 * LocalOdometer::kMicrometersPerMeter);
+}
+
+class OdometerJournalTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(directory.isValid());
+    path = directory.filePath("state/" + OdometerJournal::defaultFileName());
+  }
+
+  QTemporaryDir directory;
+  QString path;
+};
+
+TEST_F(OdometerJournalTest, RestoresTheNewestRecord) {
+  {
+    OdometerJournal journal(0);
+    ASSERT_TRUE(journal.open(path));
+    EXPECT_EQ(journal.restore(), -1);
+    journal.record(1000);
+    journal.flush();
+    journal.record(2500);
+    journal.flush();
+    EXPECT_EQ(journal.writeCount(), 2);
+  }
+
+  OdometerJournal journal;
+  ASSERT_TRUE(journal.open(path));
+  EXPECT_EQ(journal.restore(), 2500);
+  EXPECT_EQ(journal.recordCount(), 2);
+}
+
+TEST_F(OdometerJournalTest, SkipsATornTail) {
+  {
+    OdometerJournal journal(0);
+    ASSERT_TRUE(journal.open(path));
+    journal.record(1000);
+    journal.flush();
+    journal.record(2000);
+    journal.flush();
+  }
+
+  // Half of a third record, as left by a power loss during the write
+  QFile file(path);
+  ASSERT_TRUE(file.open(QIODevice::Append));
+  file.write(QByteArray(8, '\x5a'));
+  file.close();
+
+  {
+    OdometerJournal journal(0);
+    ASSERT_TRUE(journal.open(path));
+    EXPECT_EQ(journal.restore(), 2000);
+
+    // The next record follows the last valid one
+    journal.record(3000);
+    journal.flush();
+  }
+  OdometerJournal journal;
+  ASSERT_TRUE(journal.open(path));
+  EXPECT_EQ(journal.restore(), 3000);
+  EXPECT_EQ(journal.recordCount(), 3);
+}
+
+TEST_F(OdometerJournalTest, BoundsTheWriteRate) {
+  OdometerJournal journal(200);
+  ASSERT_TRUE(journal.open(path));
+  QSignalSpy spy(&journal, &OdometerJournal::written);
+
+  journal.record(1);
+  ASSERT_TRUE(spy.wait(100));
+
+  // Everything within the interval ends up in one record
+  for (qint64 figure = 2; figure <= 500; ++figure) {
+    journal.record(figure);
+  }
+  EXPECT_FALSE(spy.wait(100));
+  ASSERT_TRUE(spy.wait(500));
+  EXPECT_EQ(journal.writeCount(), 2);
+  EXPECT_EQ(spy.last().at(0).toLongLong(), 500);
+
+  // An unchanged figure is not written again
+  journal.record(500);
+  journal.flush();
+  EXPECT_EQ(journal.writeCount(), 2);
+}
+
+TEST_F(OdometerJournalTest, CompactsWhenFull) {
+  {
+    OdometerJournal journal(0);
+    ASSERT_TRUE(journal.open(path));
+    for (qint64 figure = 1; figure <= OdometerJournal::kMaxRecords + 10; ++figure) {
+      journal.record(figure);
+      journal.flush();
+    }
+    EXPECT_EQ(journal.recordCount(), 11);
+  }
+  EXPECT_EQ(QFile(path).size(), 16 + 11 * 16);
+
+  OdometerJournal journal;
+  ASSERT_TRUE(journal.open(path));
+  EXPECT_EQ(journal.restore(), OdometerJournal::kMaxRecords + 10);
+}
+
+TEST_F(OdometerJournalTest, SubscriberContinuesFromTheJournal) {
+  {
+    OdometerJournal journal(0);
+    ASSERT_TRUE(journal.open(path));
+    journal.record(4200 * LocalOdometer::kMicrometersPerMeter + 700000);
+    journal.flush();
+  }
+
+  OdometerJournal journal(0);
+  ASSERT_TRUE(journal.open(path));
+  ClusterModel model;
+  ClusterSignalHub hub;
+  ClusterDataSubscriber subscriber(&model, &hub);
+  subscriber.setOdometerJournal(&journal);
+  EXPECT_EQ(model.odometer(), 4200);
+
+  // A restarted publisher reports less; the display keeps its figure
+  hub.dispatchMessage("odo:12");
+  EXPECT_EQ(model.odometer(), 4200);
+  hub.dispatchMessage("odo:15");
+  EXPECT_EQ(model.odometer(), 4203);
+  journal.flush();
+  EXPECT_EQ(journal.restore(), subscriber.localOdometer().micrometers());
+}
+
+TEST_F(OdometerJournalTest, HeldFigureLeavesTheRestoredOdometerProvisional) {
+  const QString snapshotPath = directory.filePath("state/" + StateSnapshot::defaultFileName());
+  {
+    ClusterModel persisted;
+    StateSnapshot snapshot(&persisted, 0);
+    ASSERT_TRUE(snapshot.open(snapshotPath));
+    persisted.setOdometer(4200);
+    snapshot.flush();
+  }
+
+  ClusterModel model;
+  StateSnapshot snapshot(&model);
+  ASSERT_TRUE(snapshot.open(snapshotPath));
+  ASSERT_TRUE(snapshot.restore());
+  OdometerJournal journal(0);
+  ASSERT_TRUE(journal.open(path));
+  ClusterSignalHub hub;
+  ClusterDataSubscriber subscriber(&model, &hub);
+  subscriber.setOdometerJournal(&journal);
+  EXPECT_EQ(model.odometer(), 4200);
+  EXPECT_TRUE(model.provisionalFields().testFlag(ClusterModel::OdometerField));
+
+  // Republishing the held figure with a battery frame does not confirm it
+  hub.dispatchMessage("battery:80");
+  EXPECT_FALSE(model.provisionalFields().testFlag(ClusterModel::BatteryField));
+  EXPECT_TRUE(model.provisionalFields().testFlag(ClusterModel::OdometerField));
+
+  hub.dispatchMessage("speed:1000");
+  EXPECT_FALSE(model.provisionalFields().testFlag(ClusterModel::OdometerField));
+  EXPECT_EQ(model.odometer(), 4200);
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
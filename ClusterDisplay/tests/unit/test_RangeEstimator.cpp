@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include "ClusterDataSubscriber.hpp"
+#include "LocalOdometer.hpp"
+#include "RangeEstimator.hpp"
+
+namespace {
+
+/**
+ * @brief Simulated drive replayed into an estimator the way the publisher reports it
+ *
+ * The true battery drains by kPerKm per km and kPerMinute per minute. Like the
+ * publisher, the drive sends the speed every 100 ms, and the odometer and the
+ * battery in whole units only when they change. As on the display, the speed
+ * and odometer go through a LocalOdometer that gives the estimator its distance.
+ */
+class DriveReplay {
+ public:
+  static constexpr double kPerKm = 4.0;
+  static constexpr double kPerMinute = 0.05;
+  static constexpr qint64 kStepMs = 100;
+
+  explicit DriveReplay(RangeEstimator& estimator)
+      : m_estimator(estimator), m_timeMs(0), m_meters(0.0), m_level(100.0), m_random(12345),
+        m_speed(0), m_speedUntilMs(0), m_sentOdometer(-1), m_sentLevel(-1), m_samples(0) {}
+
+  /** @brief Drives until the battery is at a level; the speed changes every few seconds */
+  void driveTo(double level) {
+    while (m_level > level) {
+      if (m_timeMs >= m_speedUntilMs) {
+        // 0.5 to 3 m/s, with a stop now and then
+        const uint32_t draw = next();
+        m_speed = draw % 8 == 0 ? 0 : 500 + static_cast<int>(draw % 2500);
+        m_speedUntilMs = m_timeMs + 2000 + static_cast<qint64>(next() % 8000);
+      }
+      step(m_speed);
+    }
+  }
+
+  /** @brief Charges to a level while the charging flag toggles like a loose connector */
+  void charge(double level) {
+    m_estimator.setCharging(m_timeMs, true);
+    int toggles = 0;
+    while (m_level < level) {
+      m_level = std::fmin(m_level + 0.01, 100.0);
+      if (++toggles % 500 == 0) {
+        m_estimator.setCharging(m_timeMs, toggles % 1000 != 0);
+      }
+      step(0);
+    }
+    m_estimator.setCharging(m_timeMs, false);
+  }
+
+  /** @brief Remaining range at the average speed of the drive, from the true model */
+  double trueRange() const {
+    const double minutesPerKm = (m_timeMs / 60000.0) / (m_meters / 1000.0);
+    return std::floor(m_level) / (kPerKm + kPerMinute * minutesPerKm) * 1000.0;
+  }
+
+  qint64 samples() const {
+    return m_samples;
+  }
+
+ private:
+  void step(int speed) {
+    m_timeMs += kStepMs;
+    const double meters = speed * kStepMs * 1e-6;
+    m_meters += meters;
+    m_level -= kPerKm * meters / 1000.0 + kPerMinute * kStepMs / 60000.0;
+
+    m_odometer.addSpeed(m_timeMs, speed);
+    ++m_samples;
+    const qint64 odometer = static_cast<qint64>(m_meters);
+    if (odometer != m_sentOdometer) {
+      m_odometer.addPublisherValue(odometer);
+      m_sentOdometer = odometer;
+      ++m_samples;
+    }
+    m_estimator.addDistance(m_timeMs, m_odometer.driven());
+    const int level = static_cast<int>(std::floor(m_level));
+    if (level != m_sentLevel) {
+      m_estimator.addBattery(m_timeMs, level);
+      m_sentLevel = level;
+      ++m_samples;
+    }
+  }
+
+  uint32_t next() {
+    m_random = m_random * 1664525u + 1013904223u;
+    return m_random >> 8;
+  }
+
+  RangeEstimator& m_estimator;
+  LocalOdometer m_odometer;
+  qint64 m_timeMs;
+  double m_meters;
+  double m_level;
+  uint32_t m_random;
+  int m_speed;
+  qint64 m_speedUntilMs;
+  qint64 m_sentOdometer;
+  int m_sentLevel;
+  qint64 m_samples;
+};
+
+} // namespace
+
+TEST(RangeEstimatorTest, UnknownUntilTheBatteryIsReported) {
+  RangeEstimator estimator;
+  EXPECT_EQ(estimator.range(), -1);
+
+  // The nominal model until a drop was measured
+  estimator.addBattery(0, 50);
+  EXPECT_EQ(estimator.range(), 10000);
+  EXPECT_FALSE(estimator.isMeasuring());
+}
+
+TEST(RangeEstimatorTest, FirstDropOnlyStartsMeasuring) {
+  RangeEstimator estimator;
+  estimator.addBattery(0, 80);
+  estimator.addDistance(1000, 300 * LocalOdometer::kMicrometersPerMeter);
+  estimator.addBattery(60000, 79);
+  EXPECT_TRUE(estimator.isMeasuring());
+  EXPECT_EQ(estimator.model().observations, 0);
+
+  estimator.addDistance(62000, 500 * LocalOdometer::kMicrometersPerMeter);
+  estimator.addBattery(120000, 78);
+  EXPECT_EQ(estimator.model().observations, 1);
+}
+
+TEST(RangeEstimatorTest, StretchDistanceComesFromTheRunningTotal) {
+  RangeEstimator estimator;
+  estimator.addBattery(0, 80);
+  estimator.addDistance(0, 5000 * LocalOdometer::kMicrometersPerMeter);
+  estimator.addBattery(1000, 79);
+
+  // One km for one percent in no time: the fit moves the per-km weight towards 1 %/km
+  estimator.addDistance(1000, 6000 * LocalOdometer::kMicrometersPerMeter);
+  estimator.addBattery(1000, 78);
+  EXPECT_EQ(estimator.model().observations, 1);
+  EXPECT_LT(estimator.model().weights[0], RangeEstimator::kNominalPercentPerKm);
+}
+
+TEST(RangeEstimatorTest, JitterIsNotAMeasurement) {
+  RangeEstimator estimator;
+  estimator.addBattery(0, 80);
+  estimator.addBattery(1000, 79);
+  estimator.addBattery(2000, 80);
+  estimator.addBattery(3000, 79);
+  estimator.addBattery(4000, 80);
+  EXPECT_EQ(estimator.model().observations, 0);
+
+  // A large rise without the charging flag is a recharge and needs a new first drop
+  estimator.addBattery(5000, 95);
+  EXPECT_FALSE(estimator.isMeasuring());
+  estimator.addBattery(6000, 94);
+  EXPECT_EQ(estimator.model().observations, 0);
+}
+
+TEST(RangeEstimatorTest, ReplayConvergesToTheDrive) {
+  RangeEstimator estimator;
+  DriveReplay drive(estimator);
+  drive.driveTo(40.0);
+
+  EXPECT_GT(estimator.model().observations, 50);
+  EXPECT_NEAR(estimator.model().weights[0], DriveReplay::kPerKm, 0.25 * DriveReplay::kPerKm);
+  EXPECT_NEAR(estimator.range(), drive.trueRange(), 0.1 * drive.trueRange());
+}
+
+TEST(RangeEstimatorTest, ChargingIsNotLearned) {
+  RangeEstimator estimator;
+  DriveReplay drive(estimator);
+  drive.driveTo(60.0);
+  const ConsumptionModel before = estimator.model();
+
+  drive.charge(90.0);
+  EXPECT_FALSE(estimator.isMeasuring());
+  EXPECT_EQ(estimator.model().observations, before.observations);
+  EXPECT_DOUBLE_EQ(estimator.model().weights[0], before.weights[0]);
+
+  // Drops during the settle time only follow the level
+  drive.driveTo(89.0);
+  EXPECT_EQ(estimator.model().observations, before.observations);
+
+  drive.driveTo(70.0);
+  EXPECT_GT(estimator.model().observations, before.observations);
+  EXPECT_NEAR(estimator.range(), drive.trueRange(), 0.1 * drive.trueRange());
+}
+
+TEST(RangeEstimatorTest, InterruptDiscardsTheSegment) {
+  RangeEstimator estimator;
+  estimator.addBattery(0, 80);
+  estimator.addBattery(1000, 79);
+  EXPECT_TRUE(estimator.isMeasuring());
+
+  estimator.interrupt(2000);
+  EXPECT_FALSE(estimator.isMeasuring());
+  estimator.addBattery(600000, 70);
+  EXPECT_EQ(estimator.model().observations, 0);
+}
+
+TEST(RangeEstimatorTest, ReplayCostIsConstantPerSample) {
+  // Per-sample cost measured on a replay of a full battery; no allocation happens in the loop
+  RangeEstimator estimator;
+  DriveReplay drive(estimator);
+  QElapsedTimer timer;
+  timer.start();
+  drive.driveTo(1.0);
+  const qint64 elapsedNs = timer.nsecsElapsed();
+
+  ASSERT_GT(drive.samples(), 100000);
+  const double nsPerSample = static_cast<double>(elapsedNs) / drive.samples();
+  std::printf("Range estimator: %lld samples, %.1f ns per sample\n",
+              static_cast<long long>(drive.samples()), nsPerSample);
+  // Generous bound for debug and coverage builds; the fit is a handful of multiplications
+  EXPECT_LT(nsPerSample, 2000.0);
+}
+
+TEST(RangeEstimatorTest, ModelShowsTheRange) {
+  ClusterModel model;
+  ClusterSignalHub hub;
+  ClusterDataSubscriber subscriber(&model, &hub);
+  EXPECT_EQ(model.estimatedRange(), -1);
+
+  hub.dispatchMessage("battery:60");
+  EXPECT_EQ(model.estimatedRange(), subscriber.rangeEstimator().range());
+  EXPECT_EQ(model.estimatedRange(), 12000);
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "ClusterDataSubscriber.hpp"
+#include "ClusterPublisher.hpp"
+#include "ZmqRateAdvertiser.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+/// Unreachable backchannel for tests that only look at the advertised rates
+const QString kNoPublisher = QStringLiteral("tcp://127.0.0.1:1");
+
+/**
+ * @brief Process events until a condition holds or the timeout expires
+ */
+template <typename Condition>
+bool waitFor(Condition condition, int timeoutMs = 2000) {
+  QElapsedTimer timer;
+  timer.start();
+  while (!condition() && timer.elapsed() < timeoutMs) {
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+  }
+  return condition();
+}
+
+/// Binds every socket to an ephemeral loopback port
+ClusterPublisherEndpoints loopbackEndpoints() {
+  ClusterPublisherEndpoints endpoints;
+  endpoints.critical = "tcp://127.0.0.1:*";
+  endpoints.nonCritical = "tcp://127.0.0.1:*";
+  endpoints.snapshot = std::string();
+  endpoints.rates = "tcp://127.0.0.1:*";
+  return endpoints;
+}
+
+} // namespace
+
+TEST(ZmqRateAdvertiserTest, EncodesRatesInProtocolFormat) {
+  ZmqRateAdvertiser advertiser(kNoPublisher);
+  EXPECT_TRUE(advertiser.encodedRates().isEmpty());
+
+  advertiser.setMaxRate("speed", 60);
+  advertiser.setMaxRate("battery", 0.5);
+  advertiser.setMaxRate("odo", 0);
+  EXPECT_EQ(advertiser.encodedRates(), "battery:0.5;odo:0;speed:60");
+
+  // A negative rate removes the limit
+  advertiser.setMaxRate("odo", -1);
+  EXPECT_EQ(advertiser.encodedRates(), "battery:0.5;speed:60");
+}
+
+TEST(ZmqRateAdvertiserTest, ParsesRateSpecification) {
+  ZmqRateAdvertiser advertiser(kNoPublisher);
+  EXPECT_TRUE(advertiser.setMaxRates("speed=30, battery=0.25,lane=0"));
+  EXPECT_EQ(advertiser.maxRates().value("speed"), 30);
+  EXPECT_EQ(advertiser.maxRates().value("battery"), 0.25);
+  EXPECT_EQ(advertiser.maxRates().value("lane"), 0);
+  EXPECT_TRUE(advertiser.setMaxRates(QString()));
+
+  // Invalid specifications leave every rate alone
+  EXPECT_FALSE(advertiser.setMaxRates("speed=10,battery"));
+  EXPECT_FALSE(advertiser.setMaxRates("speed=fast"));
+  EXPECT_FALSE(advertiser.setMaxRates("a:b=1"));
+  EXPECT_EQ(advertiser.maxRates().value("speed"), 30);
+}
+
+TEST(ZmqRateAdvertiserTest, DefaultRatesFollowTheScreen) {
+  const QMap<QString, qreal> rates = ClusterDataSubscriber::maxUsefulRates(60);
+  EXPECT_EQ(rates.value("speed"), 60);
+  EXPECT_EQ(rates.value("battery"), 1);
+  EXPECT_EQ(rates.value("odo"), 1);
+
+  // Safety alerts are never limited
+  EXPECT_FALSE(rates.contains("obs"));
+}
+
+/**
+ * @brief Display advertising its rates to a ClusterPublisher over loopback
+ */
+class RateNegotiationTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    publisher = std::make_unique<ClusterPublisher>(loopbackEndpoints());
+    advertiser = std::make_unique<ZmqRateAdvertiser>(
+        QString::fromStdString(publisher->rateEndpoint()), 20);
+  }
+
+  /// Advertises until the publisher has applied the limits
+  bool negotiate() {
+    advertiser->start();
+    return waitFor([this]() { return publisher->receiveRateLimits() > 0; });
+  }
+
+  std::unique_ptr<ClusterPublisher> publisher;
+  std::unique_ptr<ZmqRateAdvertiser> advertiser;
+};
+
+TEST_F(RateNegotiationTest, PublisherAppliesAdvertisedRates) {
+  advertiser->setMaxRate("speed", 10);
+  advertiser->setMaxRate("battery", 0);
+  advertiser->setMaxRate("unknown", 5);
+  ASSERT_TRUE(negotiate());
+
+  EXPECT_EQ(publisher->minimumInterval("speed"), 100ms);
+  EXPECT_LT(publisher->minimumInterval("battery").count(), 0);
+  EXPECT_EQ(publisher->minimumInterval("odo").count(), 0);
+  EXPECT_GE(publisher->statistics().rateAdvertisements, 1u);
+}
+
+TEST_F(RateNegotiationTest, CoalescesUpdatesToAdvertisedRate) {
+  advertiser->setMaxRate("speed", 10);
+  ASSERT_TRUE(negotiate());
+
+  // 300 ms of speed updates every millisecond
+  const auto start = std::chrono::steady_clock::now();
+  int updates = 0;
+  while (std::chrono::steady_clock::now() - start < 300ms) {
+    publisher->setSpeed(1000 + ++updates);
+    publisher->flush();
+    std::this_thread::sleep_for(1ms);
+  }
+
+  const ClusterPublisherStatistics& statistics = publisher->statistics();
+  EXPECT_GE(statistics.framesSent, 3u);
+  EXPECT_LE(statistics.framesSent, 4u);
+
+  // The latest value goes out once the interval has passed; every other one was replaced
+  std::this_thread::sleep_for(110ms);
+  publisher->flush();
+  EXPECT_EQ(statistics.coalescedUpdates + statistics.framesSent, static_cast<uint64_t>(updates));
+}
+
+TEST_F(RateNegotiationTest, HiddenKeysAreHeldBackButAlertsAreNot) {
+  advertiser->setMaxRate("battery", 0);
+  advertiser->setMaxRate("obs", 0);
+  ASSERT_TRUE(negotiate());
+
+  publisher->setBattery(50);
+  EXPECT_EQ(publisher->flush(), 0);
+
+  publisher->setObstacle(ClusterPublisher::Obstacle::EmergencyBrake);
+  EXPECT_EQ(publisher->statistics().framesSent, 1u);
+}
+
+TEST_F(RateNegotiationTest, LimitsExpireWhenTheDisplayGoesAway) {
+  publisher->setRateLimitLifetime(50ms);
+  advertiser->setMaxRate("battery", 0);
+  ASSERT_TRUE(negotiate());
+  publisher->setBattery(50);
+  EXPECT_EQ(publisher->flush(), 0);
+
+  // Take the advertisements still in flight, then let the limits run out
+  advertiser.reset();
+  std::this_thread::sleep_for(10ms);
+  publisher->receiveRateLimits();
+  std::this_thread::sleep_for(100ms);
+  publisher->receiveRateLimits();
+  EXPECT_EQ(publisher->minimumInterval("battery").count(), 0);
+  EXPECT_EQ(publisher->flush(), 1);
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+
+  // Every received frame is logged at debug level
+  QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <thread>
+
+#include "RealtimeProfile.hpp"
+
+/// CPU number no test machine has
+constexpr int kMissingCpu = 100000;
+
+TEST(RealtimeProfileTest, ParsesCpuListsAndRanges) {
+  RealtimeProfile::ThreadSettings settings;
+  ASSERT_TRUE(RealtimeProfile::parseThreadSettings("2,4-5:70", &settings));
+  EXPECT_EQ(settings.cpus, QList<int>({2, 4, 5}));
+  EXPECT_EQ(settings.priority, 70);
+
+  ASSERT_TRUE(RealtimeProfile::parseThreadSettings("3", &settings));
+  EXPECT_EQ(settings.cpus, QList<int>({3}));
+  EXPECT_EQ(settings.priority, 0);
+}
+
+TEST(RealtimeProfileTest, ParsesPriorityWithoutPinning) {
+  RealtimeProfile::ThreadSettings settings;
+  ASSERT_TRUE(RealtimeProfile::parseThreadSettings(":60", &settings));
+  EXPECT_TRUE(settings.cpus.isEmpty());
+  EXPECT_EQ(settings.priority, 60);
+  EXPECT_TRUE(settings.isSet());
+}
+
+TEST(RealtimeProfileTest, RemovesDuplicateCpus) {
+  RealtimeProfile::ThreadSettings settings;
+  ASSERT_TRUE(RealtimeProfile::parseThreadSettings("1,0-2,1", &settings));
+  EXPECT_EQ(settings.cpus, QList<int>({1, 0, 2}));
+}
+
+TEST(RealtimeProfileTest, RejectsMalformedSpecifications) {
+  RealtimeProfile::ThreadSettings settings;
+  settings.cpus = {7};
+  for (const char* spec :
+       {"", ":", "a", "1-", "3-1", "-1", "1-2-3", "1:0", "1:100", "1:x", "1:2:3"}) {
+    EXPECT_FALSE(RealtimeProfile::parseThreadSettings(spec, &settings)) << spec;
+  }
+  // Rejected specifications leave the settings untouched
+  EXPECT_EQ(settings.cpus, QList<int>({7}));
+}
+
+TEST(RealtimeProfileTest, IsEnabledOnlyWhenSomethingIsRequested) {
+  RealtimeProfile profile;
+  EXPECT_FALSE(profile.isEnabled());
+
+  profile.setRenderThread(RealtimeProfile::ThreadSettings());
+  EXPECT_FALSE(profile.isEnabled());
+
+  profile.setLockMemory(true);
+  EXPECT_TRUE(profile.isEnabled());
+
+  RealtimeProfile pinned;
+  RealtimeProfile::ThreadSettings settings;
+  settings.cpus = {0};
+  pinned.setGuiThread(settings);
+  EXPECT_TRUE(pinned.isEnabled());
+}
+
+TEST(RealtimeProfileTest, PinsThreadToAvailableCpu) {
+  const QList<int> available = RealtimeProfile::availableCpus();
+  if (available.isEmpty()) {
+    GTEST_SKIP() << "CPU affinity not available on this platform";
+  }
+
+  RealtimeProfile profile;
+  RealtimeProfile::ThreadSettings settings;
+  settings.cpus = {available.last()};
+
+  // Pin a helper thread so the test process keeps its own placement
+  bool applied = false;
+  QList<int> placement;
+  std::thread worker([&]() {
+    applied = profile.applyToCurrentThread("worker", settings);
+    placement = RealtimeProfile::availableCpus();
+  });
+  worker.join();
+
+  EXPECT_TRUE(applied);
+  EXPECT_EQ(placement, settings.cpus);
+  ASSERT_EQ(profile.report().size(), 1);
+  EXPECT_TRUE(profile.report().first().startsWith("worker: pinned to CPUs"));
+}
+
+TEST(RealtimeProfileTest, ReportsUnavailableCpus) {
+  RealtimeProfile profile;
+  RealtimeProfile::ThreadSettings settings;
+  settings.cpus = {kMissingCpu};
+
+  bool applied = true;
+  std::thread worker([&]() { applied = profile.applyToCurrentThread("worker", settings); });
+  worker.join();
+
+  EXPECT_FALSE(applied);
+  ASSERT_EQ(profile.report().size(), 1);
+  EXPECT_TRUE(profile.report().first().contains("worker"));
+}
+
+TEST(RealtimeProfileTest, DropsUnavailableIngestCpus) {
+  const QList<int> available = RealtimeProfile::availableCpus();
+  if (available.isEmpty()) {
+    GTEST_SKIP() << "CPU affinity not available on this platform";
+  }
+
+  RealtimeProfile profile;
+  RealtimeProfile::ThreadSettings settings;
+  settings.cpus = {available.first(), kMissingCpu};
+  profile.setIngestThreads(settings);
+
+  ZmqSocketOptions defaults;
+  defaults.receiveHighWaterMark = 42;
+  const ZmqSocketOptions options = profile.ingestSocketOptions(defaults);
+
+  EXPECT_EQ(options.receiveHighWaterMark, 42);
+  EXPECT_EQ(options.ioThreadCpus, QList<int>({available.first()}));
+  EXPECT_EQ(options.ioThreadPriority, 0);
+  EXPECT_FALSE(profile.report().isEmpty());
+}
+
+TEST(RealtimeProfileTest, LeavesOptionsUnchangedWithoutIngestSettings) {
+  RealtimeProfile profile;
+  const ZmqSocketOptions options = profile.ingestSocketOptions();
+
+  EXPECT_TRUE(options.ioThreadCpus.isEmpty());
+  EXPECT_EQ(options.ioThreadPriority, 0);
+  EXPECT_TRUE(profile.report().isEmpty());
+}
+
+TEST(RealtimeProfileTest, PriorityDegradesWhenNotPermitted) {
+  RealtimeProfile profile;
+  RealtimeProfile::ThreadSettings settings;
+  settings.priority = 10;
+  profile.setIngestThreads(settings);
+
+  // Either outcome is valid; the priority is only passed on when it can be applied
+  const bool permitted = RealtimeProfile::canUseRealtimePriority(10);
+  const ZmqSocketOptions options = profile.ingestSocketOptions();
+
+  EXPECT_EQ(options.ioThreadPriority, permitted ? 10 : 0);
+  EXPECT_TRUE(options.ioThreadCpus.isEmpty());
+  if (!permitted) {
+    EXPECT_TRUE(profile.report().first().contains("not permitted"));
+  }
+}
+
+TEST(RealtimeProfileTest, RejectsOutOfRangePriority) {
+  QString error;
+  EXPECT_FALSE(RealtimeProfile::canUseRealtimePriority(0, &error));
+  EXPECT_FALSE(error.isEmpty());
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
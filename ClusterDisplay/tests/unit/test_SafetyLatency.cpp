@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <zmq.hpp>
+
+#include "ClusterDataSubscriber.hpp"
+#include "ClusterModel.hpp"
+#include "ClusterSignalHub.hpp"
+
+namespace {
+
+/// Upper bound from publishing a safety frame to the alert state being set in the model
+constexpr qint64 kSafetyLatencyBoundUs = 20000;
+
+qint64 nowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * @brief Process events until a condition holds or the timeout expires
+ */
+template <typename Condition>
+bool waitFor(Condition condition, int timeoutMs = 2000) {
+  QElapsedTimer timer;
+  timer.start();
+  while (!condition() && timer.elapsed() < timeoutMs) {
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+  }
+  return condition();
+}
+
+} // namespace
+
+/**
+ * @brief End-to-end tests of the safety priority path over a loopback publisher
+ */
+class SafetyLatencyTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    publisher = new zmq::socket_t(context, zmq::socket_type::pub);
+    publisher->set(zmq::sockopt::linger, 0);
+    publisher->bind("tcp://127.0.0.1:*");
+
+    model = new ClusterModel();
+    hub = new ClusterSignalHub();
+    hub->setPriorityKeys({"obs"});
+    hub->addSource(QString::fromStdString(publisher->get(zmq::sockopt::last_endpoint)));
+    subscriber = new ClusterDataSubscriber(model, hub);
+
+    // PUB drops frames until the subscription has arrived; probe until one gets through
+    connected = waitFor([this]() {
+      send("battery:1");
+      QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+      return model->battery() == 1;
+    });
+  }
+
+  void TearDown() override {
+    delete subscriber;
+    delete hub;
+    delete model;
+    delete publisher;
+  }
+
+  void send(const std::string& frame) {
+    publisher->send(zmq::buffer(frame), zmq::send_flags::none);
+  }
+
+  zmq::context_t context{1};
+  zmq::socket_t* publisher;
+  ClusterModel* model;
+  ClusterSignalHub* hub;
+  ClusterDataSubscriber* subscriber;
+  bool connected;
+};
+
+TEST_F(SafetyLatencyTest, SafetyFrameOvertakesQueuedTelemetry) {
+  ASSERT_TRUE(connected);
+
+  constexpr int kBacklog = 50;
+  int odometerAtBrake = -1;
+  QObject::connect(model, &ClusterModel::emergencyBrakeActiveChanged,
+                   [this, &odometerAtBrake](bool active) {
+                     if (active) {
+                       odometerAtBrake = model->odometer();
+                     }
+                   });
+
+  // Queue telemetry followed by an emergency brake frame without running the event loop
+  for (int i = 1; i <= kBacklog; ++i) {
+    send("odo:" + std::to_string(i));
+  }
+  send("obs:2");
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  ASSERT_TRUE(waitFor([this]() { return model->odometer() == kBacklog; }));
+
+  // The brake was applied before any of the telemetry in front of it
+  EXPECT_EQ(odometerAtBrake, 0);
+  EXPECT_TRUE(model->emergencyBrakeActive());
+  EXPECT_TRUE(model->objectAlert());
+}
+
+TEST_F(SafetyLatencyTest, SafetyLatencyBoundedUnderLoad) {
+  ASSERT_TRUE(connected);
+
+  constexpr int kAlerts = 10;
+  constexpr int kTelemetryRate = 5000;
+  std::atomic<qint64> alertSentUs{0};
+  std::atomic<bool> done{false};
+  qint64 worstLatencyUs = 0;
+  int alertsSeen = 0;
+
+  QObject::connect(model, &ClusterModel::emergencyBrakeActiveChanged, [&](bool) {
+    const qint64 latencyUs = nowUs() - alertSentUs.load(std::memory_order_acquire);
+    worstLatencyUs = qMax(worstLatencyUs, latencyUs);
+    ++alertsSeen;
+  });
+
+  // Telemetry at a steady rate with the emergency brake toggled every 50 ms
+  std::thread sender([&]() {
+    zmq::socket_t* socket = publisher;
+    const auto start = std::chrono::steady_clock::now();
+    const int frames = kAlerts * kTelemetryRate / 20;
+    for (int i = 1; i <= frames; ++i) {
+      std::this_thread::sleep_until(start + std::chrono::microseconds(i * 1000000LL /
+                                                                         kTelemetryRate));
+      std::string frame = "speed:" + std::to_string(i % 30000) + ";odo:" + std::to_string(i);
+      if (i % (kTelemetryRate / 20) == 0) {
+        alertSentUs.store(nowUs(), std::memory_order_release);
+        frame += (i / (kTelemetryRate / 20)) % 2 ? ";obs:2" : ";obs:0";
+      }
+      socket->send(zmq::buffer(frame), zmq::send_flags::none);
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  waitFor([&done]() { return done.load(std::memory_order_acquire); }, 10000);
+  waitFor([&alertsSeen]() { return alertsSeen == kAlerts; });
+  sender.join();
+
+  RecordProperty("worst_safety_latency_us", static_cast<int>(worstLatencyUs));
+  EXPECT_EQ(alertsSeen, kAlerts);
+  EXPECT_LT(worstLatencyUs, kSafetyLatencyBoundUs);
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+
+  // Every received frame is logged at debug level; keep that out of the measurement
+  QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "SequenceTracker.hpp"
+
+TEST(SequenceTrackerTest, CountsFramesInOrder) {
+  SequenceTracker tracker;
+  EXPECT_EQ(tracker.lastSequence(), 0);
+
+  EXPECT_EQ(tracker.track(41), SequenceTracker::First);
+  EXPECT_EQ(tracker.track(42), SequenceTracker::InOrder);
+  EXPECT_EQ(tracker.track(43), SequenceTracker::InOrder);
+  EXPECT_EQ(tracker.received(), 3);
+  EXPECT_EQ(tracker.lastSequence(), 43);
+  EXPECT_EQ(tracker.lost(), 0);
+  EXPECT_EQ(tracker.late(), 0);
+}
+
+TEST(SequenceTrackerTest, CountsSkippedFramesAsLost) {
+  SequenceTracker tracker;
+  tracker.track(1);
+  EXPECT_EQ(tracker.track(5), SequenceTracker::Gap);
+  EXPECT_EQ(tracker.lost(), 3);
+  EXPECT_EQ(tracker.track(6), SequenceTracker::InOrder);
+  EXPECT_EQ(tracker.track(10), SequenceTracker::Gap);
+  EXPECT_EQ(tracker.lost(), 6);
+}
+
+TEST(SequenceTrackerTest, LateFrameIsNoLongerLost) {
+  SequenceTracker tracker;
+  tracker.track(1);
+  tracker.track(4);
+  EXPECT_EQ(tracker.lost(), 2);
+
+  EXPECT_EQ(tracker.track(3), SequenceTracker::Late);
+  EXPECT_EQ(tracker.late(), 1);
+  EXPECT_EQ(tracker.lost(), 1);
+  EXPECT_EQ(tracker.lastSequence(), 4);
+
+  // A duplicate is late as well, but there is nothing left to take off the lost count
+  tracker.track(5);
+  tracker.track(2);
+  tracker.track(2);
+  EXPECT_EQ(tracker.late(), 3);
+  EXPECT_EQ(tracker.lost(), 0);
+}
+
+TEST(SequenceTrackerTest, DetectsRestartedPublisher) {
+  SequenceTracker tracker(100);
+  tracker.track(500);
+
+  // Counting from 1 again
+  EXPECT_EQ(tracker.track(1), SequenceTracker::Restart);
+  EXPECT_EQ(tracker.lastSequence(), 1);
+  EXPECT_EQ(tracker.track(2), SequenceTracker::InOrder);
+
+  // The first frames of the next run were missed
+  tracker.track(450);
+  EXPECT_EQ(tracker.track(350), SequenceTracker::Restart);
+  EXPECT_EQ(tracker.restarts(), 2);
+  EXPECT_EQ(tracker.late(), 0);
+}
+
+TEST(SequenceTrackerTest, LostConnectionTurnsLowerNumberIntoRestart) {
+  SequenceTracker tracker;
+  tracker.track(500);
+  tracker.expectRestart();
+  EXPECT_EQ(tracker.track(3), SequenceTracker::Restart);
+  EXPECT_EQ(tracker.late(), 0);
+
+  // Only the frame right after the lost connection is affected
+  tracker.track(4);
+  tracker.expectRestart();
+  EXPECT_EQ(tracker.track(5), SequenceTracker::InOrder);
+  EXPECT_EQ(tracker.track(3), SequenceTracker::Late);
+  EXPECT_EQ(tracker.restarts(), 1);
+}
+
+TEST(SequenceTrackerTest, ResetClearsCounters) {
+  SequenceTracker tracker;
+  tracker.track(1);
+  tracker.track(9);
+  tracker.reset();
+  EXPECT_EQ(tracker.received(), 0);
+  EXPECT_EQ(tracker.lost(), 0);
+  EXPECT_EQ(tracker.lastSequence(), 0);
+  EXPECT_EQ(tracker.track(20), SequenceTracker::First);
+}
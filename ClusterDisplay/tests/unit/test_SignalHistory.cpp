@@ -0,0 +1,253 @@
+#include <gtest/gtest.h>
+
+#include <QGuiApplication>
+#include <QSignalSpy>
+#include <cmath>
+#include <vector>
+
+#include "SignalHistory.hpp"
+#include "TrendGraph.hpp"
+
+using SmallHistory = SignalHistory<16, 8, 4>;
+
+TEST(SignalHistoryTest, StartsEmpty) {
+  SmallHistory history;
+
+  EXPECT_TRUE(history.isEmpty());
+  EXPECT_EQ(history.count(SmallHistory::Raw), 0u);
+  EXPECT_EQ(history.count(SmallHistory::Seconds), 0u);
+  EXPECT_EQ(history.count(SmallHistory::Minutes), 0u);
+}
+
+TEST(SignalHistoryTest, RawTierKeepsTheNewestSamples) {
+  SmallHistory history;
+  for (int i = 0; i < 40; ++i) {
+    EXPECT_TRUE(history.append(i * 10, static_cast<float>(i)));
+  }
+
+  // Fixed capacity: the oldest samples were overwritten
+  ASSERT_EQ(history.count(SmallHistory::Raw), 16u);
+  EXPECT_EQ(history.point(SmallHistory::Raw, 0).timeMs, 240);
+  EXPECT_FLOAT_EQ(history.point(SmallHistory::Raw, 15).value, 39.0f);
+  EXPECT_FLOAT_EQ(history.latest().value, 39.0f);
+}
+
+TEST(SignalHistoryTest, OutOfOrderSamplesAreDropped) {
+  SmallHistory history;
+  history.append(1000, 1.0f);
+
+  EXPECT_FALSE(history.append(999, 2.0f));
+  EXPECT_TRUE(history.append(1000, 3.0f));
+  EXPECT_EQ(history.count(SmallHistory::Raw), 2u);
+}
+
+TEST(SignalHistoryTest, SecondBucketsSummarizeTheirSamples) {
+  SmallHistory history;
+  history.append(0, 2.0f);
+  history.append(400, 6.0f);
+  history.append(800, 4.0f);
+
+  // The bucket being filled is not visible yet
+  EXPECT_EQ(history.count(SmallHistory::Seconds), 0u);
+
+  history.append(1000, 9.0f);
+  ASSERT_EQ(history.count(SmallHistory::Seconds), 1u);
+  const HistoryBucket bucket = history.bucket(SmallHistory::Seconds, 0);
+  EXPECT_EQ(bucket.startMs, 0);
+  EXPECT_FLOAT_EQ(bucket.min, 2.0f);
+  EXPECT_FLOAT_EQ(bucket.max, 6.0f);
+  EXPECT_FLOAT_EQ(bucket.average, 4.0f);
+
+  // Drawn in the middle of the bucket
+  EXPECT_EQ(history.point(SmallHistory::Seconds, 0).timeMs, 500);
+}
+
+TEST(SignalHistoryTest, GapsHoldThePreviousValue) {
+  SmallHistory history;
+  history.append(0, 1.0f);
+  history.append(5000, 2.0f);
+
+  // Raw: a hold sample right before the change makes a step
+  ASSERT_EQ(history.count(SmallHistory::Raw), 3u);
+  EXPECT_EQ(history.point(SmallHistory::Raw, 1).timeMs, 4999);
+  EXPECT_FLOAT_EQ(history.point(SmallHistory::Raw, 1).value, 1.0f);
+
+  // Seconds: the closed bucket and one hold bucket before the new sample
+  ASSERT_EQ(history.count(SmallHistory::Seconds), 2u);
+  EXPECT_EQ(history.bucket(SmallHistory::Seconds, 1).startMs, 4000);
+  EXPECT_FLOAT_EQ(history.bucket(SmallHistory::Seconds, 1).average, 1.0f);
+}
+
+TEST(SignalHistoryTest, MinuteBucketsFoldTheSecondBuckets) {
+  SmallHistory history;
+  for (int second = 0; second < 60; ++second) {
+    history.append(second * 1000, second < 30 ? 10.0f : 20.0f);
+  }
+  history.append(60000, 50.0f);
+  EXPECT_EQ(history.count(SmallHistory::Minutes), 0u);
+
+  history.append(61000, 50.0f);
+  ASSERT_EQ(history.count(SmallHistory::Minutes), 1u);
+  const HistoryBucket minute = history.bucket(SmallHistory::Minutes, 0);
+  EXPECT_EQ(minute.startMs, 0);
+  EXPECT_FLOAT_EQ(minute.min, 10.0f);
+  EXPECT_FLOAT_EQ(minute.max, 20.0f);
+  EXPECT_FLOAT_EQ(minute.average, 15.0f);
+}
+
+TEST(SignalHistoryTest, ResolutionCoversTheRequestedRange) {
+  SmallHistory history;
+  for (int i = 0; i <= 80; ++i) {
+    history.append(i * 250, static_cast<float>(i));
+  }
+
+  // 16 raw samples reach back to 16 s, 8 closed second buckets to 12 s
+  EXPECT_EQ(history.resolutionFor(17000), SmallHistory::Raw);
+  EXPECT_EQ(history.resolutionFor(13000), SmallHistory::Seconds);
+  EXPECT_EQ(history.resolutionFor(5000), SmallHistory::Minutes);
+}
+
+TEST(SignalHistoryTest, LowerBoundFindsTheFirstEntryInRange) {
+  SmallHistory history;
+  for (int i = 0; i < 10; ++i) {
+    history.append(i * 100, 0.0f);
+  }
+
+  EXPECT_EQ(history.lowerBound(SmallHistory::Raw, 0), 0u);
+  EXPECT_EQ(history.lowerBound(SmallHistory::Raw, 450), 5u);
+  EXPECT_EQ(history.lowerBound(SmallHistory::Raw, 2000), 10u);
+}
+
+class TrendGraphTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    graph = new TrendGraph();
+    graph->setTimeSpan(10);
+  }
+
+  void TearDown() override {
+    delete graph;
+  }
+
+  TrendGraph* graph;
+  TrendGraph::PlotPoint points[TrendGraph::kMaxPoints];
+};
+
+TEST_F(TrendGraphTest, InitialValues) {
+  TrendGraph fresh;
+  EXPECT_EQ(fresh.timeSpan(), 60);
+  EXPECT_DOUBLE_EQ(fresh.minimum(), 0.0);
+  EXPECT_DOUBLE_EQ(fresh.maximum(), 100.0);
+  EXPECT_TRUE(fresh.history().isEmpty());
+  EXPECT_EQ(fresh.plot(0, points), 0);
+}
+
+TEST_F(TrendGraphTest, ValueChangesAreRecorded) {
+  QSignalSpy spy(graph, &TrendGraph::valueChanged);
+
+  graph->setValue(42.0);
+  graph->setValue(42.0);
+
+  EXPECT_DOUBLE_EQ(graph->value(), 42.0);
+  EXPECT_EQ(spy.count(), 1);
+  EXPECT_FALSE(graph->history().isEmpty());
+  EXPECT_FLOAT_EQ(graph->history().latest().value, 42.0f);
+}
+
+TEST_F(TrendGraphTest, NewestValueIsHeldToTheRightEdge) {
+  graph->appendSample(1000, 10.0);
+  graph->appendSample(2000, 20.0);
+
+  const int count = graph->plot(5000, points);
+  ASSERT_EQ(count, 3);
+  EXPECT_EQ(points[0].timeMs, 1000);
+  EXPECT_EQ(points[2].timeMs, 5000);
+  EXPECT_FLOAT_EQ(points[2].value, 20.0f);
+}
+
+TEST_F(TrendGraphTest, PlotIsBoundedAndStartsAtTheLeftEdge) {
+  // Ten minutes at 50 Hz: more than the raw tier holds and far more than can be drawn
+  for (int i = 0; i < 30000; ++i) {
+    graph->appendSample(i * 20, std::sin(i / 100.0) * 50.0 + 50.0);
+  }
+  const qint64 now = 30000 * 20;
+
+  const int count = graph->plot(now, points);
+  EXPECT_LE(count, TrendGraph::kMaxPoints);
+  EXPECT_GT(count, TrendGraph::kMaxPoints / 2);
+
+  // The line enters from just outside the time span and ends at now
+  EXPECT_LE(points[0].timeMs, now - 10000);
+  EXPECT_GT(points[0].timeMs, now - 11000);
+  EXPECT_EQ(points[count - 1].timeMs, now);
+
+  // A longer span switches to the coarser tiers
+  graph->setTimeSpan(600);
+  const int coarse = graph->plot(now, points);
+  EXPECT_LE(coarse, TrendGraph::kMaxPoints);
+  EXPECT_LE(points[0].timeMs, now - 600000 + 60000);
+}
+
+TEST_F(TrendGraphTest, RawColumnsKeepPeaksWithoutEnvelope) {
+  // 100 Hz, far more samples than columns, with a single-sample spike
+  for (int i = 0; i < 500; ++i) {
+    graph->appendSample(i * 10, i == 250 ? 100.0 : 0.0);
+  }
+
+  const int count = graph->plot(5000, points);
+  ASSERT_LT(count, 500);
+  bool peakKept = false;
+  for (int i = 0; i < count; ++i) {
+    peakKept = peakKept || points[i].value == 100.0f;
+    EXPECT_FLOAT_EQ(points[i].min, points[i].value);
+    EXPECT_FLOAT_EQ(points[i].max, points[i].value);
+    if (i > 0) {
+      EXPECT_GT(points[i].timeMs, points[i - 1].timeMs);
+    }
+  }
+  EXPECT_TRUE(peakKept);
+}
+
+TEST_F(TrendGraphTest, BucketedTiersDrawTheirEnvelope) {
+  // Oscillating within each second, so every 1 s bucket has a range around its mean
+  graph->setTimeSpan(600);
+  for (int i = 0; i < 30000; ++i) {
+    graph->appendSample(i * 20, i % 2 == 0 ? 40.0 : 60.0);
+  }
+
+  const int count = graph->plot(30000 * 20, points);
+  ASSERT_GT(count, 2);
+  for (int i = 0; i < count - 1; ++i) {
+    EXPECT_FLOAT_EQ(points[i].min, 40.0f);
+    EXPECT_FLOAT_EQ(points[i].max, 60.0f);
+    EXPECT_FLOAT_EQ(points[i].value, 50.0f);
+  }
+}
+
+TEST_F(TrendGraphTest, IncrementalColumnsMatchARebuild) {
+  for (int i = 0; i < 20000; ++i) {
+    graph->appendSample(i * 15, std::sin(i / 50.0) * 50.0 + 50.0);
+  }
+  const qint64 now = 20000 * 15;
+  const int count = graph->plot(now, points);
+
+  // Changing the time span folds the whole history again
+  TrendGraph::PlotPoint rebuilt[TrendGraph::kMaxPoints];
+  graph->setTimeSpan(20);
+  graph->setTimeSpan(10);
+  ASSERT_EQ(graph->plot(now, rebuilt), count);
+  for (int i = 0; i < count; ++i) {
+    EXPECT_EQ(rebuilt[i].timeMs, points[i].timeMs);
+    EXPECT_FLOAT_EQ(rebuilt[i].value, points[i].value);
+  }
+}
+
+int main(int argc, char** argv) {
+  // Quick items need a GUI application; the offscreen platform keeps the test headless
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+  QGuiApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <cstdio>
+
+#include "ClusterDataSubscriber.hpp"
+#include "SignalStore.hpp"
+
+TEST(SignalStoreTest, RegistersCompactIds) {
+  SignalStore store;
+  QSignalSpy registered(&store, &SignalStore::signalRegistered);
+
+  EXPECT_EQ(store.registerSignal("motorTemperature", 20.0), 0);
+  EXPECT_EQ(store.registerSignal("motorCurrent"), 1);
+  EXPECT_EQ(store.registerSignal("motorTemperature"), 0);
+  EXPECT_EQ(registered.count(), 2);
+
+  EXPECT_EQ(store.count(), 2);
+  EXPECT_EQ(store.idOf("motorCurrent"), 1);
+  EXPECT_EQ(store.idOf("steeringAngle"), SignalStore::kInvalidSignal);
+  EXPECT_EQ(store.nameOf(0), "motorTemperature");
+  EXPECT_DOUBLE_EQ(store.value(0), 20.0);
+}
+
+TEST(SignalStoreTest, RefusesSignalsBeyondItsCapacity) {
+  SignalStore store;
+  for (int i = 0; i < SignalStore::kMaxSignals; ++i) {
+    ASSERT_EQ(store.registerSignal(QString("wheel%1").arg(i)), i);
+  }
+  EXPECT_EQ(store.registerSignal("oneTooMany"), SignalStore::kInvalidSignal);
+  EXPECT_EQ(store.registerSignal("wheel7"), 7);
+  EXPECT_FALSE(store.set(SignalStore::kInvalidSignal, 1.0));
+}
+
+TEST(SignalStoreTest, CoalescesChangesUntilTheFlush) {
+  SignalStore store;
+  const SignalStore::SignalId temperature = store.registerSignal("motorTemperature");
+  const SignalStore::SignalId current = store.registerSignal("motorCurrent");
+  const SignalStore::SignalId steering = store.registerSignal("steeringAngle");
+  QSignalSpy changed(&store, &SignalStore::valueChanged);
+
+  for (int i = 1; i <= 100; ++i) {
+    EXPECT_TRUE(store.set(temperature, 40.0 + i * 0.5));
+  }
+  EXPECT_TRUE(store.set(steering, -12.5));
+  EXPECT_FALSE(store.set(current, 0.0));
+  EXPECT_TRUE(store.hasPendingChanges());
+  EXPECT_EQ(changed.count(), 0);
+
+  // The event loop announces each changed signal once, with its newest value
+  QCoreApplication::processEvents();
+  EXPECT_FALSE(store.hasPendingChanges());
+  ASSERT_EQ(changed.count(), 2);
+  EXPECT_EQ(changed.at(0).at(0).value<SignalStore::SignalId>(), temperature);
+  EXPECT_DOUBLE_EQ(changed.at(0).at(1).toDouble(), 90.0);
+  EXPECT_EQ(changed.at(1).at(0).value<SignalStore::SignalId>(), steering);
+  EXPECT_EQ(store.updateCount(), 101);
+
+  // Nothing left to announce
+  store.flush();
+  EXPECT_EQ(changed.count(), 2);
+}
+
+TEST(SignalStoreTest, PropertyMapFollowsTheStore) {
+  SignalStore store;
+  const SignalStore::SignalId temperature = store.registerSignal("motorTemperature", 20.0);
+  SignalPropertyMap map(&store);
+  EXPECT_DOUBLE_EQ(map.value("motorTemperature").toDouble(), 20.0);
+
+  const SignalStore::SignalId current = store.registerSignal("motorCurrent", 3.0);
+  EXPECT_DOUBLE_EQ(map.value("motorCurrent").toDouble(), 3.0);
+
+  // Changes reach the map with the flush
+  store.set(temperature, 21.5);
+  store.set(current, 4.0);
+  EXPECT_DOUBLE_EQ(map.value("motorTemperature").toDouble(), 20.0);
+  store.flush();
+  EXPECT_DOUBLE_EQ(map.value("motorTemperature").toDouble(), 21.5);
+  EXPECT_DOUBLE_EQ(map.value("motorCurrent").toDouble(), 4.0);
+  EXPECT_EQ(map.count(), store.count());
+}
+
+TEST(SignalStoreTest, ModelPropertiesAreViewsOnTheStore) {
+  ClusterModel model;
+  SignalStore& store = model.signalStore();
+  QSignalSpy speedChanged(&model, &ClusterModel::speedChanged);
+
+  model.setSpeed(123);
+  EXPECT_EQ(speedChanged.count(), 1);
+  EXPECT_DOUBLE_EQ(store.value(store.idOf("speed")), 123.0);
+  model.setLaneSide(ClusterModel::RightLane);
+  EXPECT_DOUBLE_EQ(store.value(store.idOf("laneSide")), ClusterModel::RightLane);
+  EXPECT_DOUBLE_EQ(store.value(store.idOf("battery")), 100.0);
+
+  // Property values are only written through their setters
+  EXPECT_EQ(model.registerVehicleSignal("speed"), SignalStore::kInvalidSignal);
+  EXPECT_NE(model.registerVehicleSignal("motorTemperature"), SignalStore::kInvalidSignal);
+
+  store.flush();
+  EXPECT_EQ(model.vehicleSignals()->value("speed").toInt(), 123);
+}
+
+TEST(SignalStoreTest, SubscriberStoresUnknownNumericKeys) {
+  ClusterModel model;
+  ClusterSignalHub hub;
+  ClusterDataSubscriber subscriber(&model, &hub);
+
+  hub.dispatchMessage("speed:1000;motorTemp:41.5;gear:D;wheelFL:2780");
+  EXPECT_EQ(model.speed(), 36);
+
+  const SignalStore& store = model.signalStore();
+  ASSERT_NE(store.idOf("motorTemp"), SignalStore::kInvalidSignal);
+  EXPECT_DOUBLE_EQ(store.value(store.idOf("motorTemp")), 41.5);
+  EXPECT_DOUBLE_EQ(store.value(store.idOf("wheelFL")), 2780.0);
+  EXPECT_EQ(store.idOf("gear"), SignalStore::kInvalidSignal);
+
+  QCoreApplication::processEvents();
+  EXPECT_DOUBLE_EQ(model.vehicleSignals()->value("motorTemp").toDouble(), 41.5);
+}
+
+TEST(SignalStoreTest, SustainsHighUpdateRates) {
+  SignalStore store;
+  SignalPropertyMap map(&store);
+  constexpr int kSignals = 300;
+  for (int i = 0; i < kSignals; ++i) {
+    store.registerSignal(QString("signal%1").arg(i));
+  }
+
+  // One second of 300 signals at 200 Hz, with the notifications of a 60 Hz display
+  constexpr int kUpdates = 60000;
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < kUpdates; ++i) {
+    store.set(static_cast<SignalStore::SignalId>(i % kSignals), i + 1);
+    if (i % (kUpdates / 60) == 0) {
+      store.flush();
+    }
+  }
+  store.flush();
+  const qint64 elapsedNs = timer.nsecsElapsed();
+
+  EXPECT_EQ(store.updateCount(), kUpdates);
+  EXPECT_EQ(map.value("signal7").toInt(), kUpdates - kSignals + 8);
+  const double nsPerUpdate = static_cast<double>(elapsedNs) / kUpdates;
+  std::printf("Signal store: %d updates, %.1f ns per update\n", kUpdates, nsPerUpdate);
+  // Generous bound for debug and coverage builds: a 60000 updates per second budget is 16 us each
+  EXPECT_LT(nsPerUpdate, 2000.0);
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
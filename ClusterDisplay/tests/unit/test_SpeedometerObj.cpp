@@ -115,6 +115,28 @@ TEST_F(SpeedometerObjTest, ConversionFromMmSToKmH) {
   EXPECT_EQ(spy.count(), 3);
 }
 
+TEST_F(SpeedometerObjTest, UpdatesFromSignalHub) {
+  ClusterSignalHub hub;
+  SpeedometerObj hubSpeedometer(&hub);
+  QSignalSpy spy(&hubSpeedometer, &SpeedometerObj::speedChanged);
+
+  // 27778 mm/s is 100 km/h, shown as 1000
+  hub.dispatchMessage("speed:27778;battery:50");
+
+  EXPECT_EQ(hubSpeedometer.speed(), 1000);
+  EXPECT_EQ(spy.count(), 1);
+}
+
+TEST_F(SpeedometerObjTest, UnsubscribesFromSignalHub) {
+  ClusterSignalHub hub;
+  {
+    SpeedometerObj hubSpeedometer(&hub);
+    EXPECT_EQ(hub.listenerCount("speed"), 1);
+  }
+  EXPECT_EQ(hub.listenerCount("speed"), 0);
+  EXPECT_NO_THROW(hub.dispatchMessage("speed:1000"));
+}
+
 int main(int argc, char** argv) {
   QCoreApplication app(argc, argv);
   ::testing::InitGoogleTest(&argc, argv);
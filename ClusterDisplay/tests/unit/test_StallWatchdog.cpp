@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <chrono>
+#include <thread>
+
+#include "StallWatchdog.hpp"
+
+class StallWatchdogTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(directory.isValid());
+    recorder.setDumpDirectory(directory.path());
+    watchdog = new StallWatchdog(&recorder, 100);
+  }
+
+  void TearDown() override {
+    delete watchdog;
+  }
+
+  /// Keep the GUI thread responsive for a while
+  void processEventsFor(int milliseconds) {
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < milliseconds) {
+      QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+  }
+
+  QTemporaryDir directory;
+  FlightRecorder recorder{256};
+  StallWatchdog* watchdog;
+};
+
+TEST_F(StallWatchdogTest, InitialState) {
+  EXPECT_FALSE(watchdog->isRunning());
+  EXPECT_EQ(watchdog->thresholdMs(), 100);
+  EXPECT_EQ(watchdog->stallCount(), 0);
+}
+
+TEST_F(StallWatchdogTest, StartAndStop) {
+  watchdog->start();
+  EXPECT_TRUE(watchdog->isRunning());
+  watchdog->stop();
+  EXPECT_FALSE(watchdog->isRunning());
+
+  // Stopping twice is harmless
+  watchdog->stop();
+  EXPECT_FALSE(watchdog->isRunning());
+}
+
+TEST_F(StallWatchdogTest, ResponsiveThreadsAreNotReported) {
+  watchdog->start();
+  processEventsFor(400);
+
+  // Render frames well below the threshold
+  for (int i = 0; i < 5; ++i) {
+    watchdog->renderFrameStarted();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    watchdog->renderFrameFinished();
+  }
+  processEventsFor(200);
+
+  EXPECT_EQ(watchdog->stallCount(), 0);
+}
+
+TEST_F(StallWatchdogTest, BlockedGuiThreadIsReportedOnceAndDumped) {
+  QSignalSpy spy(watchdog, &StallWatchdog::stallDetected);
+  watchdog->start();
+  processEventsFor(50);
+
+  // Block the GUI thread well beyond the threshold
+  std::this_thread::sleep_for(std::chrono::milliseconds(400));
+  processEventsFor(100);
+
+  EXPECT_EQ(watchdog->stallCount(), 1);
+  ASSERT_EQ(spy.count(), 1);
+  EXPECT_EQ(spy.at(0).at(0).value<StallWatchdog::Channel>(), StallWatchdog::GuiThread);
+  EXPECT_GE(spy.at(0).at(1).toLongLong(), 100);
+
+  const QString dumpPath = spy.at(0).at(2).toString();
+  EXPECT_EQ(dumpPath, recorder.dumpPath("gui-stall"));
+  EXPECT_TRUE(QFile::exists(dumpPath));
+  EXPECT_EQ(recorder.snapshot().last().type, FlightRecorder::Stall);
+}
+
+TEST_F(StallWatchdogTest, LongRenderFrameIsReported) {
+  QSignalSpy spy(watchdog, &StallWatchdog::stallDetected);
+  watchdog->start();
+
+  watchdog->renderFrameStarted();
+  processEventsFor(300);
+  watchdog->renderFrameFinished();
+  processEventsFor(50);
+
+  ASSERT_EQ(spy.count(), 1);
+  EXPECT_EQ(spy.at(0).at(0).value<StallWatchdog::Channel>(), StallWatchdog::RenderThread);
+  EXPECT_TRUE(QFile::exists(recorder.dumpPath("render-stall")));
+
+  // The finished frame is recorded with its duration
+  const FlightRecorder::Event last = recorder.snapshot().last();
+  EXPECT_EQ(last.type, FlightRecorder::FrameSwapped);
+  EXPECT_GE(last.a, 300000);
+}
+
+TEST_F(StallWatchdogTest, IdleRenderThreadIsNotReported) {
+  watchdog->start();
+  watchdog->renderFrameStarted();
+  watchdog->renderFrameFinished();
+  processEventsFor(300);
+
+  EXPECT_EQ(watchdog->stallCount(), 0);
+}
+
+TEST_F(StallWatchdogTest, SyncWithoutRenderIsNotReported) {
+  watchdog->start();
+
+  // Nothing changed in the scene: the synchronization is not followed by a render pass or a swap
+  watchdog->renderSyncStarted();
+  watchdog->renderSyncFinished();
+  processEventsFor(300);
+
+  EXPECT_EQ(watchdog->stallCount(), 0);
+}
+
+TEST_F(StallWatchdogTest, LongSyncIsReported) {
+  QSignalSpy spy(watchdog, &StallWatchdog::stallDetected);
+  watchdog->start();
+
+  watchdog->renderSyncStarted();
+  processEventsFor(300);
+  watchdog->renderSyncFinished();
+  processEventsFor(50);
+
+  ASSERT_EQ(spy.count(), 1);
+  EXPECT_EQ(spy.at(0).at(0).value<StallWatchdog::Channel>(), StallWatchdog::RenderThread);
+}
+
+TEST_F(StallWatchdogTest, FrameIsTimedFromItsSync) {
+  watchdog->start();
+
+  watchdog->renderSyncStarted();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  watchdog->renderSyncFinished();
+  watchdog->renderFrameStarted();
+  watchdog->renderFrameFinished();
+
+  const FlightRecorder::Event last = recorder.snapshot().last();
+  EXPECT_EQ(last.type, FlightRecorder::FrameSwapped);
+  EXPECT_GE(last.a, 20000);
+  EXPECT_EQ(watchdog->stallCount(), 0);
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
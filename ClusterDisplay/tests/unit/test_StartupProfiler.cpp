@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QSignalSpy>
+
+#include "StartupProfiler.hpp"
+
+class StartupProfilerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    profiler = new StartupProfiler();
+  }
+
+  void TearDown() override {
+    delete profiler;
+  }
+
+  StartupProfiler* profiler;
+};
+
+TEST_F(StartupProfilerTest, InitialState) {
+  EXPECT_FALSE(profiler->isComplete());
+  EXPECT_TRUE(profiler->milestones().isEmpty());
+}
+
+TEST_F(StartupProfilerTest, MilestonesAreChronological) {
+  profiler->mark("Application created");
+  profiler->mark("QML engine created");
+  profiler->mark("Critical QML loaded");
+
+  const auto& milestones = profiler->milestones();
+  ASSERT_EQ(milestones.size(), 3);
+  EXPECT_EQ(milestones.at(0).name, "Application created");
+  EXPECT_EQ(milestones.at(2).name, "Critical QML loaded");
+  EXPECT_LE(milestones.at(0).elapsedNs, milestones.at(1).elapsedNs);
+  EXPECT_LE(milestones.at(1).elapsedNs, milestones.at(2).elapsedNs);
+}
+
+TEST_F(StartupProfilerTest, FirstFrameCompletesReport) {
+  QSignalSpy frameSpy(profiler, &StartupProfiler::firstFrameRendered);
+  QSignalSpy reportSpy(profiler, &StartupProfiler::reportReady);
+
+  profiler->mark("Critical QML loaded");
+  profiler->markFirstFrame();
+
+  EXPECT_TRUE(profiler->isComplete());
+  EXPECT_EQ(frameSpy.count(), 1);
+  ASSERT_EQ(reportSpy.count(), 1);
+
+  // The report lists every phase in order, ending with the first frame
+  QString report = reportSpy.at(0).at(0).toString();
+  EXPECT_TRUE(report.contains("Critical QML loaded"));
+  EXPECT_TRUE(report.contains("First frame presented"));
+  EXPECT_LT(report.indexOf("Critical QML loaded"), report.indexOf("First frame presented"));
+}
+
+TEST_F(StartupProfilerTest, FirstFrameIsRecordedOnce) {
+  QSignalSpy frameSpy(profiler, &StartupProfiler::firstFrameRendered);
+
+  profiler->markFirstFrame();
+  profiler->markFirstFrame();
+
+  EXPECT_EQ(frameSpy.count(), 1);
+  EXPECT_EQ(profiler->milestones().size(), 1);
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "StateSnapshot.hpp"
+#include "WriteThrottle.hpp"
+
+class StateSnapshotTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(directory.isValid());
+    path = directory.filePath("state/" + StateSnapshot::defaultFileName());
+  }
+
+  /// Writes a snapshot of the given values and closes it again
+  void persist(int battery, int odometer, ClusterModel::DrivingMode mode) {
+    ClusterModel model;
+    StateSnapshot snapshot(&model, 0);
+    ASSERT_TRUE(snapshot.open(path));
+    model.setBattery(battery);
+    model.setOdometer(odometer);
+    model.setDrivingModeType(mode);
+    snapshot.flush();
+  }
+
+  /// Overwrites one byte of the file
+  void corrupt(qint64 offset) {
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    file.seek(offset);
+    char byte = 0;
+    file.getChar(&byte);
+    file.seek(offset);
+    file.putChar(static_cast<char>(byte ^ 0x5a));
+  }
+
+  QTemporaryDir directory;
+  QString path;
+};
+
+TEST_F(StateSnapshotTest, CreatesEmptyFile) {
+  ClusterModel model;
+  StateSnapshot snapshot(&model);
+  EXPECT_FALSE(snapshot.isOpen());
+  EXPECT_FALSE(snapshot.restore());
+
+  ASSERT_TRUE(snapshot.open(path));
+  EXPECT_TRUE(snapshot.isOpen());
+  EXPECT_TRUE(QFile::exists(path));
+  EXPECT_EQ(snapshot.sequence(), 0u);
+
+  // Nothing valid to restore: the model keeps its defaults
+  EXPECT_FALSE(snapshot.restore());
+  EXPECT_EQ(model.battery(), 100);
+  EXPECT_EQ(model.provisionalFields(), ClusterModel::NoProvisionalField);
+}
+
+TEST_F(StateSnapshotTest, RestoresPersistedValues) {
+  persist(37, 12345, ClusterModel::AutoMode);
+
+  ClusterModel model;
+  StateSnapshot snapshot(&model);
+  ASSERT_TRUE(snapshot.open(path));
+  ASSERT_TRUE(snapshot.restore());
+
+  EXPECT_EQ(model.battery(), 37);
+  EXPECT_EQ(model.odometer(), 12345);
+  EXPECT_EQ(model.drivingModeType(), ClusterModel::AutoMode);
+  EXPECT_EQ(model.speedLimitSignal(), 50);
+  EXPECT_TRUE(model.provisionalFields().testFlag(ClusterModel::BatteryField));
+  EXPECT_TRUE(model.provisionalFields().testFlag(ClusterModel::OdometerField));
+  EXPECT_TRUE(model.provisionalFields().testFlag(ClusterModel::DrivingModeField));
+
+  // Restoring does not write the same values back
+  QCoreApplication::processEvents();
+  EXPECT_EQ(snapshot.writeCount(), 0);
+}
+
+TEST_F(StateSnapshotTest, LiveDataConfirmsRestoredValues) {
+  persist(37, 12345, ClusterModel::ManualMode);
+
+  ClusterModel model;
+  StateSnapshot snapshot(&model);
+  ASSERT_TRUE(snapshot.open(path));
+  ASSERT_TRUE(snapshot.restore());
+  QSignalSpy spy(&model, &ClusterModel::provisionalFieldsChanged);
+
+  // An unchanged value still confirms the field
+  model.setBattery(37);
+  EXPECT_FALSE(model.provisionalFields().testFlag(ClusterModel::BatteryField));
+  EXPECT_TRUE(model.provisionalFields().testFlag(ClusterModel::OdometerField));
+
+  model.setOdometer(12346);
+  EXPECT_FALSE(model.provisionalFields().testFlag(ClusterModel::OdometerField));
+  EXPECT_EQ(spy.count(), 2);
+}
+
+TEST_F(StateSnapshotTest, KeepsNewestOfBothSlots) {
+  persist(80, 100, ClusterModel::ManualMode);
+  persist(70, 200, ClusterModel::ManualMode);
+  persist(60, 300, ClusterModel::ManualMode);
+
+  ClusterModel model;
+  StateSnapshot snapshot(&model);
+  ASSERT_TRUE(snapshot.open(path));
+  EXPECT_EQ(snapshot.sequence(), 3u);
+  ASSERT_TRUE(snapshot.restore());
+  EXPECT_EQ(model.battery(), 60);
+  EXPECT_EQ(model.odometer(), 300);
+}
+
+TEST_F(StateSnapshotTest, FallsBackToOlderSlotWhenNewestIsCorrupt) {
+  persist(80, 100, ClusterModel::ManualMode); // Sequence 1, second slot
+  persist(70, 200, ClusterModel::ManualMode); // Sequence 2, first slot
+
+  // A write torn by a power loss leaves the previous slot intact
+  corrupt(20);
+
+  ClusterModel model;
+  StateSnapshot snapshot(&model);
+  ASSERT_TRUE(snapshot.open(path));
+  ASSERT_TRUE(snapshot.restore());
+  EXPECT_EQ(model.battery(), 80);
+  EXPECT_EQ(model.odometer(), 100);
+}
+
+TEST_F(StateSnapshotTest, RejectsCorruptSnapshot) {
+  persist(80, 100, ClusterModel::ManualMode);
+  corrupt(512 + 20);
+
+  ClusterModel model;
+  StateSnapshot snapshot(&model);
+  ASSERT_TRUE(snapshot.open(path));
+  EXPECT_FALSE(snapshot.restore());
+  EXPECT_EQ(model.battery(), 100);
+  EXPECT_EQ(model.odometer(), 0);
+}
+
+TEST_F(StateSnapshotTest, CoalescesWritesWithinInterval) {
+  ClusterModel model;
+  StateSnapshot snapshot(&model, 200);
+  ASSERT_TRUE(snapshot.open(path));
+  QSignalSpy spy(&snapshot, &StateSnapshot::written);
+
+  // The first change is written on the next event loop pass
+  model.setOdometer(1);
+  ASSERT_TRUE(spy.wait(100));
+  EXPECT_EQ(snapshot.writeCount(), 1);
+
+  // Everything within the interval ends up in one write
+  for (int odometer = 2; odometer <= 50; ++odometer) {
+    model.setOdometer(odometer);
+  }
+  model.setBattery(42);
+  EXPECT_FALSE(spy.wait(100));
+  ASSERT_TRUE(spy.wait(500));
+  EXPECT_EQ(snapshot.writeCount(), 2);
+
+  ClusterModel restored;
+  StateSnapshot reader(&restored);
+  ASSERT_TRUE(reader.open(path));
+  ASSERT_TRUE(reader.restore());
+  EXPECT_EQ(restored.odometer(), 50);
+  EXPECT_EQ(restored.battery(), 42);
+}
+
+TEST_F(StateSnapshotTest, IgnoresLiveOnlyValues) {
+  ClusterModel model;
+  StateSnapshot snapshot(&model, 0);
+  ASSERT_TRUE(snapshot.open(path));
+  snapshot.flush();
+  const int writes = snapshot.writeCount();
+
+  model.setSpeed(120);
+  model.setEmergencyBrakeActive(true);
+  QCoreApplication::processEvents();
+  snapshot.flush();
+  EXPECT_EQ(snapshot.writeCount(), writes);
+}
+
+TEST_F(StateSnapshotTest, FlushesOnDestruction) {
+  {
+    ClusterModel model;
+    StateSnapshot snapshot(&model, 60000);
+    ASSERT_TRUE(snapshot.open(path));
+    model.setOdometer(1);
+    snapshot.flush();
+
+    // Pending until the interval has passed, but written when the snapshot goes away
+    model.setOdometer(2);
+  }
+
+  ClusterModel model;
+  StateSnapshot snapshot(&model);
+  ASSERT_TRUE(snapshot.open(path));
+  ASSERT_TRUE(snapshot.restore());
+  EXPECT_EQ(model.odometer(), 2);
+}
+
+TEST(WriteThrottleTest, FoldsRequestsIntoOneWritePerInterval) {
+  WriteThrottle throttle(200);
+  QSignalSpy spy(&throttle, &WriteThrottle::due);
+
+  // Nothing written yet: due on the next event loop pass
+  throttle.request();
+  ASSERT_TRUE(spy.wait(100));
+  throttle.markWritten();
+
+  throttle.request();
+  throttle.request();
+  EXPECT_FALSE(spy.wait(100));
+  ASSERT_TRUE(spy.wait(500));
+  EXPECT_EQ(spy.count(), 2);
+  throttle.markWritten();
+
+  // A cancelled write is dropped, and after a reset the next one is due at once
+  throttle.request();
+  throttle.cancel();
+  throttle.reset();
+  throttle.request();
+  ASSERT_TRUE(spy.wait(100));
+  EXPECT_EQ(spy.count(), 3);
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
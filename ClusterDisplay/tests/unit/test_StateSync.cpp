@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QSignalSpy>
+
+#include "ClusterDataSubscriber.hpp"
+#include "ClusterModel.hpp"
+#include "ClusterSignalHub.hpp"
+#include "StandInPublisher.hpp"
+
+namespace {
+
+/// Unreachable snapshot endpoint for tests that feed the snapshot by hand
+const QString kNoPublisher = QStringLiteral("tcp://127.0.0.1:1");
+
+/**
+ * @brief Process events until a condition holds or the timeout expires
+ */
+template <typename Condition>
+bool waitFor(Condition condition, int timeoutMs = 2000) {
+  QElapsedTimer timer;
+  timer.start();
+  while (!condition() && timer.elapsed() < timeoutMs) {
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+  }
+  return condition();
+}
+
+} // namespace
+
+/**
+ * @brief Sequence handling of the late-join synchronization, fed directly through the hub
+ */
+class StateSyncTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    subscriber = new ClusterDataSubscriber(&model, &hub);
+  }
+
+  void TearDown() override {
+    delete subscriber;
+  }
+
+  ClusterModel model;
+  ClusterSignalHub hub;
+  ClusterDataSubscriber* subscriber;
+};
+
+TEST_F(StateSyncTest, ProcessesFramesWithoutSynchronization) {
+  EXPECT_EQ(subscriber->syncState(), ClusterDataSubscriber::Unsynchronized);
+
+  hub.dispatchMessage("nseq:3;odo:30");
+  EXPECT_EQ(model.odometer(), 30);
+
+  // A snapshot that was not requested is ignored
+  subscriber->applySnapshot("cseq:1;nseq:9;odo:90");
+  EXPECT_EQ(model.odometer(), 30);
+}
+
+TEST_F(StateSyncTest, HoldsBackFramesUntilSnapshot) {
+  QSignalSpy syncSpy(subscriber, &ClusterDataSubscriber::stateSynchronized);
+  subscriber->synchronize(kNoPublisher, 10000);
+  EXPECT_EQ(subscriber->syncState(), ClusterDataSubscriber::AwaitingSnapshot);
+
+  hub.dispatchMessage("nseq:5;odo:50");
+  hub.dispatchMessage("nseq:8;odo:80");
+  EXPECT_EQ(model.odometer(), 0);
+
+  // The first frame is covered by the snapshot, the second one is newer
+  subscriber->applySnapshot("cseq:10;nseq:7;odo:70;battery:40;mode:1");
+  EXPECT_EQ(subscriber->syncState(), ClusterDataSubscriber::Synchronized);
+  EXPECT_EQ(syncSpy.count(), 1);
+  EXPECT_EQ(model.odometer(), 80);
+  EXPECT_EQ(model.battery(), 40);
+  EXPECT_EQ(model.drivingModeType(), ClusterModel::AutoMode);
+}
+
+TEST_F(StateSyncTest, DropsFramesCoveredBySnapshot) {
+  subscriber->synchronize(kNoPublisher, 10000);
+  subscriber->applySnapshot("cseq:10;nseq:7;speed:1000;odo:70");
+
+  // Stale frames still in flight
+  hub.dispatchMessage("cseq:9;speed:0");
+  hub.dispatchMessage("nseq:7;odo:60");
+  EXPECT_EQ(model.odometer(), 70);
+  EXPECT_EQ(model.speed(), 36);
+
+  // Newer frames, and frames without a sequence number, are applied
+  hub.dispatchMessage("nseq:8;odo:71");
+  hub.dispatchMessage("speed:2000");
+  EXPECT_EQ(model.odometer(), 71);
+  EXPECT_EQ(model.speed(), 72);
+
+  // Once a channel is past the snapshot, a lower number means the publisher restarted
+  hub.dispatchMessage("nseq:1;odo:5");
+  EXPECT_EQ(model.odometer(), 5);
+}
+
+TEST_F(StateSyncTest, SafetyFramesAreNotHeldBack) {
+  hub.setPriorityKeys({"obs"});
+  subscriber->synchronize(kNoPublisher, 10000);
+
+  hub.dispatchPriorityMessage("cseq:12;obs:2");
+  EXPECT_TRUE(model.emergencyBrakeActive());
+
+  // The snapshot predates the alert; the held-back copy of the frame restores it
+  hub.dispatchMessage("cseq:12;obs:2");
+  subscriber->applySnapshot("cseq:11;nseq:0;obs:0");
+  EXPECT_TRUE(model.emergencyBrakeActive());
+}
+
+/**
+ * @brief Late join against a stand-in publisher over loopback
+ */
+class StateSyncLoopbackTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    hub.addSource(QString::fromStdString(publisher.endpoint(StandInPublisher::Critical)));
+    hub.addSource(QString::fromStdString(publisher.endpoint(StandInPublisher::NonCritical)));
+    subscriber = new ClusterDataSubscriber(&model, &hub);
+
+    // PUB drops frames until the subscription has arrived; probe until one gets through
+    int probes = 0;
+    const int listener = hub.subscribe("probe", [&probes](const QString&) { ++probes; });
+    connected = waitFor([this, &probes]() {
+      publisher.publish(StandInPublisher::Critical, "probe:1");
+      publisher.publish(StandInPublisher::NonCritical, "probe:1");
+      QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+      return probes >= 2;
+    });
+    hub.unsubscribe(listener);
+  }
+
+  void TearDown() override {
+    delete subscriber;
+  }
+
+  /// State of a drive already in progress before the display starts
+  void publishDriveState() {
+    publisher.publish(StandInPublisher::Critical, "speed:5000;mode:1");
+    publisher.publish(StandInPublisher::NonCritical, "battery:55;charging:0");
+    publisher.publish(StandInPublisher::NonCritical, "odo:12345");
+  }
+
+  StandInPublisher publisher;
+  ClusterModel model;
+  ClusterSignalHub hub;
+  ClusterDataSubscriber* subscriber;
+  bool connected;
+};
+
+TEST_F(StateSyncLoopbackTest, SnapshotShowsFullStateAfterOneRoundTrip) {
+  ASSERT_TRUE(connected);
+  publishDriveState();
+  QSignalSpy syncSpy(subscriber, &ClusterDataSubscriber::stateSynchronized);
+
+  QElapsedTimer timer;
+  timer.start();
+  subscriber->synchronize(QString::fromStdString(publisher.snapshotEndpoint()));
+  ASSERT_TRUE(waitFor([&syncSpy]() { return syncSpy.count() == 1; }));
+  const qint64 elapsedMs = timer.elapsed();
+
+  RecordProperty("time_to_valid_display_ms", static_cast<int>(elapsedMs));
+  EXPECT_LT(elapsedMs, 500);
+  EXPECT_EQ(model.battery(), 55);
+  EXPECT_EQ(model.odometer(), 12345);
+  EXPECT_EQ(model.speed(), 180);
+  EXPECT_EQ(model.drivingModeType(), ClusterModel::AutoMode);
+}
+
+TEST_F(StateSyncLoopbackTest, AppliesDeltasNewerThanSnapshot) {
+  ASSERT_TRUE(connected);
+  publishDriveState();
+  publisher.setReplyDelayMs(200);
+
+  subscriber->synchronize(QString::fromStdString(publisher.snapshotEndpoint()));
+  ASSERT_TRUE(waitFor([this]() { return publisher.snapshotRequests() == 1; }));
+
+  // Published after the snapshot was taken but received before it
+  publisher.publish(StandInPublisher::NonCritical, "odo:12346");
+  ASSERT_TRUE(waitFor([this]() {
+    return subscriber->syncState() == ClusterDataSubscriber::Synchronized;
+  }));
+  EXPECT_EQ(model.odometer(), 12346);
+  EXPECT_EQ(model.battery(), 55);
+
+  publisher.publish(StandInPublisher::NonCritical, "odo:12347");
+  EXPECT_TRUE(waitFor([this]() { return model.odometer() == 12347; }));
+}
+
+TEST_F(StateSyncLoopbackTest, FallsBackToLiveDataWithoutSnapshot) {
+  ASSERT_TRUE(connected);
+  publishDriveState();
+  publisher.setAnswering(false);
+
+  subscriber->synchronize(QString::fromStdString(publisher.snapshotEndpoint()), 50);
+  ASSERT_TRUE(waitFor([this]() {
+    return subscriber->syncState() == ClusterDataSubscriber::Unsynchronized;
+  }));
+  EXPECT_EQ(publisher.snapshotRequests(), 3);
+
+  // Without the snapshot the display only knows what is published from now on
+  EXPECT_EQ(model.odometer(), 0);
+  publisher.publish(StandInPublisher::NonCritical, "odo:12346");
+  EXPECT_TRUE(waitFor([this]() { return model.odometer() == 12346; }));
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+
+  // Every received frame is logged at debug level
+  QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
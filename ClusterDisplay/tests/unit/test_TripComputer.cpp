@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+
+#include "ClusterDataSubscriber.hpp"
+#include "StreamingStatistics.hpp"
+#include "TripComputer.hpp"
+
+TEST(RunningStatisticsTest, MatchesTheTwoPassResult) {
+  RunningStatistics statistics;
+  for (double value : {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0}) {
+    statistics.add(value);
+  }
+
+  EXPECT_EQ(statistics.count(), 8);
+  EXPECT_DOUBLE_EQ(statistics.mean(), 5.0);
+  EXPECT_DOUBLE_EQ(statistics.variance(), 4.0);
+  EXPECT_DOUBLE_EQ(statistics.standardDeviation(), 2.0);
+  EXPECT_DOUBLE_EQ(statistics.min(), 2.0);
+  EXPECT_DOUBLE_EQ(statistics.max(), 9.0);
+
+  statistics.reset();
+  EXPECT_EQ(statistics.count(), 0);
+  EXPECT_DOUBLE_EQ(statistics.variance(), 0.0);
+}
+
+TEST(RunningStatisticsTest, StableForLargeOffsets) {
+  // The naive sum of squares loses every digit of the variance here
+  RunningStatistics statistics;
+  for (int i = 0; i < 1000; ++i) {
+    statistics.add(1e9 + (i % 2 == 0 ? 1.0 : -1.0));
+  }
+  EXPECT_NEAR(statistics.variance(), 1.0, 1e-6);
+}
+
+TEST(WindowedMaximumTest, FollowsTheWindow) {
+  WindowedMaximum<16> window(10000, 1000);
+  window.add(0, 5.0);
+  window.add(2000, 9.0);
+  window.add(4000, 3.0);
+
+  EXPECT_DOUBLE_EQ(window.maximum(4000), 9.0);
+  // The 9 leaves the window; the 3 is the only value left
+  EXPECT_DOUBLE_EQ(window.maximum(13000), 3.0);
+  EXPECT_DOUBLE_EQ(window.maximum(20000), 0.0);
+}
+
+TEST(WindowedMaximumTest, ValuesOfOneSlotAreMerged) {
+  // A ring of two entries is enough when values share a slot
+  WindowedMaximum<2> window(1000, 1000);
+  for (int i = 0; i < 100; ++i) {
+    window.add(i, 100.0 - i);
+  }
+  window.add(500, 200.0);
+  EXPECT_DOUBLE_EQ(window.maximum(500), 200.0);
+  window.add(1000, 1.0);
+  EXPECT_DOUBLE_EQ(window.maximum(1500), 200.0);
+  EXPECT_DOUBLE_EQ(window.maximum(2100), 1.0);
+}
+
+TEST(TripComputerTest, StartsEmpty) {
+  TripComputer trip;
+
+  EXPECT_EQ(trip.tripCount(), 1);
+  EXPECT_EQ(trip.distance(), 0);
+  EXPECT_EQ(trip.movingTimeMs(), 0);
+  EXPECT_DOUBLE_EQ(trip.averageSpeed(), 0.0);
+  EXPECT_DOUBLE_EQ(trip.maxSpeed(), 0.0);
+  EXPECT_EQ(trip.energyUsed(), 0);
+  EXPECT_DOUBLE_EQ(trip.energyPerKilometer(), 0.0);
+}
+
+TEST(TripComputerTest, HeldSpeedIsIntegrated) {
+  TripComputer trip;
+  trip.addSpeed(0, 1000);
+  trip.addSpeed(10000, 3000);
+  // The publisher does not repeat an unchanged speed
+  trip.advance(20000);
+
+  EXPECT_EQ(trip.movingTimeMs(), 20000);
+  EXPECT_DOUBLE_EQ(trip.averageSpeed(), 2000.0);
+  EXPECT_DOUBLE_EQ(trip.maxSpeed(), 3000.0);
+  // 10 s at 1 m/s and 10 s at 3 m/s, without an odometer
+  EXPECT_EQ(trip.distance(), 40);
+}
+
+TEST(TripComputerTest, StandingStillIsNotMovingTime) {
+  TripComputer trip;
+  trip.addSpeed(0, 2000);
+  trip.addSpeed(5000, 0);
+  trip.advance(60000);
+
+  EXPECT_EQ(trip.movingTimeMs(), 5000);
+  EXPECT_DOUBLE_EQ(trip.averageSpeed(), 2000.0);
+}
+
+TEST(TripComputerTest, OdometerStepsAreTheDistance) {
+  TripComputer trip;
+  trip.addOdometer(0, 5000);
+  trip.addOdometer(1000, 5010);
+  trip.addOdometer(2000, 5025);
+  EXPECT_EQ(trip.distance(), 25);
+
+  // A restarted publisher counts from 0; an implausible jump is not driven distance
+  trip.addOdometer(3000, 0);
+  trip.addOdometer(4000, 5);
+  trip.addOdometer(5000, 900000);
+  trip.addOdometer(6000, 900002);
+  EXPECT_EQ(trip.distance(), 32);
+}
+
+TEST(TripComputerTest, OdometerContinuesTheIntegratedDistance) {
+  TripComputer trip;
+  trip.addSpeed(0, 1000);
+  trip.advance(500000);
+  EXPECT_EQ(trip.distance(), 500);
+
+  // The odometer starts late: its steps are added to the 500 m integrated so far
+  trip.addOdometer(500000, 12000);
+  EXPECT_EQ(trip.distance(), 500);
+  trip.addSpeed(501000, 1000);
+  trip.addOdometer(501000, 12001);
+  EXPECT_EQ(trip.distance(), 501);
+  trip.addSpeed(503000, 1000);
+  trip.addOdometer(503000, 12003);
+  EXPECT_EQ(trip.distance(), 503);
+}
+
+TEST(TripComputerTest, RecentMaximumForgetsOldPeaks) {
+  TripComputer trip;
+  trip.addSpeed(0, 5000);
+  trip.addSpeed(1000, 2000);
+
+  EXPECT_DOUBLE_EQ(trip.recentMaxSpeed(30000), 5000.0);
+  // The held 2000 mm/s is still current after the peak left the window
+  trip.advance(90000);
+  EXPECT_DOUBLE_EQ(trip.recentMaxSpeed(90000), 2000.0);
+  EXPECT_DOUBLE_EQ(trip.maxSpeed(), 5000.0);
+}
+
+TEST(TripComputerTest, EnergyCountsDropsWhileNotCharging) {
+  TripComputer trip;
+  trip.addBattery(0, 80);
+  trip.addBattery(1000, 79);
+  // Jitter up and down is counted once
+  trip.addBattery(2000, 80);
+  trip.addBattery(3000, 79);
+  trip.addBattery(4000, 75);
+  EXPECT_EQ(trip.energyUsed(), 5);
+
+  trip.setCharging(5000, true);
+  trip.addBattery(6000, 90);
+  trip.setCharging(7000, false);
+  trip.addBattery(8000, 88);
+  EXPECT_EQ(trip.energyUsed(), 7);
+
+  trip.addOdometer(0, 0);
+  trip.addOdometer(1000, 500);
+  trip.addOdometer(2000, 1000);
+  EXPECT_DOUBLE_EQ(trip.energyPerKilometer(), 7.0);
+}
+
+TEST(TripComputerTest, ResetStartsANewTripWhileDriving) {
+  TripComputer trip;
+  trip.addSpeed(0, 1000);
+  trip.addBattery(0, 50);
+  trip.addBattery(1000, 45);
+  trip.reset(10000);
+
+  EXPECT_EQ(trip.tripCount(), 2);
+  EXPECT_EQ(trip.movingTimeMs(), 0);
+  EXPECT_EQ(trip.energyUsed(), 0);
+
+  // The current speed keeps being integrated from the reset on
+  trip.advance(15000);
+  EXPECT_EQ(trip.movingTimeMs(), 5000);
+  EXPECT_EQ(trip.distance(), 5);
+}
+
+TEST(TripComputerTest, LongInterruptionIsANewIgnitionCycle) {
+  TripComputer trip(60000);
+  trip.addSpeed(0, 1000);
+  trip.interrupt(10000);
+  // Nothing is integrated while the link is down
+  trip.advance(20000);
+  EXPECT_EQ(trip.movingTimeMs(), 10000);
+
+  // A short outage continues the trip
+  trip.addSpeed(30000, 1000);
+  EXPECT_EQ(trip.tripCount(), 1);
+
+  trip.interrupt(40000);
+  trip.addSpeed(100000, 0);
+  EXPECT_EQ(trip.tripCount(), 2);
+  EXPECT_EQ(trip.movingTimeMs(), 0);
+}
+
+TEST(TripComputerTest, ModelShowsTheTripAndResetsOnRequest) {
+  ClusterModel model;
+  ClusterSignalHub hub;
+  ClusterDataSubscriber subscriber(&model, &hub);
+
+  hub.dispatchMessage("speed:1000;odo:100;battery:60");
+  hub.dispatchMessage("odo:150;battery:58");
+
+  EXPECT_EQ(model.tripDistance(), 50);
+  EXPECT_EQ(model.tripEnergyUsed(), 2);
+  EXPECT_EQ(model.tripMaxSpeed(), 36);
+  EXPECT_EQ(subscriber.tripComputer().tripCount(), 1);
+
+  model.resetTrip();
+  EXPECT_EQ(subscriber.tripComputer().tripCount(), 2);
+  EXPECT_EQ(model.tripDistance(), 0);
+  EXPECT_EQ(model.tripEnergyUsed(), 0);
+  EXPECT_EQ(model.tripMaxSpeed(), 0);
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <cstring>
+
+#include "ClusterModel.hpp"
+#include "TripLog.hpp"
+#include "TripLogWriter.hpp"
+
+using TripLog::Sample;
+
+namespace {
+
+constexpr quint16 kAll = (1u << TripLog::SignalCount) - 1;
+
+/**
+ * @brief Write a log of speed samples with one chunk per entry of speedChunks
+ */
+bool writeLog(const QString& path, const QVector<QVector<Sample>>& speedChunks) {
+  QFile file(path);
+  if (!QFileInfo(path).absoluteDir().mkpath(QStringLiteral(".")) ||
+      !file.open(QIODevice::WriteOnly)) {
+    return false;
+  }
+  TripLog::FileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic = TripLog::kFileMagic;
+  header.version = TripLog::kVersion;
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  for (const QVector<Sample>& samples : speedChunks) {
+    QVector<Sample> columns[TripLog::SignalCount];
+    columns[TripLog::Speed] = samples;
+    const QByteArray payload = qCompress(TripLog::encodeColumns(columns, samples.first().timeMs));
+
+    TripLog::ChunkHeader chunk;
+    std::memset(&chunk, 0, sizeof(chunk));
+    chunk.magic = TripLog::kChunkMagic;
+    chunk.payloadSize = static_cast<quint32>(payload.size());
+    chunk.sampleCount = static_cast<quint32>(samples.size());
+    chunk.signalMask = 1u << TripLog::Speed;
+    chunk.checksum = qChecksum(payload);
+    chunk.firstMs = samples.first().timeMs;
+    chunk.lastMs = samples.last().timeMs;
+    file.write(reinterpret_cast<const char*>(&chunk), sizeof(chunk));
+    file.write(payload);
+  }
+  return true;
+}
+
+} // namespace
+
+TEST(TripLogTest, ColumnsRoundTrip) {
+  QVector<Sample> columns[TripLog::SignalCount];
+  columns[TripLog::Speed] = {{10, 0}, {26, 125}, {43, 87}, {43, -300}};
+  columns[TripLog::Odometer] = {{5, 4000000000LL}, {900000, 4000000001LL}};
+  columns[TripLog::LinkStatus] = {{0, 2}};
+
+  const QByteArray payload = TripLog::encodeColumns(columns, 0);
+
+  QVector<Sample> decoded[TripLog::SignalCount];
+  ASSERT_TRUE(TripLog::decodeColumns(payload, 0, kAll, decoded));
+  for (int signal = 0; signal < TripLog::SignalCount; ++signal) {
+    ASSERT_EQ(decoded[signal].size(), columns[signal].size()) << signal;
+    for (int i = 0; i < columns[signal].size(); ++i) {
+      EXPECT_EQ(decoded[signal].at(i).timeMs, columns[signal].at(i).timeMs);
+      EXPECT_EQ(decoded[signal].at(i).value, columns[signal].at(i).value);
+    }
+  }
+
+  // Columns that are not wanted are skipped
+  QVector<Sample> linkOnly[TripLog::SignalCount];
+  ASSERT_TRUE(TripLog::decodeColumns(payload, 0, 1u << TripLog::LinkStatus, linkOnly));
+  EXPECT_TRUE(linkOnly[TripLog::Speed].isEmpty());
+  EXPECT_EQ(linkOnly[TripLog::LinkStatus].size(), 1);
+
+  // A cut payload is rejected
+  EXPECT_FALSE(TripLog::decodeColumns(payload.left(payload.size() - 1), 0, kAll, decoded));
+}
+
+TEST(TripLogTest, SlowlyChangingSignalsEncodeCompactly) {
+  QVector<Sample> columns[TripLog::SignalCount];
+  for (int i = 0; i < 3600; ++i) {
+    columns[TripLog::Speed].append({i * 16LL, 500 + (i % 40) - 20});
+  }
+  EXPECT_LE(TripLog::encodeColumns(columns, 0).size(), 3 * 3600);
+}
+
+TEST(TripLogTest, SignalNames) {
+  TripLog::Signal signal;
+  ASSERT_TRUE(TripLog::signalFromName("battery", &signal));
+  EXPECT_EQ(signal, TripLog::Battery);
+  EXPECT_STREQ(TripLog::signalName(TripLog::EstimatedRange), "range");
+  EXPECT_FALSE(TripLog::signalFromName("rpm", &signal));
+}
+
+class TripLogFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(directory.isValid());
+    path = directory.filePath("logs/" + TripLogWriter::defaultFileName());
+  }
+
+  QTemporaryDir directory;
+  QString path;
+};
+
+TEST_F(TripLogFileTest, ReadsTheRecordedChanges) {
+  ClusterModel model;
+  model.setBattery(80);
+  {
+    TripLogWriter writer(&model);
+    ASSERT_TRUE(writer.open(path));
+    EXPECT_TRUE(writer.isOpen());
+    model.setSpeed(150);
+    model.setSpeed(300);
+    model.setBattery(79);
+    writer.close();
+    EXPECT_FALSE(writer.isOpen());
+    EXPECT_EQ(writer.droppedCount(), 0);
+    EXPECT_EQ(writer.chunkCount(), 1);
+  }
+
+  TripLog::Reader reader;
+  ASSERT_TRUE(reader.open(path)) << qPrintable(reader.errorString());
+  ASSERT_EQ(reader.chunks().size(), 1);
+  EXPECT_GT(reader.startEpochMs(), 0);
+
+  QVector<Sample> columns[TripLog::SignalCount];
+  ASSERT_TRUE(reader.samples(kAll, 0, reader.endMs(), columns));
+
+  // The log starts with every value, followed by the changes
+  ASSERT_EQ(columns[TripLog::Speed].size(), 3);
+  EXPECT_EQ(columns[TripLog::Speed].at(0).value, 0);
+  EXPECT_EQ(columns[TripLog::Speed].at(1).value, 150);
+  EXPECT_EQ(columns[TripLog::Speed].at(2).value, 300);
+  ASSERT_EQ(columns[TripLog::Battery].size(), 2);
+  EXPECT_EQ(columns[TripLog::Battery].at(0).value, 80);
+  EXPECT_EQ(columns[TripLog::Battery].at(1).value, 79);
+  ASSERT_EQ(columns[TripLog::EstimatedRange].size(), 1);
+  EXPECT_EQ(columns[TripLog::EstimatedRange].at(0).value, -1);
+}
+
+TEST_F(TripLogFileTest, QueriesATimeRange) {
+  // Three one-minute chunks; the speed steps up by 1 every second
+  QVector<QVector<Sample>> chunks(3);
+  for (int second = 0; second < 180; ++second) {
+    chunks[second / 60].append({second * 1000LL, second});
+  }
+  ASSERT_TRUE(writeLog(path, chunks));
+
+  TripLog::Reader reader;
+  ASSERT_TRUE(reader.open(path));
+  ASSERT_EQ(reader.chunks().size(), 3);
+  EXPECT_EQ(reader.endMs(), 179000);
+
+  QVector<Sample> columns[TripLog::SignalCount];
+  ASSERT_TRUE(reader.samples(1u << TripLog::Speed, 59500, 61000, columns));
+  ASSERT_EQ(columns[TripLog::Speed].size(), 2);
+  EXPECT_EQ(columns[TripLog::Speed].at(0).value, 60);
+  EXPECT_EQ(columns[TripLog::Speed].at(1).value, 61);
+
+  qint64 value = 0;
+  ASSERT_TRUE(reader.valueAt(TripLog::Speed, 120999, &value));
+  EXPECT_EQ(value, 120);
+  EXPECT_FALSE(reader.valueAt(TripLog::Battery, 120999, &value));
+}
+
+TEST_F(TripLogFileTest, SummarizesTheHeldValue) {
+  // 100 for 9 s, then 0 for 1 s: the time-weighted mean is 90
+  ASSERT_TRUE(writeLog(path, {{{0, 100}, {9000, 0}, {10000, 0}}}));
+
+  TripLog::Reader reader;
+  ASSERT_TRUE(reader.open(path));
+  const TripLog::Summary summary = reader.summarize(TripLog::Speed, 0, 10000);
+  EXPECT_EQ(summary.count, 3);
+  EXPECT_EQ(summary.min, 0);
+  EXPECT_EQ(summary.max, 100);
+  EXPECT_NEAR(summary.mean, 33.33, 0.01);
+  EXPECT_DOUBLE_EQ(summary.timeWeighted, 90.0);
+
+  // The value held when the range starts counts from the start
+  const TripLog::Summary later = reader.summarize(TripLog::Speed, 5000, 10000);
+  EXPECT_EQ(later.count, 2);
+  EXPECT_DOUBLE_EQ(later.timeWeighted, 80.0);
+}
+
+TEST_F(TripLogFileTest, IgnoresATruncatedChunk) {
+  ASSERT_TRUE(writeLog(path, {{{0, 1}, {1000, 2}}, {{60000, 3}, {61000, 4}}}));
+  QFile file(path);
+  ASSERT_TRUE(file.resize(file.size() - 3));
+
+  TripLog::Reader reader;
+  ASSERT_TRUE(reader.open(path));
+  ASSERT_EQ(reader.chunks().size(), 1);
+  EXPECT_EQ(reader.endMs(), 1000);
+
+  QFile garbage(directory.filePath("garbage.ctl"));
+  ASSERT_TRUE(garbage.open(QIODevice::WriteOnly));
+  garbage.write("not a trip log at all");
+  garbage.close();
+  EXPECT_FALSE(reader.open(garbage.fileName()));
+}
+
+TEST_F(TripLogFileTest, RecordNeverBlocks) {
+  ClusterModel model;
+  TripLogWriter writer(&model);
+  ASSERT_TRUE(writer.open(path));
+
+  // A burst far beyond the ring: the excess is dropped and counted instead of waited for
+  const qint64 burst = 4 * TripLogWriter::kQueueCapacity;
+  for (qint64 i = 0; i < burst; ++i) {
+    writer.record(TripLog::Speed, i);
+  }
+  writer.close();
+  EXPECT_EQ(writer.recordedCount() + writer.droppedCount(), burst + TripLog::SignalCount);
+  EXPECT_GT(writer.droppedCount(), 0);
+  EXPECT_FALSE(writer.record(TripLog::Speed, 0));
+
+  TripLog::Reader reader;
+  ASSERT_TRUE(reader.open(path));
+  qint64 samples = 0;
+  for (const TripLog::Reader::ChunkInfo& chunk : reader.chunks()) {
+    samples += chunk.header.sampleCount;
+  }
+  EXPECT_EQ(samples, writer.recordedCount());
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <atomic>
+#include <thread>
+
+#include "TripleBuffer.hpp"
+
+namespace {
+
+/**
+ * @brief Value whose fields must always be seen together
+ */
+struct Pair {
+  int value;
+  int doubled;
+};
+
+} // namespace
+
+TEST(TripleBufferTest, InitialValueIsValueInitialized) {
+  TripleBuffer<Pair> buffer;
+  EXPECT_FALSE(buffer.hasNewData());
+  EXPECT_EQ(buffer.read().value, 0);
+  EXPECT_EQ(buffer.read().doubled, 0);
+}
+
+TEST(TripleBufferTest, ReadReturnsLatestPublishedValue) {
+  TripleBuffer<Pair> buffer;
+  buffer.write({1, 2});
+  EXPECT_TRUE(buffer.hasNewData());
+  EXPECT_EQ(buffer.read().value, 1);
+  EXPECT_FALSE(buffer.hasNewData());
+
+  // Values the reader did not pick up are skipped
+  buffer.write({2, 4});
+  buffer.write({3, 6});
+  EXPECT_EQ(buffer.read().value, 3);
+}
+
+TEST(TripleBufferTest, ReadKeepsValueWithoutNewData) {
+  TripleBuffer<Pair> buffer;
+  buffer.write({5, 10});
+  EXPECT_EQ(buffer.read().value, 5);
+
+  EXPECT_FALSE(buffer.update());
+  EXPECT_EQ(buffer.readBuffer().value, 5);
+  EXPECT_EQ(buffer.read().value, 5);
+}
+
+TEST(TripleBufferTest, WriteBufferIsNotVisibleBeforePublish) {
+  TripleBuffer<Pair> buffer;
+  buffer.write({1, 2});
+  EXPECT_EQ(buffer.read().value, 1);
+
+  buffer.writeBuffer() = {7, 14};
+  EXPECT_FALSE(buffer.hasNewData());
+  EXPECT_EQ(buffer.read().value, 1);
+
+  buffer.publish();
+  EXPECT_EQ(buffer.read().value, 7);
+}
+
+TEST(TripleBufferTest, ConcurrentReaderSeesConsistentIncreasingValues) {
+  constexpr int kWrites = 200000;
+  TripleBuffer<Pair> buffer;
+  std::atomic<bool> done{false};
+
+  std::thread writer([&buffer, &done]() {
+    for (int i = 1; i <= kWrites; ++i) {
+      buffer.write({i, i * 2});
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  int last = 0;
+  bool consistent = true;
+  bool increasing = true;
+  while (!done.load(std::memory_order_acquire) || buffer.hasNewData()) {
+    const Pair& pair = buffer.read();
+    consistent = consistent && pair.doubled == pair.value * 2;
+    increasing = increasing && pair.value >= last;
+    last = pair.value;
+  }
+  writer.join();
+
+  EXPECT_TRUE(consistent);
+  EXPECT_TRUE(increasing);
+  EXPECT_EQ(buffer.read().value, kWrites);
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
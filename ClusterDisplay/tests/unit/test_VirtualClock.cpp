@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <cstdio>
+#include <memory>
+
+#include "ClusterDataSubscriber.hpp"
+#include "VirtualClock.hpp"
+
+TEST(VirtualClockTest, FiresTimersInDeadlineOrder) {
+  VirtualClock clock;
+  QObject owner;
+  QStringList fired;
+
+  ClockTimer* fast = clock.createTimer(&owner);
+  ClockTimer* slow = clock.createTimer(&owner);
+  ClockTimer* once = clock.createTimer(&owner);
+  once->setSingleShot(true);
+  QObject::connect(fast, &ClockTimer::timeout, [&]() {
+    fired << QString("fast@%1").arg(clock.elapsedMs());
+  });
+  QObject::connect(slow, &ClockTimer::timeout, [&]() {
+    fired << QString("slow@%1").arg(clock.elapsedMs());
+  });
+  QObject::connect(once, &ClockTimer::timeout, [&]() {
+    fired << QString("once@%1").arg(clock.elapsedMs());
+  });
+
+  // Equal deadlines fire in start order; a repeating timer is started again when it fires
+  slow->start(300);
+  fast->start(100);
+  once->start(300);
+  EXPECT_EQ(clock.timeToNextTimer(), 100);
+
+  EXPECT_EQ(clock.advance(650), 9);
+  EXPECT_EQ(fired, QStringList({"fast@100", "fast@200", "slow@300", "once@300", "fast@300",
+                                "fast@400", "fast@500", "slow@600", "fast@600"}));
+  EXPECT_EQ(clock.elapsedMs(), 650);
+  EXPECT_FALSE(once->isActive());
+  EXPECT_TRUE(slow->isActive());
+
+  fired.clear();
+  fast->stop();
+  ASSERT_TRUE(clock.advanceToNextTimer());
+  EXPECT_EQ(fired, QStringList({"slow@900"}));
+  slow->stop();
+  EXPECT_FALSE(clock.advanceToNextTimer());
+  EXPECT_EQ(clock.timeToNextTimer(), -1);
+  EXPECT_EQ(clock.firedCount(), 10);
+}
+
+TEST(VirtualClockTest, RestartingMovesTheDeadline) {
+  VirtualClock clock;
+  QObject owner;
+  ClockTimer* timer = clock.createTimer(&owner);
+  timer->setSingleShot(true);
+  int timeouts = 0;
+  QObject::connect(timer, &ClockTimer::timeout, [&]() { ++timeouts; });
+
+  timer->start(1000);
+  clock.advance(600);
+  timer->start(1000);
+  clock.advance(999);
+  EXPECT_EQ(timeouts, 0);
+  clock.advance(1);
+  EXPECT_EQ(timeouts, 1);
+  EXPECT_EQ(timer->interval(), 1000);
+
+  // A new interval restarts a running timer, like QTimer::setInterval()
+  timer->setSingleShot(false);
+  timer->start(1000);
+  clock.advance(900);
+  timer->setInterval(200);
+  clock.advance(199);
+  EXPECT_EQ(timeouts, 1);
+  clock.advance(1);
+  EXPECT_EQ(timeouts, 2);
+}
+
+TEST(VirtualClockTest, TimersAndClockMayGoInAnyOrder) {
+  auto clock = std::make_unique<VirtualClock>();
+  QObject owner;
+  ClockTimer* kept = clock->createTimer(&owner);
+  kept->start(10);
+  {
+    QObject shortLived;
+    clock->createTimer(&shortLived)->start(5);
+  }
+  EXPECT_EQ(clock->advance(10), 1);
+
+  // A timer outliving its clock is stopped
+  clock.reset();
+  EXPECT_FALSE(kept->isActive());
+  kept->start(10);
+  EXPECT_FALSE(kept->isActive());
+}
+
+TEST(VirtualClockTest, ShowsTheVirtualDateAndTime) {
+  VirtualClock clock(QDateTime(QDate(2025, 6, 30), QTime(23, 59)));
+  ClusterModel model(&clock);
+  EXPECT_EQ(model.clock(), &clock);
+  EXPECT_EQ(model.currentTime(), "23:59");
+
+  clock.advance(60 * 1000);
+  EXPECT_EQ(model.currentTime(), "00:00");
+  EXPECT_EQ(model.currentDate(), QDate(2025, 7, 1).toString("dd MMM yyyy"));
+}
+
+TEST(VirtualClockTest, ModelDefaultsToTheSystemClock) {
+  ClusterModel model;
+  EXPECT_EQ(model.clock(), Clock::system());
+  EXPECT_GE(Clock::system()->elapsedMs(), 0);
+}
+
+class VirtualDriveTest : public ::testing::Test {
+ protected:
+  VirtualDriveTest() : model(&clock), subscriber(&model, &hub) {}
+
+  VirtualClock clock;
+  ClusterModel model;
+  ClusterSignalHub hub;
+  ClusterDataSubscriber subscriber;
+};
+
+TEST_F(VirtualDriveTest, SignExpiresAfterSixSeconds) {
+  hub.dispatchMessage("sign:50");
+  EXPECT_TRUE(model.speedLimitVisible());
+
+  // Seeing the same sign again prolongs it
+  clock.advance(4000);
+  hub.dispatchMessage("sign:50");
+  clock.advance(5999);
+  EXPECT_TRUE(model.speedLimitVisible());
+  clock.advance(1);
+  EXPECT_FALSE(model.speedLimitVisible());
+  EXPECT_FALSE(model.signVisible());
+}
+
+TEST_F(VirtualDriveTest, LinkTurnsStaleWithoutFrames) {
+  subscriber.setStaleTimeout(1000);
+  hub.dispatchMessage("speed:1000");
+  EXPECT_EQ(model.linkStatus(), ClusterModel::LinkUp);
+
+  clock.advance(1000);
+  EXPECT_EQ(model.linkStatus(), ClusterModel::LinkUp);
+  clock.advance(250);
+  EXPECT_EQ(model.linkStatus(), ClusterModel::LinkStale);
+
+  hub.dispatchMessage("speed:1000");
+  EXPECT_EQ(model.linkStatus(), ClusterModel::LinkUp);
+}
+
+TEST_F(VirtualDriveTest, ReplaysAnHourInLessThanASecondOfItsLength) {
+  // One hour at 3.6 km/h with a frame every 100 ms
+  QElapsedTimer timer;
+  timer.start();
+  for (int frame = 0; frame < 36000; ++frame) {
+    hub.dispatchMessage("speed:1000");
+    clock.advance(100);
+  }
+  const qint64 elapsedMs = timer.elapsed();
+
+  EXPECT_EQ(clock.elapsedMs(), 3600 * 1000);
+  EXPECT_NEAR(model.tripDistance(), 3600, 36);
+  EXPECT_NEAR(model.tripMovingTime(), 3600, 1);
+  EXPECT_EQ(model.linkStatus(), ClusterModel::LinkUp);
+  std::printf("Virtual drive: 1 h replayed in %lld ms\n", static_cast<long long>(elapsedMs));
+  // Generous bound for debug and coverage builds
+  EXPECT_LT(elapsedMs, 60 * 1000);
+}
+
+TEST(VirtualClockTest, FollowsTheSystemClockAtARate) {
+  VirtualClock clock;
+  QObject owner;
+  ClockTimer* timer = clock.createTimer(&owner);
+  int timeouts = 0;
+  QObject::connect(timer, &ClockTimer::timeout, [&]() { ++timeouts; });
+  timer->start(1000);
+
+  // A minute per second of real time
+  clock.setRate(60);
+  EXPECT_DOUBLE_EQ(clock.rate(), 60.0);
+  QDeadlineTimer deadline(5000);
+  while (clock.elapsedMs() < 3000 && !deadline.hasExpired()) {
+    QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 10);
+  }
+  clock.setRate(0);
+
+  EXPECT_GE(clock.elapsedMs(), 3000);
+  EXPECT_EQ(timeouts, clock.elapsedMs() / 1000);
+  const qint64 stopped = clock.elapsedMs();
+  QCoreApplication::processEvents(QEventLoop::AllEvents, 20);
+  EXPECT_EQ(clock.elapsedMs(), stopped);
+}
+
+int main(int argc, char** argv) {
+  QCoreApplication app(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -107,6 +107,29 @@ TEST_F(ZmqSubscriberTest, LargeMessageHandling) {
   EXPECT_EQ(spy.at(0).at(0).toString(), largeMessage);
 }
 
+TEST(ZmqSubscriberPriorityTest, ContainsKeyFindsKeyAtAnyPosition) {
+  const QList<QByteArray> keys = {"obs"};
+  const QByteArray first = "obs:2;speed:100";
+  const QByteArray middle = "speed:100;obs:1;battery:80";
+  const QByteArray last = "speed:100;obs:0";
+
+  EXPECT_TRUE(ZmqSubscriber::containsKey(first.constData(), first.size(), keys));
+  EXPECT_TRUE(ZmqSubscriber::containsKey(middle.constData(), middle.size(), keys));
+  EXPECT_TRUE(ZmqSubscriber::containsKey(last.constData(), last.size(), keys));
+}
+
+TEST(ZmqSubscriberPriorityTest, ContainsKeyRequiresWholeKey) {
+  const QList<QByteArray> keys = {"obs"};
+  const QByteArray prefix = "observer:1;speed:100";
+  const QByteArray inValue = "sign:obs:;speed:100";
+  const QByteArray truncated = "speed:100;obs";
+
+  EXPECT_FALSE(ZmqSubscriber::containsKey(prefix.constData(), prefix.size(), keys));
+  EXPECT_FALSE(ZmqSubscriber::containsKey(inValue.constData(), inValue.size(), keys));
+  EXPECT_FALSE(ZmqSubscriber::containsKey(truncated.constData(), truncated.size(), keys));
+  EXPECT_FALSE(ZmqSubscriber::containsKey(prefix.constData(), prefix.size(), {}));
+}
+
 int main(int argc, char** argv) {
   QCoreApplication app(argc, argv);
   ::testing::InitGoogleTest(&argc, argv);
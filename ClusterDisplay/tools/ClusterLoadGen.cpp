@@ -0,0 +1,418 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <zmq.hpp>
+
+#include "ClusterProtocol.hpp"
+
+/**
+ * @file ClusterLoadGen.cpp
+ * @brief Synthetic publisher for load-testing the cluster display
+ *
+ * Publishes "key:value;..." frames on the critical (5555) and non-critical
+ * (5556) ports, exactly like the vehicle does, at configurable rates and
+ * patterns. Run the display with `--host localhost` to receive them.
+ *
+ * Frames are formatted here rather than with ClusterPublisher, since the
+ * load generator deliberately sends repeated values and malformed frames.
+ * Like the vehicle's frames, each one starts with the sequence number of its
+ * channel (ClusterProtocol::sequenceKey()). `--unsequenced` leaves it out of a
+ * share of the frames; malformed frames never carry one and do not advance it,
+ * so the display sees gaps only where it really missed a frame.
+ *
+ * Scenarios:
+ * - steady: constant rate
+ * - burst:  `--burst-size` frames back to back every `--burst-interval` ms
+ * - ramp:   rate rising linearly from `--rate` to `--ramp-to` over `--duration`
+ */
+
+namespace {
+
+std::atomic<bool> g_running{true};
+
+/**
+ * @brief Load pattern of a run
+ */
+enum class Scenario { Steady, Burst, Ramp };
+
+/**
+ * @brief A message key and its share of the generated traffic
+ */
+struct KeyWeight {
+  QString key;   ///< Message key (speed, battery, ...)
+  int weight;    ///< Relative frequency
+  bool critical; ///< Sent on the critical port
+};
+
+/**
+ * @brief Check whether a key belongs to the critical data channel
+ */
+bool isCriticalKey(const QString& key) {
+  return ClusterProtocol::channelOf(key.toUtf8().constData()) ==
+         ClusterProtocol::Channel::Critical;
+}
+
+/**
+ * @brief Parse a key mix such as "speed=10,battery=1,lane"
+ * @return The weighted keys, or an empty list if the specification is invalid
+ */
+QVector<KeyWeight> parseKeyMix(const QString& spec) {
+  QVector<KeyWeight> keys;
+  for (const QString& entry : spec.split(',', Qt::SkipEmptyParts)) {
+    const QStringList parts = entry.split('=');
+    bool ok = true;
+    const int weight = parts.size() > 1 ? parts.at(1).toInt(&ok) : 1;
+    if (!ok || weight <= 0 || parts.size() > 2) {
+      return {};
+    }
+    const QString key = parts.at(0).trimmed();
+    keys.append({key, weight, isCriticalKey(key)});
+  }
+  return keys;
+}
+
+/**
+ * @brief Produces plausible (and optionally malformed) cluster data frames
+ */
+class FrameGenerator {
+ public:
+  FrameGenerator(const QVector<KeyWeight>& keys, int keysPerFrame, double malformedRatio,
+                 double unsequencedRatio, quint32 seed)
+      : m_keys(keys),
+        m_keysPerFrame(qMax(1, keysPerFrame)),
+        m_malformedRatio(malformedRatio),
+        m_unsequencedRatio(unsequencedRatio),
+        m_random(seed),
+        m_totalWeight(0),
+        m_phase(0.0),
+        m_odometer(0),
+        m_sequences{0, 0} {
+    for (const KeyWeight& key : m_keys) {
+      m_totalWeight += key.weight;
+    }
+  }
+
+  /**
+   * @brief Generate the next frame
+   * @param critical Set to the channel the frame must be published on
+   * @param malformed Set if the frame was deliberately corrupted
+   * @param unsequenced Set if the frame was deliberately sent without a sequence number
+   */
+  std::string next(bool& critical, bool& malformed, bool& unsequenced) {
+    const KeyWeight& first = pickKey();
+    critical = first.critical;
+    malformed = m_random.generateDouble() < m_malformedRatio;
+    unsequenced = !malformed && m_random.generateDouble() < m_unsequencedRatio;
+    if (malformed) {
+      return malformedFrame(first.key);
+    }
+
+    // The sequence number of the channel comes first, as on the vehicle
+    std::string frame;
+    if (!unsequenced) {
+      const ClusterProtocol::Channel channel =
+          critical ? ClusterProtocol::Channel::Critical : ClusterProtocol::Channel::NonCritical;
+      frame = std::string(ClusterProtocol::sequenceKey(channel)) +
+              ClusterProtocol::kKeyValueSeparator +
+              std::to_string(++m_sequences[critical ? 0 : 1]) + ClusterProtocol::kPairSeparator;
+    }
+
+    // Additional keys come from the same channel, each key at most once per frame
+    QStringList used{first.key};
+    frame += pair(first.key);
+    for (int attempt = 0; used.size() < m_keysPerFrame && attempt < m_keysPerFrame * 4; ++attempt) {
+      const KeyWeight& extra = pickKey();
+      if (extra.critical == critical && !used.contains(extra.key)) {
+        used << extra.key;
+        frame += ';' + pair(extra.key);
+      }
+    }
+    return frame;
+  }
+
+ private:
+  const KeyWeight& pickKey() {
+    int ticket = static_cast<int>(m_random.bounded(m_totalWeight));
+    for (const KeyWeight& key : m_keys) {
+      if (ticket < key.weight) {
+        return key;
+      }
+      ticket -= key.weight;
+    }
+    return m_keys.last();
+  }
+
+  std::string pair(const QString& key) {
+    return key.toStdString() + ':' + value(key);
+  }
+
+  std::string value(const QString& key) {
+    if (key == QLatin1String("speed")) {
+      // 0-30 km/h in mm/s, following a slow sine so the display shows a moving value
+      m_phase += 0.001;
+      return std::to_string(static_cast<int>(4166 + 4166 * std::sin(m_phase)));
+    }
+    if (key == QLatin1String("battery")) {
+      return std::to_string(m_random.bounded(101));
+    }
+    if (key == QLatin1String("charging") || key == QLatin1String("mode")) {
+      return std::to_string(m_random.bounded(2));
+    }
+    if (key == QLatin1String("lane")) {
+      return std::to_string(m_random.bounded(3));
+    }
+    if (key == QLatin1String("obs")) {
+      // Mostly clear road, occasional obstacle, rare emergency brake
+      const int roll = static_cast<int>(m_random.bounded(100));
+      return roll < 90 ? "0" : (roll < 98 ? "1" : "2");
+    }
+    if (key == QLatin1String("sign")) {
+      static const char* const signs[] = {"30", "50", "80", "stop", "crosswalk", "yield"};
+      return signs[m_random.bounded(6)];
+    }
+    if (key == QLatin1String("odo")) {
+      return std::to_string(++m_odometer);
+    }
+    return std::to_string(m_random.bounded(1000));
+  }
+
+  std::string malformedFrame(const QString& key) {
+    const std::string name = key.toStdString();
+    switch (m_random.bounded(6)) {
+      case 0:
+        return name + value(key); // Missing separator
+      case 1:
+        return name + ":1:2"; // Too many separators
+      case 2:
+        return name + ":not_a_number";
+      case 3:
+        return ";;;";
+      case 4:
+        return std::string();
+      default: {
+        // Random binary garbage
+        std::string garbage(1 + m_random.bounded(64), '\0');
+        for (char& byte : garbage) {
+          byte = static_cast<char>(m_random.bounded(256));
+        }
+        return garbage;
+      }
+    }
+  }
+
+  QVector<KeyWeight> m_keys;
+  int m_keysPerFrame;
+  double m_malformedRatio;
+  double m_unsequencedRatio;
+  QRandomGenerator m_random;
+  int m_totalWeight;
+  double m_phase;
+  int m_odometer;
+  quint64 m_sequences[2]; ///< Last sequence number of the critical and non-critical channel
+};
+
+/**
+ * @brief Number of frames that should have been sent after a given time
+ */
+double scheduledFrames(Scenario scenario, double seconds, double rate, double rampTo,
+                       double durationSeconds, int burstSize, int burstIntervalMs) {
+  switch (scenario) {
+    case Scenario::Burst:
+      return (std::floor(seconds * 1000.0 / burstIntervalMs) + 1.0) * burstSize;
+    case Scenario::Ramp:
+      // Integral of a rate rising linearly from rate to rampTo over the run
+      return rate * seconds + (rampTo - rate) * seconds * seconds / (2.0 * durationSeconds);
+    case Scenario::Steady:
+    default:
+      return rate * seconds;
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+  app.setApplicationName("ClusterLoadGen");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Synthetic ZeroMQ load generator for the cluster display");
+  parser.addHelpOption();
+
+  QCommandLineOption bindOption("bind", "Interface to bind the publishers to", "address", "*");
+  QCommandLineOption criticalPortOption("critical-port", "Critical data port", "port",
+                                        QString::number(ClusterProtocol::kCriticalPort));
+  QCommandLineOption nonCriticalPortOption("non-critical-port", "Non-critical data port", "port",
+                                           QString::number(ClusterProtocol::kNonCriticalPort));
+  QCommandLineOption scenarioOption("scenario", "Load pattern: steady, burst or ramp", "name",
+                                    "steady");
+  QCommandLineOption rateOption("rate", "Frames per second (start rate for ramp)", "hz", "1000");
+  QCommandLineOption rampToOption("ramp-to", "Final frames per second of the ramp scenario", "hz",
+                                  "50000");
+  QCommandLineOption burstSizeOption("burst-size", "Frames per burst", "count", "1000");
+  QCommandLineOption burstIntervalOption("burst-interval", "Milliseconds between bursts", "ms",
+                                         "100");
+  QCommandLineOption durationOption("duration", "Run time in seconds (0 = until Ctrl+C)",
+                                    "seconds", "10");
+  QCommandLineOption keysOption(
+      "keys", "Key mix with optional weights, e.g. speed=10,battery=1", "mix",
+      "speed=10,lane=2,obs=2,sign=1,mode=1,battery=2,charging=1,odo=2");
+  QCommandLineOption keysPerFrameOption("keys-per-frame", "Keys combined into each frame", "count",
+                                        "1");
+  QCommandLineOption malformedOption("malformed", "Ratio of malformed frames (0.0 - 1.0)", "ratio",
+                                     "0");
+  QCommandLineOption unsequencedOption(
+      "unsequenced", "Ratio of frames sent without a sequence number (0.0 - 1.0)", "ratio", "0");
+  QCommandLineOption seedOption("seed", "Random seed for reproducible runs", "seed", "1");
+  QCommandLineOption warmupOption("warmup", "Milliseconds to wait for subscribers before sending",
+                                  "ms", "500");
+
+  parser.addOptions({bindOption, criticalPortOption, nonCriticalPortOption, scenarioOption,
+                     rateOption, rampToOption, burstSizeOption, burstIntervalOption,
+                     durationOption, keysOption, keysPerFrameOption, malformedOption,
+                     unsequencedOption, seedOption, warmupOption});
+  parser.process(app);
+
+  // Validate the configuration
+  Scenario scenario = Scenario::Steady;
+  const QString scenarioName = parser.value(scenarioOption);
+  if (scenarioName == QLatin1String("burst")) {
+    scenario = Scenario::Burst;
+  } else if (scenarioName == QLatin1String("ramp")) {
+    scenario = Scenario::Ramp;
+  } else if (scenarioName != QLatin1String("steady")) {
+    std::fprintf(stderr, "Unknown scenario: %s\n", qPrintable(scenarioName));
+    return 1;
+  }
+
+  const double rate = parser.value(rateOption).toDouble();
+  const double rampTo = parser.value(rampToOption).toDouble();
+  const int burstSize = parser.value(burstSizeOption).toInt();
+  const int burstIntervalMs = parser.value(burstIntervalOption).toInt();
+  const double durationSeconds = parser.value(durationOption).toDouble();
+  const double malformedRatio = parser.value(malformedOption).toDouble();
+  const double unsequencedRatio = parser.value(unsequencedOption).toDouble();
+  const QVector<KeyWeight> keys = parseKeyMix(parser.value(keysOption));
+
+  if (keys.isEmpty()) {
+    std::fprintf(stderr, "Invalid key mix: %s\n", qPrintable(parser.value(keysOption)));
+    return 1;
+  }
+  if (rate < 0.0 || malformedRatio < 0.0 || malformedRatio > 1.0 || unsequencedRatio < 0.0 ||
+      unsequencedRatio > 1.0) {
+    std::fprintf(stderr, "Rate must be positive and the malformed and unsequenced ratios "
+                         "between 0 and 1\n");
+    return 1;
+  }
+  if (scenario == Scenario::Burst && (burstSize <= 0 || burstIntervalMs <= 0)) {
+    std::fprintf(stderr, "Burst size and interval must be positive\n");
+    return 1;
+  }
+  if (scenario == Scenario::Ramp && durationSeconds <= 0.0) {
+    std::fprintf(stderr, "The ramp scenario needs a finite --duration\n");
+    return 1;
+  }
+
+  // Bind one publisher per channel, like the vehicle side
+  zmq::context_t context(1);
+  zmq::socket_t critical(context, zmq::socket_type::pub);
+  zmq::socket_t nonCritical(context, zmq::socket_type::pub);
+  for (zmq::socket_t* socket : {&critical, &nonCritical}) {
+    socket->set(zmq::sockopt::sndhwm, 100000);
+    socket->set(zmq::sockopt::linger, 0);
+  }
+  const std::string bind = parser.value(bindOption).toStdString();
+  try {
+    critical.bind("tcp://" + bind + ":" + parser.value(criticalPortOption).toStdString());
+    nonCritical.bind("tcp://" + bind + ":" + parser.value(nonCriticalPortOption).toStdString());
+  } catch (const zmq::error_t& e) {
+    std::fprintf(stderr, "Failed to bind publishers: %s\n", e.what());
+    return 1;
+  }
+
+  std::signal(SIGINT, [](int) { g_running = false; });
+  std::signal(SIGTERM, [](int) { g_running = false; });
+
+  // PUB sockets drop everything sent before a subscriber has connected
+  std::this_thread::sleep_for(std::chrono::milliseconds(parser.value(warmupOption).toInt()));
+
+  FrameGenerator generator(keys, parser.value(keysPerFrameOption).toInt(), malformedRatio,
+                           unsequencedRatio, parser.value(seedOption).toUInt());
+
+  std::printf("ClusterLoadGen: %s scenario on ports %s/%s\n", qPrintable(scenarioName),
+              qPrintable(parser.value(criticalPortOption)),
+              qPrintable(parser.value(nonCriticalPortOption)));
+
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point start = Clock::now();
+  Clock::time_point lastReport = start;
+  quint64 sent = 0;
+  quint64 sentAtLastReport = 0;
+  quint64 malformedSent = 0;
+  quint64 unsequencedSent = 0;
+  quint64 dropped = 0;
+
+  while (g_running) {
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    if (durationSeconds > 0.0 && elapsed >= durationSeconds) {
+      break;
+    }
+
+    // Send everything that is due; if the publisher cannot keep up it sends back to back,
+    // which is the saturation point being looked for
+    const double due = scheduledFrames(scenario, elapsed, rate, rampTo, durationSeconds,
+                                       burstSize, burstIntervalMs);
+    while (sent < due && g_running) {
+      bool isCritical = true;
+      bool isMalformed = false;
+      bool isUnsequenced = false;
+      const std::string frame = generator.next(isCritical, isMalformed, isUnsequenced);
+      zmq::socket_t& socket = isCritical ? critical : nonCritical;
+      if (!socket.send(zmq::buffer(frame), zmq::send_flags::dontwait)) {
+        ++dropped;
+      }
+      ++sent;
+      malformedSent += isMalformed ? 1 : 0;
+      unsequencedSent += isUnsequenced ? 1 : 0;
+
+      // Keep reporting even while saturated
+      if ((sent & 0x3ff) == 0 && Clock::now() - lastReport >= std::chrono::seconds(1)) {
+        break;
+      }
+    }
+
+    const Clock::time_point now = Clock::now();
+    if (now - lastReport >= std::chrono::seconds(1)) {
+      const double interval = std::chrono::duration<double>(now - lastReport).count();
+      std::printf(
+          "t=%6.1fs  sent %10llu  rate %9.0f msg/s  malformed %llu  unsequenced %llu  "
+          "dropped %llu\n",
+          std::chrono::duration<double>(now - start).count(), static_cast<unsigned long long>(sent),
+          (sent - sentAtLastReport) / interval, static_cast<unsigned long long>(malformedSent),
+          static_cast<unsigned long long>(unsequencedSent),
+          static_cast<unsigned long long>(dropped));
+      std::fflush(stdout);
+      lastReport = now;
+      sentAtLastReport = sent;
+    } else if (sent >= due) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+
+  const double total = std::chrono::duration<double>(Clock::now() - start).count();
+  std::printf(
+      "Done: %llu frames in %.1f s (%.0f msg/s average), %llu malformed, %llu unsequenced, "
+      "%llu dropped\n",
+      static_cast<unsigned long long>(sent), total, total > 0.0 ? sent / total : 0.0,
+      static_cast<unsigned long long>(malformedSent),
+      static_cast<unsigned long long>(unsequencedSent), static_cast<unsigned long long>(dropped));
+  return 0;
+}
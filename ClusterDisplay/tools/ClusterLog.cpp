@@ -0,0 +1,224 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QStringList>
+#include <QVector>
+#include <cstdio>
+#include <limits>
+
+#include "TripLog.hpp"
+
+/**
+ * @file ClusterLog.cpp
+ * @brief Analyzer for the trip logs written by the display (`--trip-log <dir>`)
+ *
+ * Commands:
+ * - info:  start time, duration, chunks and samples per signal
+ * - stats: count, minimum, maximum, mean and time-weighted mean per signal
+ * - csv:   the samples as `time_ms,signal,value` rows in time order
+ *
+ * `--from` and `--to` limit every command to a time range in seconds since
+ * the start of the log, and `--signals` to some signals. Only the chunks
+ * overlapping the range are decompressed, and only the wanted columns of
+ * them are decoded, so a few minutes of a multi-hour drive are read in
+ * milliseconds.
+ */
+
+namespace {
+
+constexpr quint16 kAllSignals = (1u << TripLog::SignalCount) - 1;
+
+/**
+ * @brief Parse a comma-separated list of signal names into a mask
+ * @return False if a name is unknown
+ */
+bool parseSignals(const QString& list, quint16* mask) {
+  if (list.isEmpty()) {
+    *mask = kAllSignals;
+    return true;
+  }
+
+  *mask = 0;
+  for (const QString& name : list.split(',', Qt::SkipEmptyParts)) {
+    TripLog::Signal signal;
+    if (!TripLog::signalFromName(name.trimmed(), &signal)) {
+      std::fprintf(stderr, "Unknown signal: %s\n", qPrintable(name));
+      return false;
+    }
+    *mask |= 1u << signal;
+  }
+  return *mask != 0;
+}
+
+/**
+ * @brief Parse a time in seconds into milliseconds
+ * @return False if the value is not a number
+ */
+bool parseSeconds(const QString& text, qint64 fallback, qint64* ms) {
+  if (text.isEmpty()) {
+    *ms = fallback;
+    return true;
+  }
+  bool ok = false;
+  const double seconds = text.toDouble(&ok);
+  *ms = static_cast<qint64>(seconds * 1000.0);
+  return ok;
+}
+
+/**
+ * @brief Print the layout of a log and its samples per signal
+ */
+int printInfo(TripLog::Reader& reader, quint16 wanted, qint64 fromMs, qint64 toMs) {
+  const QVector<TripLog::Reader::ChunkInfo>& chunks = reader.chunks();
+  qint64 compressed = 0;
+  qint64 samples = 0;
+  for (const TripLog::Reader::ChunkInfo& chunk : chunks) {
+    compressed += chunk.header.payloadSize;
+    samples += chunk.header.sampleCount;
+  }
+
+  const QDateTime start = QDateTime::fromMSecsSinceEpoch(reader.startEpochMs());
+  std::printf("Started:  %s\n", qPrintable(start.toString(Qt::ISODate)));
+  std::printf("Duration: %.1f s\n", static_cast<double>(reader.endMs()) / 1000.0);
+  std::printf("Chunks:   %lld (%lld bytes compressed)\n",
+              static_cast<long long>(chunks.size()), static_cast<long long>(compressed));
+  std::printf("Samples:  %lld (%.2f bytes per sample)\n", static_cast<long long>(samples),
+              samples > 0 ? static_cast<double>(compressed) / static_cast<double>(samples) : 0.0);
+
+  QVector<TripLog::Sample> columns[TripLog::SignalCount];
+  if (!reader.samples(wanted, fromMs, toMs, columns)) {
+    std::fprintf(stderr, "%s\n", qPrintable(reader.errorString()));
+    return 1;
+  }
+  std::printf("\n%-12s %10s\n", "signal", "samples");
+  for (int signal = 0; signal < TripLog::SignalCount; ++signal) {
+    if (wanted & (1u << signal)) {
+      std::printf("%-12s %10lld\n", TripLog::signalName(static_cast<TripLog::Signal>(signal)),
+                  static_cast<long long>(columns[signal].size()));
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Print the summary of each wanted signal over the range
+ */
+int printStats(TripLog::Reader& reader, quint16 wanted, qint64 fromMs, qint64 toMs) {
+  std::printf("%-12s %10s %12s %12s %14s %14s\n", "signal", "count", "min", "max", "mean",
+              "time-weighted");
+  for (int index = 0; index < TripLog::SignalCount; ++index) {
+    if ((wanted & (1u << index)) == 0) {
+      continue;
+    }
+    const TripLog::Signal signal = static_cast<TripLog::Signal>(index);
+    const TripLog::Summary summary = reader.summarize(signal, fromMs, toMs);
+    std::printf("%-12s %10lld %12lld %12lld %14.2f %14.2f\n", TripLog::signalName(signal),
+                static_cast<long long>(summary.count), static_cast<long long>(summary.min),
+                static_cast<long long>(summary.max), summary.mean, summary.timeWeighted);
+  }
+  return 0;
+}
+
+/**
+ * @brief Write the samples of the range as CSV rows, merged in time order
+ */
+int writeCsv(TripLog::Reader& reader, quint16 wanted, qint64 fromMs, qint64 toMs,
+             std::FILE* out) {
+  QVector<TripLog::Sample> columns[TripLog::SignalCount];
+  if (!reader.samples(wanted, fromMs, toMs, columns)) {
+    std::fprintf(stderr, "%s\n", qPrintable(reader.errorString()));
+    return 1;
+  }
+
+  std::fprintf(out, "time_ms,signal,value\n");
+  int next[TripLog::SignalCount] = {};
+  for (;;) {
+    // Columns are sorted by time: the oldest head of all columns is the next row
+    int oldest = -1;
+    qint64 oldestMs = std::numeric_limits<qint64>::max();
+    for (int signal = 0; signal < TripLog::SignalCount; ++signal) {
+      if (next[signal] < columns[signal].size() &&
+          columns[signal].at(next[signal]).timeMs < oldestMs) {
+        oldest = signal;
+        oldestMs = columns[signal].at(next[signal]).timeMs;
+      }
+    }
+    if (oldest < 0) {
+      break;
+    }
+    std::fprintf(out, "%lld,%s,%lld\n", static_cast<long long>(oldestMs),
+                 TripLog::signalName(static_cast<TripLog::Signal>(oldest)),
+                 static_cast<long long>(columns[oldest].at(next[oldest]).value));
+    ++next[oldest];
+  }
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+  app.setApplicationName("cluster-log");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Query, summarize and export cluster display trip logs");
+  parser.addHelpOption();
+  parser.addPositionalArgument("command", "info, stats or csv");
+  parser.addPositionalArgument("file", "Trip log written with --trip-log");
+
+  QCommandLineOption signalsOption(
+      "signals", "Comma-separated signals, e.g. speed,battery (default: all)", "names");
+  QCommandLineOption fromOption("from", "Start of the range in seconds since the log start",
+                                "seconds");
+  QCommandLineOption toOption("to", "End of the range in seconds since the log start", "seconds");
+  QCommandLineOption outputOption({"o", "output"}, "CSV file to write (default: stdout)", "file");
+
+  parser.addOptions({signalsOption, fromOption, toOption, outputOption});
+  parser.process(app);
+
+  const QStringList arguments = parser.positionalArguments();
+  if (arguments.size() != 2) {
+    parser.showHelp(1);
+  }
+  const QString command = arguments.at(0);
+
+  quint16 wanted = 0;
+  qint64 fromMs = 0;
+  qint64 toMs = 0;
+  if (!parseSignals(parser.value(signalsOption), &wanted) ||
+      !parseSeconds(parser.value(fromOption), 0, &fromMs) ||
+      !parseSeconds(parser.value(toOption), std::numeric_limits<qint64>::max(), &toMs)) {
+    std::fprintf(stderr, "Invalid --signals, --from or --to\n");
+    return 1;
+  }
+
+  TripLog::Reader reader;
+  if (!reader.open(arguments.at(1))) {
+    std::fprintf(stderr, "Cannot open %s: %s\n", qPrintable(arguments.at(1)),
+                 qPrintable(reader.errorString()));
+    return 1;
+  }
+
+  if (command == QLatin1String("info")) {
+    return printInfo(reader, wanted, fromMs, toMs);
+  }
+  if (command == QLatin1String("stats")) {
+    return printStats(reader, wanted, fromMs, toMs);
+  }
+  if (command == QLatin1String("csv")) {
+    if (!parser.isSet(outputOption)) {
+      return writeCsv(reader, wanted, fromMs, toMs, stdout);
+    }
+    std::FILE* out = std::fopen(qPrintable(parser.value(outputOption)), "w");
+    if (!out) {
+      std::fprintf(stderr, "Cannot write %s\n", qPrintable(parser.value(outputOption)));
+      return 1;
+    }
+    const int result = writeCsv(reader, wanted, fromMs, toMs, out);
+    std::fclose(out);
+    return result;
+  }
+
+  std::fprintf(stderr, "Unknown command: %s\n", qPrintable(command));
+  return 1;
+}
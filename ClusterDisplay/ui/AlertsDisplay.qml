@@ -1,4 +1,5 @@
 import QtQuick 6.4
+import ClusterDisplay 1.0
 
 Item {
     id: alertsDisplay
@@ -8,12 +9,14 @@ Item {
     // Properties for alerts
     property bool laneAlertActive: false
     property bool objectAlertActive: false
-    property bool emergencyBrakeActive: clusterModel.emergencyBrakeActive
-    property string laneDeviationSide: "left"
+    property bool emergencyBrakeActive: ClusterModel.emergencyBrakeActive
+    property int highlightedLane: ClusterModel.NoLane
     property int lastSpeedLimit: 0
 
-    // Add property to check if current speed exceeds speed limit (speed is scaled 10x, speed limit is not)
-    property bool speedLimitExceeded: lastSpeedLimit > 0 && clusterModel.speed > lastSpeedLimit
+    // Speed limit check and overall severity are computed in ClusterModel, so speed
+    // updates do not run any JavaScript here
+    property bool speedLimitExceeded: ClusterModel.speedLimitExceeded
+    property int alertSeverity: ClusterModel.alertSeverity
 
     // Centralized blinking control for synchronized alerts
     property real alertOpacity: 1.0
@@ -21,7 +24,7 @@ Item {
     // Synchronized blinking timer - only runs when alerts are active
     SequentialAnimation {
         id: blinkAnimation
-        running: laneAlertActive || objectAlertActive || speedLimitExceeded || emergencyBrakeActive
+        running: alertSeverity !== ClusterModel.NoAlert
         loops: Animation.Infinite
         NumberAnimation {
             target: alertsDisplay
@@ -37,186 +40,144 @@ Item {
         }
     }
 
-    // Reset opacity to 1.0 when no alerts are active
-    onLaneAlertActiveChanged: {
-        if (!laneAlertActive && !objectAlertActive && !speedLimitExceeded && !emergencyBrakeActive) {
-            alertOpacity = 1.0;
-        } else if (laneAlertActive) {
-            // Immediately start blinking when lane alert becomes active
-            blinkAnimation.restart();
-            alertOpacity = 1.0;  // Start with full opacity
-        }
-    }
-    onObjectAlertActiveChanged: {
-        if (!laneAlertActive && !objectAlertActive && !speedLimitExceeded && !emergencyBrakeActive) {
-            alertOpacity = 1.0;
-        } else if (objectAlertActive) {
-            // Immediately start blinking when object alert becomes active
-            blinkAnimation.restart();
-            alertOpacity = 1.0;  // Start with full opacity
-        }
-    }
-    onSpeedLimitExceededChanged: {
-        if (!laneAlertActive && !objectAlertActive && !speedLimitExceeded && !emergencyBrakeActive) {
-            alertOpacity = 1.0;
-        } else if (speedLimitExceeded) {
-            // Immediately start blinking when speed limit is exceeded
-            blinkAnimation.restart();
-            alertOpacity = 1.0;  // Start with full opacity
-        }
-    }
-    onEmergencyBrakeActiveChanged: {
-        if (!laneAlertActive && !objectAlertActive && !speedLimitExceeded && !emergencyBrakeActive) {
-            alertOpacity = 1.0;
-        } else if (emergencyBrakeActive) {
-            // Immediately start blinking when emergency brake becomes active
-            blinkAnimation.restart();
-            alertOpacity = 1.0;  // Start with full opacity
-        }
+    // Immediately start blinking at full opacity when a new alert becomes active
+    function restartBlink() {
+        blinkAnimation.restart();
+        alertOpacity = 1.0;
     }
 
-    // Also watch for speed changes to immediately trigger blinking
-    Connections {
-        target: clusterModel
-        function onSpeedChanged() {
-            var wasExceeded = speedLimitExceeded;
-            // Force re-evaluation of speedLimitExceeded
-            if (lastSpeedLimit > 0 && clusterModel.speed > lastSpeedLimit) {
-                if (!wasExceeded) {
-                    // Speed just exceeded the limit - start blinking immediately
-                    blinkAnimation.restart();
-                    alertOpacity = 1.0;
-                }
-            } else if (wasExceeded) {
-                // Speed dropped below limit - stop blinking
-                if (!laneAlertActive && !objectAlertActive && !emergencyBrakeActive) {
-                    alertOpacity = 1.0;
-                }
-            }
+    onLaneAlertActiveChanged: if (laneAlertActive) restartBlink()
+    onObjectAlertActiveChanged: if (objectAlertActive) restartBlink()
+    onSpeedLimitExceededChanged: if (speedLimitExceeded) restartBlink()
+    onEmergencyBrakeActiveChanged: if (emergencyBrakeActive) restartBlink()
+
+    // Reset opacity to 1.0 when no alerts are active
+    onAlertSeverityChanged: {
+        if (alertSeverity === ClusterModel.NoAlert) {
+            alertOpacity = 1.0;
         }
     }
 
-    // Lane departure alert
-    Item {
+    // Lane departure alert (advisory): created on demand and unloaded when idle
+    LazyOverlay {
         id: laneAlertBox
-        visible: laneAlertActive
+        wanted: laneAlertActive
         anchors {
             horizontalCenter: parent.horizontalCenter
             horizontalCenterOffset: 80
             verticalCenter: parent.verticalCenter
             verticalCenterOffset: 0
         }
-        width: 60
-        height: 60
 
-        Item {
-            id: laneIcon
-            anchors {
-                centerIn: parent
-            }
-            width: 60
-            height: 40
-
-            // Left lane line - vertical with perspective
-            Rectangle {
-                anchors {
-                    left: parent.left
-                    leftMargin: 12
-                    verticalCenter: parent.verticalCenter
-                }
-                width: 4
-                height: 30
-                color: laneDeviationSide === "left" ? "#FF0000" : "#FF4444"
-                radius: 2
+        sourceComponent: Component {
+            Item {
+                id: laneIcon
+                width: 60
+                height: 40
 
-                
+                // Left lane line - vertical with perspective
                 Rectangle {
                     anchors {
-                        top: parent.top
-                        horizontalCenter: parent.horizontalCenter
+                        left: parent.left
+                        leftMargin: 12
+                        verticalCenter: parent.verticalCenter
                     }
-                    width: 2
-                    height: 8
-                    color: laneDeviationSide === "left" ? "#FF0000" : "#FF4444"
-                    radius: 1
-                }
-            }
+                    width: 4
+                    height: 30
+                    color: highlightedLane === ClusterModel.LeftLane ? "#FF0000" : "#FF4444"
+                    radius: 2
 
-            // Center dashed line - moving effect
-            Column {
-                anchors {
-                    horizontalCenter: parent.horizontalCenter
-                    verticalCenter: parent.verticalCenter
-                }
-                spacing: 3
-                Repeater {
-                    model: 4
+                
                     Rectangle {
-                        width: 3
-                        height: 6
-                        color: "#FF4444"  // Bright red
+                        anchors {
+                            top: parent.top
+                            horizontalCenter: parent.horizontalCenter
+                        }
+                        width: 2
+                        height: 8
+                        color: highlightedLane === ClusterModel.LeftLane ? "#FF0000" : "#FF4444"
                         radius: 1
-                        anchors.horizontalCenter: parent.horizontalCenter
                     }
                 }
-            }
 
-            // Right lane line - vertical with perspective
-            Rectangle {
-                anchors {
-                    right: parent.right
-                    rightMargin: 12
-                    verticalCenter: parent.verticalCenter
+                // Center dashed line - moving effect
+                Column {
+                    anchors {
+                        horizontalCenter: parent.horizontalCenter
+                        verticalCenter: parent.verticalCenter
+                    }
+                    spacing: 3
+                    Repeater {
+                        model: 4
+                        Rectangle {
+                            width: 3
+                            height: 6
+                            color: "#FF4444"  // Bright red
+                            radius: 1
+                            anchors.horizontalCenter: parent.horizontalCenter
+                        }
+                    }
                 }
-                width: 4
-                height: 30
-                color: laneDeviationSide === "right" ? "#FF0000" : "#FF4444"  
-                radius: 2
+
+                // Right lane line - vertical with perspective
+                Rectangle {
+                    anchors {
+                        right: parent.right
+                        rightMargin: 12
+                        verticalCenter: parent.verticalCenter
+                    }
+                    width: 4
+                    height: 30
+                    color: highlightedLane === ClusterModel.RightLane ? "#FF0000" : "#FF4444"  
+                    radius: 2
 
                 
+                    Rectangle {
+                        anchors {
+                            top: parent.top
+                            horizontalCenter: parent.horizontalCenter
+                        }
+                        width: 2
+                        height: 8
+                        color: highlightedLane === ClusterModel.RightLane ? "#FF0000" : "#FF4444"
+                        radius: 1
+                    }
+                }
+
+                // Car indicator - small rectangle at bottom
                 Rectangle {
                     anchors {
-                        top: parent.top
                         horizontalCenter: parent.horizontalCenter
+                        bottom: parent.bottom
+                        bottomMargin: 2
                     }
-                    width: 2
+                    width: 12
                     height: 8
-                    color: laneDeviationSide === "right" ? "#FF0000" : "#FF4444"
-                    radius: 1
-                }
-            }
+                    color: "#FF4444"  // Bright red
+                    radius: 2
 
-            // Car indicator - small rectangle at bottom
-            Rectangle {
-                anchors {
-                    horizontalCenter: parent.horizontalCenter
-                    bottom: parent.bottom
-                    bottomMargin: 2
-                }
-                width: 12
-                height: 8
-                color: "#FF4444"  // Bright red
-                radius: 2
+                    // Add lateral movement to indicate which side is deviating
+                    transform: Translate {
+                        x: highlightedLane === ClusterModel.LeftLane ? -5 : (highlightedLane === ClusterModel.RightLane ? 5 : 0)
 
-                // Add lateral movement to indicate which side is deviating
-                transform: Translate {
-                    x: laneAlertActive ? (laneDeviationSide === "left" ? -5 : 5) : 0
-
-                    Behavior on x {
-                        NumberAnimation { duration: 300 }
+                        Behavior on x {
+                            NumberAnimation { duration: 300 }
+                        }
                     }
                 }
-            }
 
-            // Use centralized blinking opacity
-            opacity: laneAlertActive ? alertOpacity : 1.0
+                // Use centralized blinking opacity
+                opacity: laneAlertActive ? alertOpacity : 1.0
+            }
         }
     }
 
-    
+    // Safety-critical overlays (obstacle, emergency brake) are always instantiated and kept
+    // in the scene graph at zero opacity, so their nodes and glyphs are already prepared and
+    // they appear in the very next frame
     Item {
         id: objectAlertBox
-        visible: objectAlertActive
+        opacity: objectAlertActive ? 1.0 : 0.0
         anchors {
             horizontalCenter: parent.horizontalCenter
             horizontalCenterOffset: -80  
@@ -292,10 +253,9 @@ Item {
         }
     }
 
-    
     Item {
         id: emergencyBrakeBox
-        visible: emergencyBrakeActive
+        opacity: emergencyBrakeActive ? 1.0 : 0.0
         anchors {
             horizontalCenter: parent.horizontalCenter
             horizontalCenterOffset: 0  // Centered like speed alert
@@ -362,40 +322,39 @@ Item {
         }
     }
 
-    
-    Item {
+    // Last speed limit (advisory): created on demand and unloaded when idle
+    LazyOverlay {
         id: speedLimitBox
-        visible: lastSpeedLimit > 0
+        wanted: lastSpeedLimit > 0
         anchors {
             horizontalCenter: parent.horizontalCenter
             verticalCenter: parent.verticalCenter
-            verticalCenterOffset: -70  
+            verticalCenterOffset: -70
         }
-        width: 60
-        height: 60
 
         // Speed limit sign background (circular like real traffic signs)
-        Rectangle {
-            id: speedLimitBackground
-            anchors.centerIn: parent
-            width: 50
-            height: 50
-            radius: 25  // Circular
-            color: "white"
-            border.width: 3
-            border.color: "#FF0000"  // Red border like real speed limit signs
+        sourceComponent: Component {
+            Rectangle {
+                id: speedLimitBackground
+                width: 50
+                height: 50
+                radius: 25  // Circular
+                color: "white"
+                border.width: 3
+                border.color: "#FF0000"  // Red border like real speed limit signs
 
-            // Speed limit text
-            Text {
-                anchors.centerIn: parent
-                text: lastSpeedLimit.toString()
-                color: "black"
-                font.pixelSize: 22
-                font.bold: true
-            }
+                // Speed limit text
+                Text {
+                    anchors.centerIn: parent
+                    text: lastSpeedLimit.toString()
+                    color: "black"
+                    font.pixelSize: 22
+                    font.bold: true
+                }
 
-            // Use centralized blinking opacity
-            opacity: speedLimitExceeded ? alertOpacity : 1.0
+                // Use centralized blinking opacity
+                opacity: speedLimitExceeded ? alertOpacity : 1.0
+            }
         }
     }
 }
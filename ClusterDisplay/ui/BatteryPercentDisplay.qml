@@ -1,4 +1,5 @@
 import QtQuick 6.4
+import ClusterDisplay 1.0
 
 Item {
     id: batteryPercentDisplay
@@ -6,9 +7,11 @@ Item {
     height: 60
 
     // Properties connected to ClusterModel
-    property real batteryPercent: clusterModel.battery  // Battery percentage from ClusterModel
-    property bool isCharging: clusterModel.charging     // Charging status from ClusterModel
+    property real batteryPercent: ClusterModel.battery  // Battery percentage from ClusterModel
+    property bool isCharging: ClusterModel.charging     // Charging status from ClusterModel
     property bool isLowBattery: false    // Low battery status (automatically set when < 20%)
+    property bool provisional: ClusterModel.provisionalFields & ClusterModel.BatteryField
+    property int estimatedRange: ClusterModel.estimatedRange  // Remaining range in meters (-1 = unknown)
 
     // Computed properties
     property bool _isLowActual: batteryPercent < 10.0
@@ -27,24 +30,40 @@ Item {
         anchors.fill: parent
         spacing: 5
 
-        Text {
+        Row {
             anchors.left: parent.left
-            text: "BATTERY"
-            font.pixelSize: 18
-            color: "#5a6580"
-            font.letterSpacing: window.letterSpacingWide
-            font.family: window.secondaryFont
+            spacing: 10
+
+            Text {
+                text: "BATTERY"
+                font.pixelSize: 18
+                color: "#5a6580"
+                font.letterSpacing: Theme.letterSpacingWide
+                font.family: Theme.secondaryFont
+            }
+
+            // Estimated range at the recent consumption
+            Text {
+                anchors.baseline: parent.children[0].baseline
+                visible: estimatedRange >= 0
+                text: "~" + (estimatedRange / 1000).toFixed(1) + " km"
+                font.pixelSize: 14
+                color: "#5a6580"
+                font.family: Theme.monoFont
+            }
         }
 
-        Text {
+        DigitDisplay {
             id: batteryText
             anchors.left: parent.left
             text: batteryPercent.toFixed(0) + "%"
+            characters: "0123456789%"
             font.pixelSize: 32
-            font.weight: window.fontBold
+            font.weight: Theme.fontBold
             color: "#ffffff"
-            font.family: window.monoFont
-            font.letterSpacing: window.letterSpacingTight
+            opacity: provisional ? Theme.provisionalOpacity : 1.0
+            font.family: Theme.monoFont
+            font.letterSpacing: Theme.letterSpacingTight
 
 
             Text {
@@ -1,11 +1,12 @@
 import QtQuick 6.4
+import ClusterDisplay 1.0
 
 Item {
     id: clockDisplay
     width: 200
     height: 60
 
-    property string currentTime: clusterModel.currentTime
+    property string currentTime: ClusterModel.currentTime
 
     Column {
         anchors.left: parent.left
@@ -16,18 +17,19 @@ Item {
             text: "TIME"
             font.pixelSize: 18
             color: "#5a6580"
-            font.letterSpacing: window.letterSpacingWide
-            font.family: window.secondaryFont
+            font.letterSpacing: Theme.letterSpacingWide
+            font.family: Theme.secondaryFont
         }
 
-        Text {
+        DigitDisplay {
             anchors.left: parent.left
             text: currentTime
-            font.family: window.monoFont
+            characters: "0123456789:"
+            font.family: Theme.monoFont
             font.pixelSize: 30
             color: "#ffffff"
             font.bold: true
-            font.letterSpacing: window.letterSpacingTight
+            font.letterSpacing: Theme.letterSpacingTight
         }
     }
 }
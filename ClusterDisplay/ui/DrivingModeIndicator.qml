@@ -1,21 +1,17 @@
 import QtQuick 6.4
+import ClusterDisplay 1.0
 
 Item {
     id: drivingModeIndicator
     width: 180
     height: 60
 
-    property string mode: clusterModel.drivingMode
+    property bool autoMode: ClusterModel.drivingModeType === ClusterModel.AutoMode
+    property bool provisional: ClusterModel.provisionalFields & ClusterModel.DrivingModeField
 
     // Mode colors for different driving modes
-    property var modeColors: {
-        "AUTO": "#00d4ff",
-        "MAN": "#5a6580"
-    }
-
-    // Get current color based on mode
-    property color currentColor: modeColors[mode] || modeColors["MAN"]
-    property string displayMode: mode || "MAN"
+    property color currentColor: autoMode ? "#00d4ff" : "#5a6580"
+    property string displayMode: autoMode ? "AUTO" : "MAN"
 
     Column {
         anchors.right: parent.right
@@ -26,19 +22,19 @@ Item {
             text: "MODE"
             font.pixelSize: 18
             color: "#5a6580"
-            font.letterSpacing: window.letterSpacingWide
-            font.family: window.secondaryFont
+            font.letterSpacing: Theme.letterSpacingWide
+            font.family: Theme.secondaryFont
         }
 
         Text {
             anchors.right: parent.right
             text: displayMode
             font.pixelSize: 26
-            font.weight: window.fontBold
-            font.letterSpacing: window.letterSpacingWide
+            font.weight: Theme.fontBold
+            font.letterSpacing: Theme.letterSpacingWide
             color: "#ffffff"
-            opacity: 1.0
-            font.family: window.primaryFont
+            opacity: provisional ? Theme.provisionalOpacity : 1.0
+            font.family: Theme.primaryFont
         }
     }
 }
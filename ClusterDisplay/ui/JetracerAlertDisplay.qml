@@ -1,4 +1,5 @@
 import QtQuick 6.4
+import ClusterDisplay 1.0
 
 Item {
     id: jetracerAlertDisplay
@@ -9,7 +10,7 @@ Item {
     property int speed: 0                // Speed value (km/h) controlling animation speed
     property bool objectAlertActive: false // Object detection alert
     property bool laneAlertActive: false   // Lane departure alert
-    property string laneDeviationSide: "left" // Which side the lane deviation is on ("left" or "right")
+    property int highlightedLane: ClusterModel.NoLane // Lane being departed (ClusterModel.LaneSide)
 
     // Use actual speed directly without stopping for objects
     property int _effectiveSpeed: speed
@@ -43,7 +44,7 @@ Item {
             function onLaneAlertActiveChanged() {
                 roadLines.requestPaint();
             }
-            function onLaneDeviationSideChanged() {
+            function onHighlightedLaneChanged() {
                 roadLines.requestPaint();
             }
         }
@@ -126,7 +127,7 @@ Item {
             var leftEnd = centerX - width * 0.25    // Narrower at bottom
 
             // Set color based on lane deviation (red if deviating to the left)
-            ctx.strokeStyle = (laneAlertActive && laneDeviationSide === "left") ? "#FF4444" : "white";
+            ctx.strokeStyle = highlightedLane === ClusterModel.LeftLane ? "#FF4444" : "white";
             drawRoadLine(ctx, leftStart, leftEnd, startY, endY, progress)
 
             // Right lane marking - narrower spacing
@@ -134,7 +135,7 @@ Item {
             var rightEnd = centerX + width * 0.25    // Narrower at bottom
 
             // Set color based on lane deviation (red if deviating to the right)
-            ctx.strokeStyle = (laneAlertActive && laneDeviationSide === "right") ? "#FF4444" : "white";
+            ctx.strokeStyle = highlightedLane === ClusterModel.RightLane ? "#FF4444" : "white";
             drawRoadLine(ctx, rightStart, rightEnd, startY, endY, progress)
         }
 
@@ -221,8 +222,8 @@ Item {
 
         
         transform: Translate {
-            x: laneAlertActive ?
-               (laneDeviationSide === "left" ? -25 : 25) : 0  
+            x: highlightedLane === ClusterModel.LeftLane ? -25 :
+               (highlightedLane === ClusterModel.RightLane ? 25 : 0)
 
             Behavior on x {
                 NumberAnimation { duration: 300; easing.type: Easing.OutQuad }
@@ -311,12 +312,12 @@ Item {
             ctx.strokeRect(width - 16, height - 60, 6, 14); // Right front wheel contour
 
             // Draw lane warning indicators when lane alert is active
-            if (laneAlertActive) {
+            if (highlightedLane !== ClusterModel.NoLane) {
                 ctx.fillStyle = "#FFEB3B"; // Yellow warning color
 
                 // Draw arrow indicating direction of drift
                 ctx.beginPath();
-                if (laneDeviationSide === "left") {
+                if (highlightedLane === ClusterModel.LeftLane) {
                     // Left arrow on right side
                     ctx.moveTo(width - 10, height * 0.4);
                     ctx.lineTo(width - 30, height * 0.35);
@@ -331,10 +332,9 @@ Item {
                 ctx.fill();
 
                 // Add pulsing glow around the car to indicate danger
-                var glowColor = laneDeviationSide === "left" ? "rgba(255, 0, 0, 0.3)" : "rgba(255, 0, 0, 0.3)";
-                ctx.fillStyle = glowColor;
+                ctx.fillStyle = "rgba(255, 0, 0, 0.3)";
                 ctx.beginPath();
-                if (laneDeviationSide === "left") {
+                if (highlightedLane === ClusterModel.LeftLane) {
                     // Left side glow
                     ctx.ellipse(-20, height/2, 30, height/2, 0, 0, 2 * Math.PI);
                 } else {
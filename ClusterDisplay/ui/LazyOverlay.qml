@@ -0,0 +1,38 @@
+import QtQuick 6.4
+import ClusterDisplay 1.0
+
+// Loader for overlays that are not safety-critical. The content is created
+// asynchronously the first time it is wanted and destroyed again once it has
+// not been wanted for DisplaySettings.overlayIdleUnloadMs, so overlays that
+// are rarely shown do not keep their items, animations and scene graph nodes
+// alive.
+Loader {
+    id: overlay
+
+    // Whether the overlay content should currently be shown
+    property bool wanted: false
+
+    // How long hidden content is kept before it is unloaded (0 unloads immediately)
+    property int idleUnloadMs: DisplaySettings.overlayIdleUnloadMs
+
+    active: false
+    asynchronous: true
+    visible: wanted
+
+    onWantedChanged: {
+        if (wanted) {
+            idleTimer.stop();
+            active = true;
+        } else {
+            idleTimer.restart();
+        }
+    }
+
+    Component.onCompleted: active = wanted
+
+    Timer {
+        id: idleTimer
+        interval: overlay.idleUnloadMs
+        onTriggered: overlay.active = false
+    }
+}
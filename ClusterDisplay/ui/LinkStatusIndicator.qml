@@ -0,0 +1,16 @@
+import QtQuick 6.4
+import ClusterDisplay 1.0
+
+Text {
+    id: linkStatusIndicator
+
+    property int status: ClusterModel.linkStatus
+
+    visible: status !== ClusterModel.LinkUp
+    text: status === ClusterModel.LinkDown ? "NO SIGNAL" : "NO DATA"
+    font.pixelSize: 16
+    font.weight: Theme.fontBold
+    font.letterSpacing: Theme.letterSpacingWide
+    font.family: Theme.secondaryFont
+    color: status === ClusterModel.LinkDown ? "#FFC0CB" : "#FFFACD"
+}
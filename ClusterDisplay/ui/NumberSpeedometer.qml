@@ -1,11 +1,12 @@
 import QtQuick 6.4
+import ClusterDisplay 1.0
 
 Item {
     id: speedometer
     width: 400
     height: 400
 
-    property int speed: clusterModel.speed
+    property int speed: ClusterModel.speed
 
     Item {
         id: speedDisplayContainer
@@ -25,15 +26,15 @@ Item {
             spacing: 5
 
             // Main speed value
-            Text {
+            DigitDisplay {
                 id: speedValue
                 anchors.horizontalCenter: parent.horizontalCenter
                 text: speed.toString()
                 color: "#ffffff"
                 font.pixelSize: 105
-                font.family: window.primaryFont
-                font.weight: window.fontNormal
-                font.letterSpacing: window.letterSpacingTight
+                font.family: Theme.primaryFont
+                font.weight: Theme.fontNormal
+                font.letterSpacing: Theme.letterSpacingTight
             }
 
             // Units label
@@ -42,8 +43,8 @@ Item {
                 text: "km/h (×10)"
                 color: "#5a6580"
                 font.pixelSize: 15
-                font.letterSpacing: window.letterSpacingWide
-                font.family: window.secondaryFont
+                font.letterSpacing: Theme.letterSpacingWide
+                font.family: Theme.secondaryFont
             }
         }
     }
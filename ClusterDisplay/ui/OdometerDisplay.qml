@@ -1,11 +1,13 @@
 import QtQuick 6.4
+import ClusterDisplay 1.0
 
 Item {
     id: odometerDisplay
     width: 200
     height: 60
 
-    property int value: clusterModel.odometer
+    property int value: ClusterModel.odometer
+    property bool provisional: ClusterModel.provisionalFields & ClusterModel.OdometerField
 
     Column {
         anchors.right: parent.right
@@ -16,19 +18,21 @@ Item {
             text: "ODOMETER"
             font.pixelSize: 18
             color: "#5a6580"
-            font.letterSpacing: window.letterSpacingWide
-            font.family: window.secondaryFont
+            font.letterSpacing: Theme.letterSpacingWide
+            font.family: Theme.secondaryFont
         }
 
-        Text {
+        DigitDisplay {
             id: valueText
             anchors.right: parent.right
             text: value.toString() + " m"
-            font.family: window.monoFont
+            characters: "0123456789 m"
+            font.family: Theme.monoFont
             font.pixelSize: 30
             color: "#ffffff"
+            opacity: provisional ? Theme.provisionalOpacity : 1.0
             font.bold: true
-            font.letterSpacing: window.letterSpacingTight
+            font.letterSpacing: Theme.letterSpacingTight
         }
     }
 }
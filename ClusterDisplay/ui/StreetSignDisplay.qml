@@ -1,25 +1,19 @@
 import QtQuick 6.4
+import ClusterDisplay 1.0
 
 Item {
     id: streetSignDisplay
     width: 220
     height: 220
 
-    property string signType: clusterModel.signType || "SPEED_LIMIT"  // Default to speed limit for backward compatibility
-    property string signValue: clusterModel.signValue || clusterModel.speedLimitSignal.toString()
-    property bool signVisible: clusterModel.signVisible || clusterModel.speedLimitVisible  // Show if either system is active
+    // Sign panel to show, resolved in C++ (speed limit signs from either sign system)
+    property int visibleSign: ClusterModel.visibleSign
+    property string signValue: ClusterModel.signValue || ClusterModel.speedLimitSignal.toString()
+    property bool signVisible: visibleSign !== ClusterModel.NoSign
 
     // Sign is only visible when signVisible is true
     visible: signVisible
 
-    // Debug output
-    onSignTypeChanged: {
-        requestPaint()
-    }
-    onSignVisibleChanged: {
-        requestPaint()
-    }
-
     // Speed Limit Sign
     Rectangle {
         id: speedLimitSign
@@ -32,7 +26,7 @@ Item {
             width: 12
             color: "red"
         }
-        visible: signType === "SPEED_LIMIT"
+        visible: visibleSign === ClusterModel.SpeedLimitSign
 
         // Red border ring
         Rectangle {
@@ -63,7 +57,7 @@ Item {
         anchors.centerIn: parent
         width: 140
         height: 140
-        visible: signType === "STOP"
+        visible: visibleSign === ClusterModel.StopSign
 
         // Octagonal shape for stop sign
         Canvas {
@@ -121,7 +115,7 @@ Item {
             width: 4
             color: "white"
         }
-        visible: signType === "CROSSWALK"
+        visible: visibleSign === ClusterModel.CrosswalkSign
 
         // White triangle background
         Canvas {
@@ -267,7 +261,7 @@ Item {
         anchors.centerIn: parent
         width: 140
         height: 140
-        visible: signType === "YIELD"
+        visible: visibleSign === ClusterModel.YieldSign
 
         // Triangular yield sign with rounded corners
         Canvas {
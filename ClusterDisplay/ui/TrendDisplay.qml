@@ -0,0 +1,54 @@
+import QtQuick 6.4
+import ClusterDisplay 1.0
+
+// Speed and battery over the last minutes. The graphs record from the moment they are
+// created, so they are loaded right after the first frame.
+Item {
+    id: trendDisplay
+    width: 240
+    height: 150
+
+    // Seconds shown by both graphs
+    property int timeSpan: 120
+
+    Column {
+        anchors.fill: parent
+        spacing: 6
+
+        Text {
+            text: "SPEED"
+            font.pixelSize: 14
+            color: "#5a6580"
+            font.letterSpacing: Theme.letterSpacingWide
+            font.family: Theme.secondaryFont
+        }
+
+        TrendGraph {
+            width: parent.width
+            height: 45
+            value: ClusterModel.speed
+            timeSpan: trendDisplay.timeSpan
+            minimum: 0
+            maximum: 1000
+            color: "#00d4ff"
+        }
+
+        Text {
+            text: "BATTERY"
+            font.pixelSize: 14
+            color: "#5a6580"
+            font.letterSpacing: Theme.letterSpacingWide
+            font.family: Theme.secondaryFont
+        }
+
+        TrendGraph {
+            width: parent.width
+            height: 45
+            value: ClusterModel.battery
+            timeSpan: trendDisplay.timeSpan
+            minimum: 0
+            maximum: 100
+            color: "#90EE90"
+        }
+    }
+}
@@ -0,0 +1,72 @@
+import QtQuick 6.4
+import ClusterDisplay 1.0
+
+// Trip computer readout. The values change at most once per second, so plain Text is enough.
+Item {
+    id: tripDisplay
+    width: 300
+    height: 60
+
+    // Moving time as h:mm or m:ss
+    function formatDuration(seconds) {
+        var hours = Math.floor(seconds / 3600);
+        var minutes = Math.floor(seconds % 3600 / 60);
+        var rest = seconds % 60;
+        if (hours > 0)
+            return hours + ":" + (minutes < 10 ? "0" : "") + minutes;
+        return minutes + ":" + (rest < 10 ? "0" : "") + rest;
+    }
+
+    Column {
+        anchors.fill: parent
+        spacing: 5
+
+        Text {
+            text: "TRIP"
+            font.pixelSize: 18
+            color: "#5a6580"
+            font.letterSpacing: Theme.letterSpacingWide
+            font.family: Theme.secondaryFont
+        }
+
+        Row {
+            spacing: 16
+
+            Repeater {
+                model: [
+                    { label: "DIST", value: (ClusterModel.tripDistance / 1000).toFixed(2) + " km" },
+                    { label: "TIME", value: tripDisplay.formatDuration(ClusterModel.tripMovingTime) },
+                    { label: "AVG", value: ClusterModel.tripAverageSpeed.toString() },
+                    { label: "MAX", value: ClusterModel.tripMaxSpeed.toString() },
+                    { label: "USED", value: ClusterModel.tripEnergyUsed + "%" }
+                ]
+
+                Column {
+                    required property var modelData
+
+                    Text {
+                        text: modelData.label
+                        font.pixelSize: 11
+                        color: "#5a6580"
+                        font.letterSpacing: Theme.letterSpacingNormal
+                        font.family: Theme.secondaryFont
+                    }
+
+                    Text {
+                        text: modelData.value
+                        font.pixelSize: 16
+                        color: "#ffffff"
+                        font.family: Theme.monoFont
+                    }
+                }
+            }
+        }
+    }
+
+    // Long press starts a new trip
+    MouseArea {
+        anchors.fill: parent
+        pressAndHoldInterval: 1500
+        onPressAndHold: ClusterModel.resetTrip()
+    }
+}